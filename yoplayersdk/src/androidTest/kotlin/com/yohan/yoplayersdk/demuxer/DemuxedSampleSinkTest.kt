@@ -0,0 +1,68 @@
+package com.yohan.yoplayersdk.demuxer
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.nio.ByteBuffer
+
+/**
+ * 네이티브 디먹서의 청크 단위 샘플 싱크 테스트
+ */
+@RunWith(AndroidJUnit4::class)
+class DemuxedSampleSinkTest {
+
+    private lateinit var demuxer: FfmpegDemuxer
+
+    @Before
+    fun setUp() {
+        demuxer = FfmpegDemuxer()
+        demuxer.initialize()
+    }
+
+    @After
+    fun tearDown() {
+        demuxer.release()
+    }
+
+    /**
+     * 60fps 비디오와 AAC 2트랙으로 된 2만 샘플 이상의 세그먼트가 잘리지 않고 모두 전달되는지 확인
+     */
+    @Test
+    fun sinkDeliversEverySampleOfLongSegment() {
+        val segment = SyntheticTsSegment.build(videoFrames = 8000, audioTracks = 2)
+        val expected = segment.videoSamples + segment.audioSamplesPerTrack * 2
+        assertTrue(expected >= 20000)
+        val buffer = ByteBuffer.allocateDirect(segment.bytes.size)
+        buffer.put(segment.bytes)
+        buffer.flip()
+
+        var chunks = 0
+        var received = 0
+        val perTrack = HashMap<Int, Int>()
+        var lastVideoDecodeTimeUs = Long.MIN_VALUE
+        var decodeOrderViolations = 0
+        val delivered = demuxer.demuxSegmentDirect(buffer, 0, buffer.limit()) { batch ->
+            chunks++
+            received += batch.sampleCount
+            for (i in 0 until batch.sampleCount) {
+                perTrack[batch.trackId[i]] = (perTrack[batch.trackId[i]] ?: 0) + 1
+                if (batch.isVideo(i)) {
+                    if (batch.decodeTimeUs[i] <= lastVideoDecodeTimeUs) decodeOrderViolations++
+                    lastVideoDecodeTimeUs = batch.decodeTimeUs[i]
+                }
+            }
+        }
+
+        assertEquals(expected, delivered)
+        assertEquals(expected, received)
+        assertTrue("segment must span several chunks", chunks > 1)
+        assertEquals(segment.videoSamples, perTrack[SyntheticTsSegment.VIDEO_PID])
+        assertEquals(segment.audioSamplesPerTrack, perTrack[SyntheticTsSegment.AUDIO_PID])
+        assertEquals(segment.audioSamplesPerTrack, perTrack[SyntheticTsSegment.AUDIO_PID + 1])
+        assertEquals(0, decodeOrderViolations)
+    }
+}
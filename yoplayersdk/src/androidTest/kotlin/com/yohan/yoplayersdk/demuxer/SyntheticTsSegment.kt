@@ -0,0 +1,232 @@
+package com.yohan.yoplayersdk.demuxer
+
+import java.io.ByteArrayOutputStream
+
+/**
+ * 테스트용 합성 MPEG-TS 세그먼트
+ *
+ * PAT/PMT(CRC 포함), 프레임마다 PES 하나인 H.264 비디오, PES마다 ADTS 프레임 하나인 AAC 오디오 트랙으로
+ * 구성된다. 비디오는 60fps, 오디오는 48kHz이며 디코딩 시각 순서로 섞어 기록한다.
+ *
+ * @property bytes TS 바이트
+ * @property videoSamples 비디오 액세스 유닛 수
+ * @property audioSamplesPerTrack 오디오 트랙마다의 ADTS 프레임 수
+ */
+class SyntheticTsSegment private constructor(
+    val bytes: ByteArray,
+    val videoSamples: Int,
+    val audioSamplesPerTrack: Int
+) {
+    companion object {
+        const val PMT_PID = 0x1000
+        const val VIDEO_PID = 0x100
+        const val AUDIO_PID = 0x101  // 오디오 트랙 i는 AUDIO_PID + i
+
+        private const val PACKET_SIZE = 188
+        private const val VIDEO_FRAME_DURATION = 1500L  // 90kHz, 60fps
+        private const val AUDIO_FRAME_DURATION = 1920L  // 90kHz, 1024 samples @ 48kHz
+        private const val START_PTS = 126000L
+
+        private val SPS = byteArrayOf(
+            0x67, 0x64, 0x00, 0x28, 0xAC.toByte(), 0xD9.toByte(), 0x40, 0x78, 0x02, 0x27,
+            0xE5.toByte(), 0xC0.toByte(), 0x44, 0x00, 0x00, 0x03, 0x00, 0x04, 0x00, 0x00,
+            0x03, 0x00, 0xF0.toByte(), 0x3C, 0x60, 0xC6.toByte(), 0x58
+        )
+        private val PPS = byteArrayOf(0x68, 0xEB.toByte(), 0xE3.toByte(), 0xCB.toByte(), 0x22, 0xC0.toByte())
+
+        /**
+         * @param videoFrames 비디오 프레임 수 (오디오는 같은 길이만큼 생성)
+         * @param audioTracks 오디오 트랙 수
+         * @param gop 키프레임 간격
+         */
+        fun build(videoFrames: Int, audioTracks: Int, gop: Int = 120): SyntheticTsSegment {
+            val writer = Writer()
+            writer.writePat()
+            writer.writePmt(audioTracks)
+
+            val audioFrames = (videoFrames * VIDEO_FRAME_DURATION / AUDIO_FRAME_DURATION).toInt()
+            var video = 0
+            var audio = 0
+            while (video < videoFrames || audio < audioFrames) {
+                val videoDts = START_PTS + video * VIDEO_FRAME_DURATION
+                val audioPts = START_PTS + audio * AUDIO_FRAME_DURATION
+                if (video < videoFrames && (audio >= audioFrames || videoDts <= audioPts)) {
+                    val idr = video % gop == 0
+                    writer.writePes(
+                        VIDEO_PID, 0xE0, videoDts + VIDEO_FRAME_DURATION, videoDts,
+                        videoAccessUnit(idr, if (idr) 1200 else 300), idr
+                    )
+                    video++
+                } else {
+                    for (track in 0 until audioTracks) {
+                        writer.writePes(
+                            AUDIO_PID + track, 0xC0 + track, audioPts, audioPts,
+                            adtsFrame(200), false
+                        )
+                    }
+                    audio++
+                }
+            }
+            return SyntheticTsSegment(writer.toByteArray(), videoFrames, audioFrames)
+        }
+
+        private fun videoAccessUnit(idr: Boolean, size: Int): ByteArray {
+            val out = ByteArrayOutputStream(size)
+            out.write(byteArrayOf(0, 0, 0, 1, 0x09, 0xF0.toByte()))
+            if (idr) {
+                out.write(byteArrayOf(0, 0, 0, 1))
+                out.write(SPS)
+                out.write(byteArrayOf(0, 0, 0, 1))
+                out.write(PPS)
+            }
+            if (idr) {
+                out.write(byteArrayOf(0, 0, 1, 0x65, 0x88.toByte(), 0x84.toByte()))
+            } else {
+                out.write(byteArrayOf(0, 0, 1, 0x41, 0x9A.toByte(), 0x02))
+            }
+            // 0이 없는 슬라이스 데이터 (시작 코드/에뮬레이션 방지 바이트가 생기지 않음)
+            while (out.size() < size - 1) {
+                out.write(0x5A)
+            }
+            out.write(0x80)
+            return out.toByteArray()
+        }
+
+        private fun adtsFrame(payloadSize: Int): ByteArray {
+            val frameSize = payloadSize + 7
+            val frame = ByteArray(frameSize) { 0x21 }
+            frame[0] = 0xFF.toByte()
+            frame[1] = 0xF1.toByte()  // MPEG-4, protection_absent
+            frame[2] = ((1 shl 6) or (3 shl 2)).toByte()  // AAC-LC, 48kHz
+            frame[3] = ((2 shl 6) or ((frameSize shr 11) and 0x03)).toByte()  // 스테레오
+            frame[4] = ((frameSize shr 3) and 0xFF).toByte()
+            frame[5] = (((frameSize and 0x07) shl 5) or 0x1F).toByte()
+            frame[6] = 0xFC.toByte()
+            return frame
+        }
+    }
+
+    private class Writer {
+        private val out = ByteArrayOutputStream()
+        private val continuity = IntArray(0x2000)
+
+        fun toByteArray(): ByteArray = out.toByteArray()
+
+        fun writePat() {
+            writeSection(
+                0x0000,
+                intArrayOf(0x00, 0, 0, 0x00, 0x01, 0xC1, 0x00, 0x00, 0x00, 0x01,
+                    0xE0 or (PMT_PID shr 8), PMT_PID and 0xFF)
+            )
+        }
+
+        fun writePmt(audioTracks: Int) {
+            val section = mutableListOf(
+                0x02, 0, 0, 0x00, 0x01, 0xC1, 0x00, 0x00,
+                0xE0 or (VIDEO_PID shr 8), VIDEO_PID and 0xFF, 0xF0, 0x00,
+                0x1B, 0xE0 or (VIDEO_PID shr 8), VIDEO_PID and 0xFF, 0xF0, 0x00
+            )
+            for (track in 0 until audioTracks) {
+                val pid = AUDIO_PID + track
+                section += listOf(0x0F, 0xE0 or (pid shr 8), pid and 0xFF, 0xF0, 0x00)
+            }
+            writeSection(PMT_PID, section.toIntArray())
+        }
+
+        private fun writeSection(pid: Int, header: IntArray) {
+            val sectionLength = header.size - 3 + 4
+            header[1] = 0xB0 or (sectionLength shr 8)
+            header[2] = sectionLength and 0xFF
+            val section = ByteArray(header.size + 4)
+            for (i in header.indices) {
+                section[i] = header[i].toByte()
+            }
+            val crc = crc32Mpeg(section, header.size)
+            for (i in 0 until 4) {
+                section[header.size + i] = (crc ushr (24 - 8 * i)).toByte()
+            }
+            // pointer_field
+            writePacket(pid, true, false, byteArrayOf(0) + section, 0, section.size + 1)
+        }
+
+        fun writePes(pid: Int, streamId: Int, pts: Long, dts: Long, payload: ByteArray, randomAccess: Boolean) {
+            val hasDts = pts != dts
+            val headerLength = if (hasDts) 10 else 5
+            val pes = ByteArrayOutputStream(payload.size + 19)
+            pes.write(byteArrayOf(0, 0, 1, streamId.toByte()))
+            // 비디오는 PES_packet_length 0 (unbounded)
+            val pesLength = if (streamId >= 0xE0) 0 else 3 + headerLength + payload.size
+            pes.write(pesLength shr 8)
+            pes.write(pesLength and 0xFF)
+            pes.write(0x80)
+            pes.write(if (hasDts) 0xC0 else 0x80)
+            pes.write(headerLength)
+            writeTimestamp(pes, if (hasDts) 0x03 else 0x02, pts)
+            if (hasDts) {
+                writeTimestamp(pes, 0x01, dts)
+            }
+            pes.write(payload)
+
+            val data = pes.toByteArray()
+            var pos = 0
+            var first = true
+            while (pos < data.size) {
+                val capacity = if (first && randomAccess) 182 else 184
+                val chunk = minOf(capacity, data.size - pos)
+                writePacket(pid, first, first && randomAccess, data, pos, chunk)
+                pos += chunk
+                first = false
+            }
+        }
+
+        private fun writeTimestamp(out: ByteArrayOutputStream, prefix: Int, timestamp: Long) {
+            val ts = timestamp and 0x1FFFFFFFFL
+            out.write((prefix shl 4) or (((ts shr 30) and 0x07).toInt() shl 1) or 0x01)
+            out.write((ts shr 22).toInt() and 0xFF)
+            out.write(((((ts shr 15) and 0x7F).toInt()) shl 1) or 0x01)
+            out.write((ts shr 7).toInt() and 0xFF)
+            out.write((((ts and 0x7F).toInt()) shl 1) or 0x01)
+        }
+
+        private fun writePacket(
+            pid: Int,
+            unitStart: Boolean,
+            randomAccess: Boolean,
+            payload: ByteArray,
+            offset: Int,
+            size: Int
+        ) {
+            val packet = ByteArray(PACKET_SIZE) { 0xFF.toByte() }
+            packet[0] = 0x47
+            packet[1] = ((if (unitStart) 0x40 else 0x00) or (pid shr 8)).toByte()
+            packet[2] = (pid and 0xFF).toByte()
+            val counter = continuity[pid]
+            continuity[pid] = (counter + 1) and 0x0F
+            var headerSize = 4
+            if (randomAccess || size < 184) {
+                packet[3] = (0x30 or counter).toByte()
+                val adaptationLength = 183 - size
+                packet[4] = adaptationLength.toByte()
+                if (adaptationLength > 0) {
+                    packet[5] = (if (randomAccess) 0x40 else 0x00).toByte()
+                }
+                headerSize = 5 + adaptationLength
+            } else {
+                packet[3] = (0x10 or counter).toByte()
+            }
+            System.arraycopy(payload, offset, packet, headerSize, size)
+            out.write(packet)
+        }
+
+        private fun crc32Mpeg(data: ByteArray, size: Int): Int {
+            var crc = -1
+            for (i in 0 until size) {
+                crc = crc xor ((data[i].toInt() and 0xFF) shl 24)
+                repeat(8) {
+                    crc = if ((crc and Int.MIN_VALUE) != 0) (crc shl 1) xor 0x04C11DB7 else crc shl 1
+                }
+            }
+            return crc
+        }
+    }
+}
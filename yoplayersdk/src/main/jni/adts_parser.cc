@@ -0,0 +1,71 @@
+/*
+ * ADTS 헤더 파서 구현 (ISO/IEC 13818-7 6.2 adts_frame)
+ */
+#include "adts_parser.h"
+
+static const int kAdtsSampleRates[16] = {
+    96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050,
+    16000, 12000, 11025, 8000, 7350, 0, 0, 0,
+};
+
+bool is_adts_sync(const uint8_t* data, size_t size) {
+    return size >= 2 && data[0] == 0xFF && (data[1] & 0xF6) == 0xF0;
+}
+
+bool parse_adts_header(const uint8_t* data, size_t size, AdtsHeader* out) {
+    if (size < (size_t)ADTS_HEADER_SIZE || !is_adts_sync(data, size)) {
+        return false;
+    }
+    bool protection_absent = (data[1] & 0x01) != 0;
+    out->raw_blocks = (data[6] & 0x03) + 1;
+    // adts_header_error_check: 두 번째 블록부터의 raw_data_block_position과 crc_check
+    out->header_size = protection_absent ? ADTS_HEADER_SIZE
+                                         : ADTS_HEADER_SIZE + ADTS_CRC_SIZE * out->raw_blocks;
+    out->frame_size = ((data[3] & 0x03) << 11) | (data[4] << 3) | (data[5] >> 5);
+    if (out->frame_size < out->header_size) {
+        return false;
+    }
+    out->profile = (data[2] >> 6) & 0x03;
+    out->sample_rate_index = (data[2] >> 2) & 0x0F;
+    out->sample_rate = kAdtsSampleRates[out->sample_rate_index];
+    out->channel_config = ((data[2] & 0x01) << 2) | ((data[3] >> 6) & 0x03);
+    out->protection_absent = protection_absent;
+    return true;
+}
+
+int64_t adts_frame_duration(const AdtsHeader* header) {
+    if (header->sample_rate <= 0) {
+        return 0;
+    }
+    return (int64_t)header->raw_blocks * AAC_SAMPLES_PER_FRAME * 90000 / header->sample_rate;
+}
+
+int adts_split_raw_blocks(const uint8_t* frame, const AdtsHeader* header, AdtsRawBlock* blocks) {
+    if (header->frame_size <= header->header_size) {
+        return 0;
+    }
+    blocks[0].offset = header->header_size;
+    blocks[0].size = header->frame_size - header->header_size;
+    if (header->raw_blocks == 1 || header->protection_absent) {
+        return 1;
+    }
+
+    // 블록 i(1 이상)의 시작 위치, 각 블록 뒤에는 adts_raw_data_block_error_check(CRC)가 붙는다
+    int starts[ADTS_MAX_RAW_BLOCKS + 1];
+    starts[0] = header->header_size;
+    for (int i = 1; i < header->raw_blocks; i++) {
+        const uint8_t* position = frame + ADTS_HEADER_SIZE + (i - 1) * ADTS_CRC_SIZE;
+        starts[i] = (position[0] << 8) | position[1];
+    }
+    starts[header->raw_blocks] = header->frame_size;
+    for (int i = 0; i < header->raw_blocks; i++) {
+        if (starts[i + 1] - starts[i] - ADTS_CRC_SIZE <= 0) {
+            return 1;
+        }
+    }
+    for (int i = 0; i < header->raw_blocks; i++) {
+        blocks[i].offset = starts[i];
+        blocks[i].size = starts[i + 1] - starts[i] - ADTS_CRC_SIZE;
+    }
+    return header->raw_blocks;
+}
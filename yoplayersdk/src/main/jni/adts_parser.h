@@ -0,0 +1,64 @@
+/*
+ * ADTS(Audio Data Transport Stream) 헤더 파서
+ *
+ * MPEG-TS의 AAC는 프레임마다 7바이트(CRC가 있으면 9바이트 이상) ADTS 헤더가 붙어 있다.
+ * 헤더에서 프레임 길이와 샘플레이트, 채널 구성을 읽어 PES 페이로드를 raw AAC 액세스 유닛으로 나눈다.
+ * 프레임 하나에 raw_data_block이 여러 개면 블록마다 액세스 유닛 하나로 나눈다.
+ */
+#ifndef YOPLAYER_ADTS_PARSER_H
+#define YOPLAYER_ADTS_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static const int ADTS_HEADER_SIZE = 7;
+static const int ADTS_CRC_SIZE = 2;
+static const int ADTS_MAX_RAW_BLOCKS = 4;
+static const int AAC_SAMPLES_PER_FRAME = 1024;
+
+struct AdtsHeader {
+    int header_size;            // 7, CRC가 있으면 7 + 2 * raw_blocks (블록 위치 + 헤더 CRC)
+    int frame_size;             // 헤더 포함 프레임 길이
+    int profile;                // audio object type - 1
+    int sample_rate_index;
+    int sample_rate;            // 예약된 인덱스면 0
+    int channel_config;
+    int raw_blocks;             // 프레임의 raw_data_block 수 (1~4)
+    bool protection_absent;
+};
+
+/**
+ * data가 ADTS 동기 워드(0xFFF, layer 0)로 시작하는지 여부
+ */
+bool is_adts_sync(const uint8_t* data, size_t size);
+
+/**
+ * ADTS 헤더 파싱
+ * @param data 동기 워드부터 시작하는 데이터 (ADTS_HEADER_SIZE바이트 이상)
+ * @return 동기 워드가 없거나 frame_length가 헤더보다 짧으면 false
+ */
+bool parse_adts_header(const uint8_t* data, size_t size, AdtsHeader* out);
+
+/**
+ * 프레임 길이 (90kHz), 샘플레이트를 모르면 0
+ */
+int64_t adts_frame_duration(const AdtsHeader* header);
+
+// 프레임 안의 raw_data_block 구간 (offset은 프레임 시작 기준)
+struct AdtsRawBlock {
+    int offset;
+    int size;
+};
+
+/**
+ * 프레임을 raw_data_block 단위로 나눔
+ * CRC가 있으면 헤더의 raw_data_block_position으로 나누고 블록마다 붙은 CRC를 뺀다.
+ * CRC가 없는 다중 블록 프레임은 블록 경계를 헤더에서 알 수 없으므로 헤더 뒤 전체를 블록 하나로 반환한다
+ * (libavformat도 나누지 않음). 블록 위치가 올바르지 않을 때도 마찬가지다.
+ * @param frame 프레임 전체 (header->frame_size바이트)
+ * @param blocks ADTS_MAX_RAW_BLOCKS개 이상
+ * @return 블록 수, 헤더만 있는 빈 프레임이면 0
+ */
+int adts_split_raw_blocks(const uint8_t* frame, const AdtsHeader* header, AdtsRawBlock* blocks);
+
+#endif  // YOPLAYER_ADTS_PARSER_H
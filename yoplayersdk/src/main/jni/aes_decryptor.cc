@@ -0,0 +1,369 @@
+/*
+ * HLS AES-128 세그먼트 복호화 구현 (FIPS-197, RFC 8216 4.3.2.4)
+ *
+ * 하드웨어 경로는 equivalent inverse cipher 라운드 키를 미리 만들어 두고 4블록씩 묶어 복호화한다.
+ * CBC 복호화는 블록 사이에 의존성이 없으므로 AESDEC 지연 시간을 여러 블록이 나누어 가린다.
+ */
+#include "aes_decryptor.h"
+
+#include <string.h>
+
+extern "C" {
+#include <libavutil/aes.h>
+#include <libavutil/mem.h>
+}
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#define AES_DECRYPTOR_X86 1
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_AES
+#define HWCAP_AES (1 << 3)
+#endif
+#define AES_DECRYPTOR_ARMV8 1
+#endif
+
+enum AesImplementation {
+    AES_IMPL_SOFTWARE = 0,
+    AES_IMPL_AESNI,
+    AES_IMPL_ARMV8,
+};
+
+static const uint8_t kSbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+/**
+ * AES-128 암호화 라운드 키 확장 (FIPS-197 5.2)
+ */
+static void expand_key(const uint8_t* key, uint8_t out[11][AES_BLOCK_SIZE]) {
+    memcpy(out[0], key, AES_BLOCK_SIZE);
+    uint8_t rcon = 0x01;
+    for (int round = 1; round <= 10; round++) {
+        const uint8_t* prev = out[round - 1];
+        uint8_t* cur = out[round];
+        // RotWord + SubWord + Rcon
+        cur[0] = prev[0] ^ kSbox[prev[13]] ^ rcon;
+        cur[1] = prev[1] ^ kSbox[prev[14]];
+        cur[2] = prev[2] ^ kSbox[prev[15]];
+        cur[3] = prev[3] ^ kSbox[prev[12]];
+        for (int i = 4; i < AES_BLOCK_SIZE; i++) {
+            cur[i] = prev[i] ^ cur[i - 4];
+        }
+        rcon = (uint8_t)((rcon << 1) ^ ((rcon & 0x80) ? 0x1B : 0x00));
+    }
+}
+
+#if defined(AES_DECRYPTOR_X86)
+
+/**
+ * 복호화 라운드 키: 마지막 암호화 라운드 키부터 역순, 중간 라운드는 InvMixColumns 적용
+ */
+__attribute__((target("aes")))
+static void prepare_round_keys_aesni(const uint8_t enc[11][AES_BLOCK_SIZE],
+                                     uint8_t dec[11][AES_BLOCK_SIZE]) {
+    _mm_storeu_si128((__m128i*)dec[0], _mm_loadu_si128((const __m128i*)enc[10]));
+    for (int i = 1; i < 10; i++) {
+        __m128i round_key = _mm_loadu_si128((const __m128i*)enc[10 - i]);
+        _mm_storeu_si128((__m128i*)dec[i], _mm_aesimc_si128(round_key));
+    }
+    _mm_storeu_si128((__m128i*)dec[10], _mm_loadu_si128((const __m128i*)enc[0]));
+}
+
+__attribute__((target("aes")))
+static inline __m128i decrypt_block_aesni(__m128i block, const __m128i* rk) {
+    block = _mm_xor_si128(block, rk[0]);
+    for (int i = 1; i < 10; i++) {
+        block = _mm_aesdec_si128(block, rk[i]);
+    }
+    return _mm_aesdeclast_si128(block, rk[10]);
+}
+
+__attribute__((target("aes")))
+static void decrypt_blocks_aesni(const AesKey* key, uint8_t* iv,
+                                 const uint8_t* in, uint8_t* out, size_t blocks) {
+    __m128i rk[11];
+    for (int i = 0; i < 11; i++) {
+        rk[i] = _mm_loadu_si128((const __m128i*)key->round_keys[i]);
+    }
+    __m128i prev = _mm_loadu_si128((const __m128i*)iv);
+
+    size_t i = 0;
+    for (; i + 4 <= blocks; i += 4) {
+        const __m128i* src = (const __m128i*)(in + i * AES_BLOCK_SIZE);
+        __m128i c0 = _mm_loadu_si128(src);
+        __m128i c1 = _mm_loadu_si128(src + 1);
+        __m128i c2 = _mm_loadu_si128(src + 2);
+        __m128i c3 = _mm_loadu_si128(src + 3);
+        __m128i x0 = _mm_xor_si128(c0, rk[0]);
+        __m128i x1 = _mm_xor_si128(c1, rk[0]);
+        __m128i x2 = _mm_xor_si128(c2, rk[0]);
+        __m128i x3 = _mm_xor_si128(c3, rk[0]);
+        for (int r = 1; r < 10; r++) {
+            x0 = _mm_aesdec_si128(x0, rk[r]);
+            x1 = _mm_aesdec_si128(x1, rk[r]);
+            x2 = _mm_aesdec_si128(x2, rk[r]);
+            x3 = _mm_aesdec_si128(x3, rk[r]);
+        }
+        x0 = _mm_xor_si128(_mm_aesdeclast_si128(x0, rk[10]), prev);
+        x1 = _mm_xor_si128(_mm_aesdeclast_si128(x1, rk[10]), c0);
+        x2 = _mm_xor_si128(_mm_aesdeclast_si128(x2, rk[10]), c1);
+        x3 = _mm_xor_si128(_mm_aesdeclast_si128(x3, rk[10]), c2);
+        prev = c3;
+        __m128i* dst = (__m128i*)(out + i * AES_BLOCK_SIZE);
+        _mm_storeu_si128(dst, x0);
+        _mm_storeu_si128(dst + 1, x1);
+        _mm_storeu_si128(dst + 2, x2);
+        _mm_storeu_si128(dst + 3, x3);
+    }
+    for (; i < blocks; i++) {
+        __m128i c = _mm_loadu_si128((const __m128i*)(in + i * AES_BLOCK_SIZE));
+        __m128i x = _mm_xor_si128(decrypt_block_aesni(c, rk), prev);
+        prev = c;
+        _mm_storeu_si128((__m128i*)(out + i * AES_BLOCK_SIZE), x);
+    }
+    _mm_storeu_si128((__m128i*)iv, prev);
+}
+
+static int detect_implementation() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("aes") ? AES_IMPL_AESNI : AES_IMPL_SOFTWARE;
+}
+
+#elif defined(AES_DECRYPTOR_ARMV8)
+
+static void prepare_round_keys_armv8(const uint8_t enc[11][AES_BLOCK_SIZE],
+                                     uint8_t dec[11][AES_BLOCK_SIZE]) {
+    vst1q_u8(dec[0], vld1q_u8(enc[10]));
+    for (int i = 1; i < 10; i++) {
+        vst1q_u8(dec[i], vaesimcq_u8(vld1q_u8(enc[10 - i])));
+    }
+    vst1q_u8(dec[10], vld1q_u8(enc[0]));
+}
+
+/**
+ * AESD는 AddRoundKey를 먼저 수행하므로 (AESD + AESIMC) 9회 뒤 AESD, 마지막 라운드 키 XOR 순서가 된다.
+ */
+static inline uint8x16_t decrypt_block_armv8(uint8x16_t block, const uint8x16_t* rk) {
+    for (int i = 0; i < 9; i++) {
+        block = vaesimcq_u8(vaesdq_u8(block, rk[i]));
+    }
+    return veorq_u8(vaesdq_u8(block, rk[9]), rk[10]);
+}
+
+static void decrypt_blocks_armv8(const AesKey* key, uint8_t* iv,
+                                 const uint8_t* in, uint8_t* out, size_t blocks) {
+    uint8x16_t rk[11];
+    for (int i = 0; i < 11; i++) {
+        rk[i] = vld1q_u8(key->round_keys[i]);
+    }
+    uint8x16_t prev = vld1q_u8(iv);
+
+    size_t i = 0;
+    for (; i + 4 <= blocks; i += 4) {
+        const uint8_t* src = in + i * AES_BLOCK_SIZE;
+        uint8x16_t c0 = vld1q_u8(src);
+        uint8x16_t c1 = vld1q_u8(src + 16);
+        uint8x16_t c2 = vld1q_u8(src + 32);
+        uint8x16_t c3 = vld1q_u8(src + 48);
+        uint8x16_t x0 = c0;
+        uint8x16_t x1 = c1;
+        uint8x16_t x2 = c2;
+        uint8x16_t x3 = c3;
+        for (int r = 0; r < 9; r++) {
+            x0 = vaesimcq_u8(vaesdq_u8(x0, rk[r]));
+            x1 = vaesimcq_u8(vaesdq_u8(x1, rk[r]));
+            x2 = vaesimcq_u8(vaesdq_u8(x2, rk[r]));
+            x3 = vaesimcq_u8(vaesdq_u8(x3, rk[r]));
+        }
+        x0 = veorq_u8(veorq_u8(vaesdq_u8(x0, rk[9]), rk[10]), prev);
+        x1 = veorq_u8(veorq_u8(vaesdq_u8(x1, rk[9]), rk[10]), c0);
+        x2 = veorq_u8(veorq_u8(vaesdq_u8(x2, rk[9]), rk[10]), c1);
+        x3 = veorq_u8(veorq_u8(vaesdq_u8(x3, rk[9]), rk[10]), c2);
+        prev = c3;
+        uint8_t* dst = out + i * AES_BLOCK_SIZE;
+        vst1q_u8(dst, x0);
+        vst1q_u8(dst + 16, x1);
+        vst1q_u8(dst + 32, x2);
+        vst1q_u8(dst + 48, x3);
+    }
+    for (; i < blocks; i++) {
+        uint8x16_t c = vld1q_u8(in + i * AES_BLOCK_SIZE);
+        uint8x16_t x = veorq_u8(decrypt_block_armv8(c, rk), prev);
+        prev = c;
+        vst1q_u8(out + i * AES_BLOCK_SIZE, x);
+    }
+    vst1q_u8(iv, prev);
+}
+
+static int detect_implementation() {
+    return (getauxval(AT_HWCAP) & HWCAP_AES) ? AES_IMPL_ARMV8 : AES_IMPL_SOFTWARE;
+}
+
+#else
+
+static int detect_implementation() {
+    return AES_IMPL_SOFTWARE;
+}
+
+#endif
+
+// CPU 기능은 최초 호출 시 한 번만 확인
+static int implementation() {
+    static const int impl = detect_implementation();
+    return impl;
+}
+
+void aes_cbc_decrypt_blocks(const AesKey* key, uint8_t* iv,
+                            const uint8_t* in, uint8_t* out, size_t blocks) {
+    if (blocks == 0) {
+        return;
+    }
+    switch (implementation()) {
+#if defined(AES_DECRYPTOR_X86)
+        case AES_IMPL_AESNI:
+            decrypt_blocks_aesni(key, iv, in, out, blocks);
+            return;
+#elif defined(AES_DECRYPTOR_ARMV8)
+        case AES_IMPL_ARMV8:
+            decrypt_blocks_armv8(key, iv, in, out, blocks);
+            return;
+#endif
+        default:
+            // av_aes_crypt는 블록마다 암호문을 IV로 복사한 뒤 출력을 쓰므로 제자리 복호화가 가능
+            av_aes_crypt(key->av_aes, out, in, (int)blocks, iv, 1);
+            return;
+    }
+}
+
+void aes_key_init(AesKey* key) {
+    memset(key, 0, sizeof(*key));
+}
+
+void aes_key_release(AesKey* key) {
+    av_freep(&key->av_aes);
+    key->valid = false;
+}
+
+bool aes_key_set(AesKey* key, const uint8_t* bytes) {
+    if (key->valid && memcmp(key->key, bytes, AES_BLOCK_SIZE) == 0) {
+        return true;
+    }
+    key->valid = false;
+
+    if (implementation() == AES_IMPL_SOFTWARE) {
+        if (!key->av_aes) {
+            key->av_aes = av_aes_alloc();
+            if (!key->av_aes) {
+                return false;
+            }
+        }
+        if (av_aes_init(key->av_aes, bytes, 128, 1) < 0) {
+            return false;
+        }
+    } else {
+        uint8_t enc[11][AES_BLOCK_SIZE];
+        expand_key(bytes, enc);
+#if defined(AES_DECRYPTOR_X86)
+        prepare_round_keys_aesni(enc, key->round_keys);
+#elif defined(AES_DECRYPTOR_ARMV8)
+        prepare_round_keys_armv8(enc, key->round_keys);
+#endif
+    }
+
+    memcpy(key->key, bytes, AES_BLOCK_SIZE);
+    key->valid = true;
+    return true;
+}
+
+void aes_cbc_start(AesCbcState* state, const uint8_t* iv) {
+    memcpy(state->iv, iv, AES_BLOCK_SIZE);
+    state->pending_size = 0;
+}
+
+size_t aes_cbc_update(const AesKey* key, AesCbcState* state,
+                      const uint8_t* in, size_t size, uint8_t* out) {
+    size_t total = (size_t)state->pending_size + size;
+    if (total == 0) {
+        return 0;
+    }
+    // 끝이 블록 경계에 맞으면 그 블록이 세그먼트의 마지막일 수 있으므로 보류
+    size_t hold = total % AES_BLOCK_SIZE;
+    if (hold == 0) {
+        hold = AES_BLOCK_SIZE;
+    }
+    size_t blocks = (total - hold) / AES_BLOCK_SIZE;
+    size_t written = 0;
+
+    if (blocks > 0 && state->pending_size > 0) {
+        size_t fill = AES_BLOCK_SIZE - state->pending_size;
+        memcpy(state->pending + state->pending_size, in, fill);
+        in += fill;
+        size -= fill;
+        aes_cbc_decrypt_blocks(key, state->iv, state->pending, out, 1);
+        state->pending_size = 0;
+        written = AES_BLOCK_SIZE;
+        blocks--;
+    }
+
+    aes_cbc_decrypt_blocks(key, state->iv, in, out + written, blocks);
+    in += blocks * AES_BLOCK_SIZE;
+    size -= blocks * AES_BLOCK_SIZE;
+    written += blocks * AES_BLOCK_SIZE;
+
+    memcpy(state->pending + state->pending_size, in, size);
+    state->pending_size += (int)size;
+    return written;
+}
+
+size_t aes_cbc_finish(const AesKey* key, AesCbcState* state, uint8_t* out, bool* padding_valid) {
+    *padding_valid = false;
+    if (state->pending_size != AES_BLOCK_SIZE) {
+        // 세그먼트 길이가 블록 단위가 아님: 남은 조각은 복호화할 수 없으므로 버림
+        state->pending_size = 0;
+        return 0;
+    }
+    aes_cbc_decrypt_blocks(key, state->iv, state->pending, out, 1);
+    state->pending_size = 0;
+
+    int padding = out[AES_BLOCK_SIZE - 1];
+    if (padding < 1 || padding > AES_BLOCK_SIZE) {
+        return AES_BLOCK_SIZE;
+    }
+    for (int i = AES_BLOCK_SIZE - padding; i < AES_BLOCK_SIZE; i++) {
+        if (out[i] != padding) {
+            return AES_BLOCK_SIZE;
+        }
+    }
+    *padding_valid = true;
+    return (size_t)(AES_BLOCK_SIZE - padding);
+}
+
+const char* aes_implementation_name() {
+    switch (implementation()) {
+        case AES_IMPL_AESNI:
+            return "aes-ni";
+        case AES_IMPL_ARMV8:
+            return "armv8-crypto";
+        default:
+            return "libavutil";
+    }
+}
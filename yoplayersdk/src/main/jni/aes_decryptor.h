@@ -0,0 +1,75 @@
+/*
+ * HLS AES-128 세그먼트 복호화 (EXT-X-KEY METHOD=AES-128)
+ *
+ * 세그먼트 전체를 AES-128-CBC로 복호화하고 PKCS#7 패딩을 제거한다. 입력은 블록 경계와 무관하게
+ * 나누어 넣을 수 있으며, 마지막 블록은 패딩 제거를 위해 세그먼트 끝까지 보류한다.
+ * 블록 복호화는 AES-NI / ARMv8 Crypto 확장을 런타임에 확인하여 사용하고,
+ * 미지원 환경은 libavutil AES로 처리한다.
+ */
+#ifndef YOPLAYER_AES_DECRYPTOR_H
+#define YOPLAYER_AES_DECRYPTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static const int AES_BLOCK_SIZE = 16;
+
+// 키 스케줄 (같은 키로 다시 설정하면 확장을 건너뜀)
+struct AesKey {
+    uint8_t key[AES_BLOCK_SIZE];
+    bool valid;
+    uint8_t round_keys[11][AES_BLOCK_SIZE];   // 하드웨어 경로용 복호화 라운드 키
+    struct AVAES* av_aes;                     // 소프트웨어 경로 (libavutil)
+};
+
+// 세그먼트 하나의 CBC 진행 상태
+struct AesCbcState {
+    uint8_t iv[AES_BLOCK_SIZE];        // 다음 블록에 쓸 직전 암호문 블록
+    uint8_t pending[AES_BLOCK_SIZE];   // 블록을 채우지 못한 바이트 또는 보류 중인 마지막 블록
+    int pending_size;
+};
+
+void aes_key_init(AesKey* key);
+void aes_key_release(AesKey* key);
+
+/**
+ * 키 설정 (직전과 같은 키면 키 스케줄을 재사용)
+ * @return 실패 시 false
+ */
+bool aes_key_set(AesKey* key, const uint8_t* bytes);
+
+/**
+ * 블록 단위 CBC 복호화 (in과 out이 같아도 됨)
+ * @param iv 직전 암호문 블록, 마지막 암호문 블록으로 갱신됨
+ */
+void aes_cbc_decrypt_blocks(const AesKey* key, uint8_t* iv,
+                            const uint8_t* in, uint8_t* out, size_t blocks);
+
+/**
+ * 세그먼트 복호화 시작
+ */
+void aes_cbc_start(AesCbcState* state, const uint8_t* iv);
+
+/**
+ * 암호문 입력
+ * 마지막 블록을 보류하므로 출력은 입력보다 최대 16바이트 적거나 이전 입력의 잔여분만큼 많다.
+ * @param out size + 16바이트 이상. 보류 중인 바이트가 없을 때는 in과 같아도 된다 (제자리 복호화).
+ * @return out에 쓴 바이트 수
+ */
+size_t aes_cbc_update(const AesKey* key, AesCbcState* state,
+                      const uint8_t* in, size_t size, uint8_t* out);
+
+/**
+ * 세그먼트 끝: 보류한 마지막 블록을 복호화하고 PKCS#7 패딩 제거
+ * @param out 16바이트 이상
+ * @param padding_valid 패딩이 올바르지 않거나 블록이 맞지 않으면 false (블록은 패딩 제거 없이 출력)
+ * @return out에 쓴 바이트 수
+ */
+size_t aes_cbc_finish(const AesKey* key, AesCbcState* state, uint8_t* out, bool* padding_valid);
+
+/**
+ * 사용 중인 블록 복호화 구현 이름 (로그용)
+ */
+const char* aes_implementation_name();
+
+#endif  // YOPLAYER_AES_DECRYPTOR_H
@@ -0,0 +1,94 @@
+/*
+ * 오디오 프레임 헤더 파서 구현
+ * (ATSC A/52 5.3.1 syncinfo, E.1.2.2 bsi / ISO/IEC 11172-3 2.4.1.3, ISO/IEC 13818-3 2.4.1.3)
+ */
+#include "audio_frame_parser.h"
+
+static const int AC3_SAMPLES_PER_BLOCK = 256;
+static const int AC3_BLOCKS_PER_FRAME = 6;
+// bsid가 이 값 이하면 AC-3, 11~16이면 E-AC-3
+static const int AC3_MAX_BSID = 10;
+static const int EAC3_MAX_BSID = 16;
+
+static const int kAc3SampleRates[3] = {48000, 44100, 32000};
+// E-AC-3 fscod == 3일 때 fscod2로 정하는 절반 샘플레이트
+static const int kEac3ReducedSampleRates[3] = {24000, 22050, 16000};
+static const int kEac3BlocksPerFrame[4] = {1, 2, 3, 6};
+
+// MPEG-1 기준 샘플레이트 (MPEG-2는 1/2, MPEG-2.5는 1/4)
+static const int kMpegAudioSampleRates[3] = {44100, 48000, 32000};
+
+static const int MPEG_VERSION_2_5 = 0;
+static const int MPEG_VERSION_2 = 2;
+static const int MPEG_VERSION_1 = 3;
+static const int MPEG_LAYER_III = 1;
+static const int MPEG_LAYER_I = 3;
+
+bool parse_ac3_frame_info(const uint8_t* data, size_t size, AudioFrameInfo* out) {
+    if (size < 6 || data[0] != 0x0B || data[1] != 0x77) {
+        return false;
+    }
+    int bsid = data[5] >> 3;
+    if (bsid <= AC3_MAX_BSID) {
+        // syncword(16) crc1(16) fscod(2) frmsizecod(6)
+        int fscod = data[4] >> 6;
+        if (fscod == 3) {
+            return false;
+        }
+        out->sample_rate = kAc3SampleRates[fscod];
+        out->samples = AC3_SAMPLES_PER_BLOCK * AC3_BLOCKS_PER_FRAME;
+        return true;
+    }
+    if (bsid > EAC3_MAX_BSID) {
+        return false;
+    }
+    // syncword(16) strmtyp(2) substreamid(3) frmsiz(11) fscod(2) fscod2/numblkscod(2)
+    int fscod = data[4] >> 6;
+    int fscod2 = (data[4] >> 4) & 0x03;
+    if (fscod == 3) {
+        if (fscod2 == 3) {
+            return false;
+        }
+        out->sample_rate = kEac3ReducedSampleRates[fscod2];
+        out->samples = AC3_SAMPLES_PER_BLOCK * AC3_BLOCKS_PER_FRAME;
+    } else {
+        out->sample_rate = kAc3SampleRates[fscod];
+        out->samples = AC3_SAMPLES_PER_BLOCK * kEac3BlocksPerFrame[fscod2];
+    }
+    return true;
+}
+
+bool parse_mpeg_audio_frame_info(const uint8_t* data, size_t size, AudioFrameInfo* out) {
+    if (size < 4 || data[0] != 0xFF || (data[1] & 0xE0) != 0xE0) {
+        return false;
+    }
+    int version = (data[1] >> 3) & 0x03;
+    int layer = (data[1] >> 1) & 0x03;
+    int bitrate_index = data[2] >> 4;
+    int sample_rate_index = (data[2] >> 2) & 0x03;
+    if (version == 1 || layer == 0 || bitrate_index == 0x0F || sample_rate_index == 3) {
+        return false;
+    }
+    int sample_rate = kMpegAudioSampleRates[sample_rate_index];
+    if (version == MPEG_VERSION_2) {
+        sample_rate /= 2;
+    } else if (version == MPEG_VERSION_2_5) {
+        sample_rate /= 4;
+    }
+    out->sample_rate = sample_rate;
+    if (layer == MPEG_LAYER_I) {
+        out->samples = 384;
+    } else if (layer == MPEG_LAYER_III && version != MPEG_VERSION_1) {
+        out->samples = 576;
+    } else {
+        out->samples = 1152;
+    }
+    return true;
+}
+
+int64_t audio_frame_duration(const AudioFrameInfo* info) {
+    if (info->sample_rate <= 0) {
+        return 0;
+    }
+    return (int64_t)info->samples * 90000 / info->sample_rate;
+}
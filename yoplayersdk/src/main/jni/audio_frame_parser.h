@@ -0,0 +1,38 @@
+/*
+ * AC-3 / E-AC-3 / MPEG 오디오 프레임 헤더 파서
+ *
+ * 프레임 헤더에서 샘플레이트와 프레임당 샘플 수를 읽어 샘플마다 정확한 길이를 계산한다.
+ * (AC-3 1536, E-AC-3 256~1536, MPEG-1 Layer II/III 1152, MPEG-2/2.5 Layer III 576, Layer I 384)
+ * ADTS AAC는 adts_parser에서 처리한다.
+ */
+#ifndef YOPLAYER_AUDIO_FRAME_PARSER_H
+#define YOPLAYER_AUDIO_FRAME_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct AudioFrameInfo {
+    int sample_rate;
+    int samples;        // 프레임당 샘플 수 (채널당)
+};
+
+/**
+ * AC-3 syncinfo/bsi 또는 E-AC-3 bsi 파싱 (bsid로 구분)
+ * @param data 동기 워드(0x0B77)부터 시작하는 프레임
+ * @return 동기 워드가 없거나 예약된 값이면 false
+ */
+bool parse_ac3_frame_info(const uint8_t* data, size_t size, AudioFrameInfo* out);
+
+/**
+ * MPEG-1/2/2.5 오디오 프레임 헤더 파싱 (Layer I/II/III)
+ * @param data 동기 워드(11비트 0x7FF)부터 시작하는 프레임
+ * @return 동기 워드가 없거나 예약된 값이면 false
+ */
+bool parse_mpeg_audio_frame_info(const uint8_t* data, size_t size, AudioFrameInfo* out);
+
+/**
+ * 프레임 길이 (90kHz)
+ */
+int64_t audio_frame_duration(const AudioFrameInfo* info);
+
+#endif  // YOPLAYER_AUDIO_FRAME_PARSER_H
@@ -0,0 +1,93 @@
+/*
+ * 코덱 파라미터 셋(SPS 등) 파싱용 비트 리더
+ *
+ * NAL 유닛의 에뮬레이션 방지 바이트(00 00 03)를 제거한 RBSP를 MSB부터 읽는다.
+ * 범위를 넘어 읽으면 0을 반환하고 overflow를 표시하므로, 파싱이 끝난 뒤 한 번만 확인하면 된다.
+ */
+#ifndef YOPLAYER_BIT_READER_H
+#define YOPLAYER_BIT_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+struct BitReader {
+    const uint8_t* data;
+    size_t size;
+    size_t bit_pos;
+    bool overflow;
+};
+
+/**
+ * NAL 유닛 페이로드에서 에뮬레이션 방지 바이트를 제거하여 RBSP로 변환
+ */
+static inline void nal_to_rbsp(const uint8_t* nal, int size, std::vector<uint8_t>* out) {
+    out->clear();
+    out->reserve(size);
+    int zeros = 0;
+    for (int i = 0; i < size; i++) {
+        if (zeros >= 2 && nal[i] == 0x03) {
+            zeros = 0;
+            continue;
+        }
+        zeros = nal[i] == 0 ? zeros + 1 : 0;
+        out->push_back(nal[i]);
+    }
+}
+
+static inline void bit_reader_init(BitReader* br, const uint8_t* data, size_t size) {
+    br->data = data;
+    br->size = size;
+    br->bit_pos = 0;
+    br->overflow = false;
+}
+
+static inline uint32_t read_bit(BitReader* br) {
+    if (br->bit_pos >= br->size * 8) {
+        br->overflow = true;
+        return 0;
+    }
+    uint32_t bit = (br->data[br->bit_pos >> 3] >> (7 - (br->bit_pos & 7))) & 1;
+    br->bit_pos++;
+    return bit;
+}
+
+// n비트 부호 없는 값 (n <= 32)
+static inline uint32_t read_bits(BitReader* br, int n) {
+    uint32_t value = 0;
+    for (int i = 0; i < n; i++) {
+        value = (value << 1) | read_bit(br);
+    }
+    return value;
+}
+
+static inline void skip_bits(BitReader* br, int n) {
+    br->bit_pos += n;
+    if (br->bit_pos > br->size * 8) {
+        br->overflow = true;
+    }
+}
+
+// ue(v): 부호 없는 exp-Golomb
+static inline uint32_t read_ue(BitReader* br) {
+    int leading_zeros = 0;
+    while (read_bit(br) == 0) {
+        if (br->overflow || ++leading_zeros > 31) {
+            br->overflow = true;
+            return 0;
+        }
+    }
+    if (leading_zeros == 0) {
+        return 0;
+    }
+    return ((1u << leading_zeros) - 1) + read_bits(br, leading_zeros);
+}
+
+// se(v): 부호 있는 exp-Golomb
+static inline int32_t read_se(BitReader* br) {
+    uint32_t value = read_ue(br);
+    return (value & 1) ? (int32_t)((value + 1) >> 1) : -(int32_t)(value >> 1);
+}
+
+#endif  // YOPLAYER_BIT_READER_H
@@ -8,13 +8,34 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
 extern "C" {
 #include <libavformat/avformat.h>
 #include <libavcodec/avcodec.h>
 #include <libavutil/error.h>
 #include <libavutil/mem.h>
+#include <libavutil/time.h>
 }
 
+#include "adts_parser.h"
+#include "aes_decryptor.h"
+#include "audio_frame_parser.h"
+#include "h264_parser.h"
+#include "hevc_parser.h"
+#include "nal_scanner.h"
+#include "sample_aes.h"
+#include "memory_budget.h"
+#include "sample_chunk.h"
+#include "sample_ring.h"
+#include "scratch_arena.h"
+#include "segment_demux_pool.h"
+#include "timestamp_normalizer.h"
+#include "ts_demuxer.h"
+
 #define LOG_TAG "ffmpeg_demuxer_jni"
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
@@ -43,23 +64,32 @@ static const int H264_START_CODE_SIZE = 4;
 // AAC 관련 상수
 static const int AAC_ASC_SIZE = 2;
 
-/**
- * H.264 SPS에서 width/height 파싱 (간단한 구현)
- * 실제로는 더 복잡한 파싱이 필요하지만, 기본적인 케이스 처리
- */
-static bool parse_sps_dimensions(const uint8_t* sps, int sps_size, int* width, int* height) {
-    if (sps_size < 8) return false;
+// HLS 암호화 방식 (FfmpegDemuxer.DECRYPTION_* 와 호환)
+static const int DECRYPTION_METHOD_AES_128 = 1;
+static const int DECRYPTION_METHOD_SAMPLE_AES = 2;
 
-    // SPS 파싱은 복잡하므로, 여기서는 간단히 로그만 출력
-    LOGI("SPS found: size=%d bytes", sps_size);
+// AVIO 버퍼 크기
+static const int AVIO_BUFFER_SIZE = 32768;
+// 세그먼트 임시 메모리 첫 블록 크기 (샘플 수백 개의 메타데이터)
+static const size_t SCRATCH_INITIAL_SIZE = 64 * 1024;
+// 패킷 페이로드 풀 버퍼의 최소 크기 (더 큰 패킷을 보면 2의 거듭제곱으로 키움)
+static const size_t PAYLOAD_POOL_MIN_SIZE = 64 * 1024;
 
-    // TODO: 실제 SPS 파싱 구현 필요
-    // 현재는 기본값 사용
-    return false;
-}
+// push 모드 입력 FIFO 한도 (다운로드가 디먹싱보다 앞서갈 때 feed를 대기시킴, 메모리 예산이 있으면
+// 예산의 입력 한도도 적용) / 압축 기준
+static const size_t PUSH_MAX_BUFFERED_BYTES = 16 * 1024 * 1024;
+static const size_t PUSH_COMPACT_BYTES = 1024 * 1024;
+static const int64_t PUSH_ANALYZE_DURATION_US = 500000;
+
+// 병렬 디먹스 풀에서 출력하지 않은 세그먼트 한도 (입력과 파싱 결과를 함께 세므로 push FIFO 한도의 두 배)
+static const size_t POOL_MAX_PENDING_BYTES = 2 * PUSH_MAX_BUFFERED_BYTES;
+
+// 경량 TS 디먹서가 PMT를 찾지 못한 채 이 크기 이상 읽으면 libavformat으로 전환
+static const size_t TS_PROGRAM_SEARCH_BYTES = 1024 * 1024;
 
 /**
  * H.264 비트스트림에서 SPS/PPS NAL 유닛 찾기
+ * NAL 경계는 find_nal_units로 한 번의 선형 탐색으로 구한다.
  */
 static bool find_h264_sps_pps(const uint8_t* data, int size,
                                const uint8_t** sps_out, int* sps_size,
@@ -69,54 +99,26 @@ static bool find_h264_sps_pps(const uint8_t* data, int size,
     *sps_size = 0;
     *pps_size = 0;
 
-    int i = 0;
-    while (i < size - 4) {
-        // Start code 찾기 (0x00000001 또는 0x000001)
-        if (data[i] == 0 && data[i+1] == 0) {
-            int start_code_len = 0;
-            if (data[i+2] == 1) {
-                start_code_len = 3;
-            } else if (data[i+2] == 0 && data[i+3] == 1) {
-                start_code_len = 4;
-            }
+    std::vector<NalUnit> units;
+    find_nal_units(data, size, &units);
+    for (size_t i = 0; i < units.size(); i++) {
+        const NalUnit& unit = units[i];
+        int nal_type = unit.data[0] & 0x1F;
+        int nal_start = (int)(unit.data - data);
+
+        if (nal_type == NAL_TYPE_SPS && *sps_out == nullptr) {
+            *sps_out = unit.data;
+            *sps_size = unit.size;
+            LOGI("Found SPS at offset %d, size %d", nal_start, unit.size);
+        } else if (nal_type == NAL_TYPE_PPS && *pps_out == nullptr) {
+            *pps_out = unit.data;
+            *pps_size = unit.size;
+            LOGI("Found PPS at offset %d, size %d", nal_start, unit.size);
+        }
 
-            if (start_code_len > 0) {
-                int nal_start = i + start_code_len;
-                if (nal_start < size) {
-                    int nal_type = data[nal_start] & 0x1F;
-
-                    // 다음 start code 찾기
-                    int nal_end = size;
-                    for (int j = nal_start + 1; j < size - 3; j++) {
-                        if (data[j] == 0 && data[j+1] == 0 &&
-                            (data[j+2] == 1 || (data[j+2] == 0 && data[j+3] == 1))) {
-                            nal_end = j;
-                            break;
-                        }
-                    }
-
-                    int nal_size = nal_end - nal_start;
-
-                    if (nal_type == NAL_TYPE_SPS && *sps_out == nullptr) {
-                        *sps_out = data + nal_start;
-                        *sps_size = nal_size;
-                        LOGI("Found SPS at offset %d, size %d", nal_start, nal_size);
-                    } else if (nal_type == NAL_TYPE_PPS && *pps_out == nullptr) {
-                        *pps_out = data + nal_start;
-                        *pps_size = nal_size;
-                        LOGI("Found PPS at offset %d, size %d", nal_start, nal_size);
-                    }
-
-                    if (*sps_out != nullptr && *pps_out != nullptr) {
-                        return true;
-                    }
-
-                    i = nal_end;
-                    continue;
-                }
-            }
+        if (*sps_out != nullptr && *pps_out != nullptr) {
+            return true;
         }
-        i++;
     }
 
     return (*sps_out != nullptr);
@@ -151,16 +153,13 @@ static uint8_t* build_h264_extradata(const uint8_t* sps, int sps_size,
 
 static bool build_aac_extradata_from_adts(const uint8_t* data, int size,
                                           uint8_t** out_data, int* out_size) {
-    if (!data || size < 7) {
+    AdtsHeader header;
+    if (!data || size < 0 || !parse_adts_header(data, (size_t)size, &header)) {
         return false;
     }
-    if (!(data[0] == 0xFF && (data[1] & 0xF0) == 0xF0)) {
-        return false;
-    }
-    int profile = (data[2] >> 6) & 0x03;
-    int sample_rate_index = (data[2] >> 2) & 0x0F;
-    int channel_config = ((data[2] & 0x01) << 2) | ((data[3] >> 6) & 0x03);
-    int audio_object_type = profile + 1;
+    int sample_rate_index = header.sample_rate_index;
+    int channel_config = header.channel_config;
+    int audio_object_type = header.profile + 1;
 
     uint8_t* extradata = (uint8_t*)av_malloc(AAC_ASC_SIZE);
     if (!extradata) {
@@ -180,15 +179,176 @@ struct BufferData {
     size_t pos;
 };
 
+// 세그먼트 하나의 SAMPLE-AES 키
+struct SampleAesParams {
+    bool enabled;
+    uint8_t key[AES_BLOCK_SIZE];
+    uint8_t iv[AES_BLOCK_SIZE];
+};
+
+/**
+ * push 모드 입력 FIFO
+ * 다운로드 스레드가 받은 바이트를 이어 붙이고(feed), 디먹스 스레드의 AVIO read 콜백이 꺼내 읽는다.
+ * 위치는 세션 시작부터의 누적 바이트 오프셋이며, 세그먼트 끝 위치를 넘어서는 읽지 않는다.
+ */
+struct PushInput {
+    std::mutex lock;
+    std::condition_variable cond;
+    std::vector<uint8_t> data;          // [base_pos, write_pos) 구간의 바이트
+    int64_t base_pos = 0;
+    int64_t read_pos = 0;
+    int64_t write_pos = 0;
+    std::deque<int64_t> segment_ends;   // 끝이 확정되었지만 아직 다 읽지 않은 세그먼트의 끝 위치
+    // 세그먼트별 SAMPLE-AES 키 (feed가 세그먼트 첫 입력에서 추가하고 drain이 세그먼트 시작에서 꺼냄)
+    std::deque<SampleAesParams> segment_keys;
+    bool cancelled = false;
+    MemoryBudget* budget = nullptr;     // 아직 디먹싱하지 않은 바이트를 MEMORY_BUDGET_INPUT으로 반영
+};
+
+/**
+ * 경량 TS 디먹서 세션 상태
+ * 처리할 수 없는 스트림을 만나면 libavformat으로 전환하며, 전환 시 replay에 남긴 입력을 먼저 읽게 한다.
+ * PMT를 찾기 전까지 읽은 입력은 PAT부터 다시 읽을 수 있도록 replay에 보관한다.
+ */
+struct TsSession {
+    TsDemuxer demuxer;
+    bool active;                        // 현재 세션을 경량 디먹서로 처리 중
+    std::vector<uint8_t> read_buffer;
+    std::vector<uint8_t> replay;
+    size_t replay_pos;
+};
+
+/**
+ * 디먹싱 중인 세그먼트의 키프레임 인덱스 (디먹스 스레드에서만 접근)
+ * 경량 TS 디먹서가 내보낸 비디오 키프레임마다 정규화된 시각, 90kHz PTS, 키프레임 PES가 시작된
+ * TS 패킷의 세그먼트 내 바이트 오프셋을 기록한다. seek 시 그 패킷부터 받아 디먹싱을 시작할 수 있다.
+ */
+struct KeyframeIndex {
+    int64_t segment_start;          // 세그먼트 첫 바이트의 경량 디먹서 입력 위치
+    int pid;                        // 인덱싱하는 비디오 PID, 아직 없으면 -1
+    std::vector<jlong> entries;     // (time_us, pts, offset) 반복
+};
+
+/**
+ * probe에서 분석한 스트림 파라미터 캐시
+ * 같은 PMT로 구성된 세그먼트를 다시 열 때 avformat_find_stream_info(패킷을 미리 읽어 분석)를
+ * 건너뛰기 위해 PID별 AVCodecParameters와 PMT PID/버전을 보관한다.
+ */
+struct CachedStream {
+    int pid;                        // AVStream.id (MPEG-TS PID)
+    AVCodecParameters* codecpar;
+};
+
+struct StreamParamCache {
+    std::vector<CachedStream> streams;
+    int pmt_pid;                    // 알 수 없으면 -1
+    int pmt_version;                // 알 수 없으면 -1
+};
+
+/**
+ * HLS 세그먼트 복호화 설정
+ * 설정은 세그먼트 하나에만 적용되며, feed(push 모드) 또는 디먹스 호출 스레드에서만 접근한다.
+ */
+struct SegmentDecryption {
+    // AES-128: 세그먼트 전체를 입력 단계에서 복호화
+    AesKey key;
+    AesCbcState state;
+    bool enabled;
+    std::vector<uint8_t> output;   // 복호화 출력 (push 모드는 feed마다, 메모리 입력은 세그먼트마다 재사용)
+    // SAMPLE-AES: 디먹싱한 샘플 단위로 복호화하므로 키만 디먹스 쪽으로 넘긴다
+    SampleAesParams sample;
+    bool segment_started;          // push 모드에서 현재 세그먼트의 키를 이미 넘겼는지 여부
+};
+
+// 디먹싱 중인 세그먼트의 SAMPLE-AES 복호화 상태 (디먹스 스레드에서만 접근)
+struct SampleDecryption {
+    AesKey key;
+    uint8_t iv[AES_BLOCK_SIZE];
+    bool enabled;
+    bool unsupported_logged;
+};
+
+/**
+ * 디먹싱할 트랙(PID) 선택
+ * 재생 스레드가 설정하고, 디먹스 스레드가 다음 세그먼트를 시작할 때 가져가 적용한다.
+ */
+struct TrackSelection {
+    std::mutex lock;
+    bool changed;
+    bool all;                   // 선택하지 않았으면 모든 트랙
+    std::vector<int> pids;
+    // 디먹스 스레드에서 적용 중인 선택 (디먹스 스레드에서만 접근)
+    bool active_all;
+    std::vector<int> active_pids;
+};
+
+/**
+ * 디먹서 컨텍스트별 메모리 재사용 상태 (디먹스 스레드에서만 접근)
+ * AVIO 버퍼와 AVPacket은 입력을 다시 열어도 재사용하고, 복사가 필요한 패킷 페이로드는 지금까지 본
+ * 최대 크기에 맞춘 AVBufferPool에서, 세그먼트 동안의 샘플 메타데이터는 세그먼트마다 비우는 임시 메모리에서 받는다.
+ */
+struct DemuxerArena {
+    uint8_t* avio_buffer;           // 아직 없거나 libavformat이 다른 버퍼로 바꿨으면 nullptr
+    AVPacket* packet;
+    AVBufferPool* payload_pool;
+    size_t payload_size;            // payload_pool 버퍼 크기
+    ScratchArena scratch;
+    // 싱크 청크용 direct ByteBuffer (global ref, 싱크가 콜백 안에서 복사하므로 청크마다 재사용)
+    jobject sink_buffer;
+};
+
+// 세그먼트 동안의 시스템 할당 횟수 (종류별)
+struct AllocationCounts {
+    int64_t avio;       // AVIO 버퍼
+    int64_t packet;     // AVPacket
+    int64_t payload;    // 패킷 페이로드 풀 버퍼
+    int64_t scratch;    // 임시 메모리 블록
+    int64_t direct;     // 샘플 배치용 direct ByteBuffer
+};
+
+// 디먹싱 통계 (세그먼트당 비용 측정용)
+struct DemuxerStats {
+    int64_t segment_count;
+    int64_t open_count;
+    int64_t sample_count;
+    int64_t total_open_us;
+    int64_t total_demux_us;
+    // JNI 비용 (direct 버퍼 할당, 배열/객체 생성) - 현재 세그먼트 / 누적
+    int64_t segment_jni_us;
+    int64_t total_jni_us;
+    // 스트림 분석 (avformat_find_stream_info 수행 / 캐시 재사용 횟수)
+    int64_t stream_info_count;
+    int64_t stream_info_reused;
+    // 시스템 할당 - 현재 세그먼트 / 누적
+    AllocationCounts segment_allocs;
+    int64_t total_allocs;
+};
+
 // 디먹서 컨텍스트
 struct DemuxerContext {
     AVFormatContext* fmt_ctx;
     AVIOContext* avio_ctx;
-    uint8_t* avio_buffer;
+    DemuxerArena* arena;
     BufferData buffer_data;
-    int video_stream_idx;
-    int audio_stream_idx;
     bool initialized;
+    // 세션 모드: 플레이리스트 전체에서 하나의 AVFormatContext를 유지
+    bool session_opened;
+    // push 모드: 세션 입력을 메모리 버퍼 대신 PushInput FIFO에서 읽음
+    bool push_mode;
+    PushInput* push;
+    TsSession* ts;
+    // 병렬 디먹스: 완성된 세그먼트를 워커들이 파싱하고 디먹스 스레드가 순서대로 출력 (시작 전에는 nullptr)
+    SegmentDemuxPool* pool;
+    StreamParamCache* param_cache;
+    SegmentDecryption* decryption;
+    SampleDecryption* sample_decryption;
+    TrackSelection* selection;
+    // 세그먼트를 넘어 이어지는 타임스탬프 정규화 상태
+    TimestampNormalizer* timestamps;
+    KeyframeIndex* keyframes;
+    // 플레이어의 메모리 예산 (nullptr이면 고정 한도만 적용, 소유하지 않음)
+    MemoryBudget* budget;
+    DemuxerStats stats;
 };
 
 // AVIOContext read 콜백 - 메모리 버퍼에서 읽기
@@ -235,6 +395,313 @@ static int64_t seek_packet(void* opaque, int64_t offset, int whence) {
     return (int64_t)bd->pos;
 }
 
+/**
+ * AVIOContext read 콜백 - push FIFO에서 읽기
+ * 데이터가 아직 도착하지 않았으면 feed/세그먼트 종료/취소까지 대기한다.
+ * 세그먼트 중간에 EOF를 돌려주면 mpegts 디먹서가 미완성 PES를 내보내므로 EOF는 세그먼트 끝에서만 반환한다.
+ */
+static int push_read_packet(void* opaque, uint8_t* buf, int buf_size) {
+    PushInput* in = (PushInput*)opaque;
+    std::unique_lock<std::mutex> guard(in->lock);
+
+    while (true) {
+        if (in->cancelled) {
+            return AVERROR_EXIT;
+        }
+        int64_t limit = in->segment_ends.empty() ? in->write_pos : in->segment_ends.front();
+        if (in->read_pos < limit) {
+            int64_t available = limit - in->read_pos;
+            int to_read = available < buf_size ? (int)available : buf_size;
+            memcpy(buf, in->data.data() + (in->read_pos - in->base_pos), to_read);
+            in->read_pos += to_read;
+            memory_budget_set(in->budget, MEMORY_BUDGET_INPUT, in->write_pos - in->read_pos);
+
+            // 읽은 앞부분이 충분히 쌓이면 버퍼 앞쪽을 비움
+            size_t consumed = (size_t)(in->read_pos - in->base_pos);
+            if (consumed >= PUSH_COMPACT_BYTES && consumed * 2 >= in->data.size()) {
+                in->data.erase(in->data.begin(), in->data.begin() + consumed);
+                in->base_pos = in->read_pos;
+            }
+            in->cond.notify_all();
+            return to_read;
+        }
+        if (!in->segment_ends.empty()) {
+            return AVERROR_EOF;
+        }
+        in->cond.wait(guard);
+    }
+}
+
+/**
+ * 세션 입력(메모리 버퍼 또는 push FIFO)에서 읽기
+ */
+static int read_session_source(DemuxerContext* ctx, uint8_t* buf, int buf_size) {
+    return ctx->push_mode ? push_read_packet(ctx->push, buf, buf_size)
+                          : read_packet(&ctx->buffer_data, buf, buf_size);
+}
+
+/**
+ * AVIOContext read 콜백 - 세션 입력
+ * 경량 TS 디먹서에서 넘겨받은 replay 바이트를 먼저 읽는다.
+ */
+static int session_read_packet(void* opaque, uint8_t* buf, int buf_size) {
+    DemuxerContext* ctx = (DemuxerContext*)opaque;
+    TsSession* ts = ctx->ts;
+    if (ts->replay_pos < ts->replay.size()) {
+        size_t remaining = ts->replay.size() - ts->replay_pos;
+        int to_read = remaining < (size_t)buf_size ? (int)remaining : buf_size;
+        memcpy(buf, ts->replay.data() + ts->replay_pos, to_read);
+        ts->replay_pos += to_read;
+        return to_read;
+    }
+    return read_session_source(ctx, buf, buf_size);
+}
+
+static void ts_session_start(TsSession* ts) {
+    ts_demuxer_reset(&ts->demuxer);
+    ts->active = true;
+    ts->replay.clear();
+    ts->replay_pos = 0;
+}
+
+/**
+ * push FIFO에 [size] 바이트를 넣을 공간이 생길 때까지 대기
+ * 디먹싱이 밀려 있거나 메모리 예산이 모자라면 다운로드 스레드를 멈춰 FIFO가 무한히 커지지 않게 한다.
+ * 디먹서가 읽을 때마다 깨어나 다시 확인하며, FIFO가 비어 있으면 교착을 막기 위해 기다리지 않는다.
+ * @return false면 취소됨
+ */
+static bool push_wait_for_space(PushInput* in, size_t size) {
+    std::unique_lock<std::mutex> guard(in->lock);
+    while (!in->cancelled && in->write_pos > in->read_pos &&
+           ((size_t)(in->write_pos - in->read_pos) + size > PUSH_MAX_BUFFERED_BYTES ||
+            !memory_budget_fits_input(in->budget, (int64_t)size))) {
+        in->cond.wait(guard);
+    }
+    return !in->cancelled;
+}
+
+static void push_append(PushInput* in, const uint8_t* data, size_t size) {
+    std::lock_guard<std::mutex> guard(in->lock);
+    in->data.insert(in->data.end(), data, data + size);
+    in->write_pos += size;
+    memory_budget_set(in->budget, MEMORY_BUDGET_INPUT, in->write_pos - in->read_pos);
+    in->cond.notify_all();
+}
+
+// 현재까지 받은 바이트 위치를 세그먼트 끝으로 확정
+static void push_end_segment(PushInput* in) {
+    std::lock_guard<std::mutex> guard(in->lock);
+    in->segment_ends.push_back(in->write_pos);
+    in->cond.notify_all();
+}
+
+// 디먹서가 세그먼트 끝까지 읽었으면 다음 세그먼트로 넘어감
+static void push_finish_segment(PushInput* in) {
+    std::lock_guard<std::mutex> guard(in->lock);
+    if (!in->segment_ends.empty() && in->read_pos >= in->segment_ends.front()) {
+        in->segment_ends.pop_front();
+    }
+}
+
+// 디먹서가 대기 없이 읽을 수 있는 바이트 수
+static int64_t push_available(PushInput* in) {
+    std::lock_guard<std::mutex> guard(in->lock);
+    int64_t limit = in->segment_ends.empty() ? in->write_pos : in->segment_ends.front();
+    return limit - in->read_pos;
+}
+
+static void push_cancel(PushInput* in) {
+    std::lock_guard<std::mutex> guard(in->lock);
+    in->cancelled = true;
+    in->cond.notify_all();
+}
+
+static void push_reset(PushInput* in) {
+    std::lock_guard<std::mutex> guard(in->lock);
+    in->data.clear();
+    in->base_pos = 0;
+    in->read_pos = 0;
+    in->write_pos = 0;
+    in->segment_ends.clear();
+    in->segment_keys.clear();
+    in->cancelled = false;
+    memory_budget_set(in->budget, MEMORY_BUDGET_INPUT, 0);
+    in->cond.notify_all();
+}
+
+static void push_add_segment_key(PushInput* in, const SampleAesParams& params) {
+    std::lock_guard<std::mutex> guard(in->lock);
+    in->segment_keys.push_back(params);
+    in->cond.notify_all();
+}
+
+/**
+ * 다음 세그먼트의 SAMPLE-AES 키 꺼내기 (feed가 세그먼트를 시작할 때까지 대기)
+ * @return false면 취소됨
+ */
+static bool push_take_segment_key(PushInput* in, SampleAesParams* out) {
+    std::unique_lock<std::mutex> guard(in->lock);
+    in->cond.wait(guard, [in] { return in->cancelled || !in->segment_keys.empty(); });
+    if (in->cancelled) {
+        return false;
+    }
+    *out = in->segment_keys.front();
+    in->segment_keys.pop_front();
+    return true;
+}
+
+/**
+ * 세그먼트 복호화 종료: 보류한 마지막 블록을 복호화하고 패딩 제거
+ * @param out 16바이트 이상
+ * @return out에 쓴 바이트 수
+ */
+static size_t finish_decryption(SegmentDecryption* dec, uint8_t* out) {
+    bool padding_valid = false;
+    size_t size = aes_cbc_finish(&dec->key, &dec->state, out, &padding_valid);
+    if (!padding_valid) {
+        LOGE("Invalid AES-128 padding or segment size, keeping last block as is");
+    }
+    dec->enabled = false;
+    return size;
+}
+
+/**
+ * push 모드에서 세그먼트의 첫 입력이면 세그먼트의 SAMPLE-AES 키를 디먹스 쪽으로 넘김
+ * 암호화되지 않은 세그먼트도 빈 키를 넘겨 drain 호출과 세그먼트 순서를 맞춘다.
+ */
+static void push_begin_segment(DemuxerContext* ctx) {
+    SegmentDecryption* dec = ctx->decryption;
+    if (!dec->segment_started) {
+        push_add_segment_key(ctx->push, dec->sample);
+        dec->segment_started = true;
+    }
+}
+
+/**
+ * push 입력 추가 (복호화가 설정되어 있으면 평문으로 바꾸어 추가)
+ * 마지막 블록은 nativeEndSegment에서 패딩을 제거한 뒤 추가된다.
+ */
+static void push_append_input(DemuxerContext* ctx, const uint8_t* data, size_t size) {
+    SegmentDecryption* dec = ctx->decryption;
+    push_begin_segment(ctx);
+    if (!dec->enabled) {
+        push_append(ctx->push, data, size);
+        return;
+    }
+    dec->output.resize(size + AES_BLOCK_SIZE);
+    size_t plain_size = aes_cbc_update(&dec->key, &dec->state, data, size, dec->output.data());
+    push_append(ctx->push, dec->output.data(), plain_size);
+}
+
+/**
+ * 디먹싱할 세그먼트의 SAMPLE-AES 복호화 설정
+ * @param params null이거나 비활성이면 복호화하지 않음
+ */
+static void begin_sample_decryption(DemuxerContext* ctx, const SampleAesParams* params) {
+    SampleDecryption* dec = ctx->sample_decryption;
+    dec->enabled = false;
+    if (!params || !params->enabled) {
+        return;
+    }
+    if (!aes_key_set(&dec->key, params->key)) {
+        LOGE("Failed to set SAMPLE-AES key");
+        return;
+    }
+    memcpy(dec->iv, params->iv, AES_BLOCK_SIZE);
+    dec->enabled = true;
+}
+
+/**
+ * 메모리 입력 세그먼트의 복호화 준비
+ * AES-128이면 세그먼트 전체를 컨텍스트의 복호화 버퍼로 복호화하고, SAMPLE-AES면 이번 디먹싱의 샘플
+ * 복호화를 설정한다. 호출자의 입력(Java 배열일 수 있음)은 바꾸지 않는다.
+ * @param size 입력 크기, 디먹싱할 크기로 바뀜 (AES-128은 패딩을 제거한 평문 크기)
+ * @return 디먹싱할 입력 (AES-128이면 다음 복호화 전까지 유효한 dec->output)
+ */
+static const uint8_t* prepare_segment_decryption(DemuxerContext* ctx, const uint8_t* data,
+                                                 size_t* size) {
+    SegmentDecryption* dec = ctx->decryption;
+    begin_sample_decryption(ctx, &dec->sample);
+    dec->sample.enabled = false;
+    if (!dec->enabled) {
+        return data;
+    }
+    dec->output.resize(*size + AES_BLOCK_SIZE);
+    uint8_t* plain = dec->output.data();
+    size_t plain_size = aes_cbc_update(&dec->key, &dec->state, data, *size, plain);
+    plain_size += finish_decryption(dec, plain + plain_size);
+    *size = plain_size;
+    return plain;
+}
+
+// 페이로드 풀 버퍼 할당 (풀에 남는 버퍼가 없을 때만 호출되므로 할당 횟수로 센다)
+static AVBufferRef* alloc_pooled_payload(void* opaque, size_t size) {
+    DemuxerContext* ctx = (DemuxerContext*)opaque;
+    ctx->stats.segment_allocs.payload++;
+    return av_buffer_alloc(size);
+}
+
+/**
+ * 패킷 페이로드를 쓸 수 있게 만듦
+ * 다른 곳과 공유 중인 페이로드만 풀 버퍼로 복사한다. 풀 버퍼 크기는 지금까지 본 가장 큰 패킷에 맞추며,
+ * 더 큰 패킷을 만나면 풀을 새로 만든다 (이전 풀은 나가 있는 버퍼가 모두 돌아오면 해제된다).
+ */
+static bool make_packet_writable(DemuxerContext* ctx, AVPacket* pkt) {
+    if (pkt->buf && av_buffer_is_writable(pkt->buf)) {
+        return true;
+    }
+    DemuxerArena* arena = ctx->arena;
+    size_t required = (size_t)pkt->size + AV_INPUT_BUFFER_PADDING_SIZE;
+    if (!arena->payload_pool || required > arena->payload_size) {
+        size_t size = PAYLOAD_POOL_MIN_SIZE;
+        while (size < required) {
+            size *= 2;
+        }
+        av_buffer_pool_uninit(&arena->payload_pool);
+        arena->payload_pool = av_buffer_pool_init2(size, ctx, alloc_pooled_payload, nullptr);
+        if (!arena->payload_pool) {
+            return false;
+        }
+        arena->payload_size = size;
+    }
+    AVBufferRef* buf = av_buffer_pool_get(arena->payload_pool);
+    if (!buf) {
+        return false;
+    }
+    memcpy(buf->data, pkt->data, pkt->size);
+    memset(buf->data + pkt->size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+    av_buffer_unref(&pkt->buf);
+    pkt->buf = buf;
+    pkt->data = buf->data;
+    return true;
+}
+
+/**
+ * SAMPLE-AES 패킷을 제자리에서 복호화 (H.264 / ADTS AAC)
+ * @return false면 패킷을 쓸 수 없음
+ */
+static bool decrypt_sample(DemuxerContext* ctx, AVCodecID codec_id, AVPacket* pkt) {
+    SampleDecryption* dec = ctx->sample_decryption;
+    if (!make_packet_writable(ctx, pkt)) {
+        LOGE("Failed to make packet writable for SAMPLE-AES");
+        return false;
+    }
+    switch (codec_id) {
+        case AV_CODEC_ID_H264:
+            pkt->size = sample_aes_decrypt_h264(&dec->key, dec->iv, pkt->data, pkt->size);
+            return true;
+        case AV_CODEC_ID_AAC:
+            sample_aes_decrypt_adts(&dec->key, dec->iv, pkt->data, pkt->size);
+            return true;
+        default:
+            if (!dec->unsupported_logged) {
+                LOGE("SAMPLE-AES is not supported for codec id %d", (int)codec_id);
+                dec->unsupported_logged = true;
+            }
+            return true;
+    }
+}
+
 // 에러 메시지 로깅
 static void log_error(const char* func, int error) {
     char errbuf[256];
@@ -282,525 +749,2769 @@ static const char* codec_id_to_mime(AVCodecID codec_id, int track_type) {
     }
 }
 
-// JNI 매크로
-#define DEMUXER_FUNC(RETURN_TYPE, NAME, ...)                                    \
-    extern "C" {                                                                \
-    JNIEXPORT RETURN_TYPE JNICALL                                               \
-    Java_com_yohan_yoplayersdk_demuxer_FfmpegDemuxer_##NAME(JNIEnv* env,        \
-                                                            jobject thiz,       \
-                                                            ##__VA_ARGS__);     \
-    }                                                                           \
-    JNIEXPORT RETURN_TYPE JNICALL                                               \
-    Java_com_yohan_yoplayersdk_demuxer_FfmpegDemuxer_##NAME(                    \
-        JNIEnv* env, jobject thiz, ##__VA_ARGS__)
-
 /**
- * 디먹서 초기화
- * @return 네이티브 컨텍스트 포인터 (0이면 실패)
+ * 열려 있는 입력(AVFormatContext, AVIOContext) 정리
+ * 커스텀 IO는 avformat_close_input이 해제하지 않으므로 직접 해제한다.
  */
-DEMUXER_FUNC(jlong, nativeInit) {
-    DemuxerContext* ctx = (DemuxerContext*)av_mallocz(sizeof(DemuxerContext));
-    if (!ctx) {
-        LOGE("Failed to allocate DemuxerContext");
-        return 0;
+static void close_input(DemuxerContext* ctx) {
+    if (ctx->fmt_ctx) {
+        avformat_close_input(&ctx->fmt_ctx);
     }
-
-    ctx->fmt_ctx = nullptr;
-    ctx->avio_ctx = nullptr;
-    ctx->avio_buffer = nullptr;
-    ctx->video_stream_idx = -1;
-    ctx->audio_stream_idx = -1;
-    ctx->initialized = false;
-
-    LOGI("Demuxer initialized");
-    return (jlong)ctx;
+    if (ctx->avio_ctx) {
+        // AVIO 버퍼는 다음 입력에서 재사용. libavformat이 버퍼를 바꿨으면 원래 버퍼는 이미 해제되어 있다
+        if (ctx->avio_ctx->buffer != ctx->arena->avio_buffer) {
+            av_freep(&ctx->avio_ctx->buffer);
+            ctx->arena->avio_buffer = nullptr;
+        }
+        avio_context_free(&ctx->avio_ctx);
+    }
+    ctx->session_opened = false;
 }
 
 /**
- * 세그먼트 데이터를 디먹싱하여 트랙 정보 반환
- * @param context 네이티브 컨텍스트
- * @param data TS 세그먼트 바이트 배열
- * @return TrackInfo 배열 (jobjectArray)
+ * 재사용 AVPacket 반환 (처음 한 번만 할당)
+ * 호출자는 패킷을 다 쓰면 av_packet_unref로 비워 둔다.
  */
-DEMUXER_FUNC(jobjectArray, nativeProbeSegment, jlong context, jbyteArray data) {
-    DemuxerContext* ctx = (DemuxerContext*)context;
-    if (!ctx) {
-        LOGE("Invalid context");
-        return nullptr;
+static AVPacket* obtain_packet(DemuxerContext* ctx) {
+    DemuxerArena* arena = ctx->arena;
+    if (!arena->packet) {
+        arena->packet = av_packet_alloc();
+        if (!arena->packet) {
+            LOGE("Failed to allocate AVPacket");
+            return nullptr;
+        }
+        ctx->stats.segment_allocs.packet++;
     }
+    return arena->packet;
+}
 
-    jsize data_size = env->GetArrayLength(data);
-    jbyte* data_ptr = env->GetByteArrayElements(data, nullptr);
-    if (!data_ptr) {
-        LOGE("Failed to get byte array elements");
-        return nullptr;
+/**
+ * 재사용 메모리가 잡고 있는 바이트 (AVIO 버퍼, 페이로드 풀 버퍼 하나, 임시 메모리 블록)
+ */
+static int64_t arena_reserved_bytes(const DemuxerArena* arena) {
+    int64_t bytes = (arena->avio_buffer ? AVIO_BUFFER_SIZE : 0) + (int64_t)arena->payload_size;
+    for (size_t i = 0; i < arena->scratch.blocks.size(); i++) {
+        bytes += (int64_t)arena->scratch.blocks[i].size;
     }
+    return bytes;
+}
 
-    // 버퍼 데이터 설정
-    ctx->buffer_data.ptr = (const uint8_t*)data_ptr;
-    ctx->buffer_data.size = (size_t)data_size;
-    ctx->buffer_data.pos = 0;
+// close_input 이후 재사용 메모리 해제
+static void release_arena(JNIEnv* env, DemuxerArena* arena) {
+    if (arena->sink_buffer) {
+        env->DeleteGlobalRef(arena->sink_buffer);
+    }
+    av_freep(&arena->avio_buffer);
+    av_packet_free(&arena->packet);
+    av_buffer_pool_uninit(&arena->payload_pool);
+    scratch_arena_release(&arena->scratch);
+    delete arena;
+}
 
-    // AVIO 버퍼 할당
-    const int avio_buffer_size = 32768;
-    ctx->avio_buffer = (uint8_t*)av_malloc(avio_buffer_size);
-    if (!ctx->avio_buffer) {
-        LOGE("Failed to allocate AVIO buffer");
-        env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
-        return nullptr;
+/**
+ * 현재 buffer_data(또는 세션 입력)를 입력으로 AVFormatContext 열기
+ * @param seekable false면 seek 콜백 없이 세션 입력(replay, buffer_data 또는 push FIFO)을
+ *                 순차 입력으로 연다 (세션 모드)
+ * @param deep_probe 트랙 분석용으로 probesize/analyzeduration을 크게 설정
+ * @param push_input push FIFO 입력이면 첫 샘플이 늦지 않도록 분석 시간을 줄인다
+ * @return 0 성공, 음수면 AVERROR
+ */
+static int open_input(DemuxerContext* ctx, bool seekable, bool deep_probe, bool push_input) {
+    DemuxerArena* arena = ctx->arena;
+    if (!arena->avio_buffer) {
+        arena->avio_buffer = (uint8_t*)av_malloc(AVIO_BUFFER_SIZE);
+        if (!arena->avio_buffer) {
+            LOGE("Failed to allocate AVIO buffer");
+            return AVERROR(ENOMEM);
+        }
+        ctx->stats.segment_allocs.avio++;
     }
 
     // 커스텀 AVIO 컨텍스트 생성
     ctx->avio_ctx = avio_alloc_context(
-        ctx->avio_buffer,
-        avio_buffer_size,
+        arena->avio_buffer,
+        AVIO_BUFFER_SIZE,
         0,  // write_flag = 0 (읽기 전용)
-        &ctx->buffer_data,
-        read_packet,
+        seekable ? (void*)&ctx->buffer_data : (void*)ctx,
+        seekable ? read_packet : session_read_packet,
         nullptr,  // write_packet
-        seek_packet
+        seekable ? seek_packet : nullptr
     );
-
     if (!ctx->avio_ctx) {
         LOGE("Failed to allocate AVIO context");
-        av_free(ctx->avio_buffer);
-        ctx->avio_buffer = nullptr;
-        env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
-        return nullptr;
+        return AVERROR(ENOMEM);
     }
 
     // AVFormatContext 생성
     ctx->fmt_ctx = avformat_alloc_context();
     if (!ctx->fmt_ctx) {
         LOGE("Failed to allocate format context");
-        avio_context_free(&ctx->avio_ctx);
-        ctx->avio_buffer = nullptr;
-        env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
-        return nullptr;
+        close_input(ctx);
+        return AVERROR(ENOMEM);
     }
 
     ctx->fmt_ctx->pb = ctx->avio_ctx;
     ctx->fmt_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
 
-    // TS 스트림 분석을 위한 옵션 설정
-    ctx->fmt_ctx->probesize = 5000000;  // 5MB까지 분석
-    ctx->fmt_ctx->max_analyze_duration = 5000000;  // 5초까지 분석
+    if (deep_probe) {
+        // TS 스트림 분석을 위한 옵션 설정
+        ctx->fmt_ctx->probesize = 5000000;  // 5MB까지 분석
+        ctx->fmt_ctx->max_analyze_duration = 5000000;  // 5초까지 분석
+    } else if (push_input) {
+        // 트랙은 이미 분석되었으므로 첫 샘플이 늦지 않도록 짧게만 분석
+        ctx->fmt_ctx->max_analyze_duration = PUSH_ANALYZE_DURATION_US;
+    }
 
     // 입력 포맷 열기 (MPEG-TS 자동 감지)
     int ret = avformat_open_input(&ctx->fmt_ctx, nullptr, nullptr, nullptr);
     if (ret < 0) {
         log_error("avformat_open_input", ret);
-        avio_context_free(&ctx->avio_ctx);
-        ctx->avio_buffer = nullptr;
-        env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
-        return nullptr;
+        close_input(ctx);
+        return ret;
     }
+    return 0;
+}
 
-    // 스트림 정보 찾기
-    ret = avformat_find_stream_info(ctx->fmt_ctx, nullptr);
+/**
+ * 스트림의 트랙 타입
+ * @return TRACK_TYPE_VIDEO / TRACK_TYPE_AUDIO, 샘플로 내보내지 않는 스트림이면 0
+ */
+static int stream_track_type(const AVStream* stream) {
+    if (stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+        return TRACK_TYPE_VIDEO;
+    }
+    if (stream->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+        return TRACK_TYPE_AUDIO;
+    }
+    return 0;
+}
 
-    LOGI("probeSegment: probesize=%lld, analyzeduration=%lld",
-         ctx->fmt_ctx->probesize, ctx->fmt_ctx->max_analyze_duration);
-    if (ret < 0) {
-        log_error("avformat_find_stream_info", ret);
-        avformat_close_input(&ctx->fmt_ctx);
-        ctx->avio_buffer = nullptr;
-        env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
-        return nullptr;
+static bool is_track_selected(const TrackSelection* selection, int pid) {
+    if (selection->active_all) {
+        return true;
+    }
+    for (size_t i = 0; i < selection->active_pids.size(); i++) {
+        if (selection->active_pids[i] == pid) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * 재생 스레드가 바꾼 트랙 선택을 가져와 경량 TS 디먹서에 적용
+ * 디먹스 스레드에서 세그먼트를 시작할 때 호출한다.
+ */
+static void take_track_selection(DemuxerContext* ctx) {
+    TrackSelection* selection = ctx->selection;
+    {
+        std::lock_guard<std::mutex> guard(selection->lock);
+        if (!selection->changed) {
+            return;
+        }
+        selection->changed = false;
+        selection->active_all = selection->all;
+        selection->active_pids = selection->pids;
     }
+    ts_demuxer_select_pids(&ctx->ts->demuxer,
+                           selection->active_all ? nullptr : selection->active_pids.data(),
+                           selection->active_pids.size());
+    LOGI("Track selection applied: %s (%zu pids)",
+         selection->active_all ? "all" : "filtered", selection->active_pids.size());
+}
 
-    // 비디오/오디오 스트림 인덱스 찾기
+/**
+ * 열린 입력(libavformat)의 스트림별 discard 설정
+ * 선택되지 않은 트랙과 샘플로 내보내지 않는 스트림은 AVDISCARD_ALL로 두어 PES를 조립하지 않게 하고,
+ * 선택된 스트림이 하나도 없는 프로그램은 프로그램 단위로 버려 TS 패킷 단계에서 건너뛰게 한다.
+ * @return 선택된 트랙 수
+ */
+static int update_stream_selection(DemuxerContext* ctx) {
+    AVFormatContext* fmt_ctx = ctx->fmt_ctx;
     int track_count = 0;
-    for (unsigned int i = 0; i < ctx->fmt_ctx->nb_streams; i++) {
-        AVStream* stream = ctx->fmt_ctx->streams[i];
-        if (stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
-            ctx->video_stream_idx = i;
-            track_count++;
-        } else if (stream->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
-            ctx->audio_stream_idx = i;
+    for (unsigned int i = 0; i < fmt_ctx->nb_streams; i++) {
+        AVStream* stream = fmt_ctx->streams[i];
+        bool selected = stream_track_type(stream) != 0 &&
+                        is_track_selected(ctx->selection, stream->id);
+        stream->discard = selected ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+        if (selected) {
             track_count++;
         }
     }
-
-    LOGI("Found %d tracks (video_idx=%d, audio_idx=%d)",
-         track_count, ctx->video_stream_idx, ctx->audio_stream_idx);
-
-    uint8_t* video_extradata = nullptr;
-    int video_extradata_size = 0;
-    uint8_t* audio_extradata = nullptr;
-    int audio_extradata_size = 0;
-
-    bool need_video_extradata = false;
-    bool need_audio_extradata = false;
-
-    if (ctx->video_stream_idx >= 0) {
-        AVCodecParameters* codecpar = ctx->fmt_ctx->streams[ctx->video_stream_idx]->codecpar;
-        need_video_extradata =
-            codecpar->codec_id == AV_CODEC_ID_H264 &&
-            (codecpar->extradata == nullptr || codecpar->extradata_size == 0);
-    }
-    if (ctx->audio_stream_idx >= 0) {
-        AVCodecParameters* codecpar = ctx->fmt_ctx->streams[ctx->audio_stream_idx]->codecpar;
-        need_audio_extradata =
-            codecpar->codec_id == AV_CODEC_ID_AAC &&
-            (codecpar->extradata == nullptr || codecpar->extradata_size == 0);
-    }
-
-    if (need_video_extradata || need_audio_extradata) {
-        AVPacket* pkt = av_packet_alloc();
-        int scan_count = 0;
-        const int max_scan_packets = 200;
-        while ((need_video_extradata || need_audio_extradata) &&
-               av_read_frame(ctx->fmt_ctx, pkt) >= 0 &&
-               scan_count < max_scan_packets) {
-            if (need_video_extradata && pkt->stream_index == ctx->video_stream_idx) {
-                const uint8_t* sps = nullptr;
-                const uint8_t* pps = nullptr;
-                int sps_size = 0;
-                int pps_size = 0;
-                if (find_h264_sps_pps(pkt->data, pkt->size, &sps, &sps_size, &pps, &pps_size)) {
-                    video_extradata = build_h264_extradata(sps, sps_size, pps, pps_size,
-                                                           &video_extradata_size);
-                    if (video_extradata) {
-                        LOGI("Video extradata built from bitstream: %d bytes", video_extradata_size);
-                        need_video_extradata = false;
-                    }
-                }
-            } else if (need_audio_extradata && pkt->stream_index == ctx->audio_stream_idx) {
-                if (build_aac_extradata_from_adts(pkt->data, pkt->size,
-                                                  &audio_extradata, &audio_extradata_size)) {
-                    LOGI("Audio extradata built from ADTS: %d bytes", audio_extradata_size);
-                    need_audio_extradata = false;
-                }
-            }
-            av_packet_unref(pkt);
-            scan_count++;
+    for (unsigned int i = 0; i < fmt_ctx->nb_programs; i++) {
+        AVProgram* program = fmt_ctx->programs[i];
+        bool used = program->nb_stream_indexes == 0;
+        for (unsigned int j = 0; j < program->nb_stream_indexes && !used; j++) {
+            used = fmt_ctx->streams[program->stream_index[j]]->discard != AVDISCARD_ALL;
         }
-        av_packet_free(&pkt);
+        program->discard = used ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
     }
+    return track_count;
+}
 
-    // TrackFormat 클래스 참조
-    jclass trackFormatClass = env->FindClass("com/yohan/yoplayersdk/demuxer/TrackFormat");
-    if (!trackFormatClass) {
-        LOGE("Failed to find TrackFormat class");
-        avformat_close_input(&ctx->fmt_ctx);
-        ctx->avio_buffer = nullptr;
-        env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
-        return nullptr;
+static void clear_stream_params(StreamParamCache* cache) {
+    for (size_t i = 0; i < cache->streams.size(); i++) {
+        avcodec_parameters_free(&cache->streams[i].codecpar);
     }
+    cache->streams.clear();
+    cache->pmt_pid = -1;
+    cache->pmt_version = -1;
+}
 
-    // TrackFormat 생성자
-    jmethodID trackFormatConstructor = env->GetMethodID(
-        trackFormatClass, "<init>",
-        "(ILjava/lang/String;II[BII)V"
-    );
-
-    // 결과 배열 생성
-    jobjectArray result = env->NewObjectArray(track_count, trackFormatClass, nullptr);
-    int idx = 0;
-
-    // 비디오 트랙 정보 추가
-    if (ctx->video_stream_idx >= 0) {
-        AVStream* stream = ctx->fmt_ctx->streams[ctx->video_stream_idx];
-        AVCodecParameters* codecpar = stream->codecpar;
-
-        LOGI("Video track: codec_id=%d, width=%d, height=%d, extradata_size=%d",
-             codecpar->codec_id, codecpar->width, codecpar->height, codecpar->extradata_size);
-
-        const char* mime = codec_id_to_mime(codecpar->codec_id, TRACK_TYPE_VIDEO);
-        jstring mimeStr = env->NewStringUTF(mime);
-
-        // extradata (SPS/PPS 등)
-        jbyteArray extraData = nullptr;
-        const uint8_t* video_extra_ptr = codecpar->extradata;
-        int video_extra_size = codecpar->extradata_size;
-        if (video_extra_size <= 0 && video_extradata) {
-            video_extra_ptr = video_extradata;
-            video_extra_size = video_extradata_size;
-        }
-        if (video_extra_ptr && video_extra_size > 0) {
-            extraData = env->NewByteArray(video_extra_size);
-            env->SetByteArrayRegion(extraData, 0, video_extra_size, (jbyte*)video_extra_ptr);
-            LOGI("Video extradata found: %d bytes", video_extra_size);
-        } else {
-            LOGI("Video extradata not found (will be in-band)");
-        }
-
-        jobject trackFormat = env->NewObject(
-            trackFormatClass, trackFormatConstructor,
-            TRACK_TYPE_VIDEO,
-            mimeStr,
-            codecpar->width,
-            codecpar->height,
-            extraData,
-            0,  // sampleRate (비디오는 0)
-            0   // channelCount (비디오는 0)
-        );
-
-        env->SetObjectArrayElement(result, idx++, trackFormat);
-        env->DeleteLocalRef(mimeStr);
-        if (extraData) env->DeleteLocalRef(extraData);
-        env->DeleteLocalRef(trackFormat);
+static const CachedStream* find_cached_stream(const StreamParamCache* cache, int pid) {
+    for (size_t i = 0; i < cache->streams.size(); i++) {
+        if (cache->streams[i].pid == pid) {
+            return &cache->streams[i];
+        }
     }
+    return nullptr;
+}
 
-    // 오디오 트랙 정보 추가
-    if (ctx->audio_stream_idx >= 0) {
-        AVStream* stream = ctx->fmt_ctx->streams[ctx->audio_stream_idx];
-        AVCodecParameters* codecpar = stream->codecpar;
-
-        LOGI("Audio track: codec_id=%d, sample_rate=%d, channels=%d, extradata_size=%d",
-             codecpar->codec_id, codecpar->sample_rate, codecpar->ch_layout.nb_channels,
-             codecpar->extradata_size);
+/**
+ * 분석이 끝난 입력의 비디오/오디오 스트림 파라미터를 캐시에 저장
+ */
+static void store_stream_params(DemuxerContext* ctx) {
+    StreamParamCache* cache = ctx->param_cache;
+    clear_stream_params(cache);
+    if (ctx->fmt_ctx->nb_programs > 0) {
+        cache->pmt_pid = ctx->fmt_ctx->programs[0]->pmt_pid;
+        cache->pmt_version = ctx->fmt_ctx->programs[0]->pmt_version;
+    }
+    for (unsigned int i = 0; i < ctx->fmt_ctx->nb_streams; i++) {
+        AVStream* stream = ctx->fmt_ctx->streams[i];
+        AVMediaType type = stream->codecpar->codec_type;
+        if (type != AVMEDIA_TYPE_VIDEO && type != AVMEDIA_TYPE_AUDIO) {
+            continue;
+        }
+        CachedStream cached;
+        cached.pid = stream->id;
+        cached.codecpar = avcodec_parameters_alloc();
+        if (!cached.codecpar || avcodec_parameters_copy(cached.codecpar, stream->codecpar) < 0) {
+            avcodec_parameters_free(&cached.codecpar);
+            clear_stream_params(cache);
+            return;
+        }
+        cache->streams.push_back(cached);
+    }
+}
 
-        const char* mime = codec_id_to_mime(codecpar->codec_id, TRACK_TYPE_AUDIO);
-        jstring mimeStr = env->NewStringUTF(mime);
+/**
+ * 캐시된 파라미터를 방금 연 입력의 스트림에 적용
+ * PMT PID/버전이 다르거나, 캐시에 없는 PID 또는 코덱이 바뀐 비디오/오디오 스트림이 있으면 적용하지 않는다.
+ * @return 모든 비디오/오디오 스트림에 적용했으면 true
+ */
+static bool apply_stream_params(DemuxerContext* ctx) {
+    const StreamParamCache* cache = ctx->param_cache;
+    AVFormatContext* fmt_ctx = ctx->fmt_ctx;
+    if (cache->streams.empty()) {
+        return false;
+    }
+    if (cache->pmt_version >= 0 &&
+        (fmt_ctx->nb_programs == 0 || fmt_ctx->programs[0]->pmt_pid != cache->pmt_pid ||
+         fmt_ctx->programs[0]->pmt_version != cache->pmt_version)) {
+        LOGI("PMT changed (pid=%d, version=%d), re-probing streams",
+             fmt_ctx->nb_programs > 0 ? fmt_ctx->programs[0]->pmt_pid : -1,
+             fmt_ctx->nb_programs > 0 ? fmt_ctx->programs[0]->pmt_version : -1);
+        return false;
+    }
 
-        // extradata (AudioSpecificConfig 등)
-        jbyteArray extraData = nullptr;
-        const uint8_t* audio_extra_ptr = codecpar->extradata;
-        int audio_extra_size = codecpar->extradata_size;
-        if (audio_extra_size <= 0 && audio_extradata) {
-            audio_extra_ptr = audio_extradata;
-            audio_extra_size = audio_extradata_size;
+    int matched = 0;
+    for (unsigned int i = 0; i < fmt_ctx->nb_streams; i++) {
+        AVCodecParameters* codecpar = fmt_ctx->streams[i]->codecpar;
+        if (codecpar->codec_type != AVMEDIA_TYPE_VIDEO && codecpar->codec_type != AVMEDIA_TYPE_AUDIO) {
+            continue;
         }
-        if (audio_extra_ptr && audio_extra_size > 0) {
-            extraData = env->NewByteArray(audio_extra_size);
-            env->SetByteArrayRegion(extraData, 0, audio_extra_size, (jbyte*)audio_extra_ptr);
-            LOGI("Audio extradata found: %d bytes", audio_extra_size);
-        } else {
-            LOGI("Audio extradata not found");
-        }
-
-        jobject trackFormat = env->NewObject(
-            trackFormatClass, trackFormatConstructor,
-            TRACK_TYPE_AUDIO,
-            mimeStr,
-            0,  // width (오디오는 0)
-            0,  // height (오디오는 0)
-            extraData,
-            codecpar->sample_rate,
-            codecpar->ch_layout.nb_channels
-        );
-
-        env->SetObjectArrayElement(result, idx++, trackFormat);
-        env->DeleteLocalRef(mimeStr);
-        if (extraData) env->DeleteLocalRef(extraData);
-        env->DeleteLocalRef(trackFormat);
+        const CachedStream* cached = find_cached_stream(cache, fmt_ctx->streams[i]->id);
+        if (!cached || cached->codecpar->codec_id != codecpar->codec_id) {
+            LOGI("Stream 0x%x changed (codec_id=%d), re-probing streams",
+                 fmt_ctx->streams[i]->id, codecpar->codec_id);
+            return false;
+        }
+        matched++;
+    }
+    if (matched == 0) {
+        return false;
     }
 
-    ctx->initialized = true;
-
-    if (video_extradata) {
-        av_free(video_extradata);
+    for (unsigned int i = 0; i < fmt_ctx->nb_streams; i++) {
+        const CachedStream* cached = find_cached_stream(cache, fmt_ctx->streams[i]->id);
+        if (cached && avcodec_parameters_copy(fmt_ctx->streams[i]->codecpar, cached->codecpar) < 0) {
+            return false;
+        }
     }
-    if (audio_extradata) {
-        av_free(audio_extradata);
+    return true;
+}
+
+/**
+ * 방금 연 입력의 스트림 파라미터 준비
+ * 캐시와 PMT/코덱이 같으면 캐시를 적용하고, 다르면 avformat_find_stream_info로 다시 분석하여 캐시를 갱신한다.
+ */
+static void prepare_stream_params(DemuxerContext* ctx) {
+    if (apply_stream_params(ctx)) {
+        ctx->stats.stream_info_reused++;
+        return;
     }
+    avformat_find_stream_info(ctx->fmt_ctx, nullptr);
+    ctx->stats.stream_info_count++;
+    store_stream_params(ctx);
+}
 
-    // 바이트 배열 릴리즈 (JNI_ABORT: 변경 없이 해제)
-    env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
+/**
+ * 세그먼트 입력 버퍼 설정 / 해제
+ */
+static void set_input_buffer(DemuxerContext* ctx, const uint8_t* ptr, size_t size) {
+    ctx->buffer_data.ptr = ptr;
+    ctx->buffer_data.size = size;
+    ctx->buffer_data.pos = 0;
+}
 
-    return result;
+/**
+ * 세그먼트 디먹싱 비용 누적 및 로깅
+ */
+static void record_segment_stats(DemuxerContext* ctx, int64_t open_us, int64_t demux_us,
+                                 int sample_count) {
+    DemuxerStats* stats = &ctx->stats;
+    stats->segment_count++;
+    stats->sample_count += sample_count;
+    stats->total_demux_us += demux_us;
+    stats->total_jni_us += stats->segment_jni_us;
+    if (open_us > 0) {
+        stats->open_count++;
+        stats->total_open_us += open_us;
+    }
+    // 디먹서 임시 메모리 (AES-128 복호화 버퍼, 싱크로 넘기는 출력 청크 버퍼 포함)
+    memory_budget_set(ctx->budget, MEMORY_BUDGET_SCRATCH,
+                      arena_reserved_bytes(ctx->arena) +
+                          (int64_t)ctx->decryption->output.capacity() +
+                          (ctx->arena->sink_buffer ? SAMPLE_CHUNK_BYTES : 0));
+    AllocationCounts* allocs = &stats->segment_allocs;
+    allocs->scratch += ctx->arena->scratch.block_allocs;
+    ctx->arena->scratch.block_allocs = 0;
+    int64_t segment_allocs =
+        allocs->avio + allocs->packet + allocs->payload + allocs->scratch + allocs->direct;
+    stats->total_allocs += segment_allocs;
+    LOGI("Demuxed %d samples: open=%lldus, jni=%lldus, total=%lldus "
+         "(avg=%lldus/segment, jni avg=%lldus/segment over %lld segments, opens=%lld, "
+         "stream info=%lld, reused=%lld, timestamp jumps=%lld)",
+         sample_count, (long long)open_us, (long long)stats->segment_jni_us, (long long)demux_us,
+         (long long)(stats->total_demux_us / stats->segment_count),
+         (long long)(stats->total_jni_us / stats->segment_count),
+         (long long)stats->segment_count, (long long)stats->open_count,
+         (long long)stats->stream_info_count, (long long)stats->stream_info_reused,
+         (long long)ctx->timestamps->discontinuity_count);
+    LOGD("Segment allocations: %lld (avio=%lld, packet=%lld, payload=%lld, scratch=%lld, "
+         "direct=%lld), total=%lld",
+         (long long)segment_allocs, (long long)allocs->avio, (long long)allocs->packet,
+         (long long)allocs->payload, (long long)allocs->scratch, (long long)allocs->direct,
+         (long long)stats->total_allocs);
+    if (ctx->budget) {
+        MemoryBudget* budget = ctx->budget;
+        LOGD("Memory budget: %lld/%lld bytes (download=%lld, input=%lld, scratch=%lld, "
+             "samples=%lld, pool=%lld), peak=%lld",
+             (long long)memory_budget_total(budget), (long long)budget->limit,
+             (long long)memory_budget_used(budget, MEMORY_BUDGET_DOWNLOAD),
+             (long long)memory_budget_used(budget, MEMORY_BUDGET_INPUT),
+             (long long)memory_budget_used(budget, MEMORY_BUDGET_SCRATCH),
+             (long long)memory_budget_used(budget, MEMORY_BUDGET_SAMPLES),
+             (long long)memory_budget_used(budget, MEMORY_BUDGET_POOL),
+             (long long)budget->peak.load());
+    }
+    stats->segment_jni_us = 0;
+    memset(allocs, 0, sizeof(*allocs));
 }
 
 /**
- * 세그먼트에서 샘플 추출
- * @param context 네이티브 컨텍스트
- * @param data TS 세그먼트 바이트 배열
- * @return DemuxedSample 배열
+ * direct ByteBuffer의 [offset, offset + length) 영역 주소 반환
+ * @return 영역 시작 주소, direct 버퍼가 아니거나 범위를 벗어나면 nullptr
  */
-DEMUXER_FUNC(jobjectArray, nativeDemuxSegment, jlong context, jbyteArray data) {
-    DemuxerContext* ctx = (DemuxerContext*)context;
-    if (!ctx) {
-        LOGE("Invalid context");
+static const uint8_t* get_direct_buffer_region(JNIEnv* env, jobject buffer,
+                                               jint offset, jint length) {
+    uint8_t* address = (uint8_t*)env->GetDirectBufferAddress(buffer);
+    jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (!address || capacity < 0) {
+        LOGE("Not a direct buffer");
         return nullptr;
     }
-
-    jsize data_size = env->GetArrayLength(data);
-    jbyte* data_ptr = env->GetByteArrayElements(data, nullptr);
-    if (!data_ptr) {
-        LOGE("Failed to get byte array elements");
+    if (offset < 0 || length < 0 || (jlong)offset + length > capacity) {
+        LOGE("Invalid buffer region: offset=%d, length=%d, capacity=%lld",
+             offset, length, (long long)capacity);
         return nullptr;
     }
+    return address + offset;
+}
 
-    // 이전 컨텍스트 정리
-    if (ctx->fmt_ctx) {
-        avformat_close_input(&ctx->fmt_ctx);
-        ctx->avio_buffer = nullptr;  // avformat_close_input이 해제함
-    }
-    if (ctx->avio_ctx) {
-        avio_context_free(&ctx->avio_ctx);
-    }
+// JNI 매크로
+// 네이티브 메서드는 JNI_OnLoad에서 RegisterNatives로 등록하므로 심볼을 export하지 않는다
+#define DEMUXER_FUNC(RETURN_TYPE, NAME, ...)                                    \
+    static RETURN_TYPE JNICALL NAME(JNIEnv* env, jobject thiz, ##__VA_ARGS__)
+
+#define DEMUXER_CLASS "com/yohan/yoplayersdk/demuxer/FfmpegDemuxer"
+#define TRACK_FORMAT_CLASS "com/yohan/yoplayersdk/demuxer/TrackFormat"
+#define SAMPLE_BATCH_CLASS "com/yohan/yoplayersdk/demuxer/DemuxedSampleBatch"
+#define SAMPLE_SINK_CLASS "com/yohan/yoplayersdk/demuxer/DemuxedSampleSink"
+#define SAMPLE_RING_CLASS "com/yohan/yoplayersdk/exoplayer/SampleRingBuffer"
+#define BUFFER_BUDGET_CLASS "com/yohan/yoplayersdk/exoplayer/BufferBudget"
+
+// JNI_OnLoad에서 한 번만 조회하여 고정해 두는 클래스(global ref)와 메서드 ID
+struct JniCache {
+    jclass track_format_class;
+    jmethodID track_format_constructor;
+    jclass byte_buffer_class;
+    jmethodID allocate_direct;
+    jclass sample_batch_class;
+    jmethodID sample_batch_constructor;
+    jmethodID on_sample_batch;
+};
 
-    // 버퍼 데이터 설정
-    ctx->buffer_data.ptr = (const uint8_t*)data_ptr;
-    ctx->buffer_data.size = (size_t)data_size;
-    ctx->buffer_data.pos = 0;
+static JniCache jni_cache;
 
-    // AVIO 버퍼 할당
-    const int avio_buffer_size = 32768;
-    ctx->avio_buffer = (uint8_t*)av_malloc(avio_buffer_size);
-    if (!ctx->avio_buffer) {
-        env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
+/**
+ * 클래스를 찾아 global ref로 고정
+ */
+static jclass find_global_class(JNIEnv* env, const char* name) {
+    jclass local = env->FindClass(name);
+    if (!local) {
+        LOGE("JNI_OnLoad: FindClass failed: %s", name);
         return nullptr;
     }
+    jclass global = (jclass)env->NewGlobalRef(local);
+    env->DeleteLocalRef(local);
+    return global;
+}
 
-    // 커스텀 AVIO 컨텍스트 생성
-    ctx->avio_ctx = avio_alloc_context(
-        ctx->avio_buffer, avio_buffer_size, 0,
-        &ctx->buffer_data, read_packet, nullptr, seek_packet
-    );
-
-    if (!ctx->avio_ctx) {
-        av_free(ctx->avio_buffer);
-        ctx->avio_buffer = nullptr;
-        env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
-        return nullptr;
+/**
+ * 디먹서가 사용하는 클래스/메서드 조회
+ * @return 하나라도 찾지 못하면 false
+ */
+static bool init_jni_cache(JNIEnv* env) {
+    JniCache* cache = &jni_cache;
+    cache->track_format_class = find_global_class(env, TRACK_FORMAT_CLASS);
+    cache->byte_buffer_class = find_global_class(env, "java/nio/ByteBuffer");
+    cache->sample_batch_class = find_global_class(env, SAMPLE_BATCH_CLASS);
+    if (!cache->track_format_class || !cache->byte_buffer_class || !cache->sample_batch_class) {
+        return false;
     }
 
-    // AVFormatContext 생성
-    ctx->fmt_ctx = avformat_alloc_context();
-    ctx->fmt_ctx->pb = ctx->avio_ctx;
-    ctx->fmt_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
+    cache->track_format_constructor = env->GetMethodID(
+        cache->track_format_class, "<init>",
+        "(ILjava/lang/String;II[BIILjava/lang/String;IIFFIIILjava/lang/String;)V"
+    );
+    cache->allocate_direct = env->GetStaticMethodID(
+        cache->byte_buffer_class, "allocateDirect", "(I)Ljava/nio/ByteBuffer;"
+    );
+    cache->sample_batch_constructor = env->GetMethodID(
+        cache->sample_batch_class, "<init>", "(Ljava/nio/ByteBuffer;[J[J[J[I[I[I[I[I)V"
+    );
 
-    if (avformat_open_input(&ctx->fmt_ctx, nullptr, nullptr, nullptr) < 0) {
-        avio_context_free(&ctx->avio_ctx);
-        ctx->avio_buffer = nullptr;
-        env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
-        return nullptr;
+    jclass sinkClass = env->FindClass(SAMPLE_SINK_CLASS);
+    if (!sinkClass) {
+        LOGE("JNI_OnLoad: FindClass failed: %s", SAMPLE_SINK_CLASS);
+        return false;
     }
+    cache->on_sample_batch = env->GetMethodID(
+        sinkClass, "onSampleBatch", "(L" SAMPLE_BATCH_CLASS ";)V"
+    );
+    env->DeleteLocalRef(sinkClass);
 
-    avformat_find_stream_info(ctx->fmt_ctx, nullptr);
+    return cache->track_format_constructor && cache->allocate_direct &&
+           cache->sample_batch_constructor && cache->on_sample_batch;
+}
 
-    // 스트림 인덱스 업데이트
-    ctx->video_stream_idx = -1;
-    ctx->audio_stream_idx = -1;
-    for (unsigned int i = 0; i < ctx->fmt_ctx->nb_streams; i++) {
-        if (ctx->fmt_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
-            ctx->video_stream_idx = i;
-        } else if (ctx->fmt_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
-            ctx->audio_stream_idx = i;
-        }
+/**
+ * 디먹서 초기화
+ * @return 네이티브 컨텍스트 포인터 (0이면 실패)
+ */
+DEMUXER_FUNC(jlong, nativeInit) {
+    DemuxerContext* ctx = (DemuxerContext*)av_mallocz(sizeof(DemuxerContext));
+    if (!ctx) {
+        LOGE("Failed to allocate DemuxerContext");
+        return 0;
     }
 
-    // DemuxedSample 클래스 참조
-    jclass sampleClass = env->FindClass("com/yohan/yoplayersdk/demuxer/DemuxedSample");
-    jmethodID sampleConstructor = env->GetMethodID(
-        sampleClass, "<init>", "(IJI[B)V"
-    );
+    ctx->fmt_ctx = nullptr;
+    ctx->avio_ctx = nullptr;
+    ctx->arena = new DemuxerArena();
+    ctx->arena->avio_buffer = nullptr;
+    ctx->arena->packet = nullptr;
+    ctx->arena->payload_pool = nullptr;
+    ctx->arena->payload_size = 0;
+    scratch_arena_init(&ctx->arena->scratch, SCRATCH_INITIAL_SIZE);
+    ctx->initialized = false;
+    ctx->session_opened = false;
+    ctx->push_mode = false;
+    ctx->push = nullptr;
+    ctx->ts = new TsSession();
+    ts_demuxer_reset(&ctx->ts->demuxer);
+    ts_demuxer_select_pids(&ctx->ts->demuxer, nullptr, 0);
+    ctx->ts->active = false;
+    ctx->ts->replay_pos = 0;
+    ctx->ts->read_buffer.resize(AVIO_BUFFER_SIZE);
+    ctx->pool = nullptr;
+    ctx->param_cache = new StreamParamCache();
+    clear_stream_params(ctx->param_cache);
+    ctx->decryption = new SegmentDecryption();
+    aes_key_init(&ctx->decryption->key);
+    ctx->decryption->enabled = false;
+    ctx->decryption->sample.enabled = false;
+    ctx->decryption->segment_started = false;
+    ctx->sample_decryption = new SampleDecryption();
+    aes_key_init(&ctx->sample_decryption->key);
+    ctx->sample_decryption->enabled = false;
+    ctx->sample_decryption->unsupported_logged = false;
+    ctx->selection = new TrackSelection();
+    ctx->selection->changed = false;
+    ctx->selection->all = true;
+    ctx->selection->active_all = true;
+    ctx->timestamps = new TimestampNormalizer();
+    timestamp_normalizer_reset(ctx->timestamps);
+    ctx->keyframes = new KeyframeIndex();
+    ctx->keyframes->segment_start = 0;
+    ctx->keyframes->pid = -1;
+    ctx->budget = nullptr;
+    set_input_buffer(ctx, nullptr, 0);
+
+    LOGI("Demuxer initialized (aes: %s)", aes_implementation_name());
+    return (jlong)ctx;
+}
 
-    // 먼저 패킷 수를 세기 위해 임시 벡터 사용 (최대 1000개로 제한)
-    const int MAX_SAMPLES = 2000;
-    jobject samples[MAX_SAMPLES];
-    int sample_count = 0;
+/**
+ * Annex-B HEVC 비트스트림의 VPS/SPS/PPS로 hvcC extradata 생성
+ * @param out_data 성공 시 av_malloc으로 할당된 hvcC (기존 값은 해제됨)
+ * @param info 성공 시 SPS 파싱 결과
+ */
+static bool build_hevc_extradata(const uint8_t* data, int size,
+                                 uint8_t** out_data, int* out_size, HevcSpsInfo* info) {
+    const uint8_t* vps = nullptr;
+    const uint8_t* sps = nullptr;
+    const uint8_t* pps = nullptr;
+    int vps_size = 0, sps_size = 0, pps_size = 0;
+    if (!data || size <= 0 ||
+        !find_hevc_parameter_sets(data, size, &vps, &vps_size, &sps, &sps_size, &pps, &pps_size) ||
+        !parse_hevc_sps(sps, sps_size, info)) {
+        return false;
+    }
 
-    AVPacket* pkt = av_packet_alloc();
-    bool sps_pps_logged = false;
+    std::vector<uint8_t> hvcc;
+    build_hevc_hvcc(vps, vps_size, sps, sps_size, pps, pps_size, *info, &hvcc);
+    uint8_t* extradata = (uint8_t*)av_malloc(hvcc.size());
+    if (!extradata) {
+        return false;
+    }
+    memcpy(extradata, hvcc.data(), hvcc.size());
+    av_free(*out_data);
+    *out_data = extradata;
+    *out_size = (int)hvcc.size();
+    return true;
+}
 
-    while (av_read_frame(ctx->fmt_ctx, pkt) >= 0 && sample_count < MAX_SAMPLES) {
-        int stream_idx = pkt->stream_index;
+// probe에서 분석한 비디오/오디오 트랙 하나
+struct ProbeTrack {
+    int stream_idx;
+    int track_type;
+    uint8_t* extradata;        // 비트스트림에서 만든 extradata (av_malloc), 없으면 nullptr
+    int extradata_size;
+    bool need_extradata;
+    // HEVC는 파라미터 셋을 찾으면 hvcC로 만들어 전달
+    HevcSpsInfo hevc_info;
+    bool hevc_info_valid;
+};
 
-        // 비디오 또는 오디오 스트림만 처리
-        if (stream_idx != ctx->video_stream_idx && stream_idx != ctx->audio_stream_idx) {
-            av_packet_unref(pkt);
+/**
+ * 분석한 입력의 비디오/오디오 트랙 목록 생성
+ * 코덱 설정에 extradata가 없는 트랙은 이후 패킷에서 찾도록 표시한다.
+ */
+static void collect_probe_tracks(DemuxerContext* ctx, std::vector<ProbeTrack>* tracks) {
+    for (unsigned int i = 0; i < ctx->fmt_ctx->nb_streams; i++) {
+        int track_type = stream_track_type(ctx->fmt_ctx->streams[i]);
+        if (track_type == 0) {
             continue;
         }
+        ProbeTrack track;
+        track.stream_idx = (int)i;
+        track.track_type = track_type;
+        track.extradata = nullptr;
+        track.extradata_size = 0;
+        track.hevc_info_valid = false;
+
+        AVCodecParameters* codecpar = ctx->fmt_ctx->streams[i]->codecpar;
+        bool no_extradata = codecpar->extradata == nullptr || codecpar->extradata_size == 0;
+        if (codecpar->codec_id == AV_CODEC_ID_H264) {
+            track.need_extradata = no_extradata;
+        } else if (codecpar->codec_id == AV_CODEC_ID_HEVC) {
+            // Annex-B extradata가 있으면 그대로 hvcC로 변환하고, 없으면 비트스트림에서 찾는다
+            track.need_extradata = no_extradata ||
+                !build_hevc_extradata(codecpar->extradata, codecpar->extradata_size,
+                                      &track.extradata, &track.extradata_size, &track.hevc_info);
+            track.hevc_info_valid = !track.need_extradata;
+        } else {
+            track.need_extradata = codecpar->codec_id == AV_CODEC_ID_AAC && no_extradata;
+        }
+        tracks->push_back(track);
+    }
+}
 
-        AVStream* stream = ctx->fmt_ctx->streams[stream_idx];
-        int track_type = (stream_idx == ctx->video_stream_idx) ? TRACK_TYPE_VIDEO : TRACK_TYPE_AUDIO;
+/**
+ * extradata가 없는 트랙의 코덱 설정을 앞쪽 패킷의 비트스트림에서 찾음
+ * (H.264 SPS/PPS, HEVC VPS/SPS/PPS, ADTS 헤더의 AudioSpecificConfig)
+ */
+static void find_extradata_in_packets(DemuxerContext* ctx, std::vector<ProbeTrack>* tracks) {
+    int pending = 0;
+    for (size_t i = 0; i < tracks->size(); i++) {
+        if ((*tracks)[i].need_extradata) {
+            pending++;
+        }
+    }
+    if (pending == 0) {
+        return;
+    }
 
-        // 첫 번째 비디오 키프레임에서 SPS/PPS 확인 (디버깅용)
-        if (!sps_pps_logged && track_type == TRACK_TYPE_VIDEO && (pkt->flags & AV_PKT_FLAG_KEY)) {
+    AVPacket* pkt = obtain_packet(ctx);
+    if (!pkt) {
+        return;
+    }
+    int scan_count = 0;
+    const int max_scan_packets = 200;
+    while (pending > 0 && av_read_frame(ctx->fmt_ctx, pkt) >= 0 && scan_count < max_scan_packets) {
+        ProbeTrack* track = nullptr;
+        for (size_t i = 0; i < tracks->size(); i++) {
+            if ((*tracks)[i].stream_idx == pkt->stream_index && (*tracks)[i].need_extradata) {
+                track = &(*tracks)[i];
+                break;
+            }
+        }
+        AVCodecID codec_id = track ? ctx->fmt_ctx->streams[track->stream_idx]->codecpar->codec_id
+                                   : AV_CODEC_ID_NONE;
+        if (codec_id == AV_CODEC_ID_HEVC) {
+            if (build_hevc_extradata(pkt->data, pkt->size,
+                                     &track->extradata, &track->extradata_size, &track->hevc_info)) {
+                LOGI("Video hvcC built from bitstream: %d bytes (stream %d)",
+                     track->extradata_size, track->stream_idx);
+                track->need_extradata = false;
+                track->hevc_info_valid = true;
+            }
+        } else if (codec_id == AV_CODEC_ID_H264) {
             const uint8_t* sps = nullptr;
             const uint8_t* pps = nullptr;
-            int sps_size = 0, pps_size = 0;
-
+            int sps_size = 0;
+            int pps_size = 0;
             if (find_h264_sps_pps(pkt->data, pkt->size, &sps, &sps_size, &pps, &pps_size)) {
-                LOGI("First video keyframe: size=%d, has SPS(%d bytes), has PPS(%d bytes)",
-                     pkt->size, sps_size, pps_size);
-            } else {
-                LOGI("First video keyframe: size=%d, SPS/PPS not found in packet", pkt->size);
+                track->extradata = build_h264_extradata(sps, sps_size, pps, pps_size,
+                                                        &track->extradata_size);
+                if (track->extradata) {
+                    LOGI("Video extradata built from bitstream: %d bytes (stream %d)",
+                         track->extradata_size, track->stream_idx);
+                    track->need_extradata = false;
+                }
             }
-            sps_pps_logged = true;
+        } else if (codec_id == AV_CODEC_ID_AAC) {
+            if (build_aac_extradata_from_adts(pkt->data, pkt->size,
+                                              &track->extradata, &track->extradata_size)) {
+                LOGI("Audio extradata built from ADTS: %d bytes (stream %d)",
+                     track->extradata_size, track->stream_idx);
+                track->need_extradata = false;
+            }
+        }
+        if (track && !track->need_extradata) {
+            pending--;
         }
+        av_packet_unref(pkt);
+        scan_count++;
+    }
+}
 
-        // PTS를 마이크로초로 변환
-        int64_t time_us = 0;
-        if (pkt->pts != AV_NOPTS_VALUE) {
-            time_us = av_rescale_q(pkt->pts, stream->time_base, {1, 1000000});
-        } else if (pkt->dts != AV_NOPTS_VALUE) {
-            time_us = av_rescale_q(pkt->dts, stream->time_base, {1, 1000000});
+/**
+ * 스트림이 속한 프로그램 번호 (program_number)
+ * @return 프로그램 정보가 없으면 0
+ */
+static int stream_program_id(const AVFormatContext* fmt_ctx, int stream_idx) {
+    for (unsigned int i = 0; i < fmt_ctx->nb_programs; i++) {
+        const AVProgram* program = fmt_ctx->programs[i];
+        for (unsigned int j = 0; j < program->nb_stream_indexes; j++) {
+            if ((int)program->stream_index[j] == stream_idx) {
+                return program->id;
+            }
         }
+    }
+    return 0;
+}
 
-        // 플래그 설정
-        int flags = 0;
-        if (pkt->flags & AV_PKT_FLAG_KEY) {
-            flags |= SAMPLE_FLAG_KEY_FRAME;
+/**
+ * 비디오 트랙의 TrackFormat 생성
+ */
+static jobject new_video_track_format(JNIEnv* env, DemuxerContext* ctx, const ProbeTrack& track,
+                                      int program_id, jstring languageStr) {
+    AVStream* stream = ctx->fmt_ctx->streams[track.stream_idx];
+    AVCodecParameters* codecpar = stream->codecpar;
+
+    LOGI("Video track: pid=0x%x, program=%d, codec_id=%d, width=%d, height=%d, extradata_size=%d",
+         stream->id, program_id, codecpar->codec_id, codecpar->width, codecpar->height,
+         codecpar->extradata_size);
+
+    const char* mime = codec_id_to_mime(codecpar->codec_id, TRACK_TYPE_VIDEO);
+    jstring mimeStr = env->NewStringUTF(mime);
+
+    // extradata (SPS/PPS 등)
+    jbyteArray extraData = nullptr;
+    const uint8_t* video_extra_ptr = codecpar->extradata;
+    int video_extra_size = codecpar->extradata_size;
+    if (track.extradata) {
+        video_extra_ptr = track.extradata;
+        video_extra_size = track.extradata_size;
+    }
+    if (video_extra_ptr && video_extra_size > 0) {
+        extraData = env->NewByteArray(video_extra_size);
+        env->SetByteArrayRegion(extraData, 0, video_extra_size, (jbyte*)video_extra_ptr);
+        LOGI("Video extradata found: %d bytes", video_extra_size);
+    } else {
+        LOGI("Video extradata not found (will be in-band)");
+    }
+
+    // 기본값은 libavformat 분석 결과, H.264는 SPS에서 읽은 값으로 대체
+    int width = codecpar->width;
+    int height = codecpar->height;
+    int profile = codecpar->profile > 0 ? codecpar->profile : 0;
+    int level = codecpar->level > 0 ? codecpar->level : 0;
+    float frame_rate = stream->avg_frame_rate.num > 0 && stream->avg_frame_rate.den > 0
+                           ? (float)av_q2d(stream->avg_frame_rate) : 0.0f;
+    float pixel_ratio = codecpar->sample_aspect_ratio.num > 0 &&
+                        codecpar->sample_aspect_ratio.den > 0
+                            ? (float)av_q2d(codecpar->sample_aspect_ratio) : 1.0f;
+    int max_num_reorder_frames = -1;
+    jstring codecsStr = nullptr;
+
+    const uint8_t* sps = nullptr;
+    const uint8_t* pps = nullptr;
+    int sps_size = 0;
+    int pps_size = 0;
+    H264SpsInfo sps_info;
+    if (codecpar->codec_id == AV_CODEC_ID_H264 && video_extra_ptr &&
+        find_h264_sps_pps(video_extra_ptr, video_extra_size, &sps, &sps_size, &pps, &pps_size) &&
+        parse_h264_sps(sps, sps_size, &sps_info)) {
+        width = sps_info.width;
+        height = sps_info.height;
+        profile = sps_info.profile_idc;
+        level = sps_info.level_idc;
+        if (sps_info.frame_rate > 0) {
+            frame_rate = sps_info.frame_rate;
         }
+        pixel_ratio = (float)sps_info.sar_width / (float)sps_info.sar_height;
+        max_num_reorder_frames = sps_info.max_num_reorder_frames;
+
+        char codecs[16];
+        snprintf(codecs, sizeof(codecs), "avc1.%02X%02X%02X",
+                 sps_info.profile_idc, sps_info.constraint_flags, sps_info.level_idc);
+        codecsStr = env->NewStringUTF(codecs);
+        LOGI("SPS parsed: %dx%d, %s, sar=%d:%d, fps=%.3f, reorder=%d, dpb=%d",
+             width, height, codecs, sps_info.sar_width, sps_info.sar_height,
+             frame_rate, sps_info.max_num_reorder_frames, sps_info.max_dec_frame_buffering);
+    } else if (codecpar->codec_id == AV_CODEC_ID_HEVC && track.hevc_info_valid) {
+        const HevcSpsInfo& hevc_info = track.hevc_info;
+        width = hevc_info.width;
+        height = hevc_info.height;
+        profile = hevc_info.general_profile_idc;
+        level = hevc_info.general_level_idc;
+        max_num_reorder_frames = hevc_info.max_num_reorder_pics;
+
+        char codecs[64];
+        build_hevc_codec_string(hevc_info, codecs, sizeof(codecs));
+        codecsStr = env->NewStringUTF(codecs);
+        LOGI("HEVC SPS parsed: %dx%d, %s, %d-bit, reorder=%d",
+             width, height, codecs, hevc_info.bit_depth_luma, max_num_reorder_frames);
+    }
+
+    jobject trackFormat = env->NewObject(
+        jni_cache.track_format_class, jni_cache.track_format_constructor,
+        TRACK_TYPE_VIDEO,
+        mimeStr,
+        width,
+        height,
+        extraData,
+        0,  // sampleRate (비디오는 0)
+        0,  // channelCount (비디오는 0)
+        codecsStr,
+        profile,
+        level,
+        frame_rate,
+        pixel_ratio,
+        max_num_reorder_frames,
+        stream->id,
+        program_id,
+        languageStr
+    );
+
+    env->DeleteLocalRef(mimeStr);
+    if (codecsStr) env->DeleteLocalRef(codecsStr);
+    if (extraData) env->DeleteLocalRef(extraData);
+    return trackFormat;
+}
 
-        // 패킷 데이터를 ByteArray로 복사
-        jbyteArray sampleData = env->NewByteArray(pkt->size);
-        env->SetByteArrayRegion(sampleData, 0, pkt->size, (jbyte*)pkt->data);
+/**
+ * 오디오 트랙의 TrackFormat 생성
+ */
+static jobject new_audio_track_format(JNIEnv* env, DemuxerContext* ctx, const ProbeTrack& track,
+                                      int program_id, jstring languageStr) {
+    AVStream* stream = ctx->fmt_ctx->streams[track.stream_idx];
+    AVCodecParameters* codecpar = stream->codecpar;
+
+    LOGI("Audio track: pid=0x%x, program=%d, codec_id=%d, sample_rate=%d, channels=%d, "
+         "extradata_size=%d",
+         stream->id, program_id, codecpar->codec_id, codecpar->sample_rate,
+         codecpar->ch_layout.nb_channels, codecpar->extradata_size);
+
+    const char* mime = codec_id_to_mime(codecpar->codec_id, TRACK_TYPE_AUDIO);
+    jstring mimeStr = env->NewStringUTF(mime);
+
+    // extradata (AudioSpecificConfig 등)
+    jbyteArray extraData = nullptr;
+    const uint8_t* audio_extra_ptr = codecpar->extradata;
+    int audio_extra_size = codecpar->extradata_size;
+    if (audio_extra_size <= 0 && track.extradata) {
+        audio_extra_ptr = track.extradata;
+        audio_extra_size = track.extradata_size;
+    }
+    if (audio_extra_ptr && audio_extra_size > 0) {
+        extraData = env->NewByteArray(audio_extra_size);
+        env->SetByteArrayRegion(extraData, 0, audio_extra_size, (jbyte*)audio_extra_ptr);
+        LOGI("Audio extradata found: %d bytes", audio_extra_size);
+    } else {
+        LOGI("Audio extradata not found");
+    }
 
-        // DemuxedSample 객체 생성
-        jobject sample = env->NewObject(
-            sampleClass, sampleConstructor,
-            track_type,
-            time_us,
-            flags,
-            sampleData
-        );
+    jobject trackFormat = env->NewObject(
+        jni_cache.track_format_class, jni_cache.track_format_constructor,
+        TRACK_TYPE_AUDIO,
+        mimeStr,
+        0,  // width (오디오는 0)
+        0,  // height (오디오는 0)
+        extraData,
+        codecpar->sample_rate,
+        codecpar->ch_layout.nb_channels,
+        nullptr,  // codecs
+        codecpar->profile > 0 ? codecpar->profile : 0,
+        0,      // level
+        0.0f,   // frameRate (오디오는 0)
+        1.0f,   // pixelWidthHeightRatio
+        -1,     // maxNumReorderFrames
+        stream->id,
+        program_id,
+        languageStr
+    );
 
-        samples[sample_count++] = sample;
+    env->DeleteLocalRef(mimeStr);
+    if (extraData) env->DeleteLocalRef(extraData);
+    return trackFormat;
+}
 
-        env->DeleteLocalRef(sampleData);
-        av_packet_unref(pkt);
+/**
+ * 메모리 입력을 분석하여 트랙 정보 반환
+ * 모든 프로그램의 비디오/오디오 엘리멘터리 스트림을 PID, 프로그램 번호, 언어와 함께 반환한다.
+ * @param data TS 세그먼트 시작 주소 (호출 동안 유효해야 함)
+ * @param size 세그먼트 크기
+ * @return TrackFormat 배열 (jobjectArray)
+ */
+static jobjectArray probe_input(JNIEnv* env, DemuxerContext* ctx,
+                                const uint8_t* data, size_t size) {
+    // 이전 컨텍스트(세션 포함) 정리
+    close_input(ctx);
+    // 새 스트림의 첫 타임스탬프부터 다시 0으로 시작
+    timestamp_normalizer_reset(ctx->timestamps);
+
+    // 암호화된 세그먼트는 사본을 복호화하여 분석 (같은 바이트를 이후 feed로 다시 받으므로 CBC 상태는 유지)
+    std::vector<uint8_t> plain;
+    SegmentDecryption* dec = ctx->decryption;
+    if (dec->enabled) {
+        AesCbcState state = dec->state;
+        plain.resize(size + AES_BLOCK_SIZE);
+        size = aes_cbc_update(&dec->key, &state, data, size, plain.data());
+        data = plain.data();
     }
 
-    av_packet_free(&pkt);
+    // 버퍼 데이터 설정
+    set_input_buffer(ctx, data, size);
 
-    // 결과 배열 생성
-    jobjectArray result = env->NewObjectArray(sample_count, sampleClass, nullptr);
-    for (int i = 0; i < sample_count; i++) {
-        env->SetObjectArrayElement(result, i, samples[i]);
-        env->DeleteLocalRef(samples[i]);
+    int ret = open_input(ctx, true, true, false);
+    if (ret < 0) {
+        set_input_buffer(ctx, nullptr, 0);
+        return nullptr;
     }
 
-    env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
+    // 스트림 정보 찾기
+    ret = avformat_find_stream_info(ctx->fmt_ctx, nullptr);
+
+    LOGI("probeSegment: probesize=%lld, analyzeduration=%lld",
+         ctx->fmt_ctx->probesize, ctx->fmt_ctx->max_analyze_duration);
+    if (ret < 0) {
+        log_error("avformat_find_stream_info", ret);
+        close_input(ctx);
+        set_input_buffer(ctx, nullptr, 0);
+        return nullptr;
+    }
+
+    // 이후 세그먼트를 열 때 재사용
+    ctx->stats.stream_info_count++;
+    store_stream_params(ctx);
+
+    // 모든 비디오/오디오 트랙 (트랙 선택과 무관하게 분석)
+    std::vector<ProbeTrack> tracks;
+    collect_probe_tracks(ctx, &tracks);
+
+    LOGI("Found %zu tracks in %u programs", tracks.size(), ctx->fmt_ctx->nb_programs);
+
+    find_extradata_in_packets(ctx, &tracks);
+
+    // 결과 배열 생성 (TrackFormat 클래스는 JNI_OnLoad에서 조회)
+    jobjectArray result = env->NewObjectArray((jsize)tracks.size(), jni_cache.track_format_class,
+                                              nullptr);
+    for (size_t i = 0; i < tracks.size(); i++) {
+        const ProbeTrack& track = tracks[i];
+        AVStream* stream = ctx->fmt_ctx->streams[track.stream_idx];
+        int program_id = stream_program_id(ctx->fmt_ctx, track.stream_idx);
+        AVDictionaryEntry* language = av_dict_get(stream->metadata, "language", nullptr, 0);
+        jstring languageStr = language ? env->NewStringUTF(language->value) : nullptr;
+
+        jobject trackFormat = track.track_type == TRACK_TYPE_VIDEO
+            ? new_video_track_format(env, ctx, track, program_id, languageStr)
+            : new_audio_track_format(env, ctx, track, program_id, languageStr);
+        env->SetObjectArrayElement(result, (jsize)i, trackFormat);
+        env->DeleteLocalRef(trackFormat);
+        if (languageStr) env->DeleteLocalRef(languageStr);
+        av_free(track.extradata);
+    }
+
+    ctx->initialized = true;
+
+    // 호출자가 입력 메모리를 해제하므로 포인터를 남기지 않는다
+    set_input_buffer(ctx, nullptr, 0);
 
-    LOGI("Demuxed %d samples", sample_count);
     return result;
 }
 
 /**
- * 디먹서 리소스 해제
+ * 세그먼트 데이터를 디먹싱하여 트랙 정보 반환
+ * @param context 네이티브 컨텍스트
+ * @param data TS 세그먼트 바이트 배열
+ * @return TrackInfo 배열 (jobjectArray)
  */
-DEMUXER_FUNC(void, nativeRelease, jlong context) {
+DEMUXER_FUNC(jobjectArray, nativeProbeSegment, jlong context, jbyteArray data) {
     DemuxerContext* ctx = (DemuxerContext*)context;
     if (!ctx) {
-        return;
+        LOGE("Invalid context");
+        return nullptr;
     }
 
-    if (ctx->fmt_ctx) {
-        avformat_close_input(&ctx->fmt_ctx);
-        ctx->avio_buffer = nullptr;
+    jsize data_size = env->GetArrayLength(data);
+    jbyte* data_ptr = env->GetByteArrayElements(data, nullptr);
+    if (!data_ptr) {
+        LOGE("Failed to get byte array elements");
+        return nullptr;
     }
 
-    if (ctx->avio_ctx) {
-        avio_context_free(&ctx->avio_ctx);
-    }
+    jobjectArray result = probe_input(env, ctx, (const uint8_t*)data_ptr, (size_t)data_size);
 
-    av_free(ctx);
-    LOGI("Demuxer released");
+    // 바이트 배열 릴리즈 (JNI_ABORT: 변경 없이 해제)
+    env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
+    return result;
 }
 
 /**
- * FFmpeg 버전 반환
+ * Direct ByteBuffer의 세그먼트 데이터를 분석하여 트랙 정보 반환
+ * Java 힙 복사 없이 버퍼 주소를 그대로 입력으로 사용한다.
+ * @param context 네이티브 컨텍스트
+ * @param buffer TS 세그먼트가 담긴 direct ByteBuffer
+ * @param offset 버퍼 내 세그먼트 시작 위치
+ * @param length 세그먼트 크기
+ * @return TrackInfo 배열 (jobjectArray)
  */
-DEMUXER_FUNC(jstring, nativeGetVersion) {
-    char version[128];
-    snprintf(version, sizeof(version), "libavformat %d.%d.%d, libavcodec %d.%d.%d",
-             LIBAVFORMAT_VERSION_MAJOR, LIBAVFORMAT_VERSION_MINOR, LIBAVFORMAT_VERSION_MICRO,
-             LIBAVCODEC_VERSION_MAJOR, LIBAVCODEC_VERSION_MINOR, LIBAVCODEC_VERSION_MICRO);
-    return env->NewStringUTF(version);
+DEMUXER_FUNC(jobjectArray, nativeProbeSegmentDirect, jlong context, jobject buffer,
+             jint offset, jint length) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        LOGE("Invalid context");
+        return nullptr;
+    }
+
+    const uint8_t* data = get_direct_buffer_region(env, buffer, offset, length);
+    if (!data) {
+        return nullptr;
+    }
+    return probe_input(env, ctx, data, (size_t)length);
+}
+
+// 배치 출력의 Java 쪽 페이로드
+// 샘플은 SampleChunkWriter가 direct ByteBuffer 주소에 이어 쓰고, 청크마다 DemuxedSampleBatch로 만든다.
+struct SampleBatchBuilder {
+    int64_t jni_us;   // 버퍼 할당/배치 객체 생성에 쓴 누적 시간
+    int64_t direct_allocs;   // direct ByteBuffer 할당 횟수
+    jobject payload;  // direct ByteBuffer (shared_payload가 아니면 local ref)
+    bool shared_payload;   // 컨텍스트의 싱크 청크 버퍼 (해제하지 않음)
+};
+
+/**
+ * Java 힙 밖에 페이로드를 두기 위한 direct ByteBuffer 할당
+ * @return direct ByteBuffer local ref, 실패 시 nullptr
+ */
+static jobject allocate_direct_buffer(JNIEnv* env, size_t capacity) {
+    jobject buffer = env->CallStaticObjectMethod(
+        jni_cache.byte_buffer_class, jni_cache.allocate_direct, (jint)capacity
+    );
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        LOGE("Failed to allocate direct buffer: %zu bytes", capacity);
+        return nullptr;
+    }
+    return buffer;
+}
+
+/**
+ * 배치 페이로드 버퍼의 참조 해제 (공유 버퍼는 그대로 둔다)
+ */
+static void batch_release_payload(JNIEnv* env, SampleBatchBuilder* batch) {
+    if (batch->payload && !batch->shared_payload) {
+        env->DeleteLocalRef(batch->payload);
+    }
+    batch->payload = nullptr;
+    batch->shared_payload = false;
+}
+
+/**
+ * 배치 페이로드 버퍼 준비
+ * @param capacity 예상 페이로드 크기 (ES 페이로드는 TS 입력보다 작으므로 입력 크기 기준)
+ * @param shared 재사용할 direct ByteBuffer (capacity 이상), nullptr이면 새로 할당
+ * @return 버퍼 주소, 실패 시 nullptr
+ */
+static uint8_t* batch_begin(JNIEnv* env, SampleBatchBuilder* batch, size_t capacity,
+                            jobject shared) {
+    if (shared) {
+        batch->payload = shared;
+        batch->shared_payload = true;
+    } else {
+        int64_t start_us = av_gettime_relative();
+        batch->payload = allocate_direct_buffer(env, capacity);
+        batch->jni_us += av_gettime_relative() - start_us;
+        batch->direct_allocs++;
+        batch->shared_payload = false;
+        if (!batch->payload) {
+            return nullptr;
+        }
+    }
+    return (uint8_t*)env->GetDirectBufferAddress(batch->payload);
+}
+
+/**
+ * 청크 페이로드를 더 큰 direct ByteBuffer로 옮김
+ */
+static bool batch_grow(JNIEnv* env, SampleBatchBuilder* batch, SampleChunk* chunk,
+                       size_t capacity) {
+    int64_t start_us = av_gettime_relative();
+    jobject grown = allocate_direct_buffer(env, capacity);
+    batch->jni_us += av_gettime_relative() - start_us;
+    batch->direct_allocs++;
+    if (!grown) {
+        return false;
+    }
+    uint8_t* grown_data = (uint8_t*)env->GetDirectBufferAddress(grown);
+    memcpy(grown_data, chunk->payload, chunk->payload_size);
+    batch_release_payload(env, batch);
+    batch->payload = grown;
+    chunk->payload = grown_data;
+    chunk->payload_capacity = capacity;
+    return true;
+}
+
+static jlongArray new_long_array(JNIEnv* env, const jlong* values, size_t count) {
+    jlongArray array = env->NewLongArray((jsize)count);
+    if (array && count > 0) {
+        env->SetLongArrayRegion(array, 0, (jsize)count, values);
+    }
+    return array;
+}
+
+static jintArray new_int_array(JNIEnv* env, const ScratchVector<int32_t>& values) {
+    jintArray array = env->NewIntArray((jsize)values.count);
+    if (array && values.count > 0) {
+        env->SetIntArrayRegion(array, 0, (jsize)values.count, (const jint*)values.items);
+    }
+    return array;
+}
+
+static jlongArray new_long_array(JNIEnv* env, const ScratchVector<int64_t>& values) {
+    return new_long_array(env, (const jlong*)values.items, values.count);
+}
+
+/**
+ * 청크를 DemuxedSampleBatch 객체로 변환 (배치 페이로드 참조는 해제)
+ */
+static jobject batch_finish(JNIEnv* env, SampleBatchBuilder* batch, const SampleChunk* chunk) {
+    int64_t start_us = av_gettime_relative();
+
+    jlongArray timeUs = new_long_array(env, chunk->time_us);
+    jlongArray decodeTimeUs = new_long_array(env, chunk->decode_time_us);
+    jlongArray durationUs = new_long_array(env, chunk->duration_us);
+    jintArray offset = new_int_array(env, chunk->offset);
+    jintArray size = new_int_array(env, chunk->size);
+    jintArray flags = new_int_array(env, chunk->flags);
+    jintArray trackType = new_int_array(env, chunk->track_type);
+    jintArray trackId = new_int_array(env, chunk->track_id);
+
+    jobject result = env->NewObject(
+        jni_cache.sample_batch_class, jni_cache.sample_batch_constructor,
+        batch->payload, timeUs, decodeTimeUs, durationUs, offset, size, flags, trackType, trackId
+    );
+
+    env->DeleteLocalRef(timeUs);
+    env->DeleteLocalRef(decodeTimeUs);
+    env->DeleteLocalRef(durationUs);
+    env->DeleteLocalRef(offset);
+    env->DeleteLocalRef(size);
+    env->DeleteLocalRef(flags);
+    env->DeleteLocalRef(trackType);
+    env->DeleteLocalRef(trackId);
+    batch_release_payload(env, batch);
+    batch->jni_us += av_gettime_relative() - start_us;
+    return result;
+}
+
+/**
+ * 샘플 출력 대상
+ * 싱크 모드면 청크가 찰 때마다 DemuxedSampleSink로 넘기고, 아니면 배치 하나에 모두 모은다.
+ * 청크를 나누는 기준과 페이로드 누적은 SampleChunkWriter가 맡는다.
+ */
+struct SampleEmitter {
+    JNIEnv* env;
+    jobject sink;
+    TimestampNormalizer* timestamps;
+    KeyframeIndex* keyframes;
+    jobject chunk_buffer;   // 싱크 모드에서 청크마다 재사용하는 페이로드 버퍼
+    SampleBatchBuilder batch;
+    SampleChunkWriter writer;
+};
+
+/**
+ * 싱크 청크용 direct ByteBuffer (컨텍스트마다 처음 한 번만 할당)
+ * 싱크는 콜백 안에서 배치를 복사하므로 모든 세그먼트와 청크가 같은 버퍼를 쓴다.
+ * @return global ref, 실패 시 nullptr
+ */
+static jobject sink_chunk_buffer(JNIEnv* env, DemuxerContext* ctx) {
+    DemuxerArena* arena = ctx->arena;
+    if (!arena->sink_buffer) {
+        int64_t start_us = av_gettime_relative();
+        jobject local = allocate_direct_buffer(env, SAMPLE_CHUNK_BYTES);
+        ctx->stats.segment_jni_us += av_gettime_relative() - start_us;
+        if (!local) {
+            return nullptr;
+        }
+        arena->sink_buffer = env->NewGlobalRef(local);
+        env->DeleteLocalRef(local);
+        ctx->stats.segment_allocs.direct++;
+        LOGD("Allocated sink chunk buffer: %zu bytes", SAMPLE_CHUNK_BYTES);
+    }
+    return arena->sink_buffer;
+}
+
+/**
+ * SampleChunkWriter flush 콜백 - 청크를 싱크로 넘기고 청크 버퍼로 새 청크 시작
+ * @return false면 Java 쪽에서 예외가 발생한 것으로, 예외는 호출자에게 그대로 전파된다
+ */
+static bool emitter_flush_chunk(void* opaque, SampleChunk* chunk) {
+    SampleEmitter* out = (SampleEmitter*)opaque;
+    JNIEnv* env = out->env;
+    jobject result = batch_finish(env, &out->batch, chunk);
+    if (!result) {
+        return false;
+    }
+    env->CallVoidMethod(out->sink, jni_cache.on_sample_batch, result);
+    env->DeleteLocalRef(result);
+    if (env->ExceptionCheck()) {
+        return false;
+    }
+    sample_chunk_restart(chunk, batch_begin(env, &out->batch, SAMPLE_CHUNK_BYTES, out->chunk_buffer),
+                         SAMPLE_CHUNK_BYTES);
+    return true;
+}
+
+// SampleChunkWriter grow 콜백
+static bool emitter_grow_chunk(void* opaque, SampleChunk* chunk, size_t capacity) {
+    SampleEmitter* out = (SampleEmitter*)opaque;
+    return batch_grow(out->env, &out->batch, chunk, capacity);
+}
+
+/**
+ * 출력 시작
+ * 싱크 모드는 컨텍스트의 청크 버퍼를 재사용하고, 단일 배치 모드는 입력 크기로 페이로드 버퍼를 잡는다.
+ */
+static bool emitter_begin(JNIEnv* env, DemuxerContext* ctx, SampleEmitter* out, jobject sink) {
+    out->env = env;
+    out->sink = sink;
+    out->timestamps = ctx->timestamps;
+    out->keyframes = ctx->keyframes;
+    out->chunk_buffer = nullptr;
+    out->batch.jni_us = 0;
+    out->batch.direct_allocs = 0;
+    out->batch.payload = nullptr;
+    out->batch.shared_payload = false;
+    if (sink) {
+        out->chunk_buffer = sink_chunk_buffer(env, ctx);
+        if (!out->chunk_buffer) {
+            return false;
+        }
+    }
+    size_t capacity = sink ? SAMPLE_CHUNK_BYTES : ctx->buffer_data.size + AVIO_BUFFER_SIZE;
+    uint8_t* payload = batch_begin(env, &out->batch, capacity, out->chunk_buffer);
+    if (!payload) {
+        ctx->stats.segment_jni_us += out->batch.jni_us;
+        ctx->stats.segment_allocs.direct += out->batch.direct_allocs;
+        return false;
+    }
+    // 이전 세그먼트의 임시 메모리를 한꺼번에 비우고 청크 메타데이터를 새로 잡는다
+    scratch_arena_reset(&ctx->arena->scratch);
+    SampleChunkCallbacks callbacks = {emitter_flush_chunk, emitter_grow_chunk, out};
+    sample_chunk_writer_init(&out->writer, &ctx->arena->scratch, &callbacks, payload, capacity,
+                             sink != nullptr);
+    return true;
+}
+
+/**
+ * 샘플 하나 출력
+ * @return false면 더 이상 출력할 수 없음
+ */
+static bool emit_sample(SampleEmitter* out, int track_type, int track_id,
+                        const SampleTiming* timing, int flags, const uint8_t* data, int size) {
+    return sample_chunk_write(&out->writer, track_type, track_id, timing, flags, data, size);
+}
+
+/**
+ * push 모드에서 다음 읽기가 대기하게 되면, 모인 샘플부터 먼저 싱크로 넘겨 지연을 줄인다
+ */
+static bool emit_pending_before_wait(DemuxerContext* ctx, SampleEmitter* out) {
+    if (ctx->push_mode && push_available(ctx->push) == 0) {
+        return sample_chunk_writer_flush(&out->writer);
+    }
+    return !out->writer.failed;
+}
+
+/**
+ * 출력 마무리
+ * @param out_count 출력된 전체 샘플 수
+ * @return 단일 배치 모드면 DemuxedSampleBatch, 싱크 모드이거나 실패 시 null
+ */
+static jobject emitter_finish(DemuxerContext* ctx, SampleEmitter* out, int* out_count) {
+    SampleBatchBuilder* batch = &out->batch;
+    jobject result = nullptr;
+    *out_count = sample_chunk_writer_finish(&out->writer);
+    // 싱크 전달에 실패했으면 payload가 이미 해제되어 있다
+    if (!out->sink && batch->payload) {
+        result = batch_finish(out->env, batch, &out->writer.chunk);
+    } else {
+        batch_release_payload(out->env, batch);
+    }
+    ctx->stats.segment_jni_us += batch->jni_us;
+    ctx->stats.segment_allocs.direct += batch->direct_allocs;
+    return result;
+}
+
+// 90kHz 틱을 마이크로초로
+static int64_t ticks_to_us(int64_t ticks) {
+    return av_rescale(ticks, 1000000, 90000);
+}
+
+/**
+ * 오디오 패킷 길이 (90kHz)
+ * AC-3/E-AC-3/MPEG 오디오는 프레임 헤더에서 계산하고, 그 밖에는 패킷 duration을 사용한다.
+ * @return 알 수 없으면 0
+ */
+static int64_t audio_packet_duration(const AVStream* stream, const AVPacket* pkt) {
+    AudioFrameInfo info;
+    bool parsed = false;
+    switch (stream->codecpar->codec_id) {
+        case AV_CODEC_ID_AC3:
+        case AV_CODEC_ID_EAC3:
+            parsed = parse_ac3_frame_info(pkt->data, (size_t)pkt->size, &info);
+            break;
+        case AV_CODEC_ID_MP1:
+        case AV_CODEC_ID_MP2:
+        case AV_CODEC_ID_MP3:
+            parsed = parse_mpeg_audio_frame_info(pkt->data, (size_t)pkt->size, &info);
+            break;
+        default:
+            break;
+    }
+    if (parsed) {
+        return audio_frame_duration(&info);
+    }
+    if (pkt->duration > 0) {
+        return av_rescale_q(pkt->duration, stream->time_base, {1, 90000});
+    }
+    return 0;
+}
+
+/**
+ * ADTS AAC 패킷을 헤더를 뺀 raw_data_block으로 나누어 출력
+ * 패킷 하나에 여러 ADTS 프레임(또는 블록)이 있으면 패킷 PTS에서 블록 길이만큼 이어지는 타임스탬프를 붙인다.
+ * @param pts 첫 프레임의 90kHz PTS, 없으면 TIMESTAMP_NONE
+ * @return false면 더 이상 출력할 수 없음
+ */
+static bool emit_adts_packet(SampleEmitter* out, int track_id, int64_t pts,
+                             const uint8_t* data, int size) {
+    int64_t cursor = pts;
+    int pos = 0;
+    while (size - pos >= ADTS_HEADER_SIZE) {
+        AdtsHeader header;
+        if (!parse_adts_header(data + pos, (size_t)(size - pos), &header)) {
+            pos++;
+            continue;
+        }
+        // 패킷 끝에서 잘린 프레임은 버린다
+        if (header.frame_size > size - pos) {
+            break;
+        }
+        int64_t duration = adts_frame_duration(&header);
+        // raw_data_block마다 샘플 하나 (CRC가 있는 다중 블록 프레임은 블록별 CRC를 뺀다)
+        AdtsRawBlock blocks[ADTS_MAX_RAW_BLOCKS];
+        int block_count = adts_split_raw_blocks(data + pos, &header, blocks);
+        int64_t block_duration = block_count > 0 ? duration / block_count : 0;
+        for (int i = 0; i < block_count; i++) {
+            int64_t block_pts = cursor != TIMESTAMP_NONE ? cursor + i * block_duration : cursor;
+            SampleTiming timing;
+            timing.time_us = timestamp_normalize(out->timestamps, track_id, block_pts,
+                                                 block_duration, true);
+            timing.decode_time_us = timing.time_us;
+            timing.duration_us = ticks_to_us(block_duration);
+            if (!emit_sample(out, TRACK_TYPE_AUDIO, track_id, &timing, SAMPLE_FLAG_KEY_FRAME,
+                             data + pos + blocks[i].offset, blocks[i].size)) {
+                return false;
+            }
+        }
+        if (cursor != TIMESTAMP_NONE) {
+            cursor += duration;
+        }
+        pos += header.frame_size;
+    }
+    return true;
+}
+
+/**
+ * 열린 입력(libavformat)에서 EOF까지 패킷을 읽어 출력
+ * 패킷마다 Java 객체를 만들지 않고 페이로드와 메타데이터를 배치에 모은다.
+ * 샘플 수 제한이 없으며, 패킷 수와 무관하게 JNI local ref는 배치 단위로만 유지된다.
+ */
+static void read_av_packets(DemuxerContext* ctx, SampleEmitter* out) {
+    AVPacket* pkt = obtain_packet(ctx);
+    if (!pkt) {
+        out->writer.failed = true;
+        return;
+    }
+    bool sps_pps_logged = false;
+
+    while (emit_pending_before_wait(ctx, out) && av_read_frame(ctx->fmt_ctx, pkt) >= 0) {
+        AVStream* stream = ctx->fmt_ctx->streams[pkt->stream_index];
+        int track_type = stream_track_type(stream);
+
+        // 선택된 비디오/오디오 트랙만 처리
+        if (track_type == 0 || stream->discard == AVDISCARD_ALL) {
+            av_packet_unref(pkt);
+            continue;
+        }
+
+        // 첫 번째 비디오 키프레임에서 SPS/PPS 확인 (디버깅용)
+        if (!sps_pps_logged && track_type == TRACK_TYPE_VIDEO && (pkt->flags & AV_PKT_FLAG_KEY)) {
+            const uint8_t* sps = nullptr;
+            const uint8_t* pps = nullptr;
+            int sps_size = 0, pps_size = 0;
+
+            if (find_h264_sps_pps(pkt->data, pkt->size, &sps, &sps_size, &pps, &pps_size)) {
+                LOGI("First video keyframe: size=%d, has SPS(%d bytes), has PPS(%d bytes)",
+                     pkt->size, sps_size, pps_size);
+            } else {
+                LOGI("First video keyframe: size=%d, SPS/PPS not found in packet", pkt->size);
+            }
+            sps_pps_logged = true;
+        }
+
+        // SAMPLE-AES: 암호화된 블록만 제자리에서 복호화
+        if (ctx->sample_decryption->enabled &&
+            !decrypt_sample(ctx, stream->codecpar->codec_id, pkt)) {
+            av_packet_unref(pkt);
+            continue;
+        }
+
+        // PTS(없으면 DTS)를 90kHz로 옮겨 정규화 (MPEG-TS는 time_base가 이미 1/90000)
+        int64_t timestamp = pkt->pts != AV_NOPTS_VALUE ? pkt->pts : pkt->dts;
+        int64_t pts = timestamp != AV_NOPTS_VALUE
+                          ? av_rescale_q(timestamp, stream->time_base, {1, 90000}) : TIMESTAMP_NONE;
+        int64_t dts = pkt->dts != AV_NOPTS_VALUE
+                          ? av_rescale_q(pkt->dts, stream->time_base, {1, 90000}) : TIMESTAMP_NONE;
+
+        // ADTS AAC는 헤더를 빼고 프레임 단위로 나누어 출력
+        if (stream->codecpar->codec_id == AV_CODEC_ID_AAC &&
+            is_adts_sync(pkt->data, (size_t)pkt->size)) {
+            bool emitted = emit_adts_packet(out, stream->id, pts, pkt->data, pkt->size);
+            av_packet_unref(pkt);
+            if (!emitted) {
+                break;
+            }
+            continue;
+        }
+
+        // 오디오 길이는 프레임 헤더 기준 (HE-AAC/AC-3/MP3 등 프레임당 샘플 수가 코덱마다 다름)
+        // 비디오는 패킷 duration, 없으면 DTS 간격으로 추정
+        int64_t duration;
+        if (track_type == TRACK_TYPE_AUDIO) {
+            duration = audio_packet_duration(stream, pkt);
+        } else {
+            duration = timestamp_estimate_duration(out->timestamps, stream->id, dts);
+            if (pkt->duration > 0) {
+                duration = av_rescale_q(pkt->duration, stream->time_base, {1, 90000});
+            }
+        }
+        SampleTiming timing;
+        timing.time_us = timestamp_normalize(out->timestamps, stream->id, pts, duration,
+                                             track_type == TRACK_TYPE_AUDIO);
+        timing.decode_time_us = timestamp_decode_time(timing.time_us, pts, dts);
+        timing.duration_us = ticks_to_us(duration);
+
+        // 플래그 설정
+        int flags = 0;
+        if (pkt->flags & AV_PKT_FLAG_KEY) {
+            flags |= SAMPLE_FLAG_KEY_FRAME;
+        }
+
+        bool emitted = emit_sample(out, track_type, stream->id, &timing, flags,
+                                   pkt->data, pkt->size);
+        av_packet_unref(pkt);
+        if (!emitted) {
+            break;
+        }
+    }
+}
+
+/**
+ * 비디오 키프레임을 세그먼트 인덱스에 기록
+ * 이전 세그먼트에서 시작된 PES나 타임스탬프가 없는 키프레임은 seek 위치로 쓸 수 없으므로 건너뛴다.
+ */
+static void record_keyframe(KeyframeIndex* index, const TsAccessUnit* unit, int64_t pts,
+                            int64_t time_us) {
+    if (pts == TIMESTAMP_NONE || time_us == TIMESTAMP_UNSET_US || unit->pos < index->segment_start) {
+        return;
+    }
+    if (index->pid < 0) {
+        index->pid = unit->pid;
+    } else if (index->pid != unit->pid) {
+        return;
+    }
+    index->entries.push_back(time_us);
+    index->entries.push_back(pts);
+    index->entries.push_back(unit->pos - index->segment_start);
+}
+
+/**
+ * 경량 TS 디먹서 콜백 - 액세스 유닛을 샘플로 출력
+ */
+static bool on_ts_access_unit(void* opaque, const TsAccessUnit* unit) {
+    SampleEmitter* out = (SampleEmitter*)opaque;
+    int track_type = unit->codec == TS_CODEC_AAC ? TRACK_TYPE_AUDIO : TRACK_TYPE_VIDEO;
+    SampleTiming timing;
+    int64_t pts = sample_timing_from_ts_unit(out->timestamps, unit, &timing);
+    int flags = unit->key_frame ? SAMPLE_FLAG_KEY_FRAME : 0;
+    if (track_type == TRACK_TYPE_VIDEO && unit->key_frame) {
+        record_keyframe(out->keyframes, unit, pts, timing.time_us);
+    }
+    return emit_sample(out, track_type, unit->pid, &timing, flags, unit->data, unit->size);
+}
+
+/**
+ * 경량 TS 디먹서로 세션 입력을 세그먼트 끝까지 읽어 출력
+ * @return false면 처리할 수 없는 스트림이므로 libavformat으로 전환해야 함
+ *         (아직 처리하지 않은 입력은 replay에 보관됨)
+ */
+static bool read_ts_packets(DemuxerContext* ctx, SampleEmitter* out) {
+    TsSession* ts = ctx->ts;
+    TsDemuxer* demuxer = &ts->demuxer;
+    uint8_t* buffer = ts->read_buffer.data();
+
+    while (emit_pending_before_wait(ctx, out)) {
+        int read = read_session_source(ctx, buffer, (int)ts->read_buffer.size());
+        if (read == AVERROR_EOF) {
+            ts_demuxer_flush(demuxer, on_ts_access_unit, out);
+            break;
+        }
+        if (read < 0) {
+            break;  // 취소 등
+        }
+
+        bool before_program = !ts_demuxer_has_program(demuxer);
+        if (before_program) {
+            ts->replay.insert(ts->replay.end(), buffer, buffer + read);
+        }
+
+        size_t consumed = 0;
+        int status = ts_demuxer_feed(demuxer, buffer, (size_t)read, on_ts_access_unit, out,
+                                     &consumed);
+        if (status == TS_FEED_UNSUPPORTED) {
+            if (!before_program) {
+                // 세션 도중 PMT가 바뀐 경우 해당 PMT 패킷부터 넘긴다 (PAT는 다음 반복에서 받음)
+                ts->replay.assign(demuxer->partial, demuxer->partial + demuxer->partial_size);
+                ts->replay.insert(ts->replay.end(), buffer + consumed, buffer + read);
+            }
+            ts->replay_pos = 0;
+            return false;
+        }
+        if (status != TS_FEED_OK) {
+            break;
+        }
+
+        if (ts_demuxer_has_program(demuxer)) {
+            ts->replay.clear();
+        } else if (ts->replay.size() >= TS_PROGRAM_SEARCH_BYTES) {
+            LOGI("TS fast path: PMT not found in %zu bytes", ts->replay.size());
+            ts->replay_pos = 0;
+            return false;
+        }
+    }
+
+    if (demuxer->sync_errors > 0 || demuxer->continuity_errors > 0) {
+        LOGD("TS fast path: %lld packets, sync errors=%lld, continuity errors=%lld",
+             (long long)demuxer->packet_count, (long long)demuxer->sync_errors,
+             (long long)demuxer->continuity_errors);
+    }
+    return true;
+}
+
+/**
+ * 열린 입력에서 EOF까지 패킷을 읽어 DemuxedSampleBatch 생성
+ * @param sink null이 아니면 청크 단위 배치를 DemuxedSampleSink로 전달하고 null 반환,
+ *             null이면 세그먼트 전체를 배치 하나로 반환
+ */
+static jobject read_samples(JNIEnv* env, DemuxerContext* ctx, jobject sink, int* out_count) {
+    *out_count = 0;
+    SampleEmitter out;
+    if (!emitter_begin(env, ctx, &out, sink)) {
+        return nullptr;
+    }
+    read_av_packets(ctx, &out);
+    return emitter_finish(ctx, &out, out_count);
+}
+
+/**
+ * 세그먼트에서 샘플 추출
+ * 호출마다 입력을 새로 열며, 스트림 분석은 probe 결과와 PMT/코덱이 달라졌을 때만 다시 수행한다.
+ * @param context 네이티브 컨텍스트
+ * @param data TS 세그먼트 바이트 배열
+ * @return DemuxedSampleBatch (실패 시 null)
+ */
+DEMUXER_FUNC(jobject, nativeDemuxSegment, jlong context, jbyteArray data) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        LOGE("Invalid context");
+        return nullptr;
+    }
+
+    jsize data_size = env->GetArrayLength(data);
+    jbyte* data_ptr = env->GetByteArrayElements(data, nullptr);
+    if (!data_ptr) {
+        LOGE("Failed to get byte array elements");
+        return nullptr;
+    }
+
+    int64_t start_us = av_gettime_relative();
+
+    // 이전 컨텍스트 정리
+    close_input(ctx);
+
+    // 버퍼 데이터 설정
+    size_t size = (size_t)data_size;
+    const uint8_t* input = prepare_segment_decryption(ctx, (const uint8_t*)data_ptr, &size);
+    set_input_buffer(ctx, input, size);
+
+    if (open_input(ctx, true, false, false) < 0) {
+        set_input_buffer(ctx, nullptr, 0);
+        env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
+        return nullptr;
+    }
+
+    // probe 결과와 PMT/코덱이 같으면 스트림 분석을 생략
+    prepare_stream_params(ctx);
+
+    // 선택되지 않은 트랙은 읽지 않도록 설정
+    take_track_selection(ctx);
+    update_stream_selection(ctx);
+
+    int64_t open_us = av_gettime_relative() - start_us;
+
+    int sample_count = 0;
+    jobject result = read_samples(env, ctx, nullptr, &sample_count);
+
+    set_input_buffer(ctx, nullptr, 0);
+    env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
+
+    record_segment_stats(ctx, open_us, av_gettime_relative() - start_us, sample_count);
+    return result;
+}
+
+/**
+ * 세션 입력을 libavformat으로 열고 스트림 파라미터 준비
+ * 세션 입력은 순차 스트림이므로 seek 불가로 연다.
+ * @return 0 성공, 음수면 AVERROR
+ */
+static int open_session_input(DemuxerContext* ctx) {
+    int ret = open_input(ctx, false, false, ctx->push_mode);
+    if (ret < 0) {
+        return ret;
+    }
+    prepare_stream_params(ctx);
+    LOGI("Demux session opened: %u streams%s", ctx->fmt_ctx->nb_streams,
+         ctx->push_mode ? " (push)" : "");
+    return 0;
+}
+
+/**
+ * 세션 입력에서 현재 세그먼트의 샘플 추출
+ * 세션은 경량 TS 디먹서로 시작하고, 처리할 수 없는 스트림이면 읽은 입력을 되돌려
+ * libavformat 세션으로 전환한다. libavformat은 첫 세그먼트에서만 입력을 열고 스트림을 분석하며,
+ * 이후 세그먼트는 같은 컨텍스트의 입력 뒤에 이어 붙여 읽는다.
+ * 두 경우 모두 MPEG-TS PES/연속성 카운터 상태가 세그먼트 경계를 넘어 유지된다.
+ * 입력(buffer_data 또는 push FIFO)은 호출자가 준비한다.
+ * @param sink null이 아니면 샘플을 청크 단위로 전달 (read_samples 참고)
+ * @param out_count 추출된 샘플 수 (입력을 열지 못하면 -1)
+ * @return DemuxedSampleBatch (싱크 모드이거나 실패 시 null)
+ */
+static jobject demux_session(JNIEnv* env, DemuxerContext* ctx, jobject sink, int* out_count) {
+    int64_t start_us = av_gettime_relative();
+    int64_t open_us = 0;
+
+    take_track_selection(ctx);
+
+    if (!ctx->session_opened) {
+        close_input(ctx);
+        ts_session_start(ctx->ts);
+        ctx->session_opened = true;
+        LOGI("Demux session opened: TS fast path%s", ctx->push_mode ? " (push)" : "");
+    } else if (!ctx->ts->active) {
+        // 이전 세그먼트 끝에서 설정된 EOF 상태를 해제하고 이어서 읽기
+        ctx->avio_ctx->eof_reached = 0;
+    }
+    // 키프레임 인덱스는 경량 TS 디먹서로 읽는 구간에서만 기록된다
+    ctx->keyframes->entries.clear();
+    ctx->keyframes->segment_start = ctx->ts->demuxer.input_pos;
+
+    *out_count = 0;
+    SampleEmitter out;
+    if (!emitter_begin(env, ctx, &out, sink)) {
+        return nullptr;
+    }
+
+    if (ctx->ts->active && !read_ts_packets(ctx, &out)) {
+        LOGI("TS fast path unsupported, falling back to libavformat");
+        ctx->ts->active = false;
+        int64_t open_start_us = av_gettime_relative();
+        if (open_session_input(ctx) < 0) {
+            jobject partial = emitter_finish(ctx, &out, out_count);
+            if (partial) {
+                env->DeleteLocalRef(partial);
+            }
+            *out_count = -1;
+            return nullptr;
+        }
+        open_us = av_gettime_relative() - open_start_us;
+    }
+
+    if (!ctx->ts->active) {
+        // 세션 도중 늦게 발견된 스트림과 바뀐 트랙 선택도 반영
+        update_stream_selection(ctx);
+        read_av_packets(ctx, &out);
+    }
+
+    jobject result = emitter_finish(ctx, &out, out_count);
+
+    record_segment_stats(ctx, open_us, av_gettime_relative() - start_us, *out_count);
+    return result;
+}
+
+/**
+ * 세션 모드로 메모리 입력에서 샘플 추출
+ * @param data TS 세그먼트 시작 주소 (호출 동안 유효해야 함)
+ * @param size 세그먼트 크기
+ * @param sink null이 아니면 샘플을 청크 단위로 전달 (read_samples 참고)
+ * @param out_count 추출된 샘플 수
+ * @return DemuxedSampleBatch (싱크 모드이거나 실패 시 null)
+ */
+static jobject demux_session_input(JNIEnv* env, DemuxerContext* ctx,
+                                   const uint8_t* data, size_t size,
+                                   jobject sink, int* out_count) {
+    if (ctx->push_mode) {
+        LOGE("Demuxer is in push mode");
+        *out_count = -1;
+        return nullptr;
+    }
+
+    // 이전 세그먼트는 EOF까지 모두 소비되었으므로 새 세그먼트로 입력을 교체
+    set_input_buffer(ctx, data, size);
+
+    jobject result = demux_session(env, ctx, sink, out_count);
+
+    // 입력 메모리는 반환 후 무효화되므로 포인터를 남기지 않는다
+    set_input_buffer(ctx, nullptr, 0);
+    return result;
+}
+
+/**
+ * 세션 모드로 세그먼트에서 샘플 추출
+ * @param context 네이티브 컨텍스트
+ * @param data TS 세그먼트 바이트 배열
+ * @return DemuxedSampleBatch (실패 시 null)
+ */
+DEMUXER_FUNC(jobject, nativeDemuxSessionSegment, jlong context, jbyteArray data) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        LOGE("Invalid context");
+        return nullptr;
+    }
+
+    jsize data_size = env->GetArrayLength(data);
+    jbyte* data_ptr = env->GetByteArrayElements(data, nullptr);
+    if (!data_ptr) {
+        LOGE("Failed to get byte array elements");
+        return nullptr;
+    }
+
+    int sample_count = 0;
+    size_t size = (size_t)data_size;
+    const uint8_t* input = prepare_segment_decryption(ctx, (const uint8_t*)data_ptr, &size);
+    jobject result = demux_session_input(env, ctx, input, size, nullptr, &sample_count);
+
+    env->ReleaseByteArrayElements(data, data_ptr, JNI_ABORT);
+    return result;
+}
+
+/**
+ * 세션 모드로 direct ByteBuffer의 세그먼트에서 샘플 추출
+ * GetByteArrayElements의 힙 복사 없이 버퍼 주소에서 바로 읽는다.
+ * @param context 네이티브 컨텍스트
+ * @param buffer TS 세그먼트가 담긴 direct ByteBuffer
+ * @param offset 버퍼 내 세그먼트 시작 위치
+ * @param length 세그먼트 크기
+ * @return DemuxedSampleBatch (실패 시 null)
+ */
+DEMUXER_FUNC(jobject, nativeDemuxSegmentDirect, jlong context, jobject buffer,
+             jint offset, jint length) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        LOGE("Invalid context");
+        return nullptr;
+    }
+
+    const uint8_t* data = get_direct_buffer_region(env, buffer, offset, length);
+    if (!data) {
+        return nullptr;
+    }
+    size_t size = (size_t)length;
+    const uint8_t* input = prepare_segment_decryption(ctx, data, &size);
+    int sample_count = 0;
+    return demux_session_input(env, ctx, input, size, nullptr, &sample_count);
+}
+
+/**
+ * 세션 모드로 direct ByteBuffer의 세그먼트를 디먹싱하여 샘플을 싱크로 스트리밍
+ * 샘플 수 제한 없이 일정 크기의 청크(DemuxedSampleBatch)로 나누어 sink.onSampleBatch를 호출한다.
+ * 싱크에서 예외가 발생하면 디먹싱을 멈추고 예외를 Java로 전파한다.
+ * @param context 네이티브 컨텍스트
+ * @param buffer TS 세그먼트가 담긴 direct ByteBuffer
+ * @param offset 버퍼 내 세그먼트 시작 위치
+ * @param length 세그먼트 크기
+ * @param sink DemuxedSampleSink
+ * @return 전달된 샘플 수 (실패 시 음수)
+ */
+DEMUXER_FUNC(jint, nativeDemuxSegmentToSink, jlong context, jobject buffer,
+             jint offset, jint length, jobject sink) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx || !sink) {
+        LOGE("Invalid context or sink");
+        return DEMUXER_ERROR_INIT_FAILED;
+    }
+
+    const uint8_t* data = get_direct_buffer_region(env, buffer, offset, length);
+    if (!data) {
+        return DEMUXER_ERROR_READ_FAILED;
+    }
+
+    size_t size = (size_t)length;
+    const uint8_t* input = prepare_segment_decryption(ctx, data, &size);
+    int sample_count = 0;
+    demux_session_input(env, ctx, input, size, sink, &sample_count);
+    return sample_count < 0 ? DEMUXER_ERROR_OPEN_FAILED : sample_count;
+}
+
+/**
+ * 다음 세그먼트의 복호화 설정 (EXT-X-KEY)
+ * AES-128: push 모드에서는 이후 feed부터 nativeEndSegment까지, 그 밖에는 다음 분석/디먹싱 호출의
+ *          입력에 적용된다. 평문은 컨텍스트의 복호화 버퍼에 쓰며 direct 버퍼/바이트 배열 입력은 바뀌지 않는다.
+ * SAMPLE-AES: 해당 세그먼트를 디먹싱하면서 H.264/AAC 샘플을 제자리에서 복호화한다.
+ * 설정은 세그먼트 하나를 처리하면 해제되며, 키 스케줄은 같은 키가 이어지는 동안 재사용한다.
+ * @param method DECRYPTION_METHOD_*
+ * @param key 16바이트 키 (null이면 복호화 해제)
+ * @param iv 16바이트 IV
+ * @return 방식/키/IV가 올바르지 않으면 false
+ */
+DEMUXER_FUNC(jboolean, nativeSetDecryption, jlong context, jint method,
+             jbyteArray key, jbyteArray iv) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        return JNI_FALSE;
+    }
+    SegmentDecryption* dec = ctx->decryption;
+    dec->enabled = false;
+    dec->sample.enabled = false;
+    if (!key) {
+        return JNI_TRUE;
+    }
+    if (!iv || env->GetArrayLength(key) != AES_BLOCK_SIZE ||
+        env->GetArrayLength(iv) != AES_BLOCK_SIZE) {
+        LOGE("Invalid AES key or IV");
+        return JNI_FALSE;
+    }
+
+    uint8_t key_bytes[AES_BLOCK_SIZE];
+    uint8_t iv_bytes[AES_BLOCK_SIZE];
+    env->GetByteArrayRegion(key, 0, AES_BLOCK_SIZE, (jbyte*)key_bytes);
+    env->GetByteArrayRegion(iv, 0, AES_BLOCK_SIZE, (jbyte*)iv_bytes);
+
+    if (method == DECRYPTION_METHOD_SAMPLE_AES) {
+        memcpy(dec->sample.key, key_bytes, AES_BLOCK_SIZE);
+        memcpy(dec->sample.iv, iv_bytes, AES_BLOCK_SIZE);
+        dec->sample.enabled = true;
+        return JNI_TRUE;
+    }
+    if (method != DECRYPTION_METHOD_AES_128) {
+        LOGE("Unsupported decryption method: %d", method);
+        return JNI_FALSE;
+    }
+    if (!aes_key_set(&dec->key, key_bytes)) {
+        LOGE("Failed to set AES-128 key");
+        return JNI_FALSE;
+    }
+    aes_cbc_start(&dec->state, iv_bytes);
+    dec->enabled = true;
+    return JNI_TRUE;
+}
+
+/**
+ * 디먹싱할 트랙 선택
+ * 선택되지 않은 PID는 경량 TS 디먹서에서 TS 패킷 단계, libavformat에서는 PES 헤더 단계에서 버려진다.
+ * 재생 스레드에서 호출할 수 있으며, 다음에 시작하는 세그먼트부터 적용된다.
+ * @param pids 선택할 트랙 ID(PID) 목록, null이면 모든 트랙
+ */
+DEMUXER_FUNC(void, nativeSetSelectedTracks, jlong context, jintArray pids) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        return;
+    }
+    TrackSelection* selection = ctx->selection;
+    std::lock_guard<std::mutex> guard(selection->lock);
+    selection->all = pids == nullptr;
+    selection->pids.clear();
+    if (pids) {
+        selection->pids.resize(env->GetArrayLength(pids));
+        env->GetIntArrayRegion(pids, 0, (jsize)selection->pids.size(), selection->pids.data());
+    }
+    selection->changed = true;
+}
+
+/**
+ * 입력 FIFO와 임시 메모리 사용량을 반영할 메모리 예산 설정
+ * 예산은 디먹서보다 오래 유지되어야 한다.
+ * @param budget BufferBudget 네이티브 포인터, 0이면 고정 한도만 적용
+ */
+DEMUXER_FUNC(void, nativeSetMemoryBudget, jlong context, jlong budget) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        return;
+    }
+    ctx->budget = (MemoryBudget*)budget;
+    if (ctx->push) {
+        std::lock_guard<std::mutex> guard(ctx->push->lock);
+        ctx->push->budget = ctx->budget;
+        memory_budget_set(ctx->budget, MEMORY_BUDGET_INPUT,
+                          ctx->push->write_pos - ctx->push->read_pos);
+        ctx->push->cond.notify_all();
+    }
+    if (ctx->pool) {
+        segment_demux_pool_set_budget(ctx->pool, ctx->budget);
+    }
+}
+
+// push FIFO와 복호화 상태를 비우고 push 모드로 전환
+static void start_push(DemuxerContext* ctx) {
+    if (!ctx->push) {
+        ctx->push = new PushInput();
+        ctx->push->budget = ctx->budget;
+    }
+    push_reset(ctx->push);
+    ctx->decryption->enabled = false;
+    ctx->decryption->sample.enabled = false;
+    ctx->decryption->segment_started = false;
+    ctx->push_mode = true;
+}
+
+/**
+ * push 모드 시작
+ * 이후 세션 입력은 feed로 전달된 바이트에서 읽으며, 기존 세션과 FIFO는 초기화된다.
+ * 세그먼트 다운로드가 끝나기 전에 디먹싱을 시작하기 위한 모드이다.
+ */
+DEMUXER_FUNC(void, nativeStartPush, jlong context) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        return;
+    }
+    close_input(ctx);
+    start_push(ctx);
+    LOGI("Push mode started");
+}
+
+/**
+ * push 모드로 seek
+ * 이전 입력(FIFO와 조립 중인 PES)을 버리고, 이후 타임스탬프가 [timeUs]에서 이어지도록 한다.
+ * 경량 TS 디먹서 세션이 PMT를 적용한 상태면 PAT/PMT를 유지하여, 다음 입력이 세그먼트 중간의
+ * 키프레임 패킷부터 시작해도 디먹싱할 수 있다.
+ * @param timeUs seek 위치의 정규화된 시각
+ * @param pts90k timeUs에 대응하는 90kHz PTS (키프레임 인덱스 값), 모르면 음수
+ * @return PAT/PMT를 유지했으면 true (세그먼트 중간부터 입력 가능), 아니면 세그먼트 처음부터 넣어야 함
+ */
+DEMUXER_FUNC(jboolean, nativeSeekPush, jlong context, jlong timeUs, jlong pts90k) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        return JNI_FALSE;
+    }
+    TsSession* ts = ctx->ts;
+    bool resume = ctx->session_opened && ts->active && ts_demuxer_has_program(&ts->demuxer);
+    if (resume) {
+        ts_demuxer_restart(&ts->demuxer);
+        ts->replay.clear();
+        ts->replay_pos = 0;
+    } else {
+        close_input(ctx);
+    }
+    start_push(ctx);
+    timestamp_normalizer_seek(ctx->timestamps, timeUs, pts90k >= 0 ? pts90k : TIMESTAMP_NONE);
+    LOGI("Push mode seek to %lldus (program %s)", (long long)timeUs, resume ? "kept" : "reset");
+    return resume ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 마지막으로 디먹싱한 세그먼트의 키프레임 인덱스
+ * @return (timeUs, 90kHz PTS, 세그먼트 내 바이트 오프셋) 반복 배열, 경량 TS 디먹서로 읽지 않았으면 빈 배열
+ */
+DEMUXER_FUNC(jlongArray, nativeGetKeyframeIndex, jlong context) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        return nullptr;
+    }
+    const std::vector<jlong>& entries = ctx->keyframes->entries;
+    return new_long_array(env, entries.data(), entries.size());
+}
+
+/**
+ * push 모드로 바이트 배열의 [offset, offset + length) 구간 전달
+ * 디먹싱되지 않은 입력이 한도를 넘으면 자리가 날 때까지 대기한다.
+ * @return false면 push 모드가 아니거나 취소됨
+ */
+DEMUXER_FUNC(jboolean, nativeFeed, jlong context, jbyteArray data, jint offset, jint length) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx || !ctx->push_mode) {
+        LOGE("Demuxer is not in push mode");
+        return JNI_FALSE;
+    }
+    // offset + length가 jint를 넘칠 수 있으므로 jlong으로 비교
+    jsize data_size = env->GetArrayLength(data);
+    if (offset < 0 || length < 0 || (jlong)offset + length > data_size) {
+        LOGE("Invalid feed region: offset=%d, length=%d, size=%d", offset, length, data_size);
+        return JNI_FALSE;
+    }
+    // critical 구간에서는 대기할 수 없으므로 공간을 먼저 확보한다
+    if (!push_wait_for_space(ctx->push, (size_t)length)) {
+        return JNI_FALSE;
+    }
+    uint8_t* data_ptr = (uint8_t*)env->GetPrimitiveArrayCritical(data, nullptr);
+    if (!data_ptr) {
+        LOGE("Failed to get byte array elements");
+        return JNI_FALSE;
+    }
+    push_append_input(ctx, data_ptr + offset, (size_t)length);
+    env->ReleasePrimitiveArrayCritical(data, data_ptr, JNI_ABORT);
+    return JNI_TRUE;
+}
+
+/**
+ * push 모드로 direct ByteBuffer의 [offset, offset + length) 구간 전달
+ * @return false면 push 모드가 아니거나 취소됨
+ */
+DEMUXER_FUNC(jboolean, nativeFeedDirect, jlong context, jobject buffer,
+             jint offset, jint length) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx || !ctx->push_mode) {
+        LOGE("Demuxer is not in push mode");
+        return JNI_FALSE;
+    }
+    const uint8_t* data = get_direct_buffer_region(env, buffer, offset, length);
+    if (!data || !push_wait_for_space(ctx->push, (size_t)length)) {
+        return JNI_FALSE;
+    }
+    push_append_input(ctx, data, (size_t)length);
+    return JNI_TRUE;
+}
+
+/**
+ * push 모드로 전달 중인 세그먼트의 끝 표시
+ * 디먹서는 이 위치에서 EOF를 만나 미완성 PES까지 내보낸다.
+ * 암호화된 세그먼트는 보류한 마지막 블록을 패딩 제거 후 추가하고 복호화 설정을 해제한다.
+ */
+DEMUXER_FUNC(void, nativeEndSegment, jlong context) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx || !ctx->push_mode) {
+        return;
+    }
+    SegmentDecryption* dec = ctx->decryption;
+    push_begin_segment(ctx);
+    if (dec->enabled) {
+        uint8_t last_block[AES_BLOCK_SIZE];
+        size_t size = finish_decryption(dec, last_block);
+        push_append(ctx->push, last_block, size);
+    }
+    push_end_segment(ctx->push);
+    dec->sample.enabled = false;
+    dec->segment_started = false;
+}
+
+/**
+ * push 모드로 다음 세그먼트를 디먹싱하여 샘플을 싱크로 전달
+ * 입력이 모자라면 feed를 기다리며, 세그먼트 끝(nativeEndSegment)에 도달하거나 취소되면 반환한다.
+ * feed를 호출하는 스레드와 다른 스레드에서 호출해야 한다.
+ * @param context 네이티브 컨텍스트
+ * @param sink DemuxedSampleSink
+ * @return 전달된 샘플 수 (실패 시 음수)
+ */
+DEMUXER_FUNC(jint, nativeDrainSamples, jlong context, jobject sink) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx || !sink || !ctx->push_mode) {
+        LOGE("Invalid context or sink, or not in push mode");
+        return DEMUXER_ERROR_INIT_FAILED;
+    }
+
+    // feed 쪽에서 세그먼트 순서대로 넘긴 SAMPLE-AES 키 (취소되면 복호화 없이 바로 반환됨)
+    SampleAesParams params;
+    bool has_params = push_take_segment_key(ctx->push, &params);
+    begin_sample_decryption(ctx, has_params ? &params : nullptr);
+
+    int sample_count = 0;
+    demux_session(env, ctx, sink, &sample_count);
+    push_finish_segment(ctx->push);
+    return sample_count < 0 ? DEMUXER_ERROR_OPEN_FAILED : sample_count;
+}
+
+/**
+ * push 모드 취소
+ * 대기 중인 feed/drain을 깨워 반환시킨다. 다시 사용하려면 nativeStartPush를 호출한다.
+ */
+DEMUXER_FUNC(void, nativeCancelPush, jlong context) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx || !ctx->push) {
+        return;
+    }
+    push_cancel(ctx->push);
+    LOGI("Push mode cancelled");
+}
+
+/**
+ * 병렬 디먹스 풀 시작
+ * 다운로드를 마친 세그먼트를 nativeSubmitSegment로 넘기면 워커들이 동시에 복호화/파싱하고,
+ * 디먹스 스레드가 nativeDrainPooledSegment로 제출 순서대로 출력한다.
+ * 같은 워커 수의 풀이 이미 있으면 그대로 쓰고, 다르면 새로 만든다 (출력하지 않은 세그먼트는 버려짐).
+ * feed(push 입력)와 같은 세그먼트 흐름에 섞어 쓰지 않는다.
+ * @param workers 워커 수 (1 ~ 8)
+ * @return 시작된 워커 수
+ */
+DEMUXER_FUNC(jint, nativeStartPool, jlong context, jint workers) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        return 0;
+    }
+    if (ctx->pool && segment_demux_pool_worker_count(ctx->pool) != workers) {
+        segment_demux_pool_destroy(ctx->pool);
+        ctx->pool = nullptr;
+    }
+    if (!ctx->pool) {
+        ctx->pool = segment_demux_pool_create(workers, POOL_MAX_PENDING_BYTES, ctx->budget);
+        LOGI("Segment demux pool started: %d workers",
+             segment_demux_pool_worker_count(ctx->pool));
+    }
+    return segment_demux_pool_worker_count(ctx->pool);
+}
+
+/**
+ * 다운로드를 마친 세그먼트를 병렬 디먹스 풀에 제출 (다운로드 스레드)
+ * direct ByteBuffer의 [offset, offset + length) 구간을 복사하므로 반환 후 버퍼를 재사용해도 된다.
+ * nativeSetDecryption으로 설정한 복호화는 이 세그먼트에 적용되고 해제된다.
+ * 출력하지 않은 세그먼트가 한도를 넘으면 디먹스 스레드가 꺼낼 때까지 대기한다.
+ * @param discontinuity true면 이 세그먼트를 출력하기 직전에 세션과 타임스탬프 기준을 다시 잡는다
+ *                      (nativeResetSession을 출력 순서에 맞춰 적용)
+ * @return 세그먼트 순번, 풀이 없거나 취소되었으면 -1
+ */
+DEMUXER_FUNC(jlong, nativeSubmitSegment, jlong context, jobject buffer, jint offset,
+             jint length, jboolean discontinuity) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx || !ctx->pool) {
+        LOGE("Segment demux pool not started");
+        return -1;
+    }
+    const uint8_t* data = get_direct_buffer_region(env, buffer, offset, length);
+    if (!data) {
+        return -1;
+    }
+
+    SegmentDecryption* dec = ctx->decryption;
+    SegmentDemuxParams params;
+    params.encryption = SEGMENT_ENCRYPTION_NONE;
+    params.discontinuity = discontinuity == JNI_TRUE;
+    if (dec->enabled) {
+        // 아직 입력이 없으므로 CBC 상태의 iv가 설정된 IV 그대로다
+        params.encryption = SEGMENT_ENCRYPTION_AES_128;
+        memcpy(params.key, dec->key.key, AES_BLOCK_SIZE);
+        memcpy(params.iv, dec->state.iv, AES_BLOCK_SIZE);
+    } else if (dec->sample.enabled) {
+        params.encryption = SEGMENT_ENCRYPTION_SAMPLE_AES;
+        memcpy(params.key, dec->sample.key, AES_BLOCK_SIZE);
+        memcpy(params.iv, dec->sample.iv, AES_BLOCK_SIZE);
+    }
+    dec->enabled = false;
+    dec->sample.enabled = false;
+
+    return segment_demux_pool_submit(ctx->pool, data, (size_t)length, &params);
+}
+
+/**
+ * 병렬 디먹스 풀이 처리하지 못한 세그먼트를 세션 경로로 순차 디먹싱
+ * AES-128은 워커가 이미 복호화했으므로 SAMPLE-AES 설정만 적용한다.
+ * @return 추출된 샘플 수 (입력을 열지 못하면 -1)
+ */
+static int demux_pooled_fallback(JNIEnv* env, DemuxerContext* ctx, SegmentDemuxJob* job,
+                                 jobject sink) {
+    SampleAesParams params;
+    params.enabled = job->params.encryption == SEGMENT_ENCRYPTION_SAMPLE_AES;
+    memcpy(params.key, job->params.key, AES_BLOCK_SIZE);
+    memcpy(params.iv, job->params.iv, AES_BLOCK_SIZE);
+    begin_sample_decryption(ctx, &params);
+
+    int sample_count = 0;
+    if (!ctx->push_mode) {
+        demux_session_input(env, ctx, job->input.data(), job->input_size, sink, &sample_count);
+        return sample_count;
+    }
+    // push 세션은 FIFO에서 읽으므로 세그먼트를 통째로 넣고 끝을 표시한다
+    push_append(ctx->push, job->input.data(), job->input_size);
+    push_end_segment(ctx->push);
+    demux_session(env, ctx, sink, &sample_count);
+    push_finish_segment(ctx->push);
+    return sample_count;
+}
+
+/**
+ * 병렬 디먹스 풀이 파싱한 액세스 유닛을 출력
+ * 순차 경로와 같은 on_ts_access_unit을 세그먼트 순서대로 거치므로, 세그먼트 사이의 타임스탬프 기준
+ * 이어 붙이기(33비트 순환, 오디오 단조 증가 포함)와 키프레임 인덱스가 순차 디먹싱과 같다.
+ * 워커는 모든 PID를 파싱하므로 트랙 선택은 여기서 적용한다.
+ * @return 출력한 샘플 수
+ */
+static int emit_pooled_units(JNIEnv* env, DemuxerContext* ctx, SegmentDemuxJob* job,
+                             jobject sink) {
+    TsSession* ts = ctx->ts;
+    take_track_selection(ctx);
+    if (!ctx->session_opened) {
+        close_input(ctx);
+        ts_session_start(ts);
+        ctx->session_opened = true;
+        LOGI("Demux session opened: TS fast path (pooled)");
+    }
+    // 워커의 액세스 유닛 위치는 세그먼트 처음부터 센다
+    ctx->keyframes->entries.clear();
+    ctx->keyframes->segment_start = 0;
+
+    int sample_count = 0;
+    SampleEmitter out;
+    if (!emitter_begin(env, ctx, &out, sink)) {
+        return 0;
+    }
+    const uint8_t* payload = job->payload.data();
+    for (size_t i = 0; i < job->units.size(); i++) {
+        const SegmentDemuxUnit* unit = &job->units[i];
+        if (!is_track_selected(ctx->selection, unit->pid)) {
+            continue;
+        }
+        TsAccessUnit access_unit;
+        access_unit.pid = unit->pid;
+        access_unit.codec = unit->codec;
+        access_unit.data = payload + unit->offset;
+        access_unit.size = unit->size;
+        access_unit.pts = unit->pts;
+        access_unit.dts = unit->dts;
+        access_unit.duration = unit->duration;
+        access_unit.pos = unit->pos;
+        access_unit.key_frame = unit->key_frame;
+        if (!on_ts_access_unit(&out, &access_unit)) {
+            break;
+        }
+    }
+    emitter_finish(ctx, &out, &sample_count);
+
+    // 세션 디먹서는 이 세그먼트를 읽지 않았으므로 다음 순차 입력은 continuity를 새로 시작한다
+    if (ts_demuxer_has_program(&ts->demuxer)) {
+        ts_demuxer_restart(&ts->demuxer);
+    }
+    if (job->sync_errors > 0 || job->continuity_errors > 0) {
+        LOGD("TS fast path (pooled): sync errors=%lld, continuity errors=%lld",
+             (long long)job->sync_errors, (long long)job->continuity_errors);
+    }
+    return sample_count;
+}
+
+/**
+ * 병렬 디먹스 풀에 제출한 다음 세그먼트의 샘플을 싱크로 전달 (디먹스 스레드)
+ * 제출 순서대로 하나씩 꺼내며, 파싱이 끝나지 않았으면 기다린다. 불연속 표시가 있으면 출력 전에
+ * 세션과 타임스탬프 기준을 다시 잡는다. 경량 TS 디먹서로 처리할 수 없는 세그먼트와 libavformat으로
+ * 전환된 세션의 세그먼트는 순차 경로로 디먹싱한다.
+ * @param sink DemuxedSampleSink
+ * @return 전달된 샘플 수, 취소되었으면 0 (실패 시 음수)
+ */
+DEMUXER_FUNC(jint, nativeDrainPooledSegment, jlong context, jobject sink) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx || !sink || !ctx->pool) {
+        LOGE("Invalid context or sink, or segment demux pool not started");
+        return DEMUXER_ERROR_INIT_FAILED;
+    }
+
+    int64_t wait_start_us = av_gettime_relative();
+    SegmentDemuxJob* job = segment_demux_pool_take(ctx->pool);
+    if (!job) {
+        return 0;
+    }
+    int64_t start_us = av_gettime_relative();
+
+    if (job->params.discontinuity) {
+        close_input(ctx);
+        timestamp_normalizer_rebase(ctx->timestamps);
+        LOGI("Demux session reset (pooled segment %lld)", (long long)job->sequence);
+    }
+    if (job->invalid_padding) {
+        LOGE("Invalid AES-128 padding or segment size, keeping last block as is");
+    }
+
+    int sample_count;
+    bool sequential = job->status == SEGMENT_DEMUX_UNSUPPORTED ||
+                      (ctx->session_opened && !ctx->ts->active);
+    if (sequential) {
+        sample_count = demux_pooled_fallback(env, ctx, job, sink);
+    } else {
+        sample_count = emit_pooled_units(env, ctx, job, sink);
+        record_segment_stats(ctx, 0, av_gettime_relative() - start_us, sample_count);
+    }
+    LOGD("Pooled segment %lld: %s, parse=%lldus, queued=%lldus, drain wait=%lldus (%d workers)",
+         (long long)job->sequence, sequential ? "sequential" : "parallel",
+         (long long)job->parse_us, (long long)(start_us - job->submit_us),
+         (long long)(start_us - wait_start_us), segment_demux_pool_worker_count(ctx->pool));
+
+    segment_demux_pool_recycle(ctx->pool, job);
+    return sample_count < 0 ? DEMUXER_ERROR_OPEN_FAILED : sample_count;
+}
+
+/**
+ * 병렬 디먹스 풀 취소
+ * 대기 중인 submit/drain을 깨워 반환시킨다. 다시 사용하려면 drain이 반환된 뒤 nativeResetPool을 호출한다.
+ */
+DEMUXER_FUNC(void, nativeCancelPool, jlong context) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx || !ctx->pool) {
+        return;
+    }
+    segment_demux_pool_cancel(ctx->pool);
+    LOGI("Segment demux pool cancelled");
+}
+
+/**
+ * 병렬 디먹스 풀의 출력하지 않은 세그먼트를 버리고 취소 상태 해제 (seek)
+ */
+DEMUXER_FUNC(void, nativeResetPool, jlong context) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx || !ctx->pool) {
+        return;
+    }
+    segment_demux_pool_reset(ctx->pool);
+}
+
+/**
+ * 디먹스 세션 종료
+ * 다음 세션 세그먼트에서 입력을 새로 열고 스트림 분석을 다시 수행한다 (불연속 구간 등).
+ */
+DEMUXER_FUNC(void, nativeResetSession, jlong context) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        return;
+    }
+    close_input(ctx);
+    // 불연속 이후 타임스탬프는 지금까지의 출력에 이어지도록 기준을 다시 잡는다
+    timestamp_normalizer_rebase(ctx->timestamps);
+    LOGI("Demux session reset");
+}
+
+/**
+ * 디먹서 리소스 해제
+ */
+DEMUXER_FUNC(void, nativeRelease, jlong context) {
+    DemuxerContext* ctx = (DemuxerContext*)context;
+    if (!ctx) {
+        return;
+    }
+
+    // 워커가 컨텍스트를 참조하지는 않지만 예산보다 먼저 멈춰야 한다
+    segment_demux_pool_destroy(ctx->pool);
+    close_input(ctx);
+    delete ctx->push;
+    delete ctx->ts;
+    clear_stream_params(ctx->param_cache);
+    delete ctx->param_cache;
+    aes_key_release(&ctx->decryption->key);
+    delete ctx->decryption;
+    aes_key_release(&ctx->sample_decryption->key);
+    delete ctx->sample_decryption;
+    delete ctx->selection;
+    delete ctx->timestamps;
+    delete ctx->keyframes;
+    release_arena(env, ctx->arena);
+
+    av_free(ctx);
+    LOGI("Demuxer released");
+}
+
+/**
+ * FFmpeg 버전 반환
+ */
+DEMUXER_FUNC(jstring, nativeGetVersion) {
+    char version[128];
+    snprintf(version, sizeof(version), "libavformat %d.%d.%d, libavcodec %d.%d.%d",
+             LIBAVFORMAT_VERSION_MAJOR, LIBAVFORMAT_VERSION_MINOR, LIBAVFORMAT_VERSION_MICRO,
+             LIBAVCODEC_VERSION_MAJOR, LIBAVCODEC_VERSION_MINOR, LIBAVCODEC_VERSION_MICRO);
+    return env->NewStringUTF(version);
+}
+
+// ===== 트랙별 샘플 링 버퍼 (SampleRingBuffer) =====
+
+// nativePeek이 채우는 메타데이터 배열의 인덱스 (SampleRingBuffer.META_* 와 동일)
+enum SampleRingMeta {
+    RING_META_TIME_US = 0,
+    RING_META_DECODE_TIME_US,
+    RING_META_DURATION_US,
+    RING_META_SIZE,
+    RING_META_FLAGS,
+    RING_META_COUNT,
+};
+
+/**
+ * 링 버퍼 생성
+ * @param capacity 바이트 크기
+ * @param budget 사용량을 반영할 메모리 예산 포인터 (링보다 오래 유지), 없으면 0
+ * @return 링 포인터 (0이면 실패)
+ */
+DEMUXER_FUNC(jlong, nativeCreateRing, jint capacity, jlong budget) {
+    SampleRing* ring =
+        capacity > 0 ? sample_ring_create((size_t)capacity, (MemoryBudget*)budget) : nullptr;
+    if (!ring) {
+        LOGE("Failed to allocate sample ring: %d bytes", capacity);
+    }
+    return (jlong)ring;
+}
+
+DEMUXER_FUNC(void, nativeReleaseRing, jlong ring) {
+    sample_ring_destroy((SampleRing*)ring);
+}
+
+/**
+ * 링의 워터마크 설정 (sample_ring_set_watermarks 참고)
+ */
+DEMUXER_FUNC(void, nativeSetWatermarks, jlong ringPtr, jlong lowBytes, jlong highDurationUs,
+             jlong lowDurationUs) {
+    if (ringPtr) {
+        sample_ring_set_watermarks((SampleRing*)ringPtr, lowBytes > 0 ? (size_t)lowBytes : 0,
+                                   highDurationUs, lowDurationUs);
+    }
+}
+
+/**
+ * 배치 중 start 이후 trackId 트랙의 샘플이 모두 들어갈 공간이 있는지 확인 (쓰지 않음)
+ * 타임스탬프가 없는 샘플과 링보다 큰 샘플은 쓰지 않으므로 계산에서 뺀다.
+ * 높은 길이 워터마크에 도달했거나 메모리 예산이 모자라면 공간이 있어도 false를 반환한다.
+ */
+DEMUXER_FUNC(jboolean, nativeCanWrite, jlong ringPtr, jlongArray timeUs, jintArray size,
+             jintArray trackId, jint track, jint start) {
+    SampleRing* ring = (SampleRing*)ringPtr;
+    if (!ring) {
+        return JNI_FALSE;
+    }
+    SampleRingBatch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.count = env->GetArrayLength(timeUs);
+    jlong* times = (jlong*)env->GetPrimitiveArrayCritical(timeUs, nullptr);
+    jint* sizes = (jint*)env->GetPrimitiveArrayCritical(size, nullptr);
+    jint* tracks = (jint*)env->GetPrimitiveArrayCritical(trackId, nullptr);
+    bool fits = false;
+    if (times && sizes && tracks) {
+        batch.time_us = times;
+        batch.size = sizes;
+        batch.track_id = tracks;
+        fits = sample_ring_batch_fits(ring, &batch, track, start);
+    }
+    if (tracks) env->ReleasePrimitiveArrayCritical(trackId, tracks, JNI_ABORT);
+    if (sizes) env->ReleasePrimitiveArrayCritical(size, sizes, JNI_ABORT);
+    if (times) env->ReleasePrimitiveArrayCritical(timeUs, times, JNI_ABORT);
+    return fits ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 배치 중 start 이후 trackId 트랙의 샘플이 들어갈 때까지 대기 (디먹스 스레드)
+ * 소비자가 낮은 워터마크 아래로 비울 때 한 번 깨어나므로 가득 찬 동안에는 CPU를 쓰지 않는다.
+ * 남은 샘플이 링보다 크면 링이 빌 때 깨어나 나누어 쓴다 (sample_ring_batch_required 참고).
+ * @return SampleRingWaitResult
+ */
+DEMUXER_FUNC(jint, nativeAwaitWritable, jlong ringPtr, jlongArray timeUs, jintArray size,
+             jintArray trackId, jint track, jint start, jint timeoutMs) {
+    SampleRing* ring = (SampleRing*)ringPtr;
+    if (!ring) {
+        return SAMPLE_RING_WAIT_CLOSED;
+    }
+    SampleRingBatch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.count = env->GetArrayLength(timeUs);
+    size_t required = 0;
+    jlong* times = (jlong*)env->GetPrimitiveArrayCritical(timeUs, nullptr);
+    jint* sizes = (jint*)env->GetPrimitiveArrayCritical(size, nullptr);
+    jint* tracks = (jint*)env->GetPrimitiveArrayCritical(trackId, nullptr);
+    if (times && sizes && tracks) {
+        batch.time_us = times;
+        batch.size = sizes;
+        batch.track_id = tracks;
+        required = sample_ring_batch_required(ring, &batch, track, start);
+    }
+    if (tracks) env->ReleasePrimitiveArrayCritical(trackId, tracks, JNI_ABORT);
+    if (sizes) env->ReleasePrimitiveArrayCritical(size, sizes, JNI_ABORT);
+    if (times) env->ReleasePrimitiveArrayCritical(timeUs, times, JNI_ABORT);
+
+    return sample_ring_wait_writable(ring, required, timeoutMs > 0 ? timeoutMs : 0);
+}
+
+/**
+ * nativeAwaitWritable로 대기 중인 디먹스 스레드를 깨움 (대기 중이 아니면 다음 대기가 바로 반환)
+ */
+DEMUXER_FUNC(void, nativeInterrupt, jlong ringPtr) {
+    if (ringPtr) {
+        sample_ring_interrupt((SampleRing*)ringPtr);
+    }
+}
+
+/**
+ * 해제 전에 호출하여 이후의 모든 대기를 바로 반환시킴
+ */
+DEMUXER_FUNC(void, nativeClose, jlong ringPtr) {
+    if (ringPtr) {
+        sample_ring_close((SampleRing*)ringPtr);
+    }
+}
+
+/**
+ * 배치 중 start 이후 trackId 트랙의 샘플을 들어가는 데까지 링에 씀
+ * 페이로드는 배치의 direct 버퍼에서 링으로 한 번만 복사된다. 링에 한 번에 들어가지 않으면
+ * 들어간 샘플까지만 공개하고 다음 위치를 돌려주므로, 호출자가 링이 비워진 뒤 이어서 쓴다.
+ * @return 다음에 쓸 샘플 위치 (모두 썼으면 배치 크기), 링이 해제되었으면 -1
+ */
+DEMUXER_FUNC(jint, nativeWriteBatch, jlong ringPtr, jobject data, jlongArray timeUs,
+             jlongArray decodeTimeUs, jlongArray durationUs, jintArray offset, jintArray size,
+             jintArray flags, jintArray trackId, jint track, jint start) {
+    SampleRing* ring = (SampleRing*)ringPtr;
+    const uint8_t* payload = ring ? (const uint8_t*)env->GetDirectBufferAddress(data) : nullptr;
+    if (!payload) {
+        return -1;
+    }
+    SampleRingBatch batch;
+    batch.count = env->GetArrayLength(timeUs);
+    batch.payload = payload;
+    batch.payload_size = env->GetDirectBufferCapacity(data);
+
+    jlong* times = (jlong*)env->GetPrimitiveArrayCritical(timeUs, nullptr);
+    jlong* decode_times = (jlong*)env->GetPrimitiveArrayCritical(decodeTimeUs, nullptr);
+    jlong* durations = (jlong*)env->GetPrimitiveArrayCritical(durationUs, nullptr);
+    jint* offsets = (jint*)env->GetPrimitiveArrayCritical(offset, nullptr);
+    jint* sizes = (jint*)env->GetPrimitiveArrayCritical(size, nullptr);
+    jint* sample_flags = (jint*)env->GetPrimitiveArrayCritical(flags, nullptr);
+    jint* tracks = (jint*)env->GetPrimitiveArrayCritical(trackId, nullptr);
+    int next = -1;
+    int dropped = 0;
+    if (times && decode_times && durations && offsets && sizes && sample_flags && tracks) {
+        batch.time_us = times;
+        batch.decode_time_us = decode_times;
+        batch.duration_us = durations;
+        batch.offset = offsets;
+        batch.size = sizes;
+        batch.flags = sample_flags;
+        batch.track_id = tracks;
+        next = sample_ring_write_batch(ring, &batch, track, start, &dropped);
+    }
+    if (tracks) env->ReleasePrimitiveArrayCritical(trackId, tracks, JNI_ABORT);
+    if (sample_flags) env->ReleasePrimitiveArrayCritical(flags, sample_flags, JNI_ABORT);
+    if (sizes) env->ReleasePrimitiveArrayCritical(size, sizes, JNI_ABORT);
+    if (offsets) env->ReleasePrimitiveArrayCritical(offset, offsets, JNI_ABORT);
+    if (durations) env->ReleasePrimitiveArrayCritical(durationUs, durations, JNI_ABORT);
+    if (decode_times) env->ReleasePrimitiveArrayCritical(decodeTimeUs, decode_times, JNI_ABORT);
+    if (times) env->ReleasePrimitiveArrayCritical(timeUs, times, JNI_ABORT);
+
+    if (dropped > 0) {
+        LOGE("Dropped %d samples of track %d larger than the sample ring", dropped, track);
+    }
+    return next;
+}
+
+/**
+ * 다음 샘플의 메타데이터를 meta에 채움 (꺼내지 않음)
+ * @return 비어 있으면 false
+ */
+DEMUXER_FUNC(jboolean, nativePeek, jlong ringPtr, jlongArray meta) {
+    SampleRing* ring = (SampleRing*)ringPtr;
+    const SampleRingRecord* record = ring ? sample_ring_peek(ring) : nullptr;
+    if (!record) {
+        return JNI_FALSE;
+    }
+    jlong values[RING_META_COUNT];
+    values[RING_META_TIME_US] = record->time_us;
+    values[RING_META_DECODE_TIME_US] = record->decode_time_us;
+    values[RING_META_DURATION_US] = record->duration_us;
+    values[RING_META_SIZE] = record->size;
+    values[RING_META_FLAGS] = record->flags;
+    env->SetLongArrayRegion(meta, 0, RING_META_COUNT, values);
+    return JNI_TRUE;
+}
+
+/**
+ * 다음 샘플의 페이로드를 direct 버퍼의 position 위치로 복사
+ * @param advance true면 복사 후 샘플을 꺼냄
+ * @return 비어 있거나 대상 공간이 모자라면 false
+ */
+DEMUXER_FUNC(jboolean, nativeRead, jlong ringPtr, jobject target, jint position,
+             jboolean advance) {
+    SampleRing* ring = (SampleRing*)ringPtr;
+    const SampleRingRecord* record = ring ? sample_ring_peek(ring) : nullptr;
+    if (!record) {
+        return JNI_FALSE;
+    }
+    uint8_t* dst = (uint8_t*)env->GetDirectBufferAddress(target);
+    jlong capacity = env->GetDirectBufferCapacity(target);
+    if (!dst || position < 0 || (jlong)position + record->size > capacity) {
+        return JNI_FALSE;
+    }
+    memcpy(dst + position, record + 1, (size_t)record->size);
+    if (advance) {
+        sample_ring_pop(ring);
+    }
+    return JNI_TRUE;
+}
+
+/**
+ * 다음 샘플의 페이로드를 바이트 배열로 복사 (디코더 버퍼가 힙 버퍼인 경우)
+ */
+DEMUXER_FUNC(jboolean, nativeReadToArray, jlong ringPtr, jbyteArray target, jint offset,
+             jboolean advance) {
+    SampleRing* ring = (SampleRing*)ringPtr;
+    const SampleRingRecord* record = ring ? sample_ring_peek(ring) : nullptr;
+    if (!record) {
+        return JNI_FALSE;
+    }
+    if (offset < 0 || (jlong)offset + record->size > env->GetArrayLength(target)) {
+        return JNI_FALSE;
+    }
+    env->SetByteArrayRegion(target, offset, record->size, (const jbyte*)(record + 1));
+    if (advance) {
+        sample_ring_pop(ring);
+    }
+    return JNI_TRUE;
+}
+
+DEMUXER_FUNC(void, nativeSkip, jlong ringPtr) {
+    if (ringPtr) {
+        sample_ring_pop((SampleRing*)ringPtr);
+    }
+}
+
+DEMUXER_FUNC(void, nativeClear, jlong ringPtr) {
+    if (ringPtr) {
+        sample_ring_clear((SampleRing*)ringPtr);
+    }
+}
+
+DEMUXER_FUNC(jint, nativeGetSampleCount, jlong ringPtr) {
+    return ringPtr ? ((SampleRing*)ringPtr)->count.load() : 0;
+}
+
+DEMUXER_FUNC(jlong, nativeGetUsedBytes, jlong ringPtr) {
+    return ringPtr ? (jlong)sample_ring_used((SampleRing*)ringPtr) : 0;
+}
+
+DEMUXER_FUNC(jlong, nativeGetBufferedUs, jlong ringPtr) {
+    return ringPtr ? (jlong)sample_ring_buffered_us((SampleRing*)ringPtr) : 0;
+}
+
+DEMUXER_FUNC(jlong, nativeGetWakeupCount, jlong ringPtr) {
+    return ringPtr ? (jlong)((SampleRing*)ringPtr)->wakeups.load() : 0;
+}
+
+// ===== 플레이어 메모리 예산 (BufferBudget) =====
+
+/**
+ * 메모리 예산 생성
+ * @param limitBytes 전체 한도
+ * @param inputLimitBytes 입력 한도 (push FIFO와 병렬 디먹스 풀 합계)
+ * @return 예산 포인터 (0이면 실패)
+ */
+DEMUXER_FUNC(jlong, nativeCreateBudget, jlong limitBytes, jlong inputLimitBytes) {
+    MemoryBudget* budget = memory_budget_create(limitBytes, inputLimitBytes);
+    if (!budget) {
+        LOGE("Failed to create memory budget: %lld bytes", (long long)limitBytes);
+    }
+    return (jlong)budget;
+}
+
+DEMUXER_FUNC(void, nativeReleaseBudget, jlong budget) {
+    memory_budget_destroy((MemoryBudget*)budget);
+}
+
+/**
+ * Kotlin 쪽 버퍼(세그먼트 수신 버퍼 등)의 사용량 설정
+ */
+DEMUXER_FUNC(void, nativeSetUsage, jlong budget, jint category, jlong bytes) {
+    if (category >= 0 && category < MEMORY_BUDGET_CATEGORY_COUNT) {
+        memory_budget_set((MemoryBudget*)budget, category, bytes);
+    }
+}
+
+/**
+ * 사용량 조회
+ * @param category MemoryBudgetCategory, 음수면 전체
+ */
+DEMUXER_FUNC(jlong, nativeGetUsage, jlong budget, jint category) {
+    if (category < 0) {
+        return memory_budget_total((MemoryBudget*)budget);
+    }
+    return category < MEMORY_BUDGET_CATEGORY_COUNT
+               ? memory_budget_used((MemoryBudget*)budget, category) : 0;
+}
+
+DEMUXER_FUNC(jlong, nativeGetPeakUsage, jlong budget) {
+    return budget ? ((MemoryBudget*)budget)->peak.load() : 0;
+}
+
+// 네이티브 메서드 등록 테이블 (BufferBudget의 external 선언과 일치해야 함)
+static const JNINativeMethod kBufferBudgetMethods[] = {
+    {"nativeCreateBudget", "(JJ)J", (void*)nativeCreateBudget},
+    {"nativeReleaseBudget", "(J)V", (void*)nativeReleaseBudget},
+    {"nativeSetUsage", "(JIJ)V", (void*)nativeSetUsage},
+    {"nativeGetUsage", "(JI)J", (void*)nativeGetUsage},
+    {"nativeGetPeakUsage", "(J)J", (void*)nativeGetPeakUsage},
+};
+
+// 네이티브 메서드 등록 테이블 (SampleRingBuffer의 external 선언과 일치해야 함)
+static const JNINativeMethod kSampleRingMethods[] = {
+    {"nativeCreateRing", "(IJ)J", (void*)nativeCreateRing},
+    {"nativeReleaseRing", "(J)V", (void*)nativeReleaseRing},
+    {"nativeSetWatermarks", "(JJJJ)V", (void*)nativeSetWatermarks},
+    {"nativeCanWrite", "(J[J[I[III)Z", (void*)nativeCanWrite},
+    {"nativeAwaitWritable", "(J[J[I[IIII)I", (void*)nativeAwaitWritable},
+    {"nativeInterrupt", "(J)V", (void*)nativeInterrupt},
+    {"nativeClose", "(J)V", (void*)nativeClose},
+    {"nativeWriteBatch", "(JLjava/nio/ByteBuffer;[J[J[J[I[I[I[III)I", (void*)nativeWriteBatch},
+    {"nativePeek", "(J[J)Z", (void*)nativePeek},
+    {"nativeRead", "(JLjava/nio/ByteBuffer;IZ)Z", (void*)nativeRead},
+    {"nativeReadToArray", "(J[BIZ)Z", (void*)nativeReadToArray},
+    {"nativeSkip", "(J)V", (void*)nativeSkip},
+    {"nativeClear", "(J)V", (void*)nativeClear},
+    {"nativeGetSampleCount", "(J)I", (void*)nativeGetSampleCount},
+    {"nativeGetUsedBytes", "(J)J", (void*)nativeGetUsedBytes},
+    {"nativeGetBufferedUs", "(J)J", (void*)nativeGetBufferedUs},
+    {"nativeGetWakeupCount", "(J)J", (void*)nativeGetWakeupCount},
+};
+
+// 네이티브 메서드 등록 테이블 (FfmpegDemuxer의 external 선언과 일치해야 함)
+static const JNINativeMethod kDemuxerMethods[] = {
+    {"nativeInit", "()J", (void*)nativeInit},
+    {"nativeProbeSegment", "(J[B)[L" TRACK_FORMAT_CLASS ";", (void*)nativeProbeSegment},
+    {"nativeProbeSegmentDirect", "(JLjava/nio/ByteBuffer;II)[L" TRACK_FORMAT_CLASS ";",
+     (void*)nativeProbeSegmentDirect},
+    {"nativeDemuxSegment", "(J[B)L" SAMPLE_BATCH_CLASS ";", (void*)nativeDemuxSegment},
+    {"nativeDemuxSessionSegment", "(J[B)L" SAMPLE_BATCH_CLASS ";",
+     (void*)nativeDemuxSessionSegment},
+    {"nativeDemuxSegmentDirect", "(JLjava/nio/ByteBuffer;II)L" SAMPLE_BATCH_CLASS ";",
+     (void*)nativeDemuxSegmentDirect},
+    {"nativeDemuxSegmentToSink", "(JLjava/nio/ByteBuffer;IIL" SAMPLE_SINK_CLASS ";)I",
+     (void*)nativeDemuxSegmentToSink},
+    {"nativeSetDecryption", "(JI[B[B)Z", (void*)nativeSetDecryption},
+    {"nativeSetSelectedTracks", "(J[I)V", (void*)nativeSetSelectedTracks},
+    {"nativeSetMemoryBudget", "(JJ)V", (void*)nativeSetMemoryBudget},
+    {"nativeStartPush", "(J)V", (void*)nativeStartPush},
+    {"nativeFeed", "(J[BII)Z", (void*)nativeFeed},
+    {"nativeFeedDirect", "(JLjava/nio/ByteBuffer;II)Z", (void*)nativeFeedDirect},
+    {"nativeEndSegment", "(J)V", (void*)nativeEndSegment},
+    {"nativeDrainSamples", "(JL" SAMPLE_SINK_CLASS ";)I", (void*)nativeDrainSamples},
+    {"nativeCancelPush", "(J)V", (void*)nativeCancelPush},
+    {"nativeStartPool", "(JI)I", (void*)nativeStartPool},
+    {"nativeSubmitSegment", "(JLjava/nio/ByteBuffer;IIZ)J", (void*)nativeSubmitSegment},
+    {"nativeDrainPooledSegment", "(JL" SAMPLE_SINK_CLASS ";)I", (void*)nativeDrainPooledSegment},
+    {"nativeCancelPool", "(J)V", (void*)nativeCancelPool},
+    {"nativeResetPool", "(J)V", (void*)nativeResetPool},
+    {"nativeSeekPush", "(JJJ)Z", (void*)nativeSeekPush},
+    {"nativeGetKeyframeIndex", "(J)[J", (void*)nativeGetKeyframeIndex},
+    {"nativeResetSession", "(J)V", (void*)nativeResetSession},
+    {"nativeRelease", "(J)V", (void*)nativeRelease},
+    {"nativeGetVersion", "()Ljava/lang/String;", (void*)nativeGetVersion},
+};
+
+// 클래스의 네이티브 메서드 등록
+static bool register_natives(JNIEnv* env, const char* class_name,
+                             const JNINativeMethod* methods, int count) {
+    jclass clazz = env->FindClass(class_name);
+    if (!clazz) {
+        LOGE("JNI_OnLoad: FindClass failed: %s", class_name);
+        return false;
+    }
+    jint ret = env->RegisterNatives(clazz, methods, count);
+    env->DeleteLocalRef(clazz);
+    if (ret != JNI_OK) {
+        LOGE("JNI_OnLoad: RegisterNatives failed: %s", class_name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 라이브러리 로드 시 JNI 참조 캐시와 네이티브 메서드 등록
+ */
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
+    JNIEnv* env;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
+        LOGE("JNI_OnLoad: GetEnv failed");
+        return JNI_ERR;
+    }
+    if (!init_jni_cache(env)) {
+        LOGE("JNI_OnLoad: failed to resolve JNI references");
+        return JNI_ERR;
+    }
+
+    if (!register_natives(env, DEMUXER_CLASS, kDemuxerMethods,
+                          sizeof(kDemuxerMethods) / sizeof(kDemuxerMethods[0])) ||
+        !register_natives(env, SAMPLE_RING_CLASS, kSampleRingMethods,
+                          sizeof(kSampleRingMethods) / sizeof(kSampleRingMethods[0])) ||
+        !register_natives(env, BUFFER_BUDGET_CLASS, kBufferBudgetMethods,
+                          sizeof(kBufferBudgetMethods) / sizeof(kBufferBudgetMethods[0]))) {
+        return JNI_ERR;
+    }
+    return JNI_VERSION_1_6;
 }
@@ -0,0 +1,223 @@
+/*
+ * H.264 SPS/VUI 파서 구현 (ITU-T H.264 7.3.2.1.1, E.1.1)
+ */
+#include "h264_parser.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "bit_reader.h"
+
+static const int H264_NAL_TYPE_SPS = 7;
+
+// aspect_ratio_idc 1~16에 대응하는 SAR (Table E-1)
+static const int kAspectRatios[17][2] = {
+    {0, 0}, {1, 1}, {12, 11}, {10, 11}, {16, 11}, {40, 33}, {24, 11}, {20, 11}, {32, 11},
+    {80, 33}, {18, 11}, {15, 11}, {64, 33}, {160, 99}, {4, 3}, {3, 2}, {2, 1},
+};
+static const int ASPECT_RATIO_EXTENDED_SAR = 255;
+
+// chroma_format_idc 등 추가 필드를 가지는 High 계열 프로파일
+static bool has_chroma_info(int profile_idc) {
+    switch (profile_idc) {
+        case 100: case 110: case 122: case 244: case 44:
+        case 83: case 86: case 118: case 128: case 138:
+        case 139: case 134: case 135:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void skip_scaling_list(BitReader* br, int size) {
+    int last_scale = 8;
+    int next_scale = 8;
+    for (int i = 0; i < size; i++) {
+        if (next_scale != 0) {
+            int delta_scale = read_se(br);
+            next_scale = (last_scale + delta_scale + 256) % 256;
+        }
+        last_scale = next_scale == 0 ? last_scale : next_scale;
+    }
+}
+
+static void skip_hrd_parameters(BitReader* br) {
+    uint32_t cpb_cnt = read_ue(br) + 1;
+    skip_bits(br, 4);  // bit_rate_scale
+    skip_bits(br, 4);  // cpb_size_scale
+    for (uint32_t i = 0; i < cpb_cnt && !br->overflow; i++) {
+        read_ue(br);   // bit_rate_value_minus1
+        read_ue(br);   // cpb_size_value_minus1
+        skip_bits(br, 1);  // cbr_flag
+    }
+    // initial_cpb_removal_delay_length_minus1, cpb_removal_delay_length_minus1,
+    // dpb_output_delay_length_minus1, time_offset_length
+    skip_bits(br, 5 * 3 + 5);
+}
+
+static void parse_vui(BitReader* br, H264SpsInfo* out) {
+    if (read_bit(br)) {  // aspect_ratio_info_present_flag
+        int aspect_ratio_idc = read_bits(br, 8);
+        if (aspect_ratio_idc == ASPECT_RATIO_EXTENDED_SAR) {
+            out->sar_width = read_bits(br, 16);
+            out->sar_height = read_bits(br, 16);
+        } else if (aspect_ratio_idc > 0 && aspect_ratio_idc <= 16) {
+            out->sar_width = kAspectRatios[aspect_ratio_idc][0];
+            out->sar_height = kAspectRatios[aspect_ratio_idc][1];
+        }
+    }
+    if (read_bit(br)) {  // overscan_info_present_flag
+        skip_bits(br, 1);
+    }
+    if (read_bit(br)) {  // video_signal_type_present_flag
+        skip_bits(br, 3 + 1);  // video_format, video_full_range_flag
+        if (read_bit(br)) {    // colour_description_present_flag
+            skip_bits(br, 8 * 3);
+        }
+    }
+    if (read_bit(br)) {  // chroma_loc_info_present_flag
+        read_ue(br);
+        read_ue(br);
+    }
+    if (read_bit(br)) {  // timing_info_present_flag
+        out->num_units_in_tick = read_bits(br, 32);
+        out->time_scale = read_bits(br, 32);
+        out->fixed_frame_rate = read_bit(br) != 0;
+    }
+    bool nal_hrd = read_bit(br) != 0;
+    if (nal_hrd) {
+        skip_hrd_parameters(br);
+    }
+    bool vcl_hrd = read_bit(br) != 0;
+    if (vcl_hrd) {
+        skip_hrd_parameters(br);
+    }
+    if (nal_hrd || vcl_hrd) {
+        skip_bits(br, 1);  // low_delay_hrd_flag
+    }
+    skip_bits(br, 1);  // pic_struct_present_flag
+    if (read_bit(br)) {  // bitstream_restriction_flag
+        skip_bits(br, 1);  // motion_vectors_over_pic_boundaries_flag
+        read_ue(br);  // max_bytes_per_pic_denom
+        read_ue(br);  // max_bits_per_mb_denom
+        read_ue(br);  // log2_max_mv_length_horizontal
+        read_ue(br);  // log2_max_mv_length_vertical
+        out->max_num_reorder_frames = (int)read_ue(br);
+        out->max_dec_frame_buffering = (int)read_ue(br);
+    }
+}
+
+bool parse_h264_sps(const uint8_t* nal, int size, H264SpsInfo* out) {
+    if (!nal || size < 4 || (nal[0] & 0x1F) != H264_NAL_TYPE_SPS) {
+        return false;
+    }
+
+    std::vector<uint8_t> rbsp;
+    nal_to_rbsp(nal + 1, size - 1, &rbsp);
+    BitReader br;
+    bit_reader_init(&br, rbsp.data(), rbsp.size());
+
+    memset(out, 0, sizeof(*out));
+    out->sar_width = 1;
+    out->sar_height = 1;
+    out->max_num_reorder_frames = -1;
+    out->max_dec_frame_buffering = -1;
+    out->chroma_format_idc = 1;
+
+    out->profile_idc = read_bits(&br, 8);
+    out->constraint_flags = read_bits(&br, 8);
+    out->level_idc = read_bits(&br, 8);
+    read_ue(&br);  // seq_parameter_set_id
+
+    bool separate_colour_plane = false;
+    if (has_chroma_info(out->profile_idc)) {
+        out->chroma_format_idc = read_ue(&br);
+        if (out->chroma_format_idc == 3) {
+            separate_colour_plane = read_bit(&br) != 0;
+        }
+        read_ue(&br);  // bit_depth_luma_minus8
+        read_ue(&br);  // bit_depth_chroma_minus8
+        skip_bits(&br, 1);  // qpprime_y_zero_transform_bypass_flag
+        if (read_bit(&br)) {  // seq_scaling_matrix_present_flag
+            int list_count = out->chroma_format_idc != 3 ? 8 : 12;
+            for (int i = 0; i < list_count; i++) {
+                if (read_bit(&br)) {
+                    skip_scaling_list(&br, i < 6 ? 16 : 64);
+                }
+            }
+        }
+    }
+
+    read_ue(&br);  // log2_max_frame_num_minus4
+    uint32_t pic_order_cnt_type = read_ue(&br);
+    if (pic_order_cnt_type == 0) {
+        read_ue(&br);  // log2_max_pic_order_cnt_lsb_minus4
+    } else if (pic_order_cnt_type == 1) {
+        skip_bits(&br, 1);  // delta_pic_order_always_zero_flag
+        read_se(&br);  // offset_for_non_ref_pic
+        read_se(&br);  // offset_for_top_to_bottom_field
+        uint32_t cycle = read_ue(&br);
+        for (uint32_t i = 0; i < cycle && !br.overflow; i++) {
+            read_se(&br);
+        }
+    }
+    read_ue(&br);  // max_num_ref_frames
+    skip_bits(&br, 1);  // gaps_in_frame_num_value_allowed_flag
+
+    uint32_t pic_width_in_mbs = read_ue(&br) + 1;
+    uint32_t pic_height_in_map_units = read_ue(&br) + 1;
+    bool frame_mbs_only = read_bit(&br) != 0;
+    if (!frame_mbs_only) {
+        skip_bits(&br, 1);  // mb_adaptive_frame_field_flag
+    }
+    skip_bits(&br, 1);  // direct_8x8_inference_flag
+
+    int width = (int)pic_width_in_mbs * 16;
+    int height = (2 - (frame_mbs_only ? 1 : 0)) * (int)pic_height_in_map_units * 16;
+
+    if (read_bit(&br)) {  // frame_cropping_flag
+        uint32_t crop_left = read_ue(&br);
+        uint32_t crop_right = read_ue(&br);
+        uint32_t crop_top = read_ue(&br);
+        uint32_t crop_bottom = read_ue(&br);
+
+        int chroma_array_type = separate_colour_plane ? 0 : out->chroma_format_idc;
+        int crop_unit_x = 1;
+        int crop_unit_y = 2 - (frame_mbs_only ? 1 : 0);
+        if (chroma_array_type != 0) {
+            crop_unit_x = chroma_array_type == 3 ? 1 : 2;
+            crop_unit_y *= chroma_array_type == 1 ? 2 : 1;
+        }
+        width -= crop_unit_x * (int)(crop_left + crop_right);
+        height -= crop_unit_y * (int)(crop_top + crop_bottom);
+    }
+    out->width = width;
+    out->height = height;
+    if (br.overflow || out->width <= 0 || out->height <= 0) {
+        return false;
+    }
+
+    if (read_bit(&br)) {  // vui_parameters_present_flag
+        parse_vui(&br, out);
+        if (br.overflow) {
+            // VUI가 잘려 있으면 해상도만 사용
+            out->sar_width = 1;
+            out->sar_height = 1;
+            out->num_units_in_tick = 0;
+            out->time_scale = 0;
+            out->max_num_reorder_frames = -1;
+            out->max_dec_frame_buffering = -1;
+        }
+    }
+
+    if (out->num_units_in_tick > 0 && out->time_scale > 0) {
+        // H.264 tick은 필드 단위이므로 프레임레이트는 time_scale / (2 * num_units_in_tick)
+        out->frame_rate = (float)out->time_scale / (2.0f * (float)out->num_units_in_tick);
+    }
+    // bitstream_restriction이 없어도 B 프레임이 없는 Baseline 계열은 재정렬이 없다
+    if (out->max_num_reorder_frames < 0 && out->profile_idc == 66) {
+        out->max_num_reorder_frames = 0;
+    }
+    return true;
+}
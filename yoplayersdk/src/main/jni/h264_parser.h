@@ -0,0 +1,37 @@
+/*
+ * H.264 SPS/VUI 파서
+ *
+ * 디코더를 처음부터 올바른 크기로 설정할 수 있도록 SPS에서 해상도(크롭 반영), 프로파일/레벨,
+ * 화소 종횡비, 프레임레이트, 재정렬 깊이를 읽는다.
+ */
+#ifndef YOPLAYER_H264_PARSER_H
+#define YOPLAYER_H264_PARSER_H
+
+#include <stdint.h>
+
+struct H264SpsInfo {
+    int profile_idc;
+    int constraint_flags;       // constraint_set0~5_flag + reserved 비트 (codecs 문자열용)
+    int level_idc;
+    int chroma_format_idc;
+    int width;                  // 크롭 적용 후 표시 크기
+    int height;
+    int sar_width;              // 화소 종횡비 (VUI 없으면 1:1)
+    int sar_height;
+    uint32_t num_units_in_tick;  // VUI timing (없으면 0)
+    uint32_t time_scale;
+    bool fixed_frame_rate;
+    float frame_rate;           // time_scale / (2 * num_units_in_tick), 알 수 없으면 0
+    int max_num_reorder_frames;  // 알 수 없으면 -1
+    int max_dec_frame_buffering;  // 알 수 없으면 -1
+};
+
+/**
+ * SPS NAL 유닛 파싱
+ * @param nal NAL 헤더 바이트부터 시작하는 SPS (시작 코드 제외, 에뮬레이션 방지 바이트 포함)
+ * @param size NAL 유닛 크기
+ * @return 파싱 성공 여부
+ */
+bool parse_h264_sps(const uint8_t* nal, int size, H264SpsInfo* out);
+
+#endif  // YOPLAYER_H264_PARSER_H
@@ -0,0 +1,211 @@
+/*
+ * HEVC 파라미터 셋 추출 및 hvcC 생성 구현 (ITU-T H.265 7.3.2.2, ISO/IEC 14496-15 8.3.3)
+ */
+#include "hevc_parser.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bit_reader.h"
+#include "nal_scanner.h"
+
+static const int HEVC_NAL_TYPE_VPS = 32;
+static const int HEVC_NAL_TYPE_SPS = 33;
+static const int HEVC_NAL_TYPE_PPS = 34;
+static const int HEVC_NAL_HEADER_SIZE = 2;
+
+static int hevc_nal_type(const uint8_t* nal) {
+    return (nal[0] >> 1) & 0x3F;
+}
+
+bool find_hevc_parameter_sets(const uint8_t* data, int size,
+                              const uint8_t** vps, int* vps_size,
+                              const uint8_t** sps, int* sps_size,
+                              const uint8_t** pps, int* pps_size) {
+    *vps = nullptr;
+    *sps = nullptr;
+    *pps = nullptr;
+    *vps_size = 0;
+    *sps_size = 0;
+    *pps_size = 0;
+
+    std::vector<NalUnit> units;
+    find_nal_units(data, size, &units);
+    for (size_t i = 0; i < units.size(); i++) {
+        const NalUnit& unit = units[i];
+        if (unit.size < HEVC_NAL_HEADER_SIZE) {
+            continue;
+        }
+        int nal_type = hevc_nal_type(unit.data);
+        if (nal_type == HEVC_NAL_TYPE_VPS && *vps == nullptr) {
+            *vps = unit.data;
+            *vps_size = unit.size;
+        } else if (nal_type == HEVC_NAL_TYPE_SPS && *sps == nullptr) {
+            *sps = unit.data;
+            *sps_size = unit.size;
+        } else if (nal_type == HEVC_NAL_TYPE_PPS && *pps == nullptr) {
+            *pps = unit.data;
+            *pps_size = unit.size;
+        }
+        if (*vps && *sps && *pps) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_hevc_sps(const uint8_t* nal, int size, HevcSpsInfo* out) {
+    if (!nal || size <= HEVC_NAL_HEADER_SIZE || hevc_nal_type(nal) != HEVC_NAL_TYPE_SPS) {
+        return false;
+    }
+
+    std::vector<uint8_t> rbsp;
+    nal_to_rbsp(nal + HEVC_NAL_HEADER_SIZE, size - HEVC_NAL_HEADER_SIZE, &rbsp);
+    BitReader br;
+    bit_reader_init(&br, rbsp.data(), rbsp.size());
+
+    memset(out, 0, sizeof(*out));
+
+    skip_bits(&br, 4);  // sps_video_parameter_set_id
+    int max_sub_layers_minus1 = read_bits(&br, 3);
+    out->max_sub_layers = max_sub_layers_minus1 + 1;
+    out->temporal_id_nesting = read_bit(&br) != 0;
+
+    // profile_tier_level(1, sps_max_sub_layers_minus1)
+    out->general_profile_space = read_bits(&br, 2);
+    out->general_tier_flag = read_bit(&br);
+    out->general_profile_idc = read_bits(&br, 5);
+    out->general_profile_compatibility_flags = read_bits(&br, 32);
+    for (int i = 0; i < 6; i++) {
+        out->general_constraint_indicator_flags[i] = (uint8_t)read_bits(&br, 8);
+    }
+    out->general_level_idc = read_bits(&br, 8);
+
+    bool sub_layer_profile_present[8] = {false};
+    bool sub_layer_level_present[8] = {false};
+    for (int i = 0; i < max_sub_layers_minus1; i++) {
+        sub_layer_profile_present[i] = read_bit(&br) != 0;
+        sub_layer_level_present[i] = read_bit(&br) != 0;
+    }
+    if (max_sub_layers_minus1 > 0) {
+        skip_bits(&br, 2 * (8 - max_sub_layers_minus1));  // reserved_zero_2bits
+    }
+    for (int i = 0; i < max_sub_layers_minus1; i++) {
+        if (sub_layer_profile_present[i]) {
+            skip_bits(&br, 88);
+        }
+        if (sub_layer_level_present[i]) {
+            skip_bits(&br, 8);
+        }
+    }
+
+    read_ue(&br);  // sps_seq_parameter_set_id
+    out->chroma_format_idc = (int)read_ue(&br);
+    bool separate_colour_plane = false;
+    if (out->chroma_format_idc == 3) {
+        separate_colour_plane = read_bit(&br) != 0;
+    }
+    int width = (int)read_ue(&br);   // pic_width_in_luma_samples
+    int height = (int)read_ue(&br);  // pic_height_in_luma_samples
+
+    if (read_bit(&br)) {  // conformance_window_flag
+        uint32_t left = read_ue(&br);
+        uint32_t right = read_ue(&br);
+        uint32_t top = read_ue(&br);
+        uint32_t bottom = read_ue(&br);
+        int chroma_array_type = separate_colour_plane ? 0 : out->chroma_format_idc;
+        int sub_width_c = (chroma_array_type == 1 || chroma_array_type == 2) ? 2 : 1;
+        int sub_height_c = chroma_array_type == 1 ? 2 : 1;
+        width -= sub_width_c * (int)(left + right);
+        height -= sub_height_c * (int)(top + bottom);
+    }
+    out->width = width;
+    out->height = height;
+
+    out->bit_depth_luma = (int)read_ue(&br) + 8;
+    out->bit_depth_chroma = (int)read_ue(&br) + 8;
+    read_ue(&br);  // log2_max_pic_order_cnt_lsb_minus4
+
+    bool ordering_info_present = read_bit(&br) != 0;
+    out->max_num_reorder_pics = 0;
+    for (int i = ordering_info_present ? 0 : max_sub_layers_minus1;
+         i <= max_sub_layers_minus1 && !br.overflow; i++) {
+        read_ue(&br);  // sps_max_dec_pic_buffering_minus1
+        out->max_num_reorder_pics = (int)read_ue(&br);
+        read_ue(&br);  // sps_max_latency_increase_plus1
+    }
+
+    return !br.overflow && out->width > 0 && out->height > 0;
+}
+
+static void put_u16(std::vector<uint8_t>* out, int value) {
+    out->push_back((uint8_t)(value >> 8));
+    out->push_back((uint8_t)value);
+}
+
+static void put_nal_array(std::vector<uint8_t>* out, int nal_type,
+                          const uint8_t* nal, int size) {
+    out->push_back((uint8_t)(0x80 | nal_type));  // array_completeness = 1
+    put_u16(out, 1);                             // numNalus
+    put_u16(out, size);
+    out->insert(out->end(), nal, nal + size);
+}
+
+void build_hevc_hvcc(const uint8_t* vps, int vps_size,
+                     const uint8_t* sps, int sps_size,
+                     const uint8_t* pps, int pps_size,
+                     const HevcSpsInfo& info, std::vector<uint8_t>* out) {
+    out->clear();
+    out->reserve(23 + 3 * 5 + vps_size + sps_size + pps_size);
+
+    out->push_back(1);  // configurationVersion
+    out->push_back((uint8_t)((info.general_profile_space << 6) |
+                             (info.general_tier_flag << 5) |
+                             info.general_profile_idc));
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out->push_back((uint8_t)(info.general_profile_compatibility_flags >> shift));
+    }
+    out->insert(out->end(), info.general_constraint_indicator_flags,
+                info.general_constraint_indicator_flags + 6);
+    out->push_back((uint8_t)info.general_level_idc);
+    put_u16(out, 0xF000);  // min_spatial_segmentation_idc = 0
+    out->push_back(0xFC);  // parallelismType = 0
+    out->push_back((uint8_t)(0xFC | (info.chroma_format_idc & 0x03)));
+    out->push_back((uint8_t)(0xF8 | ((info.bit_depth_luma - 8) & 0x07)));
+    out->push_back((uint8_t)(0xF8 | ((info.bit_depth_chroma - 8) & 0x07)));
+    put_u16(out, 0);  // avgFrameRate
+    // constantFrameRate(2) = 0, numTemporalLayers(3), temporalIdNested(1), lengthSizeMinusOne(2) = 3
+    out->push_back((uint8_t)(((info.max_sub_layers & 0x07) << 3) |
+                             ((info.temporal_id_nesting ? 1 : 0) << 2) | 0x03));
+    out->push_back(3);  // numOfArrays
+
+    put_nal_array(out, HEVC_NAL_TYPE_VPS, vps, vps_size);
+    put_nal_array(out, HEVC_NAL_TYPE_SPS, sps, sps_size);
+    put_nal_array(out, HEVC_NAL_TYPE_PPS, pps, pps_size);
+}
+
+void build_hevc_codec_string(const HevcSpsInfo& info, char* out, size_t out_size) {
+    static const char* kProfileSpaces[] = {"", "A", "B", "C"};
+
+    // 호환성 플래그는 비트 순서를 뒤집어 16진수로 표기
+    uint32_t flags = info.general_profile_compatibility_flags;
+    uint32_t reversed = 0;
+    for (int i = 0; i < 32; i++) {
+        reversed = (reversed << 1) | ((flags >> i) & 1);
+    }
+
+    int written = snprintf(out, out_size, "hvc1.%s%d.%X.%c%d",
+                           kProfileSpaces[info.general_profile_space & 0x03],
+                           info.general_profile_idc, reversed,
+                           info.general_tier_flag ? 'H' : 'L', info.general_level_idc);
+
+    // 제약 플래그는 뒤쪽의 0 바이트를 생략
+    int last = 5;
+    while (last >= 0 && info.general_constraint_indicator_flags[last] == 0) {
+        last--;
+    }
+    for (int i = 0; i <= last && written > 0 && (size_t)written < out_size; i++) {
+        written += snprintf(out + written, out_size - written, ".%02X",
+                            info.general_constraint_indicator_flags[i]);
+    }
+}
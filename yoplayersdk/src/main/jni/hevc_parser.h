@@ -0,0 +1,61 @@
+/*
+ * HEVC 파라미터 셋 추출 및 hvcC 생성
+ *
+ * Annex-B 비트스트림에서 VPS/SPS/PPS(NAL 타입 32~34)를 찾아 SPS의 profile_tier_level과
+ * 해상도를 읽고, ISO/IEC 14496-15 hvcC 레코드와 RFC 6381 코덱 문자열을 만든다.
+ */
+#ifndef YOPLAYER_HEVC_PARSER_H
+#define YOPLAYER_HEVC_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+struct HevcSpsInfo {
+    int general_profile_space;
+    int general_tier_flag;
+    int general_profile_idc;
+    uint32_t general_profile_compatibility_flags;
+    uint8_t general_constraint_indicator_flags[6];
+    int general_level_idc;
+    int max_sub_layers;
+    bool temporal_id_nesting;
+    int chroma_format_idc;
+    int bit_depth_luma;
+    int bit_depth_chroma;
+    int width;                  // conformance window 적용 후 표시 크기
+    int height;
+    int max_num_reorder_pics;   // 최상위 sub-layer 기준
+};
+
+/**
+ * 비트스트림에서 첫 VPS/SPS/PPS NAL 유닛 찾기 (NAL 헤더 포함, 시작 코드 제외)
+ * @return 세 파라미터 셋을 모두 찾았는지 여부
+ */
+bool find_hevc_parameter_sets(const uint8_t* data, int size,
+                              const uint8_t** vps, int* vps_size,
+                              const uint8_t** sps, int* sps_size,
+                              const uint8_t** pps, int* pps_size);
+
+/**
+ * SPS NAL 유닛 파싱 (NAL 헤더부터, 에뮬레이션 방지 바이트 포함)
+ * @return 파싱 성공 여부
+ */
+bool parse_hevc_sps(const uint8_t* nal, int size, HevcSpsInfo* out);
+
+/**
+ * VPS/SPS/PPS로 hvcC(HEVCDecoderConfigurationRecord) 생성
+ * NAL 유닛 길이 필드는 4바이트(lengthSizeMinusOne = 3)로 설정한다.
+ */
+void build_hevc_hvcc(const uint8_t* vps, int vps_size,
+                     const uint8_t* sps, int sps_size,
+                     const uint8_t* pps, int pps_size,
+                     const HevcSpsInfo& info, std::vector<uint8_t>* out);
+
+/**
+ * RFC 6381 코덱 문자열 생성 (예: "hvc1.1.6.L120.90")
+ */
+void build_hevc_codec_string(const HevcSpsInfo& info, char* out, size_t out_size);
+
+#endif  // YOPLAYER_HEVC_PARSER_H
@@ -0,0 +1,87 @@
+/*
+ * 네이티브 버퍼 메모리 예산 구현
+ */
+#include "memory_budget.h"
+
+MemoryBudget* memory_budget_create(int64_t limit, int64_t input_limit) {
+    if (limit <= 0) {
+        return nullptr;
+    }
+    MemoryBudget* budget = new MemoryBudget();
+    budget->limit = limit;
+    budget->input_limit = input_limit > 0 && input_limit < limit ? input_limit : limit;
+    for (int i = 0; i < MEMORY_BUDGET_CATEGORY_COUNT; i++) {
+        budget->used[i].store(0);
+    }
+    budget->peak.store(0);
+    return budget;
+}
+
+void memory_budget_destroy(MemoryBudget* budget) {
+    delete budget;
+}
+
+static void update_peak(MemoryBudget* budget) {
+    int64_t total = memory_budget_total(budget);
+    int64_t peak = budget->peak.load(std::memory_order_relaxed);
+    while (total > peak &&
+           !budget->peak.compare_exchange_weak(peak, total, std::memory_order_relaxed)) {
+    }
+}
+
+void memory_budget_add(MemoryBudget* budget, int category, int64_t delta) {
+    if (!budget || delta == 0) {
+        return;
+    }
+    budget->used[category].fetch_add(delta, std::memory_order_relaxed);
+    if (delta > 0) {
+        update_peak(budget);
+    }
+}
+
+void memory_budget_set(MemoryBudget* budget, int category, int64_t bytes) {
+    if (!budget) {
+        return;
+    }
+    int64_t previous = budget->used[category].exchange(bytes, std::memory_order_relaxed);
+    if (bytes > previous) {
+        update_peak(budget);
+    }
+}
+
+int64_t memory_budget_used(const MemoryBudget* budget, int category) {
+    return budget ? budget->used[category].load(std::memory_order_relaxed) : 0;
+}
+
+int64_t memory_budget_total(const MemoryBudget* budget) {
+    if (!budget) {
+        return 0;
+    }
+    int64_t total = 0;
+    for (int i = 0; i < MEMORY_BUDGET_CATEGORY_COUNT; i++) {
+        total += budget->used[i].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// 디먹싱하면 줄어드는 입력 사용량
+static int64_t input_used(const MemoryBudget* budget) {
+    return memory_budget_used(budget, MEMORY_BUDGET_INPUT) +
+           memory_budget_used(budget, MEMORY_BUDGET_POOL);
+}
+
+bool memory_budget_fits_samples(const MemoryBudget* budget, int64_t required) {
+    if (!budget) {
+        return true;
+    }
+    int64_t used = memory_budget_total(budget) - input_used(budget);
+    return used + required <= budget->limit;
+}
+
+bool memory_budget_fits_input(const MemoryBudget* budget, int64_t required) {
+    if (!budget) {
+        return true;
+    }
+    return input_used(budget) + required <= budget->input_limit &&
+           memory_budget_total(budget) + required <= budget->limit;
+}
@@ -0,0 +1,70 @@
+/*
+ * 플레이어 하나의 네이티브 버퍼 메모리 예산
+ *
+ * 다운로드 중인 세그먼트 버퍼, push 입력 FIFO, 병렬 디먹스 풀, 디먹서 임시 메모리, 트랙별 링에 쌓인 샘플이
+ * 차지하는 바이트를 종류별로 모아 하나의 한도와 비교한다. 각 버퍼는 자기 사용량만 갱신하고, 새로 쌓기 전에
+ * 한도를 확인한다.
+ * 디먹싱하면 줄어드는 입력(FIFO, 병렬 디먹스 풀)은 샘플의 한도 계산에서 빼므로 입력이 한도를 채워도
+ * 디먹싱이 멈추지 않는다.
+ * 모든 함수는 budget이 nullptr이면 아무것도 하지 않는다 (한도 없음).
+ */
+#ifndef YOPLAYER_MEMORY_BUDGET_H
+#define YOPLAYER_MEMORY_BUDGET_H
+
+#include <stdint.h>
+
+#include <atomic>
+
+enum MemoryBudgetCategory {
+    MEMORY_BUDGET_DOWNLOAD = 0,     // 세그먼트 수신 버퍼 (Kotlin direct ByteBuffer)
+    MEMORY_BUDGET_INPUT,            // push 입력 FIFO에서 아직 디먹싱하지 않은 바이트
+    MEMORY_BUDGET_SCRATCH,          // AVIO 버퍼, 패킷 페이로드 풀, 세그먼트 임시 메모리, 출력 청크
+    MEMORY_BUDGET_SAMPLES,          // 트랙별 링에 쌓인 샘플
+    MEMORY_BUDGET_POOL,             // 병렬 디먹스 풀에서 아직 출력하지 않은 세그먼트와 파싱 결과
+    MEMORY_BUDGET_CATEGORY_COUNT,
+};
+
+struct MemoryBudget {
+    int64_t limit;                  // 전체 한도
+    int64_t input_limit;            // 입력(FIFO + 병렬 디먹스 풀) 한도 (전체 한도와 별도로 적용)
+    std::atomic<int64_t> used[MEMORY_BUDGET_CATEGORY_COUNT];
+    std::atomic<int64_t> peak;      // 전체 사용량의 최대값
+};
+
+/**
+ * @param limit 전체 한도 (바이트)
+ * @param input_limit 입력 FIFO와 병렬 디먹스 풀을 합친 한도 (바이트)
+ * @return 실패 시 nullptr
+ */
+MemoryBudget* memory_budget_create(int64_t limit, int64_t input_limit);
+
+void memory_budget_destroy(MemoryBudget* budget);
+
+/**
+ * category 사용량을 delta만큼 바꿈 (해제는 음수)
+ */
+void memory_budget_add(MemoryBudget* budget, int category, int64_t delta);
+
+/**
+ * category 사용량을 bytes로 설정 (사용량을 한 스레드에서만 갱신하는 종류용)
+ */
+void memory_budget_set(MemoryBudget* budget, int category, int64_t bytes);
+
+int64_t memory_budget_used(const MemoryBudget* budget, int category);
+
+/**
+ * 모든 종류의 사용량 합
+ */
+int64_t memory_budget_total(const MemoryBudget* budget);
+
+/**
+ * 샘플 required 바이트를 더 쌓아도 한도 안인지 여부 (입력 FIFO와 병렬 디먹스 풀 제외)
+ */
+bool memory_budget_fits_samples(const MemoryBudget* budget, int64_t required);
+
+/**
+ * 입력 FIFO나 병렬 디먹스 풀에 required 바이트를 더 넣어도 입력 한도와 전체 한도 안인지 여부
+ */
+bool memory_budget_fits_input(const MemoryBudget* budget, int64_t required);
+
+#endif  // YOPLAYER_MEMORY_BUDGET_H
@@ -0,0 +1,155 @@
+/*
+ * Annex-B NAL 유닛 경계 탐색 구현
+ *
+ * 16/32바이트 블록마다 data[i] == 0, data[i+1] == 0, data[i+2] == 1 비교 결과를 AND하여
+ * 시작 코드 후보를 한 번에 판별한다. x86은 AVX2를 런타임에 확인하여 사용하고,
+ * 나머지 구간과 SIMD 미지원 환경은 스칼라로 처리한다.
+ */
+#include "nal_scanner.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#include <immintrin.h>
+#define NAL_SCANNER_X86 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define NAL_SCANNER_NEON 1
+#endif
+
+/**
+ * 스칼라 시작 코드 탐색
+ * data[i+2]가 1보다 크면 i, i+1, i+2 어디에서도 시작 코드가 시작될 수 없으므로 3바이트씩 건너뛴다.
+ */
+static const uint8_t* find_start_code_scalar(const uint8_t* p, const uint8_t* end) {
+    while (p + 2 < end) {
+        if (p[2] > 1) {
+            p += 3;
+        } else if (p[2] == 0) {
+            p++;
+        } else {
+            if (p[0] == 0 && p[1] == 0) {
+                return p;
+            }
+            p += 3;
+        }
+    }
+    return end;
+}
+
+#if defined(NAL_SCANNER_X86)
+
+static const uint8_t* find_start_code_sse2(const uint8_t* p, const uint8_t* end) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    // 블록 시작 i마다 i+2 위치까지 읽으므로 마지막 블록은 18바이트가 필요
+    while (end - p >= 18) {
+        __m128i b0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(p + 1));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(p + 2));
+        __m128i match = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero),
+                                                    _mm_cmpeq_epi8(b1, zero)),
+                                      _mm_cmpeq_epi8(b2, one));
+        int mask = _mm_movemask_epi8(match);
+        if (mask != 0) {
+            return p + __builtin_ctz((unsigned int)mask);
+        }
+        p += 16;
+    }
+    return find_start_code_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static const uint8_t* find_start_code_avx2(const uint8_t* p, const uint8_t* end) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    while (end - p >= 34) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(p + 1));
+        __m256i b2 = _mm256_loadu_si256((const __m256i*)(p + 2));
+        __m256i match = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi8(b0, zero),
+                                                          _mm256_cmpeq_epi8(b1, zero)),
+                                         _mm256_cmpeq_epi8(b2, one));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(match);
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return find_start_code_sse2(p, end);
+}
+
+typedef const uint8_t* (*FindStartCodeFunc)(const uint8_t*, const uint8_t*);
+
+// CPU 기능은 최초 호출 시 한 번만 확인
+static FindStartCodeFunc select_find_start_code() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? find_start_code_avx2 : find_start_code_sse2;
+}
+
+const uint8_t* find_start_code(const uint8_t* data, const uint8_t* end) {
+    static const FindStartCodeFunc impl = select_find_start_code();
+    return impl(data, end);
+}
+
+#elif defined(NAL_SCANNER_NEON)
+
+const uint8_t* find_start_code(const uint8_t* p, const uint8_t* end) {
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const uint8x16_t one = vdupq_n_u8(1);
+    while (end - p >= 18) {
+        uint8x16_t b0 = vld1q_u8(p);
+        uint8x16_t b1 = vld1q_u8(p + 1);
+        uint8x16_t b2 = vld1q_u8(p + 2);
+        uint8x16_t match = vandq_u8(vandq_u8(vceqq_u8(b0, zero), vceqq_u8(b1, zero)),
+                                    vceqq_u8(b2, one));
+        // NEON에는 movemask가 없으므로 후보가 있는 블록만 스칼라로 위치를 확인
+        uint8x8_t folded = vorr_u8(vget_low_u8(match), vget_high_u8(match));
+        if (vget_lane_u64(vreinterpret_u64_u8(folded), 0) != 0) {
+            for (int i = 0; i < 16; i++) {
+                if (p[i] == 0 && p[i + 1] == 0 && p[i + 2] == 1) {
+                    return p + i;
+                }
+            }
+        }
+        p += 16;
+    }
+    return find_start_code_scalar(p, end);
+}
+
+#else
+
+const uint8_t* find_start_code(const uint8_t* data, const uint8_t* end) {
+    return find_start_code_scalar(data, end);
+}
+
+#endif
+
+int find_nal_units(const uint8_t* data, int size, std::vector<NalUnit>* out) {
+    out->clear();
+    if (!data || size < 3) {
+        return 0;
+    }
+
+    const uint8_t* end = data + size;
+    const uint8_t* start_code = find_start_code(data, end);
+    while (start_code < end) {
+        const uint8_t* nal = start_code + 3;
+        const uint8_t* next = find_start_code(nal, end);
+
+        // 다음 시작 코드가 00 00 00 01이면 앞의 0은 시작 코드에 속함
+        const uint8_t* nal_end = next;
+        if (next < end && next > nal && next[-1] == 0) {
+            nal_end = next - 1;
+        }
+
+        if (nal_end > nal) {
+            NalUnit unit;
+            unit.data = nal;
+            unit.size = (int)(nal_end - nal);
+            unit.start_code_size = (start_code > data && start_code[-1] == 0) ? 4 : 3;
+            out->push_back(unit);
+        }
+        start_code = next;
+    }
+    return (int)out->size();
+}
@@ -0,0 +1,34 @@
+/*
+ * Annex-B NAL 유닛 경계 탐색
+ *
+ * 00 00 01 시작 코드를 SIMD(SSE2/AVX2, NEON)로 훑어 버퍼의 NAL 유닛 경계를 한 번의 선형 탐색으로 찾는다.
+ * SIMD를 쓸 수 없는 환경에서는 스칼라 구현을 사용한다.
+ */
+#ifndef YOPLAYER_NAL_SCANNER_H
+#define YOPLAYER_NAL_SCANNER_H
+
+#include <stdint.h>
+
+#include <vector>
+
+// Annex-B NAL 유닛 (시작 코드를 제외한 구간)
+struct NalUnit {
+    const uint8_t* data;
+    int size;
+    int start_code_size;  // 3 (00 00 01) 또는 4 (00 00 00 01)
+};
+
+/**
+ * [data, end)에서 첫 번째 00 00 01 시작 코드 위치 반환
+ * @return 시작 코드 첫 바이트의 주소, 없으면 end
+ */
+const uint8_t* find_start_code(const uint8_t* data, const uint8_t* end);
+
+/**
+ * 버퍼의 모든 NAL 유닛을 찾아 out에 채움 (out은 먼저 비워진다)
+ * 4바이트 시작 코드의 앞 0은 이전 NAL 유닛에 포함하지 않는다.
+ * @return 찾은 NAL 유닛 수
+ */
+int find_nal_units(const uint8_t* data, int size, std::vector<NalUnit>* out);
+
+#endif  // YOPLAYER_NAL_SCANNER_H
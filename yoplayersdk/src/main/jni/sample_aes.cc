@@ -0,0 +1,118 @@
+/*
+ * HLS SAMPLE-AES 샘플 복호화 구현
+ * (Apple "MPEG-2 Stream Encryption Format for HTTP Live Streaming" 2.2, 2.3)
+ */
+#include "sample_aes.h"
+
+#include <string.h>
+
+#include "nal_scanner.h"
+
+static const int H264_NAL_TYPE_SLICE = 1;
+static const int H264_NAL_TYPE_IDR = 5;
+static const int VIDEO_CLEAR_LEADER_SIZE = 32;
+static const int VIDEO_MIN_ENCRYPTED_NAL_SIZE = 48;
+static const int VIDEO_CLEAR_RUN_SIZE = 144;   // 암호화 블록 하나 뒤의 평문 9블록
+
+static const int AUDIO_CLEAR_LEADER_SIZE = 16;
+static const int ADTS_HEADER_SIZE = 7;
+static const int ADTS_CRC_SIZE = 2;
+
+/**
+ * 에뮬레이션 방지 바이트(00 00 03의 03)를 제거하며 복사 (dst <= src면 제자리 가능)
+ * @return 복사된 바이트 수
+ */
+static int copy_unescaped(const uint8_t* src, int size, uint8_t* dst) {
+    int written = 0;
+    int zeros = 0;
+    for (int i = 0; i < size; i++) {
+        uint8_t byte = src[i];
+        if (zeros >= 2 && byte == 0x03) {
+            zeros = 0;
+            continue;
+        }
+        zeros = byte == 0 ? zeros + 1 : 0;
+        dst[written++] = byte;
+    }
+    return written;
+}
+
+static void decrypt_nal(const AesKey* key, const uint8_t* segment_iv, uint8_t* nal, int size) {
+    uint8_t iv[AES_BLOCK_SIZE];
+    memcpy(iv, segment_iv, AES_BLOCK_SIZE);
+
+    uint8_t* p = nal + VIDEO_CLEAR_LEADER_SIZE;
+    int remaining = size - VIDEO_CLEAR_LEADER_SIZE;
+    while (remaining > 0) {
+        // 마지막 16바이트 이하의 조각은 평문
+        if (remaining > AES_BLOCK_SIZE) {
+            aes_cbc_decrypt_blocks(key, iv, p, p, 1);
+            p += AES_BLOCK_SIZE;
+            remaining -= AES_BLOCK_SIZE;
+        }
+        int clear = remaining < VIDEO_CLEAR_RUN_SIZE ? remaining : VIDEO_CLEAR_RUN_SIZE;
+        p += clear;
+        remaining -= clear;
+    }
+}
+
+int sample_aes_decrypt_h264(const AesKey* key, const uint8_t* iv, uint8_t* data, int size) {
+    const uint8_t* end = data + size;
+    const uint8_t* start_code = find_start_code(data, end);
+    // 읽기 위치보다 앞에만 쓰므로 아직 읽지 않은 입력은 그대로 남아 있다
+    uint8_t* out = data + (start_code - data);
+
+    while (start_code < end) {
+        const uint8_t* nal = start_code + 3;
+        const uint8_t* next = find_start_code(nal, end);
+        const uint8_t* nal_end = next;
+        if (next < end && next > nal && next[-1] == 0) {
+            nal_end = next - 1;
+        }
+
+        memmove(out, start_code, 3);
+        out += 3;
+
+        int nal_size = (int)(nal_end - nal);
+        int nal_type = nal_size > 0 ? (nal[0] & 0x1F) : 0;
+        if ((nal_type == H264_NAL_TYPE_SLICE || nal_type == H264_NAL_TYPE_IDR) &&
+            nal_size > VIDEO_MIN_ENCRYPTED_NAL_SIZE) {
+            int unescaped = copy_unescaped(nal, nal_size, out);
+            decrypt_nal(key, iv, out, unescaped);
+            out += unescaped;
+        } else {
+            memmove(out, nal, nal_size);
+            out += nal_size;
+        }
+
+        // 4바이트 시작 코드의 앞 0
+        memmove(out, nal_end, next - nal_end);
+        out += next - nal_end;
+        start_code = next;
+    }
+    return (int)(out - data);
+}
+
+void sample_aes_decrypt_adts(const AesKey* key, const uint8_t* segment_iv, uint8_t* data, int size) {
+    uint8_t iv[AES_BLOCK_SIZE];
+    int pos = 0;
+    while (size - pos >= ADTS_HEADER_SIZE) {
+        uint8_t* frame = data + pos;
+        if (frame[0] != 0xFF || (frame[1] & 0xF6) != 0xF0) {
+            break;
+        }
+        int frame_length = ((frame[3] & 0x03) << 11) | (frame[4] << 3) | (frame[5] >> 5);
+        int header_size = (frame[1] & 0x01) ? ADTS_HEADER_SIZE : ADTS_HEADER_SIZE + ADTS_CRC_SIZE;
+        if (frame_length < header_size || frame_length > size - pos) {
+            break;
+        }
+
+        int encrypted = frame_length - header_size - AUDIO_CLEAR_LEADER_SIZE;
+        if (encrypted >= AES_BLOCK_SIZE) {
+            uint8_t* payload = frame + header_size + AUDIO_CLEAR_LEADER_SIZE;
+            memcpy(iv, segment_iv, AES_BLOCK_SIZE);
+            aes_cbc_decrypt_blocks(key, iv, payload, payload, (size_t)(encrypted / AES_BLOCK_SIZE));
+        }
+        pos += frame_length;
+    }
+}
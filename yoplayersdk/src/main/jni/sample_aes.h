@@ -0,0 +1,28 @@
+/*
+ * HLS SAMPLE-AES 샘플 복호화 (EXT-X-KEY METHOD=SAMPLE-AES)
+ *
+ * Apple HLS Sample Encryption 규격에 따라 H.264 슬라이스 NAL과 ADTS AAC 프레임의 암호화된 블록만
+ * AES-128-CBC로 제자리에서 복호화한다. IV는 NAL/프레임마다 세그먼트 IV로 다시 시작한다.
+ */
+#ifndef YOPLAYER_SAMPLE_AES_H
+#define YOPLAYER_SAMPLE_AES_H
+
+#include <stdint.h>
+
+#include "aes_decryptor.h"
+
+/**
+ * H.264 액세스 유닛(Annex-B) 복호화
+ * 48바이트를 넘는 슬라이스 NAL(타입 1, 5)에서 에뮬레이션 방지 바이트를 제거한 뒤,
+ * 앞 32바이트 이후 [16바이트 암호화, 144바이트 평문] 패턴을 복호화한다.
+ * @return 복호화 후 크기 (에뮬레이션 방지 바이트가 제거되어 줄어들 수 있음)
+ */
+int sample_aes_decrypt_h264(const AesKey* key, const uint8_t* iv, uint8_t* data, int size);
+
+/**
+ * ADTS AAC 프레임열 복호화
+ * 프레임마다 ADTS 헤더와 16바이트 평문 뒤의 16바이트 블록 전체가 암호화되어 있고, 남은 조각은 평문이다.
+ */
+void sample_aes_decrypt_adts(const AesKey* key, const uint8_t* iv, uint8_t* data, int size);
+
+#endif  // YOPLAYER_SAMPLE_AES_H
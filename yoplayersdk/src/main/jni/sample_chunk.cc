@@ -0,0 +1,151 @@
+/*
+ * 디먹싱한 샘플의 청크 단위 출력
+ */
+#include "sample_chunk.h"
+
+#include <string.h>
+
+// 90kHz 틱을 마이크로초로 (반올림, 길이처럼 음수가 아닌 값)
+static int64_t ticks_to_us(int64_t ticks) {
+    return (ticks * 1000000 + 45000) / 90000;
+}
+
+void sample_chunk_init(SampleChunk* chunk, ScratchArena* scratch) {
+    chunk->payload = nullptr;
+    chunk->payload_capacity = 0;
+    chunk->payload_size = 0;
+    scratch_vector_init(&chunk->time_us, scratch);
+    scratch_vector_init(&chunk->decode_time_us, scratch);
+    scratch_vector_init(&chunk->duration_us, scratch);
+    scratch_vector_init(&chunk->offset, scratch);
+    scratch_vector_init(&chunk->size, scratch);
+    scratch_vector_init(&chunk->flags, scratch);
+    scratch_vector_init(&chunk->track_type, scratch);
+    scratch_vector_init(&chunk->track_id, scratch);
+}
+
+void sample_chunk_restart(SampleChunk* chunk, uint8_t* payload, size_t capacity) {
+    chunk->payload = payload;
+    chunk->payload_capacity = capacity;
+    chunk->payload_size = 0;
+    chunk->time_us.count = 0;
+    chunk->decode_time_us.count = 0;
+    chunk->duration_us.count = 0;
+    chunk->offset.count = 0;
+    chunk->size.count = 0;
+    chunk->flags.count = 0;
+    chunk->track_type.count = 0;
+    chunk->track_id.count = 0;
+}
+
+void sample_chunk_writer_init(SampleChunkWriter* writer, ScratchArena* scratch,
+                              const SampleChunkCallbacks* callbacks, uint8_t* payload,
+                              size_t capacity, bool streaming) {
+    sample_chunk_init(&writer->chunk, scratch);
+    sample_chunk_restart(&writer->chunk, payload, capacity);
+    writer->callbacks = *callbacks;
+    writer->streaming = streaming;
+    writer->count = 0;
+    writer->failed = false;
+}
+
+/**
+ * 페이로드 공간 확보
+ * 부족하면 두 배(또는 필요한 크기) 버퍼로 옮긴다 (세션 경계에서 이전 세그먼트 PES가 넘어오는 경우,
+ * 스트리밍 모드에서 샘플 하나가 청크 버퍼보다 큰 경우 등).
+ */
+static bool reserve_payload(SampleChunkWriter* writer, size_t extra) {
+    SampleChunk* chunk = &writer->chunk;
+    size_t required = chunk->payload_size + extra;
+    if (required <= chunk->payload_capacity) {
+        return true;
+    }
+    size_t capacity = chunk->payload_capacity * 2;
+    if (capacity < required) {
+        capacity = required;
+    }
+    return writer->callbacks.grow(writer->callbacks.opaque, chunk, capacity);
+}
+
+bool sample_chunk_write(SampleChunkWriter* writer, int track_type, int track_id,
+                        const SampleTiming* timing, int flags, const uint8_t* data, int size) {
+    SampleChunk* chunk = &writer->chunk;
+    if (writer->failed) {
+        return false;
+    }
+    // 청크가 가득 차면 넘기고 새 청크 시작
+    size_t count = sample_chunk_count(chunk);
+    if (writer->streaming && count > 0 &&
+        (count >= SAMPLE_CHUNK_MAX_SAMPLES ||
+         chunk->payload_size + (size_t)size > chunk->payload_capacity) &&
+        !sample_chunk_writer_flush(writer)) {
+        return false;
+    }
+    if (!reserve_payload(writer, (size_t)size) ||
+        !scratch_vector_push(&chunk->time_us, timing->time_us) ||
+        !scratch_vector_push(&chunk->decode_time_us, timing->decode_time_us) ||
+        !scratch_vector_push(&chunk->duration_us, timing->duration_us) ||
+        !scratch_vector_push(&chunk->offset, (int32_t)chunk->payload_size) ||
+        !scratch_vector_push(&chunk->size, (int32_t)size) ||
+        !scratch_vector_push(&chunk->flags, (int32_t)flags) ||
+        !scratch_vector_push(&chunk->track_type, (int32_t)track_type) ||
+        !scratch_vector_push(&chunk->track_id, (int32_t)track_id)) {
+        writer->failed = true;
+        return false;
+    }
+    memcpy(chunk->payload + chunk->payload_size, data, size);
+    chunk->payload_size += size;
+    return true;
+}
+
+/**
+ * 쌓인 청크를 flush 콜백으로 넘김
+ * 넘기지 못한 청크는 버린다 (페이로드 버퍼는 콜백이 정리).
+ */
+static bool deliver_chunk(SampleChunkWriter* writer) {
+    SampleChunk* chunk = &writer->chunk;
+    writer->count += (int)sample_chunk_count(chunk);
+    if (!writer->callbacks.flush(writer->callbacks.opaque, chunk)) {
+        sample_chunk_restart(chunk, nullptr, 0);
+        writer->failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool sample_chunk_writer_flush(SampleChunkWriter* writer) {
+    if (writer->failed) {
+        return false;
+    }
+    if (!writer->streaming || sample_chunk_count(&writer->chunk) == 0) {
+        return true;
+    }
+    return deliver_chunk(writer);
+}
+
+int sample_chunk_writer_finish(SampleChunkWriter* writer) {
+    if (!writer->streaming) {
+        return writer->count + (int)sample_chunk_count(&writer->chunk);
+    }
+    // 버퍼 할당에 실패했더라도 이미 모은 샘플은 넘긴다
+    if (sample_chunk_count(&writer->chunk) > 0) {
+        deliver_chunk(writer);
+    }
+    return writer->count;
+}
+
+int64_t sample_timing_from_ts_unit(TimestampNormalizer* timestamps, const TsAccessUnit* unit,
+                                   SampleTiming* timing) {
+    bool audio = unit->codec == TS_CODEC_AAC;
+    int64_t pts = unit->pts != TS_NO_TIMESTAMP ? unit->pts : unit->dts;
+    if (pts == TS_NO_TIMESTAMP) {
+        pts = TIMESTAMP_NONE;
+    }
+    int64_t dts = unit->dts != TS_NO_TIMESTAMP ? unit->dts : TIMESTAMP_NONE;
+    int64_t duration = audio ? unit->duration
+                             : timestamp_estimate_duration(timestamps, unit->pid, dts);
+    timing->time_us = timestamp_normalize(timestamps, unit->pid, pts, duration, audio);
+    timing->decode_time_us = timestamp_decode_time(timing->time_us, pts, dts);
+    timing->duration_us = ticks_to_us(duration);
+    return pts;
+}
@@ -0,0 +1,122 @@
+/*
+ * 디먹싱한 샘플의 청크 단위 출력
+ *
+ * 샘플 페이로드는 호출자가 준 버퍼 하나에 이어 쓰고, 샘플 메타데이터는 세그먼트 임시 메모리의 병렬 배열로 모은다.
+ * 스트리밍 모드는 청크가 샘플 수 또는 페이로드 크기 한도에 닿으면 flush 콜백으로 넘기고 새 청크를 시작하며,
+ * 샘플 하나가 버퍼보다 크거나 한 번에 모으는 모드에서 버퍼가 모자라면 grow 콜백으로 더 큰 버퍼로 옮긴다.
+ * 버퍼 할당과 청크 전달(JNI 객체 생성, 싱크 호출)은 콜백이 맡는다.
+ */
+#ifndef YOPLAYER_SAMPLE_CHUNK_H
+#define YOPLAYER_SAMPLE_CHUNK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "scratch_arena.h"
+#include "timestamp_normalizer.h"
+#include "ts_demuxer.h"
+
+// 스트리밍 모드 청크 기준 (샘플 수 / 페이로드 버퍼 크기)
+static const size_t SAMPLE_CHUNK_MAX_SAMPLES = 256;
+static const size_t SAMPLE_CHUNK_BYTES = 1024 * 1024;
+
+// 정규화된 샘플 시각 (마이크로초)
+struct SampleTiming {
+    int64_t time_us;            // PTS
+    int64_t decode_time_us;     // DTS (B 프레임이 없으면 PTS와 같음)
+    int64_t duration_us;        // 모르면 0
+};
+
+// 청크 하나의 샘플 (메타데이터 i번째가 샘플 i)
+struct SampleChunk {
+    uint8_t* payload;
+    size_t payload_capacity;
+    size_t payload_size;
+    ScratchVector<int64_t> time_us;
+    ScratchVector<int64_t> decode_time_us;
+    ScratchVector<int64_t> duration_us;   // 오디오는 프레임 헤더, 비디오는 패킷 길이 또는 DTS 간격, 모르면 0
+    ScratchVector<int32_t> offset;        // payload 안의 위치
+    ScratchVector<int32_t> size;
+    ScratchVector<int32_t> flags;
+    ScratchVector<int32_t> track_type;
+    ScratchVector<int32_t> track_id;      // 트랙 ID (MPEG-TS PID)
+};
+
+struct SampleChunkCallbacks {
+    /**
+     * 가득 찬 청크 전달 (스트리밍 모드)
+     * 전달한 뒤 sample_chunk_restart로 새 청크를 시작해야 한다.
+     * @return false면 출력 중단
+     */
+    bool (*flush)(void* opaque, SampleChunk* chunk);
+    /**
+     * 페이로드를 capacity 크기의 새 버퍼로 옮김 (앞의 payload_size 바이트를 복사하고 payload/payload_capacity 교체)
+     * @return false면 할당 실패
+     */
+    bool (*grow)(void* opaque, SampleChunk* chunk, size_t capacity);
+    void* opaque;
+};
+
+struct SampleChunkWriter {
+    SampleChunk chunk;
+    SampleChunkCallbacks callbacks;
+    bool streaming;     // 청크가 찰 때마다 flush로 전달
+    int count;          // flush로 넘긴 샘플 수
+    bool failed;        // 버퍼 할당 실패 또는 flush 실패
+};
+
+/**
+ * 청크 메타데이터를 임시 메모리에 연결 (페이로드 버퍼는 sample_chunk_restart로 지정)
+ */
+void sample_chunk_init(SampleChunk* chunk, ScratchArena* scratch);
+
+/**
+ * 빈 청크 시작
+ * 이전 청크의 메타데이터 공간은 그대로 다시 쓴다.
+ */
+void sample_chunk_restart(SampleChunk* chunk, uint8_t* payload, size_t capacity);
+
+static inline size_t sample_chunk_count(const SampleChunk* chunk) {
+    return chunk->time_us.count;
+}
+
+/**
+ * 출력 시작
+ * @param payload 첫 청크의 페이로드 버퍼 (capacity 바이트)
+ * @param streaming true면 청크 단위로 flush, false면 모든 샘플을 청크 하나에 모은다
+ */
+void sample_chunk_writer_init(SampleChunkWriter* writer, ScratchArena* scratch,
+                              const SampleChunkCallbacks* callbacks, uint8_t* payload,
+                              size_t capacity, bool streaming);
+
+/**
+ * 샘플 하나 출력
+ * 스트리밍 모드에서 샘플이 들어가지 않으면 쌓인 청크부터 넘기며, 페이로드는 잘리지 않는다.
+ * @return false면 더 이상 출력할 수 없음
+ */
+bool sample_chunk_write(SampleChunkWriter* writer, int track_type, int track_id,
+                        const SampleTiming* timing, int flags, const uint8_t* data, int size);
+
+/**
+ * 쌓인 샘플이 있으면 청크를 바로 넘김 (스트리밍 모드, 입력 대기 전에 지연을 줄이는 용도)
+ * @return false면 더 이상 출력할 수 없음
+ */
+bool sample_chunk_writer_flush(SampleChunkWriter* writer);
+
+/**
+ * 출력 마무리
+ * 스트리밍 모드는 남은 샘플을 넘기고, 한 번에 모으는 모드는 청크를 호출자에게 남긴다.
+ * @return 출력한 전체 샘플 수 (남긴 청크 포함)
+ */
+int sample_chunk_writer_finish(SampleChunkWriter* writer);
+
+/**
+ * 경량 TS 디먹서 액세스 유닛의 샘플 시각
+ * 오디오는 표시 순서대로 오므로 트랙별 단조 증가를 보장하고, 비디오는 B 프레임 재정렬이 있어 그대로 두며
+ * PES에 없는 길이를 DTS 간격으로 추정한다.
+ * @return 유닛의 90kHz PTS (없으면 DTS, 둘 다 없으면 TIMESTAMP_NONE)
+ */
+int64_t sample_timing_from_ts_unit(TimestampNormalizer* timestamps, const TsAccessUnit* unit,
+                                   SampleTiming* timing);
+
+#endif  // YOPLAYER_SAMPLE_CHUNK_H
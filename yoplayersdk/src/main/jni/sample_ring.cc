@@ -0,0 +1,379 @@
+/*
+ * 트랙별 샘플 링 버퍼 구현
+ */
+#include "sample_ring.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "timestamp_normalizer.h"
+
+static const size_t RECORD_ALIGNMENT = 8;
+static const int32_t SAMPLE_RING_WRAP = -1;
+
+static size_t align_up(size_t size) {
+    return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+}
+
+SampleRing* sample_ring_create(size_t capacity, MemoryBudget* budget) {
+    capacity &= ~(RECORD_ALIGNMENT - 1);
+    if (capacity < sizeof(SampleRingRecord)) {
+        return nullptr;
+    }
+    SampleRing* ring = new SampleRing();
+    ring->data = (uint8_t*)malloc(capacity);
+    if (!ring->data) {
+        delete ring;
+        return nullptr;
+    }
+    ring->capacity = capacity;
+    ring->budget = budget;
+    ring->write_pos.store(0);
+    ring->read_pos.store(0);
+    ring->count.store(0);
+    ring->write_end_us.store(INT64_MIN);
+    ring->low_bytes.store(capacity / 2);
+    ring->high_duration_us.store(0);
+    ring->low_duration_us.store(0);
+    ring->waiting.store(false);
+    ring->wait_required.store(0);
+    ring->interrupted = false;
+    ring->closed = false;
+    ring->waits.store(0);
+    ring->wakeups.store(0);
+    return ring;
+}
+
+void sample_ring_destroy(SampleRing* ring) {
+    if (!ring) {
+        return;
+    }
+    memory_budget_add(ring->budget, MEMORY_BUDGET_SAMPLES, -(int64_t)sample_ring_used(ring));
+    free(ring->data);
+    delete ring;
+}
+
+size_t sample_ring_record_size(int size) {
+    return sizeof(SampleRingRecord) + align_up((size_t)size);
+}
+
+bool sample_ring_is_oversized(const SampleRing* ring, int size) {
+    return sample_ring_record_size(size) > ring->capacity;
+}
+
+void sample_ring_begin_write(SampleRing* ring, SampleRingWriter* writer) {
+    writer->pos = ring->write_pos.load(std::memory_order_relaxed);
+    writer->limit = ring->read_pos.load(std::memory_order_acquire) + ring->capacity;
+    writer->count = 0;
+    writer->end_us = INT64_MIN;
+}
+
+/**
+ * 레코드를 쓸 시작 위치 (버퍼 끝에 남은 공간이 모자라면 다음 바퀴의 처음)
+ * @param skipped 건너뛴 끝 공간의 크기
+ */
+static uint64_t record_start(const SampleRing* ring, uint64_t pos, size_t record_size,
+                             size_t* skipped) {
+    size_t offset = (size_t)(pos % ring->capacity);
+    size_t tail = ring->capacity - offset;
+    *skipped = tail < record_size ? tail : 0;
+    return pos + *skipped;
+}
+
+bool sample_ring_reserve(const SampleRing* ring, SampleRingWriter* writer, int size) {
+    size_t record_size = sample_ring_record_size(size);
+    size_t skipped;
+    uint64_t start = record_start(ring, writer->pos, record_size, &skipped);
+    if (start + record_size > writer->limit) {
+        return false;
+    }
+    writer->pos = start + record_size;
+    writer->count++;
+    return true;
+}
+
+bool sample_ring_write(SampleRing* ring, SampleRingWriter* writer,
+                       const SampleRingRecord* record, const uint8_t* payload) {
+    size_t record_size = sample_ring_record_size(record->size);
+    size_t skipped;
+    uint64_t start = record_start(ring, writer->pos, record_size, &skipped);
+    if (start + record_size > writer->limit) {
+        return false;
+    }
+    if (skipped >= sizeof(SampleRingRecord)) {
+        // 끝 공간에 헤더가 들어가면 표시를 남기고, 아니면 소비자도 같은 규칙으로 건너뛴다
+        SampleRingRecord* wrap = (SampleRingRecord*)(ring->data + writer->pos % ring->capacity);
+        wrap->size = SAMPLE_RING_WRAP;
+    }
+    uint8_t* dst = ring->data + start % ring->capacity;
+    memcpy(dst, record, sizeof(SampleRingRecord));
+    memcpy(dst + sizeof(SampleRingRecord), payload, (size_t)record->size);
+    writer->pos = start + record_size;
+    writer->count++;
+    writer->end_us = record->decode_time_us + record->duration_us;
+    return true;
+}
+
+void sample_ring_commit(SampleRing* ring, const SampleRingWriter* writer) {
+    if (writer->count == 0) {
+        return;
+    }
+    // 소비자가 샘플을 꺼내기 전에 개수가 먼저 늘어나도록 위치보다 앞서 갱신
+    uint64_t write_pos = ring->write_pos.load(std::memory_order_relaxed);
+    memory_budget_add(ring->budget, MEMORY_BUDGET_SAMPLES, (int64_t)(writer->pos - write_pos));
+    ring->count.fetch_add(writer->count, std::memory_order_relaxed);
+    ring->write_end_us.store(writer->end_us, std::memory_order_relaxed);
+    ring->write_pos.store(writer->pos, std::memory_order_release);
+}
+
+/**
+ * read_pos에서 시작하는 다음 레코드의 위치 (끝 공간을 건너뛰어야 하면 다음 바퀴의 처음)
+ * @return 비어 있으면 false
+ */
+static bool front_position(const SampleRing* ring, uint64_t read_pos, uint64_t write_pos,
+                           uint64_t* front) {
+    if (read_pos == write_pos) {
+        return false;
+    }
+    size_t offset = (size_t)(read_pos % ring->capacity);
+    size_t tail = ring->capacity - offset;
+    if (tail < sizeof(SampleRingRecord) ||
+        ((const SampleRingRecord*)(ring->data + offset))->size == SAMPLE_RING_WRAP) {
+        read_pos += tail;
+    }
+    *front = read_pos;
+    return read_pos != write_pos;
+}
+
+const SampleRingRecord* sample_ring_peek(SampleRing* ring) {
+    uint64_t read_pos = ring->read_pos.load(std::memory_order_relaxed);
+    uint64_t write_pos = ring->write_pos.load(std::memory_order_acquire);
+    uint64_t front = read_pos;
+    bool found = front_position(ring, read_pos, write_pos, &front);
+    if (front != read_pos) {
+        memory_budget_add(ring->budget, MEMORY_BUDGET_SAMPLES, -(int64_t)(front - read_pos));
+        ring->read_pos.store(front, std::memory_order_release);
+    }
+    return found ? (const SampleRingRecord*)(ring->data + front % ring->capacity) : nullptr;
+}
+
+/**
+ * 생산자가 깨어날 조건 (비어 있거나, 배치가 들어가고 모든 낮은 워터마크 아래)
+ */
+static bool below_low_watermark(const SampleRing* ring, size_t required) {
+    if (ring->count.load(std::memory_order_relaxed) == 0) {
+        return true;
+    }
+    size_t used = sample_ring_used(ring);
+    if (used > ring->low_bytes.load(std::memory_order_relaxed) ||
+        ring->capacity - used < required || !sample_ring_fits_budget(ring, required)) {
+        return false;
+    }
+    return ring->high_duration_us.load(std::memory_order_relaxed) <= 0 ||
+           sample_ring_buffered_us(ring) <= ring->low_duration_us.load(std::memory_order_relaxed);
+}
+
+/**
+ * 소비자: 대기 중인 생산자가 있고 깨어날 조건이 되었으면 깨움
+ * 생산자가 대기 표시 후 조건을 다시 확인하므로, 양쪽의 fence로 둘 중 하나는 상대의 변경을 본다.
+ */
+static void notify_producer(SampleRing* ring) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!ring->waiting.load(std::memory_order_relaxed) ||
+        !below_low_watermark(ring, ring->wait_required.load(std::memory_order_relaxed))) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(ring->wait_lock);
+    }
+    ring->wait_cond.notify_one();
+}
+
+void sample_ring_pop(SampleRing* ring) {
+    const SampleRingRecord* record = sample_ring_peek(ring);
+    if (!record) {
+        return;
+    }
+    uint64_t read_pos = ring->read_pos.load(std::memory_order_relaxed);
+    size_t record_size = sample_ring_record_size(record->size);
+    memory_budget_add(ring->budget, MEMORY_BUDGET_SAMPLES, -(int64_t)record_size);
+    ring->count.fetch_sub(1, std::memory_order_relaxed);
+    ring->read_pos.store(read_pos + record_size, std::memory_order_release);
+    notify_producer(ring);
+}
+
+void sample_ring_clear(SampleRing* ring) {
+    memory_budget_add(ring->budget, MEMORY_BUDGET_SAMPLES, -(int64_t)sample_ring_used(ring));
+    ring->read_pos.store(ring->write_pos.load(std::memory_order_acquire),
+                         std::memory_order_release);
+    ring->count.store(0);
+    ring->write_end_us.store(INT64_MIN);
+    notify_producer(ring);
+}
+
+size_t sample_ring_used(const SampleRing* ring) {
+    return (size_t)(ring->write_pos.load(std::memory_order_acquire) -
+                    ring->read_pos.load(std::memory_order_acquire));
+}
+
+int64_t sample_ring_buffered_us(const SampleRing* ring) {
+    uint64_t read_pos = ring->read_pos.load(std::memory_order_acquire);
+    uint64_t write_pos = ring->write_pos.load(std::memory_order_acquire);
+    int64_t end_us = ring->write_end_us.load(std::memory_order_relaxed);
+    uint64_t front;
+    if (end_us == INT64_MIN || !front_position(ring, read_pos, write_pos, &front)) {
+        return 0;
+    }
+    // 읽지 않은 레코드는 생산자만 덮어쓰므로 다른 스레드에서 헤더를 읽어도 안전하다
+    const SampleRingRecord* record =
+        (const SampleRingRecord*)(ring->data + front % ring->capacity);
+    int64_t buffered = end_us - record->decode_time_us;
+    return buffered > 0 ? buffered : 0;
+}
+
+void sample_ring_set_watermarks(SampleRing* ring, size_t low_bytes, int64_t high_duration_us,
+                                int64_t low_duration_us) {
+    if (high_duration_us < 0) {
+        high_duration_us = 0;
+    }
+    if (low_duration_us > high_duration_us) {
+        low_duration_us = high_duration_us;
+    }
+    ring->low_bytes.store(low_bytes < ring->capacity ? low_bytes : ring->capacity);
+    ring->high_duration_us.store(high_duration_us);
+    ring->low_duration_us.store(low_duration_us > 0 ? low_duration_us : 0);
+    notify_producer(ring);
+}
+
+bool sample_ring_above_high_watermark(const SampleRing* ring) {
+    int64_t high_us = ring->high_duration_us.load(std::memory_order_relaxed);
+    return high_us > 0 && sample_ring_buffered_us(ring) >= high_us;
+}
+
+bool sample_ring_fits_budget(const SampleRing* ring, size_t required) {
+    return memory_budget_fits_samples(ring->budget, (int64_t)required);
+}
+
+int sample_ring_wait_writable(SampleRing* ring, size_t required, int timeout_ms) {
+    std::unique_lock<std::mutex> guard(ring->wait_lock);
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    ring->waits.fetch_add(1, std::memory_order_relaxed);
+    ring->wait_required.store(required, std::memory_order_relaxed);
+    ring->waiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    int result;
+    while (true) {
+        if (ring->closed) {
+            result = SAMPLE_RING_WAIT_CLOSED;
+            break;
+        }
+        if (ring->interrupted) {
+            ring->interrupted = false;
+            result = SAMPLE_RING_WAIT_INTERRUPTED;
+            break;
+        }
+        if (below_low_watermark(ring, required)) {
+            result = SAMPLE_RING_WAIT_READY;
+            break;
+        }
+        if (ring->wait_cond.wait_until(guard, deadline) == std::cv_status::timeout) {
+            result = below_low_watermark(ring, required) ? SAMPLE_RING_WAIT_READY
+                                                         : SAMPLE_RING_WAIT_TIMEOUT;
+            break;
+        }
+        ring->wakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+    ring->waiting.store(false, std::memory_order_relaxed);
+    return result;
+}
+
+void sample_ring_interrupt(SampleRing* ring) {
+    {
+        std::lock_guard<std::mutex> guard(ring->wait_lock);
+        ring->interrupted = true;
+    }
+    ring->wait_cond.notify_all();
+}
+
+void sample_ring_close(SampleRing* ring) {
+    {
+        std::lock_guard<std::mutex> guard(ring->wait_lock);
+        ring->closed = true;
+    }
+    ring->wait_cond.notify_all();
+}
+
+// 링에 쓸 수 있는 track 트랙의 샘플인지 여부 (링보다 큰 샘플 제외)
+static bool batch_writable(const SampleRing* ring, const SampleRingBatch* batch, int track,
+                           int index) {
+    return batch->track_id[index] == track && batch->time_us[index] != TIMESTAMP_UNSET_US &&
+           !sample_ring_is_oversized(ring, batch->size[index]);
+}
+
+bool sample_ring_batch_fits(SampleRing* ring, const SampleRingBatch* batch, int track, int start) {
+    if (sample_ring_above_high_watermark(ring)) {
+        return false;
+    }
+    SampleRingWriter writer;
+    sample_ring_begin_write(ring, &writer);
+    uint64_t start_pos = writer.pos;
+    for (int i = start; i < batch->count; i++) {
+        if (batch_writable(ring, batch, track, i) &&
+            !sample_ring_reserve(ring, &writer, batch->size[i])) {
+            return false;
+        }
+    }
+    return sample_ring_fits_budget(ring, (size_t)(writer.pos - start_pos));
+}
+
+size_t sample_ring_batch_required(const SampleRing* ring, const SampleRingBatch* batch, int track,
+                                  int start) {
+    size_t required = 0;
+    size_t largest = 0;
+    for (int i = start; i < batch->count; i++) {
+        if (!batch_writable(ring, batch, track, i)) {
+            continue;
+        }
+        size_t record_size = sample_ring_record_size(batch->size[i]);
+        required += record_size;
+        if (record_size > largest) {
+            largest = record_size;
+        }
+    }
+    required += largest;
+    return required < ring->capacity ? required : ring->capacity;
+}
+
+int sample_ring_write_batch(SampleRing* ring, const SampleRingBatch* batch, int track, int start,
+                            int* dropped) {
+    SampleRingWriter writer;
+    sample_ring_begin_write(ring, &writer);
+    int next = start;
+    for (; next < batch->count; next++) {
+        if (batch->track_id[next] != track || batch->time_us[next] == TIMESTAMP_UNSET_US) {
+            continue;
+        }
+        int32_t offset = batch->offset[next];
+        int32_t size = batch->size[next];
+        if (sample_ring_is_oversized(ring, size) || offset < 0 || size < 0 ||
+            (int64_t)offset + size > batch->payload_size) {
+            (*dropped)++;
+            continue;
+        }
+        SampleRingRecord record;
+        record.time_us = batch->time_us[next];
+        record.decode_time_us = batch->decode_time_us[next];
+        record.duration_us = batch->duration_us[next];
+        record.size = size;
+        record.flags = batch->flags[next];
+        if (!sample_ring_write(ring, &writer, &record, batch->payload + offset)) {
+            break;
+        }
+    }
+    sample_ring_commit(ring, &writer);
+    return next;
+}
@@ -0,0 +1,223 @@
+/*
+ * 트랙별 샘플 링 버퍼 (단일 생산자 / 단일 소비자, lock-free)
+ *
+ * 디먹스 스레드가 쓰고 재생 스레드가 읽는다. 샘플마다 메타데이터 헤더와 페이로드를 연속으로 저장하므로
+ * 샘플 단위 힙 객체가 없고, 메모리 사용량은 생성 시 정한 바이트 크기로 고정된다.
+ * 레코드는 버퍼 끝에서 나뉘지 않으며, 끝에 남은 공간이 모자라면 처음으로 돌아간다.
+ * 위치는 단조 증가하는 바이트 오프셋이며 생산자는 write_pos만, 소비자는 read_pos만 갱신한다.
+ *
+ * 링이 가득 차면 생산자는 sample_ring_wait_writable로 잠든다. 소비자는 생산자가 기다리는 중일 때만
+ * 낮은 워터마크(바이트, 버퍼 길이) 아래로 내려간 시점에 한 번 깨우므로, 샘플마다 깨어나지 않는다.
+ * 사용 중인 바이트는 플레이어의 메모리 예산(MEMORY_BUDGET_SAMPLES)에도 반영되며, 예산이 모자라면
+ * 링에 공간이 있어도 가득 찬 것으로 본다.
+ */
+#ifndef YOPLAYER_SAMPLE_RING_H
+#define YOPLAYER_SAMPLE_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include "memory_budget.h"
+
+// 레코드 헤더 (페이로드가 바로 뒤에 이어짐)
+struct SampleRingRecord {
+    int64_t time_us;
+    int64_t decode_time_us;
+    int64_t duration_us;
+    int32_t size;       // 페이로드 크기, SAMPLE_RING_WRAP이면 버퍼 처음으로 돌아감
+    int32_t flags;
+};
+
+enum SampleRingWaitResult {
+    SAMPLE_RING_WAIT_READY = 0,     // 낮은 워터마크 아래로 내려가 쓸 수 있음
+    SAMPLE_RING_WAIT_TIMEOUT,
+    SAMPLE_RING_WAIT_INTERRUPTED,   // sample_ring_interrupt로 깨어남 (호출자가 중단 조건을 다시 확인)
+    SAMPLE_RING_WAIT_CLOSED,        // sample_ring_close 이후
+};
+
+struct SampleRing {
+    uint8_t* data;
+    size_t capacity;
+    MemoryBudget* budget;       // 공유 메모리 예산 (nullptr이면 링 크기만 적용)
+    std::atomic<uint64_t> write_pos;
+    std::atomic<uint64_t> read_pos;
+    std::atomic<int> count;     // 읽지 않은 샘플 수
+    // 마지막으로 공개된 샘플이 디코딩 순서로 끝나는 시각 (DTS + 길이), 없으면 INT64_MIN
+    std::atomic<int64_t> write_end_us;
+
+    // 워터마크: 높은 바이트 워터마크는 capacity, 길이 워터마크는 0이면 사용하지 않음
+    std::atomic<size_t> low_bytes;
+    std::atomic<int64_t> high_duration_us;
+    std::atomic<int64_t> low_duration_us;
+
+    // 생산자 대기 (wait_lock은 대기/깨우기에만 쓰며 읽기/쓰기 경로에서는 잡지 않음)
+    std::mutex wait_lock;
+    std::condition_variable wait_cond;
+    std::atomic<bool> waiting;
+    std::atomic<size_t> wait_required;  // 대기 중인 배치가 차지할 바이트
+    bool interrupted;                   // 다음 대기를 한 번 깨우는 표시 (wait_lock 안에서 접근)
+    bool closed;
+    // 통계: 대기 횟수와 대기 중 실제로 깨어난 횟수
+    std::atomic<int64_t> waits;
+    std::atomic<int64_t> wakeups;
+};
+
+// 커밋 전까지 보이지 않는 생산자 쓰기 위치 (배치 단위 전부 쓰기 / 전부 취소)
+struct SampleRingWriter {
+    uint64_t pos;
+    uint64_t limit;     // 이 위치까지 쓸 수 있음 (read_pos + capacity)
+    int count;
+    int64_t end_us;     // 쓴 샘플 중 마지막 샘플의 DTS + 길이
+};
+
+// 디먹서가 만든 샘플 배치 (여러 트랙이 섞인 병렬 배열, 소유하지 않음)
+// 타임스탬프가 없는 샘플(TIMESTAMP_UNSET_US)은 쓰지 않는다.
+struct SampleRingBatch {
+    int count;
+    const int64_t* time_us;
+    const int64_t* decode_time_us;  // 쓰기에만 사용 (확인/대기에서는 nullptr이어도 됨)
+    const int64_t* duration_us;     // 쓰기에만 사용
+    const int32_t* offset;          // payload 안의 위치, 쓰기에만 사용
+    const int32_t* size;
+    const int32_t* flags;           // 쓰기에만 사용
+    const int32_t* track_id;
+    const uint8_t* payload;
+    int64_t payload_size;
+};
+
+/**
+ * @param capacity 바이트 크기 (8의 배수로 내림)
+ * @param budget 사용량을 반영할 메모리 예산 (링보다 오래 유지되어야 함), 없으면 nullptr
+ * @return 실패 시 nullptr
+ */
+SampleRing* sample_ring_create(size_t capacity, MemoryBudget* budget);
+
+void sample_ring_destroy(SampleRing* ring);
+
+/**
+ * 페이로드 size 바이트인 샘플이 차지하는 크기 (헤더 포함, 8바이트 정렬)
+ */
+size_t sample_ring_record_size(int size);
+
+/**
+ * 비어 있는 링에도 들어가지 않는 샘플인지 여부
+ */
+bool sample_ring_is_oversized(const SampleRing* ring, int size);
+
+/**
+ * 생산자: 쓰기 시작 (현재 빈 공간 기준)
+ */
+void sample_ring_begin_write(SampleRing* ring, SampleRingWriter* writer);
+
+/**
+ * 생산자: 샘플 하나를 쓸 공간만 확인하고 writer 위치를 옮김 (실제로 쓰지 않음)
+ * @return 공간이 모자라면 false
+ */
+bool sample_ring_reserve(const SampleRing* ring, SampleRingWriter* writer, int size);
+
+/**
+ * 생산자: 샘플 하나 쓰기 (commit 전까지 소비자에게 보이지 않음)
+ * @return 공간이 모자라면 false (writer는 그대로)
+ */
+bool sample_ring_write(SampleRing* ring, SampleRingWriter* writer,
+                       const SampleRingRecord* record, const uint8_t* payload);
+
+/**
+ * 생산자: 쓴 샘플을 소비자에게 공개
+ */
+void sample_ring_commit(SampleRing* ring, const SampleRingWriter* writer);
+
+/**
+ * 소비자: 다음 샘플 헤더 (페이로드는 헤더 바로 뒤)
+ * @return 비어 있으면 nullptr
+ */
+const SampleRingRecord* sample_ring_peek(SampleRing* ring);
+
+/**
+ * 소비자: 다음 샘플을 버림 (sample_ring_peek이 nullptr이 아니었어야 함)
+ */
+void sample_ring_pop(SampleRing* ring);
+
+/**
+ * 모든 샘플 버림 (생산자가 쓰지 않는 동안에만 호출)
+ */
+void sample_ring_clear(SampleRing* ring);
+
+/**
+ * 사용 중인 바이트 (끝에서 건너뛴 공간 포함)
+ */
+size_t sample_ring_used(const SampleRing* ring);
+
+/**
+ * 버퍼에 쌓인 길이 (다음에 읽을 샘플의 DTS부터 마지막 샘플의 끝까지), 비어 있으면 0
+ * 어느 스레드에서 호출해도 된다.
+ */
+int64_t sample_ring_buffered_us(const SampleRing* ring);
+
+/**
+ * 워터마크 설정
+ * @param low_bytes 생산자를 깨우는 사용 바이트 (capacity를 넘으면 capacity)
+ * @param high_duration_us 이 길이 이상 쌓이면 가득 찬 것으로 봄, 0이면 길이 제한 없음
+ * @param low_duration_us 생산자를 깨우는 버퍼 길이 (high_duration_us를 넘지 않음)
+ */
+void sample_ring_set_watermarks(SampleRing* ring, size_t low_bytes, int64_t high_duration_us,
+                                int64_t low_duration_us);
+
+/**
+ * 높은 길이 워터마크에 도달했는지 여부 (비어 있으면 false)
+ */
+bool sample_ring_above_high_watermark(const SampleRing* ring);
+
+/**
+ * 메모리 예산 안에서 required 바이트를 더 쌓을 수 있는지 여부
+ */
+bool sample_ring_fits_budget(const SampleRing* ring, size_t required);
+
+/**
+ * 생산자: required 바이트를 쓸 수 있고 낮은 워터마크 아래로 내려갈 때까지 대기
+ * 비어 있으면 바로 반환한다.
+ * @param required 쓸 레코드 크기의 합 (버퍼 끝에서 건너뛸 수 있는 공간 포함)
+ * @param timeout_ms 최대 대기 시간
+ * @return SampleRingWaitResult
+ */
+int sample_ring_wait_writable(SampleRing* ring, size_t required, int timeout_ms);
+
+/**
+ * 대기 중인 생산자를 깨움 (대기 중이 아니면 다음 대기가 바로 반환)
+ */
+void sample_ring_interrupt(SampleRing* ring);
+
+/**
+ * 이후의 모든 대기를 바로 반환시킴 (해제 전에 호출)
+ */
+void sample_ring_close(SampleRing* ring);
+
+/**
+ * 생산자: 배치 중 start 이후 track 트랙의 샘플이 모두 들어갈 공간이 있는지 여부 (쓰지 않음)
+ * 링보다 큰 샘플은 쓰지 않으므로 계산에서 뺀다.
+ * 높은 길이 워터마크에 도달했거나 메모리 예산이 모자라면 공간이 있어도 false.
+ */
+bool sample_ring_batch_fits(SampleRing* ring, const SampleRingBatch* batch, int track, int start);
+
+/**
+ * 배치 중 start 이후 track 트랙의 샘플을 쓰려고 sample_ring_wait_writable에 넘길 바이트
+ * 레코드 크기의 합에 버퍼 끝에서 건너뛸 수 있는 최대 공간(가장 큰 레코드)을 더한 값이며,
+ * 링보다 크면 링 크기로 줄인다 (링이 빌 때 깨어나 sample_ring_write_batch로 나누어 씀).
+ */
+size_t sample_ring_batch_required(const SampleRing* ring, const SampleRingBatch* batch, int track,
+                                  int start);
+
+/**
+ * 생산자: 배치 중 start 이후 track 트랙의 샘플을 들어가는 데까지 쓰고 commit
+ * 링에 한 번에 들어가지 않는 배치는 여러 번에 나누어 쓰므로 샘플을 버리지 않는다.
+ * 링보다 크거나 페이로드 범위를 벗어난 샘플만 건너뛰고 dropped에 더한다.
+ * @return 다음에 쓸 샘플 위치 (모두 썼으면 batch->count)
+ */
+int sample_ring_write_batch(SampleRing* ring, const SampleRingBatch* batch, int track, int start,
+                            int* dropped);
+
+#endif  // YOPLAYER_SAMPLE_RING_H
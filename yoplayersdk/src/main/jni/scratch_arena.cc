@@ -0,0 +1,78 @@
+/*
+ * 세그먼트 단위 임시 메모리 구현
+ */
+#include "scratch_arena.h"
+
+#include <stdlib.h>
+
+static const size_t SCRATCH_ALIGNMENT = 16;
+
+static size_t align_up(size_t size) {
+    return (size + SCRATCH_ALIGNMENT - 1) & ~(SCRATCH_ALIGNMENT - 1);
+}
+
+static bool add_block(ScratchArena* arena, size_t size) {
+    ScratchBlock block;
+    block.data = (uint8_t*)malloc(size);
+    if (!block.data) {
+        return false;
+    }
+    block.size = size;
+    arena->blocks.push_back(block);
+    arena->used = 0;
+    arena->block_allocs++;
+    return true;
+}
+
+static void free_blocks(ScratchArena* arena) {
+    for (size_t i = 0; i < arena->blocks.size(); i++) {
+        free(arena->blocks[i].data);
+    }
+    arena->blocks.clear();
+}
+
+void scratch_arena_init(ScratchArena* arena, size_t initial_size) {
+    arena->blocks.clear();
+    arena->used = 0;
+    arena->total_used = 0;
+    arena->high_water = align_up(initial_size);
+    arena->block_allocs = 0;
+}
+
+void scratch_arena_release(ScratchArena* arena) {
+    free_blocks(arena);
+    arena->used = 0;
+    arena->total_used = 0;
+}
+
+void* scratch_arena_alloc(ScratchArena* arena, size_t size) {
+    size = align_up(size);
+    if (arena->blocks.empty() || arena->used + size > arena->blocks.back().size) {
+        // 새 블록은 지금 블록의 두 배 이상으로 잡아 블록 수를 로그 단위로 유지
+        size_t block_size = arena->blocks.empty() ? arena->high_water : arena->blocks.back().size * 2;
+        if (block_size < size) {
+            block_size = size;
+        }
+        if (!add_block(arena, block_size)) {
+            return nullptr;
+        }
+    }
+    void* result = arena->blocks.back().data + arena->used;
+    arena->used += size;
+    arena->total_used += size;
+    return result;
+}
+
+void scratch_arena_reset(ScratchArena* arena) {
+    if (arena->total_used > arena->high_water) {
+        arena->high_water = arena->total_used;
+    }
+    if (arena->blocks.size() > 1 ||
+        (!arena->blocks.empty() && arena->blocks.back().size < arena->high_water)) {
+        // 여러 블록에 걸쳤던 사용량을 블록 하나로 합침 (다음 세그먼트는 할당 없이 처리)
+        free_blocks(arena);
+        add_block(arena, arena->high_water);
+    }
+    arena->used = 0;
+    arena->total_used = 0;
+}
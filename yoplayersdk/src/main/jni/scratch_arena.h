@@ -0,0 +1,98 @@
+/*
+ * 세그먼트 단위 임시 메모리 (bump allocator)
+ *
+ * 세그먼트 하나를 디먹싱하는 동안만 쓰는 데이터(샘플 메타데이터 배열 등)를 블록에서 앞으로만 잘라 주고,
+ * 세그먼트 사이에 한꺼번에 되돌린다. 블록이 모자라면 블록을 추가하고, 되돌릴 때 그동안의 최대 사용량을
+ * 담는 블록 하나로 합치므로 같은 크기의 세그먼트가 이어지면 시스템 할당이 일어나지 않는다.
+ */
+#ifndef YOPLAYER_SCRATCH_ARENA_H
+#define YOPLAYER_SCRATCH_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+struct ScratchBlock {
+    uint8_t* data;
+    size_t size;
+};
+
+struct ScratchArena {
+    std::vector<ScratchBlock> blocks;   // 마지막 블록에서 할당
+    size_t used;                        // 마지막 블록에서 쓴 바이트
+    size_t total_used;                  // reset 이후 모든 블록에서 쓴 바이트
+    size_t high_water;                  // reset 사이 total_used의 최대값
+    int64_t block_allocs;               // 블록 할당(시스템 할당) 횟수, 호출자가 읽고 비운다
+};
+
+/**
+ * 초기화 (블록은 첫 할당 때 잡는다)
+ * @param initial_size 첫 블록 크기
+ */
+void scratch_arena_init(ScratchArena* arena, size_t initial_size);
+
+/**
+ * 모든 블록 해제
+ */
+void scratch_arena_release(ScratchArena* arena);
+
+/**
+ * size 바이트 할당 (16바이트 정렬)
+ * @return 다음 reset까지 유효한 메모리, 실패 시 nullptr
+ */
+void* scratch_arena_alloc(ScratchArena* arena, size_t size);
+
+/**
+ * 모든 할당을 한꺼번에 되돌림
+ * 블록이 여러 개였으면 최대 사용량 크기의 블록 하나로 합친다.
+ */
+void scratch_arena_reset(ScratchArena* arena);
+
+/**
+ * 임시 메모리에 두는 가변 길이 배열 (trivially copyable 타입만)
+ * 늘어날 때 두 배 크기로 새로 잘라 복사하며, 이전 공간은 reset까지 그대로 둔다.
+ * clear는 길이만 비우고 공간은 유지한다.
+ */
+template <typename T>
+struct ScratchVector {
+    ScratchArena* arena;
+    T* items;
+    size_t count;
+    size_t capacity;
+};
+
+static const size_t SCRATCH_VECTOR_MIN_CAPACITY = 64;
+
+template <typename T>
+void scratch_vector_init(ScratchVector<T>* vector, ScratchArena* arena) {
+    vector->arena = arena;
+    vector->items = nullptr;
+    vector->count = 0;
+    vector->capacity = 0;
+}
+
+/**
+ * 값 하나 추가
+ * @return 임시 메모리를 더 잡지 못하면 false
+ */
+template <typename T>
+bool scratch_vector_push(ScratchVector<T>* vector, T value) {
+    if (vector->count == vector->capacity) {
+        size_t capacity = vector->capacity ? vector->capacity * 2 : SCRATCH_VECTOR_MIN_CAPACITY;
+        T* grown = (T*)scratch_arena_alloc(vector->arena, capacity * sizeof(T));
+        if (!grown) {
+            return false;
+        }
+        if (vector->count > 0) {
+            memcpy(grown, vector->items, vector->count * sizeof(T));
+        }
+        vector->items = grown;
+        vector->capacity = capacity;
+    }
+    vector->items[vector->count++] = value;
+    return true;
+}
+
+#endif  // YOPLAYER_SCRATCH_ARENA_H
@@ -0,0 +1,311 @@
+/*
+ * 세그먼트 병렬 디먹스 풀 구현
+ */
+#include "segment_demux_pool.h"
+
+#include <string.h>
+
+#include <chrono>
+
+#include "ts_demuxer.h"
+
+// 워커 하나의 재사용 상태 (워커 스레드에서만 접근)
+struct SegmentDemuxWorker {
+    TsDemuxer demuxer;
+    AesKey key;
+};
+
+static int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 꺼내지 않은 작업의 바이트를 예산에 반영 (lock 안에서 호출)
+static void update_pending(SegmentDemuxPool* pool, int64_t delta) {
+    pool->pending_bytes += delta;
+    memory_budget_set(pool->budget, MEMORY_BUDGET_POOL, pool->pending_bytes);
+    if (delta < 0) {
+        pool->space_cond.notify_all();
+    }
+}
+
+/**
+ * 경량 TS 디먹서 콜백 - 액세스 유닛을 작업 버퍼에 복사
+ */
+static bool copy_access_unit(void* opaque, const TsAccessUnit* unit) {
+    SegmentDemuxJob* job = (SegmentDemuxJob*)opaque;
+    SegmentDemuxUnit out;
+    out.pid = unit->pid;
+    out.codec = unit->codec;
+    out.offset = job->payload.size();
+    out.size = unit->size;
+    out.pts = unit->pts;
+    out.dts = unit->dts;
+    out.duration = unit->duration;
+    out.pos = unit->pos;
+    out.key_frame = unit->key_frame;
+    job->payload.insert(job->payload.end(), unit->data, unit->data + unit->size);
+    job->units.push_back(out);
+    return true;
+}
+
+/**
+ * AES-128 세그먼트를 제자리에서 복호화하고 패딩 제거
+ * @return 키를 설정하지 못했으면 false (입력은 그대로)
+ */
+static bool decrypt_job(SegmentDemuxWorker* worker, SegmentDemuxJob* job) {
+    if (!aes_key_set(&worker->key, job->params.key)) {
+        return false;
+    }
+    uint8_t* data = job->input.data();
+    AesCbcState state;
+    aes_cbc_start(&state, job->params.iv);
+    size_t plain_size = aes_cbc_update(&worker->key, &state, data, job->input_size, data);
+    bool padding_valid = false;
+    // 마지막 블록을 보류하므로 plain_size + 16 <= input.size() (제출 시 블록 하나를 더 잡아 둠)
+    plain_size += aes_cbc_finish(&worker->key, &state, data + plain_size, &padding_valid);
+    job->input_size = plain_size;
+    job->invalid_padding = !padding_valid;
+    return true;
+}
+
+/**
+ * 작업 하나를 복호화하고 파싱
+ * @return SEGMENT_DEMUX_DONE 또는 SEGMENT_DEMUX_UNSUPPORTED
+ */
+static int parse_job(SegmentDemuxWorker* worker, SegmentDemuxJob* job) {
+    job->units.clear();
+    job->payload.clear();
+    job->invalid_padding = false;
+    job->sync_errors = 0;
+    job->continuity_errors = 0;
+
+    if (job->params.encryption == SEGMENT_ENCRYPTION_SAMPLE_AES) {
+        return SEGMENT_DEMUX_UNSUPPORTED;
+    }
+    if (job->params.encryption == SEGMENT_ENCRYPTION_AES_128 && !decrypt_job(worker, job)) {
+        return SEGMENT_DEMUX_UNSUPPORTED;
+    }
+
+    // 페이로드는 TS/PES 헤더를 뺀 만큼이므로 입력 크기면 대부분 재할당 없이 들어간다
+    job->payload.reserve(job->input_size);
+    TsDemuxer* demuxer = &worker->demuxer;
+    ts_demuxer_reset(demuxer);
+    size_t consumed = 0;
+    int status = ts_demuxer_feed(demuxer, job->input.data(), job->input_size,
+                                 copy_access_unit, job, &consumed);
+    if (status == TS_FEED_UNSUPPORTED || !ts_demuxer_has_program(demuxer)) {
+        job->units.clear();
+        job->payload.clear();
+        return SEGMENT_DEMUX_UNSUPPORTED;
+    }
+    ts_demuxer_flush(demuxer, copy_access_unit, job);
+    job->sync_errors = demuxer->sync_errors;
+    job->continuity_errors = demuxer->continuity_errors;
+    return SEGMENT_DEMUX_DONE;
+}
+
+static void run_worker(SegmentDemuxPool* pool) {
+    SegmentDemuxWorker worker;
+    ts_demuxer_reset(&worker.demuxer);
+    ts_demuxer_select_pids(&worker.demuxer, nullptr, 0);
+    aes_key_init(&worker.key);
+
+    std::unique_lock<std::mutex> guard(pool->lock);
+    while (true) {
+        pool->work_cond.wait(guard, [pool] { return pool->stopping || !pool->queued.empty(); });
+        if (pool->stopping) {
+            break;
+        }
+        SegmentDemuxJob* job = pool->queued.front();
+        pool->queued.pop_front();
+        job->status = SEGMENT_DEMUX_RUNNING;
+        guard.unlock();
+
+        int64_t start_us = now_us();
+        int status = parse_job(&worker, job);
+        int64_t parse_us = now_us() - start_us;
+
+        guard.lock();
+        job->parse_us = parse_us;
+        pool->busy_us += parse_us;
+        pool->parsed_count++;
+        if (job->discarded) {
+            job->discarded = false;
+            pool->spare.push_back(job);
+            continue;
+        }
+        job->status = status;
+        job->charged_bytes += (int64_t)job->payload.size();
+        update_pending(pool, (int64_t)job->payload.size());
+        pool->done_cond.notify_all();
+    }
+    guard.unlock();
+    aes_key_release(&worker.key);
+}
+
+SegmentDemuxPool* segment_demux_pool_create(int workers, size_t max_pending_bytes,
+                                            MemoryBudget* budget) {
+    if (workers < 1) {
+        workers = 1;
+    } else if (workers > SEGMENT_DEMUX_MAX_WORKERS) {
+        workers = SEGMENT_DEMUX_MAX_WORKERS;
+    }
+    SegmentDemuxPool* pool = new SegmentDemuxPool();
+    pool->next_sequence = 0;
+    pool->pending_bytes = 0;
+    pool->max_pending_bytes = max_pending_bytes;
+    pool->budget = budget;
+    pool->cancelled = false;
+    pool->stopping = false;
+    pool->busy_us = 0;
+    pool->parsed_count = 0;
+    for (int i = 0; i < workers; i++) {
+        pool->workers.push_back(std::thread(run_worker, pool));
+    }
+    return pool;
+}
+
+void segment_demux_pool_destroy(SegmentDemuxPool* pool) {
+    if (!pool) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->stopping = true;
+        pool->cancelled = true;
+        pool->work_cond.notify_all();
+        pool->done_cond.notify_all();
+        pool->space_cond.notify_all();
+    }
+    for (size_t i = 0; i < pool->workers.size(); i++) {
+        pool->workers[i].join();
+    }
+    // 워커는 파싱 중이던 작업을 마친 뒤 멈추므로 모든 작업이 ordered 또는 spare에 있다
+    for (size_t i = 0; i < pool->ordered.size(); i++) {
+        delete pool->ordered[i];
+    }
+    for (size_t i = 0; i < pool->spare.size(); i++) {
+        delete pool->spare[i];
+    }
+    memory_budget_set(pool->budget, MEMORY_BUDGET_POOL, 0);
+    delete pool;
+}
+
+int segment_demux_pool_worker_count(const SegmentDemuxPool* pool) {
+    return pool ? (int)pool->workers.size() : 0;
+}
+
+void segment_demux_pool_set_budget(SegmentDemuxPool* pool, MemoryBudget* budget) {
+    std::lock_guard<std::mutex> guard(pool->lock);
+    memory_budget_set(pool->budget, MEMORY_BUDGET_POOL, 0);
+    pool->budget = budget;
+    memory_budget_set(pool->budget, MEMORY_BUDGET_POOL, pool->pending_bytes);
+    pool->space_cond.notify_all();
+}
+
+int64_t segment_demux_pool_submit(SegmentDemuxPool* pool, const uint8_t* data, size_t size,
+                                  const SegmentDemuxParams* params) {
+    SegmentDemuxJob* job;
+    {
+        std::unique_lock<std::mutex> guard(pool->lock);
+        // 풀이 비어 있으면 한도와 무관하게 받아야 디먹싱이 멈추지 않는다
+        while (!pool->cancelled && !pool->ordered.empty() &&
+               ((size_t)pool->pending_bytes + size > pool->max_pending_bytes ||
+                !memory_budget_fits_input(pool->budget, (int64_t)size))) {
+            pool->space_cond.wait(guard);
+        }
+        if (pool->cancelled) {
+            return -1;
+        }
+        if (pool->spare.empty()) {
+            job = new SegmentDemuxJob();
+        } else {
+            job = pool->spare.back();
+            pool->spare.pop_back();
+        }
+    }
+
+    // 복사는 락 밖에서 (AES-128 패딩 제거용으로 블록 하나를 더 잡음)
+    job->params = *params;
+    job->input.resize(size + AES_BLOCK_SIZE);
+    memcpy(job->input.data(), data, size);
+    job->input_size = size;
+    job->units.clear();
+    job->payload.clear();
+    job->discarded = false;
+    job->parse_us = 0;
+    job->submit_us = now_us();
+
+    std::lock_guard<std::mutex> guard(pool->lock);
+    if (pool->cancelled) {
+        pool->spare.push_back(job);
+        return -1;
+    }
+    job->sequence = pool->next_sequence++;
+    job->status = SEGMENT_DEMUX_QUEUED;
+    pool->queued.push_back(job);
+    pool->ordered.push_back(job);
+    job->charged_bytes = (int64_t)size;
+    update_pending(pool, job->charged_bytes);
+    pool->work_cond.notify_one();
+    return job->sequence;
+}
+
+SegmentDemuxJob* segment_demux_pool_take(SegmentDemuxPool* pool) {
+    std::unique_lock<std::mutex> guard(pool->lock);
+    pool->done_cond.wait(guard, [pool] {
+        return pool->cancelled ||
+               (!pool->ordered.empty() &&
+                (pool->ordered.front()->status == SEGMENT_DEMUX_DONE ||
+                 pool->ordered.front()->status == SEGMENT_DEMUX_UNSUPPORTED));
+    });
+    if (pool->cancelled) {
+        return nullptr;
+    }
+    SegmentDemuxJob* job = pool->ordered.front();
+    pool->ordered.pop_front();
+    return job;
+}
+
+void segment_demux_pool_recycle(SegmentDemuxPool* pool, SegmentDemuxJob* job) {
+    std::lock_guard<std::mutex> guard(pool->lock);
+    update_pending(pool, -job->charged_bytes);
+    job->charged_bytes = 0;
+    job->units.clear();
+    job->payload.clear();
+    pool->spare.push_back(job);
+}
+
+size_t segment_demux_pool_pending(SegmentDemuxPool* pool) {
+    std::lock_guard<std::mutex> guard(pool->lock);
+    return pool->ordered.size();
+}
+
+void segment_demux_pool_cancel(SegmentDemuxPool* pool) {
+    std::lock_guard<std::mutex> guard(pool->lock);
+    pool->cancelled = true;
+    pool->done_cond.notify_all();
+    pool->space_cond.notify_all();
+}
+
+void segment_demux_pool_reset(SegmentDemuxPool* pool) {
+    std::lock_guard<std::mutex> guard(pool->lock);
+    int64_t released = 0;
+    for (size_t i = 0; i < pool->ordered.size(); i++) {
+        SegmentDemuxJob* job = pool->ordered[i];
+        released += job->charged_bytes;
+        job->charged_bytes = 0;
+        if (job->status == SEGMENT_DEMUX_RUNNING) {
+            job->discarded = true;
+        } else {
+            job->units.clear();
+            job->payload.clear();
+            pool->spare.push_back(job);
+        }
+    }
+    pool->ordered.clear();
+    pool->queued.clear();
+    pool->cancelled = false;
+    update_pending(pool, -released);
+}
@@ -0,0 +1,161 @@
+/*
+ * 다운로드를 마친 세그먼트의 병렬 디먹스 풀
+ *
+ * 워커 스레드마다 경량 TS 디먹서와 AES-128 복호화 상태를 따로 두고, 제출된 세그먼트를 동시에
+ * 복호화/파싱하여 액세스 유닛을 작업 버퍼에 복사해 둔다. 결과는 제출 순서대로만 꺼낼 수 있으므로
+ * 뒤 세그먼트가 먼저 끝나도 앞 세그먼트를 기다린다 (재정렬).
+ * 타임스탬프 정규화와 샘플 출력은 세그먼트를 넘어 상태가 이어지므로 꺼내는 쪽(디먹스 스레드)에서
+ * 순서대로 수행한다.
+ *
+ * 세그먼트는 PAT/PMT로 시작하는 독립된 TS로 보고, 끝에서 조립 중인 PES를 내보낸다.
+ * 경량 디먹서가 처리할 수 없는 세그먼트(SAMPLE-AES, 다른 코덱 등)는 SEGMENT_DEMUX_UNSUPPORTED로
+ * 표시하고 (복호화된) 입력을 남겨 호출자가 순차 경로로 디먹싱하게 한다.
+ * 꺼내지 않은 작업의 입력과 파싱 결과는 메모리 예산(MEMORY_BUDGET_POOL)에 반영되며, 한도를 넘으면
+ * 제출이 자리가 날 때까지 대기한다.
+ */
+#ifndef YOPLAYER_SEGMENT_DEMUX_POOL_H
+#define YOPLAYER_SEGMENT_DEMUX_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "aes_decryptor.h"
+#include "memory_budget.h"
+
+static const int SEGMENT_DEMUX_MAX_WORKERS = 8;
+
+enum SegmentDemuxStatus {
+    SEGMENT_DEMUX_QUEUED = 0,
+    SEGMENT_DEMUX_RUNNING,
+    SEGMENT_DEMUX_DONE,
+    SEGMENT_DEMUX_UNSUPPORTED,      // 순차 경로로 디먹싱해야 함 (input에 평문이 남아 있음)
+};
+
+enum SegmentEncryption {
+    SEGMENT_ENCRYPTION_NONE = 0,
+    SEGMENT_ENCRYPTION_AES_128,     // 워커가 세그먼트 전체를 복호화
+    SEGMENT_ENCRYPTION_SAMPLE_AES,  // 샘플 단위 복호화가 필요하므로 파싱하지 않고 순차 경로로 넘김
+};
+
+// 세그먼트별 설정 (제출 시 복사)
+struct SegmentDemuxParams {
+    int encryption;                 // SegmentEncryption
+    uint8_t key[AES_BLOCK_SIZE];
+    uint8_t iv[AES_BLOCK_SIZE];
+    bool discontinuity;             // 출력 전에 디먹스 세션과 타임스탬프 기준을 다시 잡음 (풀은 해석하지 않음)
+};
+
+// 파싱된 액세스 유닛 (페이로드는 SegmentDemuxJob::payload의 [offset, offset + size))
+struct SegmentDemuxUnit {
+    int pid;
+    int codec;                      // TsCodec
+    size_t offset;
+    int size;
+    int64_t pts;                    // 90kHz, 없으면 TS_NO_TIMESTAMP
+    int64_t dts;
+    int64_t duration;
+    int64_t pos;                    // PES가 시작된 TS 패킷의 세그먼트 내 위치
+    bool key_frame;
+};
+
+struct SegmentDemuxJob {
+    int64_t sequence;
+    int status;                     // SegmentDemuxStatus
+    bool discarded;                 // 파싱 중에 풀이 비워짐 (워커가 끝나면 재사용 목록으로 돌림)
+    SegmentDemuxParams params;
+    std::vector<uint8_t> input;     // 세그먼트 (AES-128은 워커가 평문으로 바꿈), 용량은 재사용
+    size_t input_size;
+    std::vector<SegmentDemuxUnit> units;
+    std::vector<uint8_t> payload;
+    // pending_bytes에 반영한 바이트 (제출 시 입력, 파싱 후 페이로드를 더함, lock 안에서만 접근)
+    // 복호화로 줄어든 input_size가 아니라 이 값만큼 돌려주어야 패딩 바이트가 새지 않는다
+    int64_t charged_bytes;
+    // 통계
+    int64_t submit_us;              // 제출 시각
+    int64_t parse_us;               // 워커의 복호화 + 파싱 시간
+    bool invalid_padding;           // AES-128 패딩이 올바르지 않아 마지막 블록을 그대로 둠
+    int64_t sync_errors;
+    int64_t continuity_errors;
+};
+
+struct SegmentDemuxPool {
+    std::mutex lock;
+    std::condition_variable work_cond;      // 워커: 새 작업 또는 종료
+    std::condition_variable done_cond;      // 꺼내는 쪽: 맨 앞 작업 완료 또는 취소
+    std::condition_variable space_cond;     // 제출하는 쪽: 자리가 남 또는 취소
+    std::vector<std::thread> workers;
+    std::deque<SegmentDemuxJob*> queued;    // 파싱을 기다리는 작업 (제출 순서)
+    std::deque<SegmentDemuxJob*> ordered;   // 꺼내지 않은 모든 작업 (제출 순서)
+    std::vector<SegmentDemuxJob*> spare;    // 재사용할 작업
+    int64_t next_sequence;
+    int64_t pending_bytes;                  // 꺼내서 돌려주지 않은 작업의 입력 + 페이로드
+    size_t max_pending_bytes;
+    MemoryBudget* budget;                   // 소유하지 않음 (nullptr이면 max_pending_bytes만 적용)
+    bool cancelled;
+    bool stopping;
+    // 통계: 워커 파싱 시간 합과 처리한 세그먼트 수
+    int64_t busy_us;
+    int64_t parsed_count;
+};
+
+/**
+ * 워커 스레드를 시작한 풀 생성
+ * @param workers 워커 수 (1 ~ SEGMENT_DEMUX_MAX_WORKERS로 제한)
+ * @param max_pending_bytes 꺼내지 않은 작업이 차지할 수 있는 최대 바이트
+ * @param budget 사용량을 반영할 메모리 예산 (풀보다 오래 유지되어야 함), 없으면 nullptr
+ */
+SegmentDemuxPool* segment_demux_pool_create(int workers, size_t max_pending_bytes,
+                                            MemoryBudget* budget);
+
+/**
+ * 워커를 멈추고(진행 중인 파싱이 끝날 때까지 대기) 모든 작업 해제
+ */
+void segment_demux_pool_destroy(SegmentDemuxPool* pool);
+
+int segment_demux_pool_worker_count(const SegmentDemuxPool* pool);
+
+void segment_demux_pool_set_budget(SegmentDemuxPool* pool, MemoryBudget* budget);
+
+/**
+ * 세그먼트 제출 (입력을 복사하므로 반환 후 data를 재사용해도 됨)
+ * 꺼내지 않은 작업이 한도를 넘으면 자리가 날 때까지 대기한다. 풀이 비어 있으면 기다리지 않는다.
+ * @return 세그먼트 순번, 취소되었으면 -1
+ */
+int64_t segment_demux_pool_submit(SegmentDemuxPool* pool, const uint8_t* data, size_t size,
+                                  const SegmentDemuxParams* params);
+
+/**
+ * 다음 순번의 작업을 꺼냄 (파싱이 끝날 때까지 대기)
+ * 꺼낸 작업은 출력을 마친 뒤 segment_demux_pool_recycle로 돌려주어야 한다.
+ * @return 취소되었으면 nullptr
+ */
+SegmentDemuxJob* segment_demux_pool_take(SegmentDemuxPool* pool);
+
+/**
+ * 꺼낸 작업을 돌려줌 (메모리는 다음 제출에 재사용)
+ */
+void segment_demux_pool_recycle(SegmentDemuxPool* pool, SegmentDemuxJob* job);
+
+/**
+ * 꺼내지 않은 작업 수 (파싱 중 포함)
+ */
+size_t segment_demux_pool_pending(SegmentDemuxPool* pool);
+
+/**
+ * 대기 중인 submit/take를 깨워 반환시킴 (segment_demux_pool_reset 전까지 유지)
+ */
+void segment_demux_pool_cancel(SegmentDemuxPool* pool);
+
+/**
+ * 꺼내지 않은 작업을 모두 버리고 취소 상태 해제 (seek)
+ * 꺼낸 작업을 모두 돌려준 뒤 호출해야 한다. 파싱 중인 작업은 워커가 끝낸 뒤 버려진다.
+ */
+void segment_demux_pool_reset(SegmentDemuxPool* pool);
+
+#endif  // YOPLAYER_SEGMENT_DEMUX_POOL_H
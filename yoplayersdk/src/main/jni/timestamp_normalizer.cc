@@ -0,0 +1,144 @@
+/*
+ * MPEG-TS 타임스탬프 정규화 구현 (ISO/IEC 13818-1 2.4.3.7 PTS 33비트)
+ */
+#include "timestamp_normalizer.h"
+
+static const int64_t PTS_WRAP = (int64_t)1 << 33;
+static const int64_t PTS_CLOCK = 90000;
+// 이전 타임스탬프와 이보다 크게 떨어지면 불연속으로 본다 (10초)
+static const int64_t MAX_TIMESTAMP_JUMP = 10 * PTS_CLOCK;
+// 이보다 긴 DTS 간격은 샘플 길이로 보지 않는다 (1초)
+static const int64_t MAX_SAMPLE_DURATION = PTS_CLOCK;
+
+static int64_t abs64(int64_t value) {
+    return value < 0 ? -value : value;
+}
+
+static int64_t ticks_to_us(int64_t ticks) {
+    return ticks * 1000000 / PTS_CLOCK;
+}
+
+/**
+ * 33비트 타임스탬프 차이 (a - b), 순환을 넘는 경우도 가까운 쪽의 부호 있는 값
+ */
+static int64_t pts_diff(int64_t a, int64_t b) {
+    int64_t diff = ((a - b) % PTS_WRAP + PTS_WRAP) % PTS_WRAP;
+    return diff >= PTS_WRAP / 2 ? diff - PTS_WRAP : diff;
+}
+
+void timestamp_normalizer_reset(TimestampNormalizer* normalizer) {
+    normalizer->base = TIMESTAMP_NONE;
+    normalizer->offset_us = 0;
+    normalizer->last_pts = TIMESTAMP_NONE;
+    normalizer->max_us = TIMESTAMP_UNSET_US;
+    normalizer->tracks.clear();
+    normalizer->discontinuity_count = 0;
+}
+
+void timestamp_normalizer_rebase(TimestampNormalizer* normalizer) {
+    normalizer->base = TIMESTAMP_NONE;
+    normalizer->last_pts = TIMESTAMP_NONE;
+    if (normalizer->max_us != TIMESTAMP_UNSET_US) {
+        normalizer->offset_us = normalizer->max_us;
+    }
+    // 불연속을 넘는 DTS 간격은 샘플 길이가 아니다
+    for (size_t i = 0; i < normalizer->tracks.size(); i++) {
+        normalizer->tracks[i].last_dts = TIMESTAMP_NONE;
+    }
+}
+
+void timestamp_normalizer_seek(TimestampNormalizer* normalizer, int64_t time_us, int64_t pts) {
+    normalizer->base = pts != TIMESTAMP_NONE ? pts & (PTS_WRAP - 1) : TIMESTAMP_NONE;
+    normalizer->offset_us = time_us;
+    normalizer->last_pts = normalizer->base;
+    normalizer->max_us = TIMESTAMP_UNSET_US;
+    normalizer->tracks.clear();
+}
+
+/**
+ * 33비트 PTS를 마지막 타임스탬프에 가장 가까운 순환 위치로 옮김
+ */
+static int64_t unwrap_pts(const TimestampNormalizer* normalizer, int64_t pts) {
+    int64_t last = normalizer->last_pts;
+    if (last == TIMESTAMP_NONE) {
+        return pts;
+    }
+    int64_t wraps = (last + PTS_WRAP / 2) / PTS_WRAP;
+    int64_t below = pts + PTS_WRAP * (wraps - 1);
+    int64_t above = pts + PTS_WRAP * wraps;
+    return abs64(below - last) < abs64(above - last) ? below : above;
+}
+
+static TimestampTrack* find_track(TimestampNormalizer* normalizer, int track_id) {
+    for (size_t i = 0; i < normalizer->tracks.size(); i++) {
+        if (normalizer->tracks[i].track_id == track_id) {
+            return &normalizer->tracks[i];
+        }
+    }
+    TimestampTrack track;
+    track.track_id = track_id;
+    track.last_us = TIMESTAMP_UNSET_US;
+    track.last_dts = TIMESTAMP_NONE;
+    track.duration = 0;
+    normalizer->tracks.push_back(track);
+    return &normalizer->tracks.back();
+}
+
+int64_t timestamp_normalize(TimestampNormalizer* normalizer, int track_id, int64_t pts,
+                            int64_t duration, bool monotonic) {
+    int64_t time_us = TIMESTAMP_UNSET_US;
+    if (pts != TIMESTAMP_NONE) {
+        int64_t unwrapped = unwrap_pts(normalizer, pts & (PTS_WRAP - 1));
+        if (normalizer->base == TIMESTAMP_NONE) {
+            normalizer->base = unwrapped;
+        } else if (abs64(unwrapped - normalizer->last_pts) > MAX_TIMESTAMP_JUMP) {
+            // 태그 없는 불연속 (인코더 재시작 등): 지금까지의 출력에 이어 붙인다
+            normalizer->base = unwrapped;
+            normalizer->offset_us = normalizer->max_us != TIMESTAMP_UNSET_US
+                                        ? normalizer->max_us : normalizer->offset_us;
+            normalizer->discontinuity_count++;
+        }
+        normalizer->last_pts = unwrapped;
+        time_us = normalizer->offset_us + ticks_to_us(unwrapped - normalizer->base);
+    }
+
+    if (monotonic) {
+        TimestampTrack* track = find_track(normalizer, track_id);
+        if (track->last_us != TIMESTAMP_UNSET_US &&
+            (time_us == TIMESTAMP_UNSET_US || time_us <= track->last_us)) {
+            time_us = track->last_us + ticks_to_us(duration);
+        } else if (time_us == TIMESTAMP_UNSET_US) {
+            time_us = normalizer->offset_us;
+        }
+        track->last_us = time_us;
+    }
+
+    if (time_us != TIMESTAMP_UNSET_US &&
+        (normalizer->max_us == TIMESTAMP_UNSET_US || time_us > normalizer->max_us)) {
+        normalizer->max_us = time_us;
+    }
+    return time_us;
+}
+
+int64_t timestamp_decode_time(int64_t time_us, int64_t pts, int64_t dts) {
+    if (time_us == TIMESTAMP_UNSET_US || pts == TIMESTAMP_NONE || dts == TIMESTAMP_NONE) {
+        return time_us;
+    }
+    return time_us - ticks_to_us(pts_diff(pts & (PTS_WRAP - 1), dts & (PTS_WRAP - 1)));
+}
+
+int64_t timestamp_estimate_duration(TimestampNormalizer* normalizer, int track_id, int64_t dts) {
+    TimestampTrack* track = find_track(normalizer, track_id);
+    if (dts == TIMESTAMP_NONE) {
+        return track->duration;
+    }
+    dts &= PTS_WRAP - 1;
+    if (track->last_dts != TIMESTAMP_NONE) {
+        int64_t interval = pts_diff(dts, track->last_dts);
+        if (interval > 0 && interval <= MAX_SAMPLE_DURATION) {
+            track->duration = interval;
+        }
+    }
+    track->last_dts = dts;
+    return track->duration;
+}
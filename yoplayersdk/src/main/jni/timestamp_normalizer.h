@@ -0,0 +1,81 @@
+/*
+ * MPEG-TS 타임스탬프 정규화
+ *
+ * 90kHz PTS의 33비트 순환을 풀어 이어지는 값으로 만들고, 첫 타임스탬프를 0으로 하는 마이크로초
+ * 타임라인으로 옮긴다. 불연속(EXT-X-DISCONTINUITY 또는 타임스탬프 점프)에서는 직전 출력에 이어지도록
+ * 기준을 다시 잡고, 오디오처럼 표시 순서대로 오는 트랙은 트랙별로 단조 증가하도록 보정한다.
+ * 같은 기준으로 DTS를 옮기고, 길이를 모르는 비디오 샘플은 DTS 간격으로 길이를 추정한다.
+ */
+#ifndef YOPLAYER_TIMESTAMP_NORMALIZER_H
+#define YOPLAYER_TIMESTAMP_NORMALIZER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+// 정규화할 수 없는 샘플의 타임스탬프 (androidx.media3 C.TIME_UNSET과 같은 값)
+static const int64_t TIMESTAMP_UNSET_US = INT64_MIN + 1;
+// 입력 타임스탬프가 없음
+static const int64_t TIMESTAMP_NONE = INT64_MIN;
+
+// 트랙별 단조 보정 / 샘플 길이 추정 상태
+struct TimestampTrack {
+    int track_id;
+    int64_t last_us;        // 마지막 출력, 없으면 TIMESTAMP_UNSET_US
+    int64_t last_dts;       // 마지막 90kHz DTS (33비트), 없으면 TIMESTAMP_NONE
+    int64_t duration;       // 마지막 DTS 간격 (90kHz), 없으면 0
+};
+
+struct TimestampNormalizer {
+    int64_t base;           // 출력 offset_us에 대응하는 90kHz 타임스탬프 (순환을 푼 값), 없으면 TIMESTAMP_NONE
+    int64_t offset_us;
+    int64_t last_pts;       // 마지막으로 본 90kHz 타임스탬프 (순환을 푼 값), 없으면 TIMESTAMP_NONE
+    int64_t max_us;         // 지금까지의 최대 출력, 없으면 TIMESTAMP_UNSET_US
+    std::vector<TimestampTrack> tracks;
+    int64_t discontinuity_count;   // 타임스탬프 점프로 감지한 불연속 횟수
+};
+
+/**
+ * 처음 상태로 초기화 (다음 타임스탬프가 0이 됨)
+ */
+void timestamp_normalizer_reset(TimestampNormalizer* normalizer);
+
+/**
+ * 불연속 표시: 다음 타임스탬프가 지금까지의 최대 출력에 이어지도록 기준을 다시 잡는다
+ */
+void timestamp_normalizer_rebase(TimestampNormalizer* normalizer);
+
+/**
+ * seek: 이후 타임스탬프를 주어진 위치에 맞춘다
+ * @param time_us pts에 대응하는 출력 (마이크로초)
+ * @param pts 90kHz 기준 타임스탬프, TIMESTAMP_NONE이면 다음 타임스탬프가 time_us가 됨
+ */
+void timestamp_normalizer_seek(TimestampNormalizer* normalizer, int64_t time_us, int64_t pts);
+
+/**
+ * 샘플 하나의 타임스탬프 정규화
+ * @param pts 90kHz PTS (33비트 범위를 넘는 값은 하위 33비트만 사용), 없으면 TIMESTAMP_NONE
+ * @param duration 90kHz 샘플 길이 (모르면 0)
+ * @param monotonic true면 트랙 출력이 이전 값 이하이거나 PTS가 없을 때 이전 값 + duration으로 보정
+ * @return 마이크로초, 정규화할 수 없으면 TIMESTAMP_UNSET_US
+ */
+int64_t timestamp_normalize(TimestampNormalizer* normalizer, int track_id, int64_t pts,
+                            int64_t duration, bool monotonic);
+
+/**
+ * 정규화된 PTS에 대응하는 디코딩 타임스탬프
+ * @param time_us 같은 샘플을 timestamp_normalize로 정규화한 값
+ * @param pts, dts 같은 샘플의 90kHz PTS/DTS (둘 중 하나라도 없으면 time_us를 그대로 반환)
+ * @return 마이크로초, time_us가 TIMESTAMP_UNSET_US면 그대로
+ */
+int64_t timestamp_decode_time(int64_t time_us, int64_t pts, int64_t dts);
+
+/**
+ * 트랙의 연속한 DTS 간격으로 샘플 길이 추정 (컨테이너가 길이를 알려주지 않는 비디오용)
+ * @param dts 90kHz DTS, 없으면 TIMESTAMP_NONE
+ * @return 90kHz, 이전 샘플이 없으면 직전 추정값, 추정값도 없으면 0
+ */
+int64_t timestamp_estimate_duration(TimestampNormalizer* normalizer, int track_id, int64_t dts);
+
+#endif  // YOPLAYER_TIMESTAMP_NORMALIZER_H
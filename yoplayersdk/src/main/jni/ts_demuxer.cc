@@ -0,0 +1,651 @@
+/*
+ * HLS용 경량 MPEG-TS 디먹서 구현 (ISO/IEC 13818-1 2.4.3, 2.4.4, 2.5.4)
+ */
+#include "ts_demuxer.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "adts_parser.h"
+#include "nal_scanner.h"
+
+static const uint8_t TS_SYNC_BYTE = 0x47;
+static const int TS_PAT_PID = 0x0000;
+static const int TS_NULL_PID = 0x1FFF;
+static const int TS_TABLE_ID_PAT = 0x00;
+static const int TS_TABLE_ID_PMT = 0x02;
+
+// PMT stream_type
+static const int STREAM_TYPE_AAC_ADTS = 0x0F;
+static const int STREAM_TYPE_H264 = 0x1B;
+static const int STREAM_TYPE_HEVC = 0x24;
+static const int STREAM_TYPE_PRIVATE_SECTION = 0x05;
+static const int STREAM_TYPE_METADATA = 0x15;   // ID3 timed metadata
+static const int STREAM_TYPE_SCTE35 = 0x86;
+
+static const int PES_HEADER_SIZE = 9;
+// ADTS frame_length는 13비트이므로 이보다 큰 조각은 손상된 입력으로 보고 버린다
+static const size_t ADTS_MAX_CARRY = 2 * 8192;
+// 처음 보는 PID가 모두 PMT 등장 전 데이터일 때 PSI 섹션 버퍼 상한
+static const size_t TS_MAX_SECTION_SIZE = 4096;
+
+static void reset_stream(TsElementaryStream* es) {
+    es->pid = -1;
+    es->codec = TS_CODEC_UNKNOWN;
+    es->continuity = -1;
+    es->random_access = false;
+    es->pes_pos = 0;
+    es->pes.clear();
+    es->carry.clear();
+    es->next_pts = TS_NO_TIMESTAMP;
+}
+
+void ts_demuxer_reset(TsDemuxer* demuxer) {
+    demuxer->pmt_pid = -1;
+    demuxer->pmt_version = -1;
+    demuxer->pat.data.clear();
+    demuxer->pat.started = false;
+    demuxer->pmt.data.clear();
+    demuxer->pmt.started = false;
+    for (size_t i = 0; i < demuxer->streams.size(); i++) {
+        reset_stream(&demuxer->streams[i]);
+    }
+    demuxer->partial_size = 0;
+    demuxer->input_pos = 0;
+    demuxer->packet_pos = 0;
+    demuxer->packet_count = 0;
+    demuxer->sync_errors = 0;
+    demuxer->continuity_errors = 0;
+}
+
+void ts_demuxer_restart(TsDemuxer* demuxer) {
+    demuxer->pat.data.clear();
+    demuxer->pat.started = false;
+    demuxer->pmt.data.clear();
+    demuxer->pmt.started = false;
+    for (size_t i = 0; i < demuxer->streams.size(); i++) {
+        TsElementaryStream* es = &demuxer->streams[i];
+        es->continuity = -1;
+        es->random_access = false;
+        es->pes.clear();
+        es->carry.clear();
+        es->next_pts = TS_NO_TIMESTAMP;
+    }
+    demuxer->partial_size = 0;
+    demuxer->input_pos = 0;
+    demuxer->packet_pos = 0;
+}
+
+static bool is_pid_selected(const TsDemuxer* demuxer, int pid) {
+    return !demuxer->filter_pids || (demuxer->pid_mask[pid >> 3] & (1 << (pid & 7))) != 0;
+}
+
+void ts_demuxer_select_pids(TsDemuxer* demuxer, const int* pids, size_t count) {
+    memset(demuxer->pid_mask, 0, sizeof(demuxer->pid_mask));
+    demuxer->filter_pids = pids != nullptr;
+    for (size_t i = 0; pids && i < count; i++) {
+        if (pids[i] >= 0 && pids[i] < TS_PID_COUNT) {
+            demuxer->pid_mask[pids[i] >> 3] |= (uint8_t)(1 << (pids[i] & 7));
+        }
+    }
+    // 선택에서 빠진 PID의 조립 중인 PES는 다시 선택되었을 때 이어지지 않도록 버린다
+    for (size_t i = 0; i < demuxer->streams.size(); i++) {
+        TsElementaryStream* es = &demuxer->streams[i];
+        if (es->pid >= 0 && !is_pid_selected(demuxer, es->pid)) {
+            es->continuity = -1;
+            es->random_access = false;
+            es->pes.clear();
+            es->carry.clear();
+            es->next_pts = TS_NO_TIMESTAMP;
+        }
+    }
+}
+
+bool ts_demuxer_has_program(const TsDemuxer* demuxer) {
+    return demuxer->pmt_version >= 0;
+}
+
+size_t ts_count_synced_packets(const uint8_t* data, size_t count) {
+    size_t i = 0;
+    // 동기 바이트는 188바이트 간격이라 한 벡터 레지스터에 모이지 않으므로,
+    // 8개 패킷씩 XOR/OR로 묶어 분기 없이 검사하고 어긋난 블록만 한 패킷씩 다시 본다
+    for (; i + 8 <= count; i += 8) {
+        const uint8_t* p = data + i * TS_PACKET_SIZE;
+        uint8_t bad = (uint8_t)((p[0 * TS_PACKET_SIZE] ^ TS_SYNC_BYTE) |
+                                (p[1 * TS_PACKET_SIZE] ^ TS_SYNC_BYTE) |
+                                (p[2 * TS_PACKET_SIZE] ^ TS_SYNC_BYTE) |
+                                (p[3 * TS_PACKET_SIZE] ^ TS_SYNC_BYTE) |
+                                (p[4 * TS_PACKET_SIZE] ^ TS_SYNC_BYTE) |
+                                (p[5 * TS_PACKET_SIZE] ^ TS_SYNC_BYTE) |
+                                (p[6 * TS_PACKET_SIZE] ^ TS_SYNC_BYTE) |
+                                (p[7 * TS_PACKET_SIZE] ^ TS_SYNC_BYTE));
+        if (bad != 0) {
+            break;
+        }
+    }
+    while (i < count && data[i * TS_PACKET_SIZE] == TS_SYNC_BYTE) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * 동기를 잃었을 때 다음 패킷 시작 위치 찾기
+ * 0x47은 memchr로 찾고, 188바이트 뒤에도 0x47이 있는 위치만 패킷 시작으로 인정한다.
+ * @return 패킷 시작 위치, 완전한 패킷을 판별할 수 없으면 판별하지 못한 구간의 시작
+ */
+static size_t find_sync(const uint8_t* data, size_t size, size_t pos) {
+    while (pos < size) {
+        const uint8_t* sync = (const uint8_t*)memchr(data + pos, TS_SYNC_BYTE, size - pos);
+        if (!sync) {
+            return size;
+        }
+        pos = (size_t)(sync - data);
+        if (pos + TS_PACKET_SIZE >= size || data[pos + TS_PACKET_SIZE] == TS_SYNC_BYTE) {
+            return pos;
+        }
+        pos++;
+    }
+    return size;
+}
+
+static int64_t read_timestamp(const uint8_t* p) {
+    return ((int64_t)((p[0] >> 1) & 0x07) << 30) |
+           ((int64_t)p[1] << 22) |
+           ((int64_t)(p[2] >> 1) << 15) |
+           ((int64_t)p[3] << 7) |
+           (int64_t)(p[4] >> 1);
+}
+
+/**
+ * 비디오 액세스 유닛이 IDR/IRAP 픽처인지 확인
+ * 첫 번째 VCL NAL 유닛까지만 살펴본다.
+ */
+static bool is_video_key_frame(int codec, const uint8_t* data, int size) {
+    const uint8_t* end = data + size;
+    const uint8_t* p = data;
+    while (true) {
+        const uint8_t* start_code = find_start_code(p, end);
+        if (end - start_code < 4) {
+            return false;
+        }
+        const uint8_t* nal = start_code + 3;
+        if (codec == TS_CODEC_H264) {
+            int nal_type = nal[0] & 0x1F;
+            if (nal_type >= 1 && nal_type <= 5) {
+                return nal_type == 5;
+            }
+        } else {
+            int nal_type = (nal[0] >> 1) & 0x3F;
+            if (nal_type < 32) {
+                return nal_type >= 16 && nal_type <= 23;
+            }
+        }
+        p = nal;
+    }
+}
+
+/**
+ * PES 페이로드의 ADTS 프레임을 헤더를 뺀 raw AAC 액세스 유닛으로 하나씩 내보냄
+ * 프레임마다 PES PTS에서 프레임 길이(1024 샘플)만큼 이어지는 타임스탬프를 붙인다.
+ * PES 끝에서 잘린 프레임은 carry에 남겨 다음 PES 앞에 붙인다.
+ */
+static bool emit_adts_frames(TsElementaryStream* es, const uint8_t* payload, size_t size,
+                             int64_t pts, TsAccessUnitCallback callback, void* opaque) {
+    const uint8_t* data = payload;
+    size_t data_size = size;
+    size_t carry_size = es->carry.size();
+    if (carry_size > 0) {
+        es->carry.insert(es->carry.end(), payload, payload + size);
+        data = es->carry.data();
+        data_size = es->carry.size();
+    }
+
+    // 앞 PES에서 넘어온 프레임은 이전 PES에서 이어지는 시각을 사용
+    int64_t cursor = carry_size > 0 ? es->next_pts : pts;
+    bool pes_pts_applied = carry_size == 0;
+    size_t pos = 0;
+    bool keep_going = true;
+    while (keep_going && data_size - pos >= (size_t)ADTS_HEADER_SIZE) {
+        const uint8_t* frame = data + pos;
+        AdtsHeader header;
+        if (!parse_adts_header(frame, data_size - pos, &header)) {
+            pos++;
+            continue;
+        }
+        size_t frame_size = (size_t)header.frame_size;
+        if (pos + frame_size > data_size) {
+            break;
+        }
+        if (!pes_pts_applied && pos >= carry_size) {
+            // 이 PES에서 시작하는 첫 프레임부터는 PES PTS 기준
+            if (pts != TS_NO_TIMESTAMP) {
+                cursor = pts;
+            }
+            pes_pts_applied = true;
+        }
+
+        int64_t duration = adts_frame_duration(&header);
+        // raw_data_block마다 액세스 유닛 하나 (헤더만 있는 빈 프레임은 시각만 진행)
+        AdtsRawBlock blocks[ADTS_MAX_RAW_BLOCKS];
+        int block_count = adts_split_raw_blocks(frame, &header, blocks);
+        int64_t block_duration = block_count > 0 ? duration / block_count : 0;
+        for (int i = 0; keep_going && i < block_count; i++) {
+            TsAccessUnit unit;
+            unit.pid = es->pid;
+            unit.codec = TS_CODEC_AAC;
+            unit.data = frame + blocks[i].offset;
+            unit.size = blocks[i].size;
+            unit.pts = cursor != TS_NO_TIMESTAMP ? cursor + i * block_duration : cursor;
+            unit.dts = unit.pts;
+            unit.duration = block_duration;
+            unit.pos = es->pes_pos;
+            unit.key_frame = true;
+            keep_going = callback(opaque, &unit);
+        }
+
+        if (cursor != TS_NO_TIMESTAMP) {
+            cursor += duration;
+        }
+        pos += frame_size;
+    }
+    es->next_pts = cursor;
+
+    // 남은 조각은 다음 PES로 넘김
+    if (data == es->carry.data()) {
+        es->carry.erase(es->carry.begin(), es->carry.begin() + pos);
+    } else {
+        es->carry.assign(data + pos, data + data_size);
+    }
+    if (es->carry.size() > ADTS_MAX_CARRY) {
+        es->carry.clear();
+    }
+    return keep_going;
+}
+
+/**
+ * 조립된 PES의 헤더를 해석하여 액세스 유닛으로 내보내고 버퍼를 비움
+ */
+static bool emit_pes(TsElementaryStream* es, TsAccessUnitCallback callback, void* opaque) {
+    const uint8_t* pes = es->pes.data();
+    size_t size = es->pes.size();
+    bool keep_going = true;
+
+    if (size >= (size_t)PES_HEADER_SIZE && pes[0] == 0 && pes[1] == 0 && pes[2] == 1) {
+        size_t pes_length = ((size_t)pes[4] << 8) | pes[5];
+        size_t end = size;
+        if (pes_length > 0 && 6 + pes_length < end) {
+            end = 6 + pes_length;
+        }
+        int flags = pes[7];
+        size_t header_length = pes[8];
+        size_t payload_pos = PES_HEADER_SIZE + header_length;
+
+        int64_t pts = TS_NO_TIMESTAMP;
+        int64_t dts = TS_NO_TIMESTAMP;
+        if ((flags & 0x80) && header_length >= 5 && size >= PES_HEADER_SIZE + 5) {
+            pts = read_timestamp(pes + PES_HEADER_SIZE);
+            dts = pts;
+            if ((flags & 0xC0) == 0xC0 && header_length >= 10 && size >= PES_HEADER_SIZE + 10) {
+                dts = read_timestamp(pes + PES_HEADER_SIZE + 5);
+            }
+        }
+
+        if (payload_pos < end) {
+            const uint8_t* payload = pes + payload_pos;
+            int payload_size = (int)(end - payload_pos);
+            if (es->codec == TS_CODEC_AAC) {
+                keep_going = emit_adts_frames(es, payload, (size_t)payload_size, pts,
+                                              callback, opaque);
+            } else {
+                TsAccessUnit unit;
+                unit.pid = es->pid;
+                unit.codec = es->codec;
+                unit.data = payload;
+                unit.size = payload_size;
+                unit.pts = pts;
+                unit.dts = dts;
+                unit.duration = 0;
+                unit.pos = es->pes_pos;
+                unit.key_frame = es->random_access ||
+                                 is_video_key_frame(es->codec, payload, payload_size);
+                keep_going = callback(opaque, &unit);
+            }
+        }
+    }
+
+    es->pes.clear();
+    es->random_access = false;
+    return keep_going;
+}
+
+bool ts_demuxer_flush(TsDemuxer* demuxer, TsAccessUnitCallback callback, void* opaque) {
+    bool keep_going = true;
+    for (size_t i = 0; i < demuxer->streams.size(); i++) {
+        TsElementaryStream* es = &demuxer->streams[i];
+        if (keep_going && !es->pes.empty()) {
+            keep_going = emit_pes(es, callback, opaque);
+        }
+        // 세그먼트 끝에서 잘린 ADTS 프레임은 다음 세그먼트와 이어지지 않으므로 버린다
+        es->carry.clear();
+    }
+    return keep_going;
+}
+
+/**
+ * PSI 섹션 조각을 이어 붙이고 섹션이 완성되었는지 확인
+ * @return 완성된 섹션 길이 (table_id부터 CRC까지), 아직 미완성이면 0
+ */
+static size_t append_section(TsSection* section, const uint8_t* payload, size_t size,
+                             bool unit_start) {
+    if (unit_start) {
+        size_t pointer = payload[0];
+        if (1 + pointer >= size) {
+            section->started = false;
+            return 0;
+        }
+        section->data.assign(payload + 1 + pointer, payload + size);
+        section->started = true;
+    } else if (section->started) {
+        section->data.insert(section->data.end(), payload, payload + size);
+    } else {
+        return 0;
+    }
+    if (section->data.size() > TS_MAX_SECTION_SIZE) {
+        section->started = false;
+        return 0;
+    }
+    if (section->data.size() < 3) {
+        return 0;
+    }
+    size_t section_length = 3 + ((((size_t)section->data[1] & 0x0F) << 8) | section->data[2]);
+    if (section->data.size() < section_length) {
+        return 0;
+    }
+    section->started = false;
+    return section_length;
+}
+
+/**
+ * PAT 해석
+ * @return 프로그램이 둘 이상이면 false (다중 프로그램은 libavformat으로 처리)
+ */
+static bool parse_pat(TsDemuxer* demuxer, const uint8_t* section, size_t length) {
+    // table_id(1) ~ last_section_number(1) 8바이트 헤더, 끝의 CRC 4바이트 제외
+    if (length < 12 || section[0] != TS_TABLE_ID_PAT || !(section[5] & 0x01)) {
+        return true;
+    }
+    int pmt_pid = -1;
+    for (size_t pos = 8; pos + 4 <= length - 4; pos += 4) {
+        int program_number = (section[pos] << 8) | section[pos + 1];
+        int pid = ((section[pos + 2] & 0x1F) << 8) | section[pos + 3];
+        if (program_number == 0) {
+            continue;  // network_PID
+        }
+        if (pmt_pid >= 0 && pid != pmt_pid) {
+            return false;
+        }
+        pmt_pid = pid;
+    }
+    if (pmt_pid >= 0 && pmt_pid != demuxer->pmt_pid) {
+        demuxer->pmt_pid = pmt_pid;
+        demuxer->pmt_version = -1;
+        demuxer->pmt.started = false;
+    }
+    return true;
+}
+
+static void configure_stream(TsElementaryStream* es, int pid, int codec) {
+    if (es->pid == pid && es->codec == codec) {
+        return;
+    }
+    reset_stream(es);
+    es->pid = pid;
+    es->codec = codec;
+}
+
+/**
+ * PMT 해석
+ * @return 경량 디먹서가 처리할 수 없는 구성이면 false
+ */
+static bool parse_pmt(TsDemuxer* demuxer, const uint8_t* section, size_t length,
+                      TsAccessUnitCallback callback, void* opaque, bool* keep_going) {
+    if (length < 16 || section[0] != TS_TABLE_ID_PMT || !(section[5] & 0x01)) {
+        return true;
+    }
+    int version = (section[5] >> 1) & 0x1F;
+    if (version == demuxer->pmt_version) {
+        return true;
+    }
+
+    size_t program_info_length = ((section[10] & 0x0F) << 8) | section[11];
+    size_t end = length - 4;  // CRC 제외
+    // PMT에 나열된 비디오/오디오 ES (PID, TsCodec)
+    std::vector<std::pair<int, int> > streams;
+    for (size_t pos = 12 + program_info_length; pos + 5 <= end;) {
+        int stream_type = section[pos];
+        int pid = ((section[pos + 1] & 0x1F) << 8) | section[pos + 2];
+        size_t es_info_length = ((section[pos + 3] & 0x0F) << 8) | section[pos + 4];
+        pos += 5 + es_info_length;
+
+        switch (stream_type) {
+            case STREAM_TYPE_H264:
+                streams.push_back(std::make_pair(pid, (int)TS_CODEC_H264));
+                break;
+            case STREAM_TYPE_HEVC:
+                streams.push_back(std::make_pair(pid, (int)TS_CODEC_HEVC));
+                break;
+            case STREAM_TYPE_AAC_ADTS:
+                streams.push_back(std::make_pair(pid, (int)TS_CODEC_AAC));
+                break;
+            case STREAM_TYPE_PRIVATE_SECTION:
+            case STREAM_TYPE_METADATA:
+            case STREAM_TYPE_SCTE35:
+                // 샘플로 내보내지 않는 데이터 스트림
+                break;
+            default:
+                return false;
+        }
+    }
+    if (streams.empty()) {
+        return false;
+    }
+
+    // 구성이 바뀌면 이전 PID의 PES를 먼저 내보낸다
+    bool changed = false;
+    for (size_t i = 0; i < demuxer->streams.size(); i++) {
+        int pid = i < streams.size() ? streams[i].first : -1;
+        if (demuxer->streams[i].pid != pid) {
+            changed = true;
+        }
+    }
+    if (changed || streams.size() > demuxer->streams.size()) {
+        *keep_going = ts_demuxer_flush(demuxer, callback, opaque);
+    }
+    // 남는 슬롯은 PES 버퍼 용량을 유지한 채 비워 둔다
+    if (demuxer->streams.size() < streams.size()) {
+        demuxer->streams.resize(streams.size());
+    }
+    for (size_t i = 0; i < demuxer->streams.size(); i++) {
+        if (i < streams.size()) {
+            configure_stream(&demuxer->streams[i], streams[i].first, streams[i].second);
+        } else {
+            reset_stream(&demuxer->streams[i]);
+        }
+    }
+    demuxer->pmt_version = version;
+    return true;
+}
+
+/**
+ * PES 패킷 조각 처리
+ */
+static bool push_pes_payload(TsElementaryStream* es, const uint8_t* payload, size_t size,
+                             bool unit_start, bool random_access, int64_t pes_pos,
+                             TsAccessUnitCallback callback, void* opaque) {
+    bool keep_going = true;
+    if (unit_start) {
+        if (!es->pes.empty()) {
+            keep_going = emit_pes(es, callback, opaque);
+        }
+        es->random_access = random_access;
+        es->pes_pos = pes_pos;
+    } else if (es->pes.empty()) {
+        return true;  // PES 시작 전 조각 (세션 시작 직후 등)
+    }
+    es->pes.insert(es->pes.end(), payload, payload + size);
+
+    // PES_packet_length가 있으면 다음 PES를 기다리지 않고 바로 내보낸다
+    if (keep_going && es->pes.size() >= 6) {
+        size_t pes_length = ((size_t)es->pes[4] << 8) | es->pes[5];
+        if (pes_length > 0 && es->pes.size() >= 6 + pes_length) {
+            keep_going = emit_pes(es, callback, opaque);
+        }
+    }
+    return keep_going;
+}
+
+/**
+ * TS 패킷 하나 처리
+ * @return TsFeedStatus
+ */
+static int process_packet(TsDemuxer* demuxer, const uint8_t* packet,
+                          TsAccessUnitCallback callback, void* opaque) {
+    demuxer->packet_count++;
+    if (packet[1] & 0x80) {
+        return TS_FEED_OK;  // transport_error_indicator
+    }
+    bool unit_start = (packet[1] & 0x40) != 0;
+    int pid = ((packet[1] & 0x1F) << 8) | packet[2];
+    int adaptation = (packet[3] >> 4) & 0x03;
+    int continuity = packet[3] & 0x0F;
+    if (pid == TS_NULL_PID || !(adaptation & 0x01)) {
+        return TS_FEED_OK;
+    }
+
+    size_t offset = 4;
+    bool random_access = false;
+    if (adaptation & 0x02) {
+        size_t adaptation_length = packet[4];
+        if (adaptation_length > 0) {
+            random_access = (packet[5] & 0x40) != 0;
+        }
+        offset += 1 + adaptation_length;
+        if (offset >= (size_t)TS_PACKET_SIZE) {
+            return TS_FEED_OK;
+        }
+    }
+    const uint8_t* payload = packet + offset;
+    size_t payload_size = TS_PACKET_SIZE - offset;
+
+    if (pid == TS_PAT_PID) {
+        size_t length = append_section(&demuxer->pat, payload, payload_size, unit_start);
+        if (length > 0 && !parse_pat(demuxer, demuxer->pat.data.data(), length)) {
+            return TS_FEED_UNSUPPORTED;
+        }
+        return TS_FEED_OK;
+    }
+    if (pid == demuxer->pmt_pid) {
+        size_t length = append_section(&demuxer->pmt, payload, payload_size, unit_start);
+        bool keep_going = true;
+        if (length > 0 && !parse_pmt(demuxer, demuxer->pmt.data.data(), length,
+                                     callback, opaque, &keep_going)) {
+            return TS_FEED_UNSUPPORTED;
+        }
+        return keep_going ? TS_FEED_OK : TS_FEED_STOPPED;
+    }
+
+    // 선택되지 않은 PID는 PES 조립 전에 버린다
+    if (!is_pid_selected(demuxer, pid)) {
+        return TS_FEED_OK;
+    }
+    TsElementaryStream* es = nullptr;
+    for (size_t i = 0; i < demuxer->streams.size(); i++) {
+        if (demuxer->streams[i].pid == pid) {
+            es = &demuxer->streams[i];
+            break;
+        }
+    }
+    if (!es) {
+        return TS_FEED_OK;
+    }
+
+    if (es->continuity >= 0) {
+        if (continuity == es->continuity) {
+            return TS_FEED_OK;  // 중복 패킷
+        }
+        if (continuity != ((es->continuity + 1) & 0x0F)) {
+            demuxer->continuity_errors++;
+        }
+    }
+    es->continuity = continuity;
+
+    bool keep_going = push_pes_payload(es, payload, payload_size, unit_start, random_access,
+                                       demuxer->packet_pos, callback, opaque);
+    return keep_going ? TS_FEED_OK : TS_FEED_STOPPED;
+}
+
+int ts_demuxer_feed(TsDemuxer* demuxer, const uint8_t* data, size_t size,
+                    TsAccessUnitCallback callback, void* opaque, size_t* consumed) {
+    size_t pos = 0;
+    *consumed = 0;
+    int64_t base_pos = demuxer->input_pos;
+    demuxer->input_pos += (int64_t)size;
+
+    // 이전 입력 끝에 걸렸던 패킷을 먼저 완성
+    if (demuxer->partial_size > 0) {
+        demuxer->packet_pos = base_pos - demuxer->partial_size;
+        size_t needed = TS_PACKET_SIZE - demuxer->partial_size;
+        size_t copy = needed < size ? needed : size;
+        memcpy(demuxer->partial + demuxer->partial_size, data, copy);
+        demuxer->partial_size += (int)copy;
+        pos = copy;
+        if (demuxer->partial_size < TS_PACKET_SIZE) {
+            return TS_FEED_OK;
+        }
+        demuxer->partial_size = 0;
+        if (demuxer->partial[0] != TS_SYNC_BYTE) {
+            demuxer->sync_errors++;
+            pos = find_sync(data, size, 0);
+        } else {
+            int status = process_packet(demuxer, demuxer->partial, callback, opaque);
+            if (status == TS_FEED_UNSUPPORTED) {
+                demuxer->partial_size = TS_PACKET_SIZE;
+                *consumed = pos;
+            }
+            if (status != TS_FEED_OK) {
+                return status;
+            }
+        }
+    }
+
+    while (size - pos >= (size_t)TS_PACKET_SIZE) {
+        size_t count = ts_count_synced_packets(data + pos, (size - pos) / TS_PACKET_SIZE);
+        if (count == 0) {
+            demuxer->sync_errors++;
+            pos = find_sync(data, size, pos + 1);
+            continue;
+        }
+        for (size_t i = 0; i < count; i++, pos += TS_PACKET_SIZE) {
+            demuxer->packet_pos = base_pos + (int64_t)pos;
+            int status = process_packet(demuxer, data + pos, callback, opaque);
+            if (status == TS_FEED_UNSUPPORTED) {
+                memcpy(demuxer->partial, data + pos, TS_PACKET_SIZE);
+                demuxer->partial_size = TS_PACKET_SIZE;
+                *consumed = pos + TS_PACKET_SIZE;
+            }
+            if (status != TS_FEED_OK) {
+                return status;
+            }
+        }
+    }
+
+    // 다음 입력과 이어질 나머지 바이트 보관
+    if (pos < size) {
+        memcpy(demuxer->partial, data + pos, size - pos);
+        demuxer->partial_size = (int)(size - pos);
+    }
+    *consumed = size;
+    return TS_FEED_OK;
+}
@@ -0,0 +1,143 @@
+/*
+ * HLS용 경량 MPEG-TS 디먹서
+ *
+ * 단일 프로그램에 H.264/HEVC 비디오와 ADTS AAC 오디오(다중 언어 오디오 포함)로 구성된 일반적인
+ * HLS TS를 libavformat 없이 디먹싱한다. 188바이트 패킷을 순회하며 PAT/PMT 섹션을 해석하고, PES를
+ * PID별로 재사용 버퍼에 조립한 뒤 액세스 유닛(비디오 프레임 / ADTS 헤더를 뺀 raw AAC 프레임)을
+ * 콜백으로 바로 내보낸다.
+ * PID 선택 마스크에 없는 PID의 패킷은 PES 조립 전에 버린다.
+ * 그 밖의 구성(다중 프로그램, 다른 코덱, SAMPLE-AES 등)은 TS_FEED_UNSUPPORTED로 알려
+ * 호출자가 libavformat으로 전환하게 한다.
+ */
+#ifndef YOPLAYER_TS_DEMUXER_H
+#define YOPLAYER_TS_DEMUXER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+static const int TS_PACKET_SIZE = 188;
+static const int64_t TS_NO_TIMESTAMP = INT64_MIN;
+static const int TS_PID_COUNT = 0x2000;   // 13비트 PID
+
+enum TsCodec {
+    TS_CODEC_UNKNOWN = 0,
+    TS_CODEC_H264,
+    TS_CODEC_HEVC,
+    TS_CODEC_AAC,
+};
+
+enum TsFeedStatus {
+    TS_FEED_OK = 0,
+    TS_FEED_STOPPED,       // 콜백이 false를 반환하여 중단
+    TS_FEED_UNSUPPORTED,   // 경량 디먹서가 처리할 수 없는 PAT/PMT 구성
+};
+
+// 디먹싱된 액세스 유닛 (data는 콜백 동안만 유효, AAC는 ADTS 헤더를 뺀 raw_data_block)
+struct TsAccessUnit {
+    int pid;
+    int codec;          // TsCodec
+    const uint8_t* data;
+    int size;
+    int64_t pts;        // 90kHz, 없으면 TS_NO_TIMESTAMP
+    int64_t dts;
+    int64_t duration;   // 90kHz, 모르면 0 (AAC는 ADTS 헤더에서 계산)
+    int64_t pos;        // PES가 시작된 TS 패킷의 입력 위치 (ts_demuxer_reset/restart 이후 누적 바이트)
+    bool key_frame;
+};
+
+/**
+ * 액세스 유닛 수신 콜백
+ * @return false면 디먹싱 중단
+ */
+typedef bool (*TsAccessUnitCallback)(void* opaque, const TsAccessUnit* unit);
+
+// 여러 패킷에 걸친 PSI 섹션(PAT/PMT) 조립 버퍼
+struct TsSection {
+    std::vector<uint8_t> data;
+    bool started;
+};
+
+// 엘리멘터리 스트림 하나의 PES 조립 상태
+struct TsElementaryStream {
+    int pid;                    // -1이면 없음
+    int codec;                  // TsCodec
+    int continuity;             // 마지막 continuity_counter, -1이면 아직 없음
+    bool random_access;         // 현재 PES 첫 패킷의 random_access_indicator
+    int64_t pes_pos;            // 현재 PES 첫 패킷의 입력 위치
+    std::vector<uint8_t> pes;   // 조립 중인 PES (헤더 포함), 용량은 PES마다 재사용
+    // AAC: 다음 PES로 이어지는 ADTS 프레임 조각과 다음 프레임의 예상 PTS
+    std::vector<uint8_t> carry;
+    int64_t next_pts;
+};
+
+struct TsDemuxer {
+    int pmt_pid;                // PAT에서 찾은 PMT PID, -1이면 아직 없음
+    int pmt_version;            // 적용된 PMT version_number, -1이면 아직 없음
+    TsSection pat;
+    TsSection pmt;
+    std::vector<TsElementaryStream> streams;   // PMT에 나열된 순서의 비디오/오디오 ES
+    // 디먹싱할 PID 비트마스크 (filter_pids가 false면 모든 PID), reset해도 유지된다
+    bool filter_pids;
+    uint8_t pid_mask[TS_PID_COUNT / 8];
+    // 입력 경계에 걸린 패킷 조각 (TS_FEED_UNSUPPORTED일 때는 처리하지 못한 PMT 패킷)
+    uint8_t partial[TS_PACKET_SIZE];
+    int partial_size;
+    int64_t input_pos;          // 지금까지 입력된 바이트 수 (다음 입력의 첫 바이트 위치)
+    int64_t packet_pos;         // 처리 중인 패킷의 입력 위치
+    int64_t packet_count;
+    int64_t sync_errors;
+    int64_t continuity_errors;
+};
+
+/**
+ * 디먹서 상태 초기화 (PAT/PMT와 조립 중인 PES를 모두 버림)
+ * PES 버퍼의 용량과 PID 선택은 유지된다.
+ */
+void ts_demuxer_reset(TsDemuxer* demuxer);
+
+/**
+ * 입력 위치를 옮겨 다시 시작 (seek)
+ * 적용된 PAT/PMT와 PID 선택은 유지하고, 조립 중인 PES와 continuity, 입력 조각을 버린다.
+ * 이후 입력은 PAT/PMT가 없는 세그먼트 중간(키프레임 패킷)부터 시작해도 된다.
+ */
+void ts_demuxer_restart(TsDemuxer* demuxer);
+
+/**
+ * 디먹싱할 PID 선택
+ * 선택되지 않은 PID의 패킷은 continuity 검사와 PES 조립 없이 버린다.
+ * 다시 선택된 PID는 다음 PES 시작부터 내보낸다.
+ * @param pids 선택할 PID 목록, nullptr이면 모든 PID
+ */
+void ts_demuxer_select_pids(TsDemuxer* demuxer, const int* pids, size_t count);
+
+/**
+ * TS 바이트 입력
+ * 패킷 경계와 무관하게 임의 크기로 나누어 넣을 수 있다.
+ * @param consumed TS_FEED_UNSUPPORTED일 때 data에서 처리한 바이트 수.
+ *                 처리하지 못한 입력은 partial[0, partial_size) + data[*consumed, size)이다.
+ * @return TsFeedStatus
+ */
+int ts_demuxer_feed(TsDemuxer* demuxer, const uint8_t* data, size_t size,
+                    TsAccessUnitCallback callback, void* opaque, size_t* consumed);
+
+/**
+ * 세그먼트 끝에서 조립 중인 PES를 내보냄 (libavformat이 EOF에서 미완성 PES를 내보내는 것과 같음)
+ * PAT/PMT와 continuity 상태는 다음 세그먼트를 위해 유지된다.
+ * @return false면 콜백이 중단을 요청
+ */
+bool ts_demuxer_flush(TsDemuxer* demuxer, TsAccessUnitCallback callback, void* opaque);
+
+/**
+ * PMT를 적용하여 경량 디먹서로 디먹싱 중인지 여부
+ */
+bool ts_demuxer_has_program(const TsDemuxer* demuxer);
+
+/**
+ * data에서 연속으로 동기 바이트(0x47)가 맞는 패킷 수 반환
+ * @param count 검사할 최대 패킷 수 (data는 count * 188바이트 이상이어야 함)
+ */
+size_t ts_count_synced_packets(const uint8_t* data, size_t count);
+
+#endif  // YOPLAYER_TS_DEMUXER_H
@@ -4,6 +4,7 @@ import android.content.Context
 import androidx.annotation.OptIn
 import androidx.media3.common.util.UnstableApi
 import com.yohan.yoplayersdk.player.YoPlayer
+import com.yohan.yoplayersdk.player.YoPlayerBufferConfig
 import com.yohan.yoplayersdk.player.YoPlayerImpl
 
 object YoPlayerSdk {
@@ -12,12 +13,17 @@ object YoPlayerSdk {
      * YoPlayer 인스턴스 생성
      *
      * @param context Android Context (Application 또는 Activity)
+     * @param bufferConfig 버퍼 메모리/길이 정책 (메모리가 작은 기기는 [YoPlayerBufferConfig.LOW_MEMORY])
      * @return YoPlayer 인스턴스
      */
     @OptIn(UnstableApi::class)
-    fun buildPlayer(context: Context): YoPlayer {
+    fun buildPlayer(
+        context: Context,
+        bufferConfig: YoPlayerBufferConfig = YoPlayerBufferConfig()
+    ): YoPlayer {
         return YoPlayerImpl(
-            context = context.applicationContext
+            context = context.applicationContext,
+            bufferConfig = bufferConfig
         )
     }
 }
@@ -7,12 +7,18 @@ package com.yohan.yoplayersdk.demuxer
  * @property timeUs 프레젠테이션 타임스탬프 (마이크로초)
  * @property flags 샘플 플래그 (KEY_FRAME, DECODE_ONLY 등)
  * @property data 압축된 샘플 데이터
+ * @property trackId 트랙 ID ([TrackFormat.id], MPEG-TS PID)
+ * @property durationUs 샘플 길이 (마이크로초, 모르면 0)
+ * @property decodeTimeUs 디코딩 타임스탬프 (마이크로초, B 프레임이 없으면 [timeUs]와 같음)
  */
 data class DemuxedSample(
     val trackType: Int,
     val timeUs: Long,
     val flags: Int,
-    val data: ByteArray
+    val data: ByteArray,
+    val trackId: Int = 0,
+    val durationUs: Long = 0,
+    val decodeTimeUs: Long = timeUs
 ) {
     companion object {
         const val FLAG_KEY_FRAME = 1
@@ -39,14 +45,20 @@ data class DemuxedSample(
         if (javaClass != other?.javaClass) return false
         other as DemuxedSample
         return trackType == other.trackType &&
+                trackId == other.trackId &&
                 timeUs == other.timeUs &&
+                durationUs == other.durationUs &&
+                decodeTimeUs == other.decodeTimeUs &&
                 flags == other.flags &&
                 data.contentEquals(other.data)
     }
 
     override fun hashCode(): Int {
         var result = trackType
+        result = 31 * result + trackId
         result = 31 * result + timeUs.hashCode()
+        result = 31 * result + durationUs.hashCode()
+        result = 31 * result + decodeTimeUs.hashCode()
         result = 31 * result + flags
         result = 31 * result + data.contentHashCode()
         return result
@@ -0,0 +1,111 @@
+package com.yohan.yoplayersdk.demuxer
+
+import java.nio.ByteBuffer
+
+/**
+ * 디먹싱 결과를 구조체-배열(SoA) 형태로 담은 샘플 배치
+ *
+ * 모든 샘플의 페이로드는 하나의 direct ByteBuffer에 연속으로 저장되고,
+ * 샘플별 메타데이터는 같은 인덱스를 공유하는 병렬 배열로 제공됩니다.
+ * 패킷마다 객체를 만들지 않으며, 소비자는 [offset]/[size]로 [data]의 구간을 읽습니다.
+ *
+ * @property data 전체 샘플 페이로드 (direct ByteBuffer, position/limit는 사용하지 않음)
+ * @property timeUs 샘플별 프레젠테이션 타임스탬프 (마이크로초, 첫 샘플 기준으로 정규화됨, 알 수 없으면 C.TIME_UNSET)
+ * @property decodeTimeUs 샘플별 디코딩 타임스탬프 (마이크로초, [timeUs]와 같은 기준, B 프레임이 없으면 [timeUs]와 같음)
+ * @property durationUs 샘플별 길이 (마이크로초, 오디오는 프레임 헤더, 비디오는 패킷 길이 또는 DTS 간격, 모르면 0)
+ * @property offset 샘플별 [data] 내 시작 위치
+ * @property size 샘플별 페이로드 크기
+ * @property flags 샘플별 플래그 ([DemuxedSample.FLAG_KEY_FRAME] 등)
+ * @property trackType 샘플별 트랙 타입 (TRACK_TYPE_VIDEO=2, TRACK_TYPE_AUDIO=1)
+ * @property trackId 샘플별 트랙 ID ([TrackFormat.id], MPEG-TS PID)
+ */
+class DemuxedSampleBatch(
+    val data: ByteBuffer,
+    val timeUs: LongArray,
+    val decodeTimeUs: LongArray,
+    val durationUs: LongArray,
+    val offset: IntArray,
+    val size: IntArray,
+    val flags: IntArray,
+    val trackType: IntArray,
+    val trackId: IntArray
+) {
+    companion object {
+        val EMPTY = DemuxedSampleBatch(
+            data = ByteBuffer.allocateDirect(0),
+            timeUs = LongArray(0),
+            decodeTimeUs = LongArray(0),
+            durationUs = LongArray(0),
+            offset = IntArray(0),
+            size = IntArray(0),
+            flags = IntArray(0),
+            trackType = IntArray(0),
+            trackId = IntArray(0)
+        )
+    }
+
+    /** 배치의 샘플 수 */
+    val sampleCount: Int
+        get() = timeUs.size
+
+    fun isKeyFrame(index: Int): Boolean =
+        (flags[index] and DemuxedSample.FLAG_KEY_FRAME) != 0
+
+    fun isVideo(index: Int): Boolean =
+        trackType[index] == TrackFormat.TRACK_TYPE_VIDEO
+
+    fun isAudio(index: Int): Boolean =
+        trackType[index] == TrackFormat.TRACK_TYPE_AUDIO
+
+    /**
+     * 특정 트랙의 샘플 수
+     */
+    fun countSamples(trackType: Int): Int {
+        var count = 0
+        for (i in 0 until sampleCount) {
+            if (this.trackType[i] == trackType) count++
+        }
+        return count
+    }
+
+    /**
+     * 특정 트랙 ID의 샘플 수
+     */
+    fun countTrackSamples(trackId: Int): Int {
+        var count = 0
+        for (i in 0 until sampleCount) {
+            if (this.trackId[i] == trackId) count++
+        }
+        return count
+    }
+
+    /**
+     * 단일 샘플을 [DemuxedSample]로 변환 (페이로드 복사 발생)
+     */
+    fun getSample(index: Int): DemuxedSample {
+        val bytes = ByteArray(size[index])
+        val view = data.duplicate()
+        view.position(offset[index])
+        view.get(bytes)
+        return DemuxedSample(
+            trackType = trackType[index],
+            timeUs = timeUs[index],
+            durationUs = durationUs[index],
+            decodeTimeUs = decodeTimeUs[index],
+            flags = flags[index],
+            data = bytes,
+            trackId = trackId[index]
+        )
+    }
+
+    /**
+     * 전체 샘플을 [DemuxedSample] 목록으로 변환 (페이로드 복사 발생)
+     */
+    fun toSampleList(): List<DemuxedSample> = List(sampleCount) { getSample(it) }
+
+    override fun toString(): String {
+        val videoCount = countSamples(TrackFormat.TRACK_TYPE_VIDEO)
+        val audioCount = countSamples(TrackFormat.TRACK_TYPE_AUDIO)
+        return "DemuxedSampleBatch(samples=$sampleCount, video=$videoCount, audio=$audioCount)"
+    }
+}
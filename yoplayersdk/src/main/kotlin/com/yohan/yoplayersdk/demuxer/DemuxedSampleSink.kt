@@ -0,0 +1,19 @@
+package com.yohan.yoplayersdk.demuxer
+
+/**
+ * 네이티브 디먹서가 샘플 배치를 청크 단위로 전달하는 싱크
+ *
+ * 세그먼트 하나가 여러 개의 [DemuxedSampleBatch]로 나뉘어 디먹싱 스레드에서 순서대로 전달됩니다.
+ * 샘플 수 제한이 없으므로 긴 세그먼트나 다중 트랙에서도 뒷부분이 잘리지 않습니다.
+ * 콜백에서 예외를 던지면 디먹싱이 중단되고 예외가 호출자에게 전파됩니다.
+ */
+fun interface DemuxedSampleSink {
+
+    /**
+     * 샘플 배치 청크 수신
+     *
+     * @param batch 디먹싱된 샘플 배치. 페이로드 버퍼는 다음 청크에 재사용되므로 콜백 안에서만 유효하며,
+     *              보관하려면 복사해야 합니다.
+     */
+    fun onSampleBatch(batch: DemuxedSampleBatch)
+}
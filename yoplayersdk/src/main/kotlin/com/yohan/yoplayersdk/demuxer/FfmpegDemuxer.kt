@@ -1,6 +1,7 @@
 package com.yohan.yoplayersdk.demuxer
 
 import android.util.Log
+import java.nio.ByteBuffer
 
 /**
  * FFmpeg 네이티브 디먹서 JNI 래퍼
@@ -13,6 +14,10 @@ internal class FfmpegDemuxer {
     companion object {
         private const val LIB_NAME = "ffmpegDemuxerJNI"
 
+        // 세그먼트 암호화 방식 (네이티브 DECRYPTION_METHOD_* 와 동일)
+        const val DECRYPTION_AES_128 = 1
+        const val DECRYPTION_SAMPLE_AES = 2
+
         private var isLibraryLoaded = false
 
         /**
@@ -57,17 +62,303 @@ internal class FfmpegDemuxer {
         return tracks?.toList() ?: emptyList()
     }
 
+    /**
+     * direct ByteBuffer의 세그먼트 데이터를 분석하여 트랙 정보 반환
+     * 버퍼 주소를 네이티브에서 바로 읽으므로 Java 힙 복사가 발생하지 않습니다.
+     * @param buffer TS 세그먼트가 담긴 direct ByteBuffer
+     * @param offset 버퍼 내 세그먼트 시작 위치
+     * @param length 세그먼트 크기
+     * @return 트랙 포맷 목록
+     */
+    fun probeSegmentDirect(buffer: ByteBuffer, offset: Int, length: Int): List<TrackFormat> {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        require(buffer.isDirect) { "Direct ByteBuffer required" }
+        val tracks = nativeProbeSegmentDirect(nativeContext, buffer, offset, length)
+        return tracks?.toList() ?: emptyList()
+    }
+
     /**
      * 세그먼트 데이터를 디먹싱하여 샘플 추출
      * @param data TS 세그먼트 바이트 배열
-     * @return 추출된 샘플 목록
+     * @return 추출된 샘플 배치
+     */
+    fun demuxSegment(data: ByteArray): DemuxedSampleBatch {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        return nativeDemuxSegment(nativeContext, data) ?: DemuxedSampleBatch.EMPTY
+    }
+
+    /**
+     * 세션 모드로 세그먼트 데이터를 디먹싱하여 샘플 추출
+     * 하나의 네이티브 디먹서 컨텍스트를 플레이리스트 전체에서 유지하므로 스트림 분석은
+     * 세션 시작 시 한 번만 수행되고, PES/연속성 상태가 세그먼트 경계를 넘어 이어집니다.
+     * @param data TS 세그먼트 바이트 배열 (재생 순서대로 전달해야 함)
+     * @return 추출된 샘플 배치
+     */
+    fun demuxSessionSegment(data: ByteArray): DemuxedSampleBatch {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        return nativeDemuxSessionSegment(nativeContext, data) ?: DemuxedSampleBatch.EMPTY
+    }
+
+    /**
+     * 세션 모드로 direct ByteBuffer의 세그먼트 데이터를 디먹싱하여 샘플 추출
+     * 버퍼 주소를 네이티브에서 바로 읽으므로 세그먼트 전체에 대한 Java 힙 복사가 발생하지 않습니다.
+     * @param buffer TS 세그먼트가 담긴 direct ByteBuffer
+     * @param offset 버퍼 내 세그먼트 시작 위치
+     * @param length 세그먼트 크기
+     * @return 추출된 샘플 배치
+     */
+    fun demuxSegmentDirect(buffer: ByteBuffer, offset: Int, length: Int): DemuxedSampleBatch {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        require(buffer.isDirect) { "Direct ByteBuffer required" }
+        return nativeDemuxSegmentDirect(nativeContext, buffer, offset, length)
+            ?: DemuxedSampleBatch.EMPTY
+    }
+
+    /**
+     * 세션 모드로 direct ByteBuffer의 세그먼트 데이터를 디먹싱하여 샘플을 싱크로 스트리밍
+     * 샘플 수 제한 없이 일정 크기의 청크로 나누어 [DemuxedSampleSink.onSampleBatch]를 호출합니다.
+     * @param buffer TS 세그먼트가 담긴 direct ByteBuffer
+     * @param offset 버퍼 내 세그먼트 시작 위치
+     * @param length 세그먼트 크기
+     * @param sink 샘플 배치를 받을 싱크 (호출 스레드에서 동기적으로 호출됨)
+     * @return 전달된 샘플 수 (실패 시 음수)
+     */
+    fun demuxSegmentDirect(
+        buffer: ByteBuffer,
+        offset: Int,
+        length: Int,
+        sink: DemuxedSampleSink
+    ): Int {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        require(buffer.isDirect) { "Direct ByteBuffer required" }
+        return nativeDemuxSegmentToSink(nativeContext, buffer, offset, length, sink)
+    }
+
+    /**
+     * 다음 세그먼트의 복호화 설정 (EXT-X-KEY)
+     * [DECRYPTION_AES_128]은 push 모드에서 이후 [feed]부터 [endSegment]까지, 그 밖에는 다음 분석/디먹싱 호출의
+     * 입력에 적용되며, 평문은 네이티브 버퍼에 쓰이므로 direct 버퍼/바이트 배열 입력은 바뀌지 않습니다.
+     * [DECRYPTION_SAMPLE_AES]는 해당 세그먼트를 디먹싱하면서 H.264/AAC 샘플을 복호화합니다.
+     * 설정은 세그먼트 하나를 처리하면 해제됩니다.
+     * @param method 암호화 방식
+     * @param key 16바이트 키 (null이면 복호화 해제)
+     * @param iv 16바이트 IV
+     * @return 방식/키/IV가 올바르지 않으면 false
+     */
+    fun setDecryption(method: Int, key: ByteArray?, iv: ByteArray?): Boolean {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        return nativeSetDecryption(nativeContext, method, key, iv)
+    }
+
+    /**
+     * 디먹싱할 트랙 선택
+     * 선택되지 않은 트랙의 PID는 PES 조립 전에 버려져 디먹싱 비용이 들지 않습니다.
+     * 어느 스레드에서든 호출할 수 있으며, 다음에 시작하는 세그먼트부터 적용됩니다.
+     * @param trackIds 선택할 트랙 ID([TrackFormat.id]) 목록, null이면 모든 트랙
+     */
+    fun setSelectedTracks(trackIds: IntArray?) {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        nativeSetSelectedTracks(nativeContext, trackIds)
+    }
+
+    /**
+     * 입력 FIFO와 임시 메모리 사용량을 반영할 플레이어 메모리 예산 설정
+     * 예산이 모자라면 [feed]가 디먹싱으로 자리가 날 때까지 대기합니다.
+     * @param budget 네이티브 예산 포인터 (디먹서보다 늦게 해제), 0이면 고정 한도만 적용
+     */
+    fun setMemoryBudget(budget: Long) {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        nativeSetMemoryBudget(nativeContext, budget)
+    }
+
+    /**
+     * push 모드 시작
+     * 다운로드 중인 세그먼트 바이트를 [feed]로 넘기고, 다른 스레드에서 [drainSamples]로
+     * 디먹싱하여 세그먼트 전송이 끝나기 전에 샘플을 받을 수 있습니다.
+     * 기존 세션과 아직 디먹싱되지 않은 입력은 버려집니다.
+     */
+    fun startPush() {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        nativeStartPush(nativeContext)
+    }
+
+    /**
+     * push 모드로 세그먼트 바이트 전달
+     * 디먹싱되지 않은 입력이 네이티브 한도를 넘으면 자리가 날 때까지 대기합니다.
+     * @return false면 push 모드가 아니거나 취소됨
+     */
+    fun feed(data: ByteArray, offset: Int, length: Int): Boolean {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        return nativeFeed(nativeContext, data, offset, length)
+    }
+
+    /**
+     * push 모드로 direct ByteBuffer의 [offset, offset + length) 구간 전달
+     * @return false면 push 모드가 아니거나 취소됨
+     */
+    fun feedDirect(buffer: ByteBuffer, offset: Int, length: Int): Boolean {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        require(buffer.isDirect) { "Direct ByteBuffer required" }
+        return nativeFeedDirect(nativeContext, buffer, offset, length)
+    }
+
+    /**
+     * push 모드로 전달 중인 세그먼트의 끝 표시
+     */
+    fun endSegment() {
+        if (isInitialized) {
+            nativeEndSegment(nativeContext)
+        }
+    }
+
+    /**
+     * push 모드로 다음 세그먼트를 디먹싱하여 샘플을 싱크로 전달
+     * 입력이 모자라면 [feed]를 기다리며, 세그먼트 끝([endSegment])에 도달하거나 취소되면 반환합니다.
+     * [feed]를 호출하는 스레드와 다른 스레드에서 호출해야 합니다.
+     * @return 전달된 샘플 수 (실패 시 음수)
+     */
+    fun drainSamples(sink: DemuxedSampleSink): Int {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        return nativeDrainSamples(nativeContext, sink)
+    }
+
+    /**
+     * push 모드 취소
+     * 대기 중인 [feed]/[drainSamples]를 깨워 반환시킵니다. [release] 전에 호출해야 합니다.
+     */
+    fun cancelPush() {
+        if (isInitialized) {
+            nativeCancelPush(nativeContext)
+        }
+    }
+
+    /**
+     * 병렬 디먹스 풀 시작
+     * 다운로드를 마친 세그먼트를 [submitSegment]로 넘기면 네이티브 워커들이 동시에 복호화/파싱하고,
+     * 디먹스 스레드의 [drainPooledSegment]가 제출 순서대로 샘플을 내보냅니다.
+     * 타임스탬프 정규화는 출력 시 순서대로 수행되므로 순차 디먹싱과 같은 시각이 나옵니다.
+     * 같은 세그먼트 흐름에 [feed]와 섞어 쓰지 않습니다.
+     * @param workers 워커 수 (1 ~ 8)
+     * @return 시작된 워커 수
+     */
+    fun startPool(workers: Int): Int {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        return nativeStartPool(nativeContext, workers)
+    }
+
+    /**
+     * 다운로드를 마친 세그먼트를 병렬 디먹스 풀에 제출
+     * 버퍼의 [offset, offset + length) 구간을 복사하므로 반환 후 버퍼를 재사용해도 됩니다.
+     * [setDecryption]으로 설정한 복호화는 이 세그먼트에 적용됩니다.
+     * 출력하지 않은 세그먼트가 한도를 넘으면 [drainPooledSegment]가 꺼낼 때까지 대기합니다.
+     * @param discontinuity true면 이 세그먼트를 출력하기 직전에 [resetSession]과 같이 기준을 다시 잡음
+     * @return 세그먼트 순번, 풀이 없거나 취소되었으면 -1
+     */
+    fun submitSegment(buffer: ByteBuffer, offset: Int, length: Int, discontinuity: Boolean): Long {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        require(buffer.isDirect) { "Direct ByteBuffer required" }
+        return nativeSubmitSegment(nativeContext, buffer, offset, length, discontinuity)
+    }
+
+    /**
+     * 병렬 디먹스 풀에 제출한 다음 세그먼트의 샘플을 싱크로 전달
+     * 파싱이 끝나지 않았으면 기다리며, [submitSegment]를 호출하는 스레드와 다른 스레드에서 호출해야 합니다.
+     * @return 전달된 샘플 수, 취소되었으면 0 (실패 시 음수)
+     */
+    fun drainPooledSegment(sink: DemuxedSampleSink): Int {
+        if (isInitialized.not()) {
+            throw IllegalStateException("Demuxer not initialized")
+        }
+        return nativeDrainPooledSegment(nativeContext, sink)
+    }
+
+    /**
+     * 병렬 디먹스 풀 취소
+     * 대기 중인 [submitSegment]/[drainPooledSegment]를 깨워 반환시킵니다.
+     */
+    fun cancelPool() {
+        if (isInitialized) {
+            nativeCancelPool(nativeContext)
+        }
+    }
+
+    /**
+     * 병렬 디먹스 풀의 출력하지 않은 세그먼트를 버리고 다시 제출할 수 있게 함 (seek)
+     * [cancelPool] 후 진행 중인 [drainPooledSegment]가 반환된 뒤에 호출해야 합니다.
      */
-    fun demuxSegment(data: ByteArray): List<DemuxedSample> {
+    fun resetPool() {
+        if (isInitialized) {
+            nativeResetPool(nativeContext)
+        }
+    }
+
+    /**
+     * push 모드로 seek
+     * 디먹싱되지 않은 입력을 버리고 이후 샘플 시각이 [timeUs]부터 이어지도록 합니다.
+     * [cancelPush] 후 [drainSamples]가 반환된 뒤에 호출해야 합니다.
+     *
+     * @param timeUs seek 위치의 시각
+     * @param pts [timeUs]에 대응하는 90kHz PTS, 모르면 음수 (다음 샘플이 [timeUs]가 됨)
+     * @return 적용된 PAT/PMT를 유지했으면 true. 이때는 세그먼트 중간의 키프레임 패킷부터 넣을 수 있고,
+     *         false면 세그먼트 처음부터 넣어야 합니다.
+     */
+    fun seekPush(timeUs: Long, pts: Long): Boolean {
         if (isInitialized.not()) {
             throw IllegalStateException("Demuxer not initialized")
         }
-        val samples = nativeDemuxSegment(nativeContext, data)
-        return samples?.toList() ?: emptyList()
+        return nativeSeekPush(nativeContext, timeUs, pts)
+    }
+
+    /**
+     * 마지막으로 디먹싱한 세그먼트의 키프레임 인덱스
+     * 경량 TS 디먹서로 읽은 세그먼트만 기록되며, libavformat으로 읽었으면 비어 있습니다.
+     *
+     * @return (timeUs, 90kHz PTS, 세그먼트 내 바이트 오프셋) 반복 배열
+     */
+    fun getKeyframeIndex(): LongArray {
+        if (isInitialized.not()) {
+            return LongArray(0)
+        }
+        return nativeGetKeyframeIndex(nativeContext) ?: LongArray(0)
+    }
+
+    /**
+     * 디먹스 세션 종료
+     * 다음 [demuxSessionSegment] 호출에서 스트림 분석부터 다시 시작합니다.
+     * 타임스탬프는 지금까지 출력한 마지막 시점에 이어지도록 기준을 다시 잡습니다.
+     */
+    fun resetSession() {
+        if (isInitialized) {
+            nativeResetSession(nativeContext)
+        }
     }
 
     /**
@@ -89,7 +380,60 @@ internal class FfmpegDemuxer {
 
     private external fun nativeInit(): Long
     private external fun nativeProbeSegment(context: Long, data: ByteArray): Array<TrackFormat>?
-    private external fun nativeDemuxSegment(context: Long, data: ByteArray): Array<DemuxedSample>?
+    private external fun nativeProbeSegmentDirect(
+        context: Long,
+        buffer: ByteBuffer,
+        offset: Int,
+        length: Int
+    ): Array<TrackFormat>?
+    private external fun nativeDemuxSegment(context: Long, data: ByteArray): DemuxedSampleBatch?
+    private external fun nativeDemuxSessionSegment(context: Long, data: ByteArray): DemuxedSampleBatch?
+    private external fun nativeDemuxSegmentDirect(
+        context: Long,
+        buffer: ByteBuffer,
+        offset: Int,
+        length: Int
+    ): DemuxedSampleBatch?
+    private external fun nativeDemuxSegmentToSink(
+        context: Long,
+        buffer: ByteBuffer,
+        offset: Int,
+        length: Int,
+        sink: DemuxedSampleSink
+    ): Int
+    private external fun nativeSetDecryption(
+        context: Long,
+        method: Int,
+        key: ByteArray?,
+        iv: ByteArray?
+    ): Boolean
+    private external fun nativeSetSelectedTracks(context: Long, trackIds: IntArray?)
+    private external fun nativeSetMemoryBudget(context: Long, budget: Long)
+    private external fun nativeStartPush(context: Long)
+    private external fun nativeFeed(context: Long, data: ByteArray, offset: Int, length: Int): Boolean
+    private external fun nativeFeedDirect(
+        context: Long,
+        buffer: ByteBuffer,
+        offset: Int,
+        length: Int
+    ): Boolean
+    private external fun nativeEndSegment(context: Long)
+    private external fun nativeDrainSamples(context: Long, sink: DemuxedSampleSink): Int
+    private external fun nativeCancelPush(context: Long)
+    private external fun nativeStartPool(context: Long, workers: Int): Int
+    private external fun nativeSubmitSegment(
+        context: Long,
+        buffer: ByteBuffer,
+        offset: Int,
+        length: Int,
+        discontinuity: Boolean
+    ): Long
+    private external fun nativeDrainPooledSegment(context: Long, sink: DemuxedSampleSink): Int
+    private external fun nativeCancelPool(context: Long)
+    private external fun nativeResetPool(context: Long)
+    private external fun nativeSeekPush(context: Long, timeUs: Long, pts: Long): Boolean
+    private external fun nativeGetKeyframeIndex(context: Long): LongArray?
+    private external fun nativeResetSession(context: Long)
     private external fun nativeRelease(context: Long)
     private external fun nativeGetVersion(): String
 }
@@ -0,0 +1,14 @@
+package com.yohan.yoplayersdk.demuxer
+
+/**
+ * 세그먼트 안의 비디오 키프레임 위치 (seek 인덱스 항목)
+ *
+ * @property timeUs 정규화된 키프레임 시각 (마이크로초)
+ * @property pts 키프레임의 90kHz PTS (33비트)
+ * @property byteOffset 키프레임 PES가 시작되는 TS 패킷의 세그먼트 내 바이트 오프셋
+ */
+data class SegmentKeyframe(
+    val timeUs: Long,
+    val pts: Long,
+    val byteOffset: Long
+)
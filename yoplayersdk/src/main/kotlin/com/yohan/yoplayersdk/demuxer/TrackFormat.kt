@@ -10,6 +10,15 @@ package com.yohan.yoplayersdk.demuxer
  * @property extraData 코덱 초기화 데이터 (SPS/PPS, AudioSpecificConfig 등)
  * @property sampleRate 오디오 샘플레이트 (비디오는 0)
  * @property channelCount 오디오 채널 수 (비디오는 0)
+ * @property codecs RFC 6381 코덱 문자열 (예: "avc1.64001F", 알 수 없으면 null)
+ * @property profile 코덱 프로파일 (H.264는 profile_idc, 알 수 없으면 0)
+ * @property level 코덱 레벨 (H.264는 level_idc, 알 수 없으면 0)
+ * @property frameRate 비디오 프레임레이트 (알 수 없으면 0)
+ * @property pixelWidthHeightRatio 화소 종횡비 (SAR)
+ * @property maxNumReorderFrames 디코딩 순서와 표시 순서가 다른 최대 프레임 수 (알 수 없으면 -1)
+ * @property id 트랙 ID (MPEG-TS PID), 샘플의 [DemuxedSampleBatch.trackId]와 같음
+ * @property programId 트랙이 속한 프로그램 번호 (알 수 없으면 0)
+ * @property language ISO 639 언어 코드 (예: "kor", 알 수 없으면 null)
  */
 data class TrackFormat(
     val trackType: Int,
@@ -18,7 +27,16 @@ data class TrackFormat(
     val height: Int,
     val extraData: ByteArray?,
     val sampleRate: Int,
-    val channelCount: Int
+    val channelCount: Int,
+    val codecs: String? = null,
+    val profile: Int = 0,
+    val level: Int = 0,
+    val frameRate: Float = 0f,
+    val pixelWidthHeightRatio: Float = 1f,
+    val maxNumReorderFrames: Int = -1,
+    val id: Int = 0,
+    val programId: Int = 0,
+    val language: String? = null
 ) {
     companion object {
         const val TRACK_TYPE_AUDIO = 1
@@ -41,6 +59,15 @@ data class TrackFormat(
                 height == other.height &&
                 sampleRate == other.sampleRate &&
                 channelCount == other.channelCount &&
+                codecs == other.codecs &&
+                profile == other.profile &&
+                level == other.level &&
+                frameRate == other.frameRate &&
+                pixelWidthHeightRatio == other.pixelWidthHeightRatio &&
+                maxNumReorderFrames == other.maxNumReorderFrames &&
+                id == other.id &&
+                programId == other.programId &&
+                language == other.language &&
                 extraData.contentEquals(other.extraData)
     }
 
@@ -52,14 +79,26 @@ data class TrackFormat(
         result = 31 * result + (extraData?.contentHashCode() ?: 0)
         result = 31 * result + sampleRate
         result = 31 * result + channelCount
+        result = 31 * result + (codecs?.hashCode() ?: 0)
+        result = 31 * result + profile
+        result = 31 * result + level
+        result = 31 * result + frameRate.hashCode()
+        result = 31 * result + pixelWidthHeightRatio.hashCode()
+        result = 31 * result + maxNumReorderFrames
+        result = 31 * result + id
+        result = 31 * result + programId
+        result = 31 * result + (language?.hashCode() ?: 0)
         return result
     }
 
     override fun toString(): String {
         return if (isVideo) {
-            "TrackFormat(VIDEO, $mimeType, ${width}x${height}, extraData=${extraData?.size ?: 0} bytes)"
+            "TrackFormat(VIDEO, id=$id, program=$programId, $mimeType, ${width}x${height}, " +
+                "codecs=$codecs, fps=$frameRate, reorder=$maxNumReorderFrames, " +
+                "extraData=${extraData?.size ?: 0} bytes)"
         } else {
-            "TrackFormat(AUDIO, $mimeType, ${sampleRate}Hz, ${channelCount}ch, extraData=${extraData?.size ?: 0} bytes)"
+            "TrackFormat(AUDIO, id=$id, program=$programId, $mimeType, ${sampleRate}Hz, " +
+                "${channelCount}ch, language=$language, extraData=${extraData?.size ?: 0} bytes)"
         }
     }
 }
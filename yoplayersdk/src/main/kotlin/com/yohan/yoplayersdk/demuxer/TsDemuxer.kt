@@ -1,24 +1,24 @@
 package com.yohan.yoplayersdk.demuxer
 
-import android.util.Log
-import androidx.media3.common.C
-import androidx.media3.common.util.TimestampAdjuster
 import androidx.media3.common.util.UnstableApi
+import com.yohan.yoplayersdk.m3u8.M3u8Segment
+import java.nio.ByteBuffer
 
 /**
  * MPEG-TS 세그먼트 디먹서
  * M3U8 다운로더로 받은 세그먼트들을 디먹싱하여 오디오/비디오 샘플을 추출합니다.
+ * 타임스탬프는 네이티브에서 정규화되어 나옵니다 (첫 샘플 0 기준, 33비트 PTS 순환 처리,
+ * 오디오 트랙별 단조 증가 보정).
  */
 @UnstableApi
 class TsDemuxer {
 
-    private val ffmpegDemuxer = FfmpegDemuxer()
+    companion object {
+        // 네이티브 키프레임 인덱스 항목 하나의 값 수 (timeUs, pts, byteOffset)
+        private const val KEYFRAME_ENTRY_SIZE = 3
+    }
 
-    // AAC 프레임 duration (1024 samples per frame)
-    // 48kHz: 21333us, 44.1kHz: 23220us - 일반적인 값 사용
-    private var aacFrameDurationUs = 21333L
-    private var lastAudioTimeUs = C.TIME_UNSET
-    private val timestampAdjuster = TimestampAdjuster(0)
+    private val ffmpegDemuxer = FfmpegDemuxer()
 
     /**
      * FFmpeg 버전 정보
@@ -35,41 +35,44 @@ class TsDemuxer {
 
     /**
      * 단일 세그먼트의 트랙 정보 분석
+     * 타임스탬프 기준도 초기화되어 이후 첫 샘플이 0이 됩니다.
      * @param data TS 세그먼트 바이트 배열
      * @return 트랙 포맷 목록
      */
     fun probeSegment(data: ByteArray): List<TrackFormat> {
         ensureInitialized()
-        val tracks = ffmpegDemuxer.probeSegment(data)
-
-        // 오디오 트랙의 샘플레이트로 AAC frame duration 계산
-        tracks.find { it.isAudio }?.let { audioTrack ->
-            if (audioTrack.sampleRate > 0) {
-                // AAC: 1024 samples per frame
-                aacFrameDurationUs = (1024L * 1_000_000L) / audioTrack.sampleRate
-            }
-        }
-
-        // 타임스탬프 리셋
-        lastAudioTimeUs = C.TIME_UNSET
-        timestampAdjuster.reset(0)
+        return ffmpegDemuxer.probeSegment(data)
+    }
 
-        return tracks
+    /**
+     * 단일 세그먼트의 트랙 정보 분석
+     * direct 버퍼는 Java 힙 복사 없이 네이티브에서 바로 읽습니다.
+     * @param data TS 세그먼트 버퍼 (position ~ limit 구간)
+     * @return 트랙 포맷 목록
+     */
+    fun probeSegment(data: ByteBuffer): List<TrackFormat> {
+        ensureInitialized()
+        return if (data.isDirect) {
+            ffmpegDemuxer.probeSegmentDirect(data, data.position(), data.remaining())
+        } else {
+            ffmpegDemuxer.probeSegment(data.toByteArray())
+        }
     }
 
     /**
      * 단일 세그먼트 디먹싱 (동기)
-     * PTS 기준으로 정규화하여 반환
+     * 세그먼트는 세션 모드로 이어서 디먹싱되며, PTS 기준으로 정규화되어 반환
      *
      * @param data TS 세그먼트 바이트 배열
-     * @return 정규화된 타임스탬프를 가진 샘플 목록
+     * @return 정규화된 타임스탬프를 가진 샘플 목록 (오디오 → 비디오 순)
      */
     fun demuxSegmentSync(data: ByteArray): List<DemuxedSample> {
         ensureInitialized()
-        val rawSamples = ffmpegDemuxer.demuxSegment(data)
-        val (normalizedAudioSamples, normalizedVideoSamples) = normalizeSamples(rawSamples)
+        val batch = ffmpegDemuxer.demuxSessionSegment(data)
 
-        return normalizedAudioSamples + normalizedVideoSamples
+        val audioSamples = (0 until batch.sampleCount).filter { batch.isAudio(it) }
+        val videoSamples = (0 until batch.sampleCount).filter { batch.isVideo(it) }
+        return (audioSamples + videoSamples).map { batch.getSample(it) }
     }
 
     /**
@@ -82,94 +85,253 @@ class TsDemuxer {
         data: ByteArray,
         onSample: (DemuxedSample) -> Unit
     ) {
+        demuxSegmentSync(data).forEach(onSample)
+    }
+
+    /**
+     * 단일 세그먼트를 디먹싱하여 샘플 배치로 반환
+     * 타임스탬프는 네이티브에서 정규화되어 나오며, 샘플 단위 객체/페이로드 복사가 없습니다.
+     * direct 버퍼는 Java 힙 복사 없이 네이티브에서 바로 읽습니다.
+     *
+     * @param data TS 세그먼트 버퍼 (position ~ limit 구간)
+     * @return 정규화된 샘플 배치
+     */
+    fun demuxSegment(data: ByteBuffer): DemuxedSampleBatch {
         ensureInitialized()
-        val rawSamples = ffmpegDemuxer.demuxSegment(data)
-        val (normalizedAudioSamples, normalizedVideoSamples) = normalizeSamples(rawSamples)
+        val batch = if (data.isDirect) {
+            ffmpegDemuxer.demuxSegmentDirect(data, data.position(), data.remaining())
+        } else {
+            ffmpegDemuxer.demuxSessionSegment(data.toByteArray())
+        }
+        return batch
+    }
 
-        normalizedAudioSamples.forEach(onSample)
-        normalizedVideoSamples.forEach(onSample)
+    /**
+     * 단일 세그먼트를 디먹싱하여 정규화된 샘플 배치를 청크 단위로 싱크에 전달
+     * 세그먼트 전체를 모으지 않고 일정 크기마다 전달하므로 샘플 수 제한이 없고
+     * 첫 샘플이 더 빨리 큐에 들어갑니다.
+     *
+     * @param data TS 세그먼트 버퍼 (position ~ limit 구간)
+     * @param sink 정규화된 샘플 배치를 받을 싱크
+     * @return 전달된 샘플 수 (실패 시 음수)
+     */
+    fun demuxSegment(data: ByteBuffer, sink: DemuxedSampleSink): Int {
+        ensureInitialized()
+        if (data.isDirect) {
+            return ffmpegDemuxer.demuxSegmentDirect(data, data.position(), data.remaining(), sink)
+        }
+        val batch = ffmpegDemuxer.demuxSessionSegment(data.toByteArray())
+        sink.onSampleBatch(batch)
+        return batch.sampleCount
     }
 
     /**
-     * 리소스 해제
+     * 다음 세그먼트의 복호화 설정 (AES-128 / SAMPLE-AES)
+     * 세그먼트의 첫 데이터(분석 포함)를 넘기기 전에 호출해야 하며, 세그먼트 하나를 처리하면 해제됩니다.
+     *
+     * @param method EXT-X-KEY METHOD 값
+     * @param key 16바이트 키
+     * @param iv 16바이트 IV
+     * @return 지원하지 않는 방식이거나 키/IV가 올바르지 않으면 false
      */
-    fun release() {
-        ffmpegDemuxer.release()
-        lastAudioTimeUs = C.TIME_UNSET
+    fun setSegmentDecryption(method: String, key: ByteArray, iv: ByteArray): Boolean {
+        ensureInitialized()
+        val nativeMethod = when (method) {
+            M3u8Segment.EncryptionInfo.METHOD_AES_128 -> FfmpegDemuxer.DECRYPTION_AES_128
+            M3u8Segment.EncryptionInfo.METHOD_SAMPLE_AES -> FfmpegDemuxer.DECRYPTION_SAMPLE_AES
+            else -> return false
+        }
+        return ffmpegDemuxer.setDecryption(nativeMethod, key, iv)
     }
 
     /**
-     * 불연속 구간에서 타임스탬프 기준을 재설정
+     * 디먹싱할 트랙 선택
+     * 선택되지 않은 트랙(다른 언어 오디오 등)은 네이티브에서 PES 조립 전에 버려집니다.
+     * 다음에 시작하는 세그먼트부터 적용됩니다.
+     *
+     * @param trackIds 선택할 트랙 ID([TrackFormat.id]) 목록, null이면 모든 트랙
      */
-    fun resetForDiscontinuity() {
-        val lastAdjustedUs = timestampAdjuster.lastAdjustedTimestampUs
-        val baseUs = if (lastAdjustedUs != C.TIME_UNSET) lastAdjustedUs else 0L
-        timestampAdjuster.reset(baseUs)
-        lastAudioTimeUs = C.TIME_UNSET
+    fun selectTracks(trackIds: IntArray?) {
+        ensureInitialized()
+        ffmpegDemuxer.setSelectedTracks(trackIds)
     }
 
-    private fun ensureInitialized() {
-        initialize()
+    /**
+     * 입력 FIFO와 디먹서 임시 메모리를 플레이어 메모리 예산에 포함
+     * @param budget 네이티브 예산 포인터 (디먹서보다 늦게 해제), 0이면 해제
+     */
+    fun setMemoryBudget(budget: Long) {
+        ensureInitialized()
+        ffmpegDemuxer.setMemoryBudget(budget)
+    }
+
+    /**
+     * push 모드 시작
+     * 세그먼트를 다 받기 전부터 [feedSegmentData]로 받은 바이트를 넘기고,
+     * 별도의 디먹스 스레드에서 [drainSegment]로 샘플을 꺼냅니다.
+     */
+    fun startPushMode() {
+        ensureInitialized()
+        ffmpegDemuxer.startPush()
     }
 
-    private fun normalizeSamples(
-        rawSamples: List<DemuxedSample>
-    ): Pair<List<DemuxedSample>, List<DemuxedSample>> {
-        val audioSamples = rawSamples.filter { it.isAudio }.normalize().map {
-            it.applyAudioCorrection()
+    /**
+     * push 모드로 다운로드 중인 세그먼트 바이트 전달
+     * direct 버퍼는 Java 힙 복사 없이 네이티브로 넘어갑니다.
+     *
+     * @param data 세그먼트 버퍼 (position ~ limit 구간)
+     * @return false면 push 모드가 아니거나 취소됨
+     */
+    fun feedSegmentData(data: ByteBuffer): Boolean {
+        if (data.isDirect) {
+            return ffmpegDemuxer.feedDirect(data, data.position(), data.remaining())
         }
-        val videoSamples = rawSamples.filter { it.isVideo }.normalize()
+        val bytes = data.toByteArray()
+        return ffmpegDemuxer.feed(bytes, 0, bytes.size)
+    }
 
-        return audioSamples to videoSamples
+    /**
+     * push 모드로 전달 중인 세그먼트의 다운로드 완료 표시
+     */
+    fun endSegmentData() {
+        ffmpegDemuxer.endSegment()
     }
 
-    private fun adjustTimestamp(timeUs: Long): Long {
-        if (timeUs == 0L && timestampAdjuster.isInitialized) {
-            Log.w(
-                "TsDemuxer", "timeUs is zero"
-            )
-            return C.TIME_UNSET
-        }
+    /**
+     * push 모드로 다음 세그먼트를 디먹싱하여 정규화된 샘플 배치를 싱크에 전달
+     * 세그먼트 끝이 표시되거나 취소될 때까지 대기하므로 디먹스 전용 스레드에서 호출해야 합니다.
+     *
+     * @param sink 정규화된 샘플 배치를 받을 싱크
+     * @return 전달된 샘플 수 (실패 시 음수)
+     */
+    fun drainSegment(sink: DemuxedSampleSink): Int {
+        return ffmpegDemuxer.drainSamples(sink)
+    }
 
-        if (timeUs < 0) {
-            Log.w(
-                "TsDemuxer",
-                "adjustTimestamp: previous = ${timestampAdjuster.lastAdjustedTimestampUs} , current = $timeUs"
-            )
-            return C.TIME_UNSET
+    /**
+     * push 모드 취소 (대기 중인 feed/drain 해제)
+     */
+    fun cancelPushMode() {
+        ffmpegDemuxer.cancelPush()
+    }
+
+    /**
+     * 병렬 디먹스 시작
+     * 다운로드를 마친 세그먼트를 [submitSegment]로 넘기면 여러 네이티브 워커가 동시에 파싱하고,
+     * 디먹스 전용 스레드의 [drainSubmittedSegment]가 제출 순서대로 정규화된 샘플을 내보냅니다.
+     * push 모드([feedSegmentData])와 같은 세그먼트 흐름에 섞어 쓰지 않습니다.
+     *
+     * @param workers 워커 수 (1 ~ 8)
+     * @return 시작된 워커 수
+     */
+    fun startParallelDemux(workers: Int): Int {
+        ensureInitialized()
+        return ffmpegDemuxer.startPool(workers)
+    }
+
+    /**
+     * 다운로드를 마친 세그먼트 제출 (재생 순서대로)
+     * 데이터는 복사되므로 반환 후 버퍼를 재사용해도 됩니다. 힙 버퍼는 direct 버퍼로 한 번 복사해 넘깁니다.
+     *
+     * @param data 세그먼트 버퍼 (position ~ limit 구간)
+     * @param discontinuity 불연속 구간의 첫 세그먼트면 true ([resetForDiscontinuity]를 출력 순서에 맞춰 적용)
+     * @return false면 취소됨
+     */
+    fun submitSegment(data: ByteBuffer, discontinuity: Boolean = false): Boolean {
+        val buffer = if (data.isDirect) {
+            data
+        } else {
+            ByteBuffer.allocateDirect(data.remaining()).put(data.duplicate()).apply { flip() }
         }
+        return ffmpegDemuxer.submitSegment(
+            buffer, buffer.position(), buffer.remaining(), discontinuity
+        ) >= 0
+    }
 
-        return timestampAdjuster.adjustSampleTimestamp(timeUs)
+    /**
+     * 제출한 다음 세그먼트를 정규화된 샘플 배치로 싱크에 전달
+     * 파싱이 끝날 때까지 대기하므로 디먹스 전용 스레드에서 호출해야 합니다.
+     *
+     * @param sink 정규화된 샘플 배치를 받을 싱크
+     * @return 전달된 샘플 수, 취소되었으면 0 (실패 시 음수)
+     */
+    fun drainSubmittedSegment(sink: DemuxedSampleSink): Int {
+        return ffmpegDemuxer.drainPooledSegment(sink)
     }
 
-    private fun List<DemuxedSample>.normalize() = map { sample ->
-        val adjustedTimeUs = adjustTimestamp(sample.timeUs)
-        sample.copy(timeUs = adjustedTimeUs)
+    /**
+     * 병렬 디먹스 취소 (대기 중인 submit/drain 해제)
+     */
+    fun cancelParallelDemux() {
+        ffmpegDemuxer.cancelPool()
     }
 
     /**
-     * 오디오 샘플 추가 보정 함수
-     * 역행하거나 불연속적일때 보정하기 위해 사용
+     * 출력하지 않은 제출 세그먼트를 버리고 다시 제출할 수 있게 함 (seek)
+     * [cancelParallelDemux] 후 진행 중인 [drainSubmittedSegment]가 반환된 뒤에 호출해야 합니다.
      */
-    private fun DemuxedSample.applyAudioCorrection(): DemuxedSample {
-        if (this.isAudio.not()) return this
-        if (this.timeUs == C.TIME_UNSET) {
-            val correctedTimeUs = if (lastAudioTimeUs != C.TIME_UNSET) {
-                lastAudioTimeUs + aacFrameDurationUs
-            } else {
-                0L
-            }
-            lastAudioTimeUs = correctedTimeUs
-            return this.copy(timeUs = correctedTimeUs)
-        }
+    fun resetParallelDemux() {
+        ffmpegDemuxer.resetPool()
+    }
 
-        if (lastAudioTimeUs != C.TIME_UNSET && this.timeUs <= lastAudioTimeUs) {
-            val correctedTimeUs = lastAudioTimeUs + aacFrameDurationUs
-            lastAudioTimeUs = correctedTimeUs
-            return this.copy(timeUs = correctedTimeUs)
+    /**
+     * push 모드로 seek
+     * 디먹싱되지 않은 입력을 버리고, 이후 샘플이 [timeUs]부터 이어지는 시각으로 나오게 합니다.
+     * [cancelPushMode] 후 진행 중인 [drainSegment]가 반환된 뒤에 호출해야 합니다.
+     *
+     * @param timeUs seek 위치의 시각
+     * @param pts [timeUs]에 대응하는 90kHz PTS ([SegmentKeyframe.pts]), 모르면 음수
+     * @return true면 세그먼트 중간(키프레임 패킷)부터 데이터를 넘길 수 있고,
+     *         false면 세그먼트 처음부터 넘겨야 합니다.
+     */
+    fun seekTo(timeUs: Long, pts: Long): Boolean {
+        ensureInitialized()
+        return ffmpegDemuxer.seekPush(timeUs, pts)
+    }
+
+    /**
+     * 마지막으로 디먹싱한 세그먼트의 비디오 키프레임 목록
+     * [drainSegment]가 반환된 뒤 디먹스 스레드에서 호출해야 합니다.
+     * libavformat으로 디먹싱한 세그먼트는 빈 목록입니다.
+     */
+    fun takeKeyframeIndex(): List<SegmentKeyframe> {
+        val entries = ffmpegDemuxer.getKeyframeIndex()
+        return (0 until entries.size / KEYFRAME_ENTRY_SIZE).map { i ->
+            val base = i * KEYFRAME_ENTRY_SIZE
+            SegmentKeyframe(entries[base], entries[base + 1], entries[base + 2])
         }
+    }
+
+    /**
+     * 리소스 해제
+     */
+    fun release() {
+        ffmpegDemuxer.release()
+    }
 
-        lastAudioTimeUs = this.timeUs
-        return this
+    /**
+     * 불연속 구간에서 타임스탬프 기준과 디먹스 세션을 재설정
+     * 불연속 이후에는 코덱/PID 구성이 바뀔 수 있으므로 세션을 새로 열어 스트림을 다시 분석하고,
+     * 타임스탬프는 지금까지 출력한 마지막 시점에 이어지도록 기준을 다시 잡습니다.
+     */
+    fun resetForDiscontinuity() {
+        ffmpegDemuxer.resetSession()
+    }
+
+    private fun ensureInitialized() {
+        initialize()
+    }
+
+    /**
+     * 힙 버퍼의 position ~ limit 구간을 바이트 배열로 반환
+     * 버퍼 전체를 감싼 배열이면 복사 없이 그대로 사용
+     */
+    private fun ByteBuffer.toByteArray(): ByteArray {
+        if (hasArray() && arrayOffset() == 0 && position() == 0 && remaining() == array().size) {
+            return array()
+        }
+        val bytes = ByteArray(remaining())
+        duplicate().get(bytes)
+        return bytes
     }
 }
@@ -0,0 +1,103 @@
+package com.yohan.yoplayersdk.exoplayer
+
+import com.yohan.yoplayersdk.demuxer.FfmpegDemuxer
+import com.yohan.yoplayersdk.player.YoPlayerBufferConfig
+
+/**
+ * 플레이어 하나의 네이티브 버퍼 메모리 예산 JNI 래퍼
+ *
+ * 세그먼트 수신 버퍼, push 입력 FIFO, 병렬 디먹스 풀, 디먹서 임시 메모리, 트랙별 링에 쌓인 샘플의 사용량을 모아
+ * [YoPlayerBufferConfig.maxMemoryBytes]와 비교합니다. 디먹서와 링은 [nativeHandle]을 받아 네이티브에서
+ * 직접 사용량을 갱신하고 한도를 확인하므로, 예산은 그들보다 늦게 해제해야 합니다.
+ *
+ * 한도는 입력(FIFO와 병렬 디먹스 풀 합계)에 1/4, 트랙별 링에 1/2(비디오 7/8, 오디오 1/8)로 나누고 나머지는 수신 버퍼와
+ * 임시 메모리 몫으로 둡니다. 링 크기는 상한일 뿐이며 실제 쌓을 수 있는 양은 전체 사용량으로 정해집니다.
+ */
+internal class BufferBudget(val config: YoPlayerBufferConfig) {
+
+    companion object {
+        // 네이티브 MemoryBudgetCategory와 동일
+        const val CATEGORY_DOWNLOAD = 0
+        const val CATEGORY_INPUT = 1
+        const val CATEGORY_SCRATCH = 2
+        const val CATEGORY_SAMPLES = 3
+        const val CATEGORY_POOL = 4
+        private const val CATEGORY_TOTAL = -1
+
+        // 입력 FIFO 한도의 상한 (네이티브 고정 한도와 같음)
+        private const val MAX_INPUT_BYTES = 16L * 1024 * 1024
+    }
+
+    /**
+     * 입력 한도 (push FIFO와 병렬 디먹스 풀 합계)
+     */
+    val inputLimitBytes: Long = minOf(config.maxMemoryBytes / 4, MAX_INPUT_BYTES)
+
+    private val sampleBytes: Long = config.maxMemoryBytes / 2
+
+    @Volatile
+    var nativeHandle: Long = 0L
+        private set
+
+    init {
+        FfmpegDemuxer.loadLibrary()
+        nativeHandle = nativeCreateBudget(config.maxMemoryBytes, inputLimitBytes)
+        if (nativeHandle == 0L) {
+            throw OutOfMemoryError("Failed to create buffer budget")
+        }
+    }
+
+    /**
+     * 트랙 타입별 링 크기
+     */
+    fun ringCapacity(isVideo: Boolean): Int {
+        val bytes = if (isVideo) sampleBytes * 7 / 8 else sampleBytes / 8
+        return bytes.coerceAtMost(Int.MAX_VALUE.toLong()).toInt()
+    }
+
+    /**
+     * 세그먼트 수신 버퍼 크기 반영
+     */
+    fun setDownloadBytes(bytes: Long) {
+        nativeSetUsage(nativeHandle, CATEGORY_DOWNLOAD, bytes)
+    }
+
+    /**
+     * 종류별 사용량 ([CATEGORY_DOWNLOAD] 등)
+     */
+    fun usedBytes(category: Int): Long = nativeGetUsage(nativeHandle, category)
+
+    /**
+     * 전체 사용량
+     */
+    val totalBytes: Long
+        get() = nativeGetUsage(nativeHandle, CATEGORY_TOTAL)
+
+    /**
+     * 전체 사용량의 최대값
+     */
+    val peakBytes: Long
+        get() = nativeGetPeakUsage(nativeHandle)
+
+    /**
+     * 네이티브 예산 해제 (디먹서와 링을 모두 해제한 뒤 호출)
+     */
+    fun release() {
+        val handle = nativeHandle
+        nativeHandle = 0L
+        nativeReleaseBudget(handle)
+    }
+
+    override fun toString(): String {
+        return "BufferBudget(total=$totalBytes/${config.maxMemoryBytes}, " +
+            "download=${usedBytes(CATEGORY_DOWNLOAD)}, input=${usedBytes(CATEGORY_INPUT)}, " +
+            "scratch=${usedBytes(CATEGORY_SCRATCH)}, samples=${usedBytes(CATEGORY_SAMPLES)}, " +
+            "pool=${usedBytes(CATEGORY_POOL)}, peak=$peakBytes)"
+    }
+
+    private external fun nativeCreateBudget(limitBytes: Long, inputLimitBytes: Long): Long
+    private external fun nativeReleaseBudget(budget: Long)
+    private external fun nativeSetUsage(budget: Long, category: Int, bytes: Long)
+    private external fun nativeGetUsage(budget: Long, category: Int): Long
+    private external fun nativeGetPeakUsage(budget: Long): Long
+}
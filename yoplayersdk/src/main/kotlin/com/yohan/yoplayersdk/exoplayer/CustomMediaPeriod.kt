@@ -16,23 +16,52 @@ import androidx.media3.exoplayer.source.SampleStream
 import androidx.media3.exoplayer.source.TrackGroupArray
 import androidx.media3.exoplayer.trackselection.ExoTrackSelection
 import androidx.media3.extractor.AvcConfig
-import com.yohan.yoplayersdk.demuxer.DemuxedSample
+import androidx.media3.extractor.HevcConfig
+import com.yohan.yoplayersdk.demuxer.DemuxedSampleBatch
 import com.yohan.yoplayersdk.demuxer.TrackFormat
 
 private const val TAG = "CustomMediaPeriod"
 
+/**
+ * @param bufferBudget 트랙별 큐의 용량과 버퍼 길이 정책을 정하는 플레이어 메모리 예산
+ */
 @UnstableApi
-internal class CustomMediaPeriod : MediaPeriod {
+internal class CustomMediaPeriod(
+    private val bufferBudget: BufferBudget
+) : MediaPeriod {
 
     private var callback: MediaPeriod.Callback? = null
     private var trackGroupArray: TrackGroupArray = TrackGroupArray.EMPTY
 
+    // 트랙 ID(MPEG-TS PID)별 큐/포맷/스트림
     private val sampleQueues = mutableMapOf<Int, CustomSampleQueue>()
     private val formats = mutableMapOf<Int, Format>()
     private val sampleStreams = mutableMapOf<Int, CustomSampleStream>()
+    // trackGroupArray 순서의 트랙 ID
+    private var trackIds = IntArray(0)
+    // 재생할 트랙 ID (트랙 선택 전에는 null이며 모든 트랙의 샘플을 받음)
+    @Volatile
+    private var selectedTrackIds: Set<Int>? = null
     @Volatile
     private var isLoading = false
 
+    /**
+     * 트랙 선택이 바뀌면 선택된 트랙 ID 목록으로 호출 (선택되지 않은 트랙을 디먹서에서 버리는 데 사용)
+     */
+    var onTracksSelected: ((IntArray) -> Unit)? = null
+
+    /**
+     * seek 요청 시 호출 - 다운로드/디먹싱을 목표 위치부터 다시 시작하고 실제 시작 위치(키프레임)를 반환
+     * 없으면 seek을 지원하지 않음
+     */
+    var onSeek: ((Long) -> Long)? = null
+
+    /**
+     * 키프레임 위치 조회용 seek 테이블 (플레이리스트를 받기 전에는 null)
+     */
+    @Volatile
+    var seekTable: SeekTable? = null
+
     /**
      * 트랙 정보를 설정하고 준비 완료를 알림
      */
@@ -45,58 +74,59 @@ internal class CustomMediaPeriod : MediaPeriod {
 
         val trackGroups = tracks.map { track ->
             val format = track.toFormat()
-            formats[track.trackType] = format
-            sampleQueues[track.trackType] = CustomSampleQueue(track.trackType)
-            Log.d(TAG, "Added track: ${track.mimeType}, trackType=${track.trackType}")
-            TrackGroup(format)
+            formats[track.id] = format
+            sampleQueues[track.id] = CustomSampleQueue(track.id, track.trackType, bufferBudget)
+            Log.d(
+                TAG,
+                "Added track: ${track.mimeType}, trackType=${track.trackType}, id=${track.id}, " +
+                    "program=${track.programId}, language=${track.language}"
+            )
+            TrackGroup(track.id.toString(), format)
         }
 
+        trackIds = tracks.map { it.id }.toIntArray()
         trackGroupArray = TrackGroupArray(*trackGroups.toTypedArray())
         Log.d(TAG, "Calling onPrepared, callback=${callback != null}")
         callback?.onPrepared(this)
     }
 
-    fun queueSample(sample: DemuxedSample): Boolean {
-        if (sample.timeUs == C.TIME_UNSET) {
-            return false
-        }
-        return queueSampleInternal(sample)
+    /**
+     * 새 샘플 배치를 넣기 시작 (배치마다 [queueBatch] 전에 호출)
+     */
+    fun beginBatch() {
+        sampleQueues.values.forEach { it.beginBatch() }
     }
 
-    private fun queueSampleInternal(sample: DemuxedSample): Boolean {
-        val adjustedSample = DemuxedSample(
-            trackType = sample.trackType,
-            timeUs = sample.timeUs,
-            flags = sample.flags,
-            data = if (sample.isVideo || shouldStripAdts().not()) {
-                sample.data
-            } else {
-                stripAdtsHeader(sample.data) ?: sample.data
+    /**
+     * 샘플 배치를 재생할 트랙의 큐에 추가
+     * 큐마다 공간이 있으면 넣고, 빈 큐에도 한 번에 들어가지 않는 배치는 들어가는 만큼 나누어 넣습니다.
+     * 다 넣지 못한 큐는 [awaitCapacity]로 기다린 뒤 다시 호출하면 이어서 넣으며, 샘플을 버리지 않습니다.
+     * @return 모든 큐에 배치를 다 넣었으면 true
+     */
+    fun queueBatch(batch: DemuxedSampleBatch): Boolean {
+        var queued = true
+        activeQueues().forEach {
+            if (it.queueBatch(batch).not()) {
+                queued = false
             }
-        )
-
-        return sampleQueues[sample.trackType]?.queueSample(adjustedSample) ?: false
-    }
-
-    private fun shouldStripAdts(): Boolean {
-        val audioMimeType = formats[TrackFormat.TRACK_TYPE_AUDIO]?.sampleMimeType
-        return audioMimeType == "audio/mp4a-latm" || audioMimeType == "audio/aac"
+        }
+        return queued
     }
 
-
-    private fun hasAdtsHeader(data: ByteArray): Boolean {
-        if (data.size < 7) return false
-        return data[0] == 0xFF.toByte() && (data[1].toInt() and 0xF0) == 0xF0
+    /**
+     * 재생할 트랙의 큐 (트랙 선택 전에는 모든 큐)
+     * 선택되지 않은 트랙의 큐는 샘플을 받지 않으므로 용량/버퍼 위치 계산에서 제외합니다.
+     */
+    private fun activeQueues(): List<CustomSampleQueue> {
+        val selected = selectedTrackIds ?: return sampleQueues.values.toList()
+        return sampleQueues.filterKeys { it in selected }.values.toList()
     }
 
-    private fun stripAdtsHeader(data: ByteArray): ByteArray? {
-        if (hasAdtsHeader(data).not()) return null
-        val protectionAbsent = data[1].toInt() and 0x01
-        val headerLength = if (protectionAbsent == 1) 7 else 9
-        if (data.size <= headerLength) {
-            return null
-        }
-        return data.copyOfRange(headerLength, data.size)
+    /**
+     * 모든 큐의 샘플과 스트림 종료 표시를 버림 (seek)
+     */
+    fun discardSamples() {
+        sampleQueues.values.forEach { it.clear() }
     }
 
     /**
@@ -109,16 +139,27 @@ internal class CustomMediaPeriod : MediaPeriod {
 
     private fun TrackFormat.toFormat(): Format {
         val builder = Format.Builder()
+            .setId(this.id.toString())
             .setSampleMimeType(this.mimeType)
+            .setLanguage(this.language)
 
         when (this.trackType) {
             TrackFormat.TRACK_TYPE_VIDEO -> {
                 val width = if (this.width > 0) this.width else 1920
                 val height = if (this.height > 0) this.height else 1080
                 builder.setWidth(width).setHeight(height)
+                    .setPixelWidthHeightRatio(this.pixelWidthHeightRatio)
+                    .setCodecs(this.codecs)
+                if (this.frameRate > 0f) {
+                    builder.setFrameRate(this.frameRate)
+                }
+                if (this.maxNumReorderFrames >= 0) {
+                    builder.setMaxNumReorderSamples(this.maxNumReorderFrames)
+                }
                 Log.d(
                     TAG,
-                    "Video format: ${this.mimeType}, ${width}x${height}, extraData=${this.extraData?.size ?: 0} bytes"
+                    "Video format: ${this.mimeType}, ${width}x${height}, codecs=${this.codecs}, " +
+                        "fps=${this.frameRate}, extraData=${this.extraData?.size ?: 0} bytes"
                 )
             }
 
@@ -149,9 +190,24 @@ internal class CustomMediaPeriod : MediaPeriod {
         if (track.isVideo && track.mimeType == "video/avc") {
             return buildAvcInitializationData(extraData)
         }
+        if (track.isVideo && track.mimeType == "video/hevc") {
+            return buildHevcInitializationData(extraData)
+        }
         return listOf(extraData)
     }
 
+    /**
+     * 네이티브에서 만든 hvcC를 디코더용 VPS/SPS/PPS(Annex-B)로 변환
+     */
+    private fun buildHevcInitializationData(extraData: ByteArray): List<ByteArray>? {
+        return try {
+            val hevcConfig = HevcConfig.parse(ParsableByteArray(extraData))
+            hevcConfig.initializationData
+        } catch (e: ParserException) {
+            null
+        }
+    }
+
     private fun buildAvcInitializationData(extraData: ByteArray): List<ByteArray>? {
         CodecSpecificDataUtil.splitNalUnits(extraData)?.let { nalUnits ->
             return nalUnits.toList()
@@ -186,45 +242,43 @@ internal class CustomMediaPeriod : MediaPeriod {
         streamResetFlags: BooleanArray,
         positionUs: Long
     ): Long {
+        val selected = mutableListOf<Int>()
         selections.forEachIndexed { index, selection ->
             if (selection != null) {
                 val trackGroup = selection.trackGroup
-                val format = trackGroup.getFormat(0)
-                val trackType = getTrackTypeFromFormat(format)
-                val sampleQueue = sampleQueues[trackType]
-                val trackFormat = formats[trackType]
+                val groupIndex = trackGroupArray.indexOf(trackGroup)
+                val trackId = if (groupIndex >= 0) trackIds[groupIndex] else C.INDEX_UNSET
+                val sampleQueue = sampleQueues[trackId]
+                val trackFormat = formats[trackId]
 
                 Log.d(
                     TAG,
-                    "  selection[$index]: trackType=$trackType, mimeType=${format.sampleMimeType}"
+                    "  selection[$index]: trackId=$trackId, mimeType=${trackGroup.getFormat(0).sampleMimeType}"
                 )
 
                 if (sampleQueue != null && trackFormat != null) {
                     if (streams[index] == null || mayRetainStreamFlags[index].not()) {
                         val stream = CustomSampleStream(sampleQueue, trackFormat)
                         streams[index] = stream
-                        sampleStreams[trackType] = stream
+                        sampleStreams[trackId] = stream
                         streamResetFlags[index] = true
-                        Log.d(TAG, "  Created SampleStream for trackType=$trackType")
+                        Log.d(TAG, "  Created SampleStream for trackId=$trackId")
                     }
+                    selected.add(trackId)
                 }
             } else {
                 streams[index] = null
             }
         }
-        return positionUs
-    }
 
-    private fun getTrackTypeFromFormat(format: Format): Int {
-        return when {
-            format.sampleMimeType?.startsWith("video/") == true -> TrackFormat.TRACK_TYPE_VIDEO
-            format.sampleMimeType?.startsWith("audio/") == true -> TrackFormat.TRACK_TYPE_AUDIO
-            else -> 0
-        }
+        // 선택되지 않은 트랙(다른 언어 오디오 등)은 디먹서에서 버리고 큐에도 넣지 않음
+        selectedTrackIds = selected.toSet()
+        onTracksSelected?.invoke(selected.toIntArray())
+        return positionUs
     }
 
     override fun discardBuffer(positionUs: Long, toKeyframe: Boolean) {
-        sampleQueues.values.forEach {
+        activeQueues().forEach {
             it.skipToPosition(positionUs, toKeyframe)
         }
     }
@@ -234,17 +288,23 @@ internal class CustomMediaPeriod : MediaPeriod {
     }
 
     override fun seekToUs(positionUs: Long): Long {
-        // 간단한 seek 구현 - 현재는 지원하지 않음
+        val seek = onSeek ?: return positionUs
+        // 큐는 onSeek 안에서 비워지고, 이전 위치의 배치는 세대 검사로 다시 들어오지 않음 ([discardSamples])
+        val startUs = seek(positionUs)
+        Log.d(TAG, "seekToUs: positionUs=$positionUs, demux starts at ${startUs}us")
+        // 키프레임부터 positionUs 전까지의 샘플은 렌더러가 디코딩만 하고 출력하지 않음
         return positionUs
     }
 
     override fun getAdjustedSeekPositionUs(positionUs: Long, seekParameters: SeekParameters): Long {
-        return positionUs
+        val table = seekTable ?: return positionUs
+        val (before, after) = table.keyframesAround(positionUs)
+        return seekParameters.resolveSeekPositionUs(positionUs, before, after)
     }
 
     override fun getBufferedPositionUs(): Long {
         var bufferedPosition = Long.MAX_VALUE
-        sampleQueues.values.forEach { queue ->
+        activeQueues().forEach { queue ->
             val queueBuffered = queue.getBufferedPositionUs()
             if (queueBuffered == C.TIME_END_OF_SOURCE) {
                 return@forEach
@@ -277,23 +337,50 @@ internal class CustomMediaPeriod : MediaPeriod {
 
     fun setLoading(loading: Boolean) {
         isLoading = loading
+        if (loading.not()) {
+            interruptCapacityWait()
+        }
     }
 
-    fun hasCapacity(videoCount: Int, audioCount: Int): Boolean {
-        val videoQueue = sampleQueues[TrackFormat.TRACK_TYPE_VIDEO]
-        val audioQueue = sampleQueues[TrackFormat.TRACK_TYPE_AUDIO]
+    fun hasCapacity(batch: DemuxedSampleBatch): Boolean {
+        val selected = selectedTrackIds
+        return sampleQueues.all { (trackId, queue) ->
+            (selected != null && trackId !in selected) ||
+                queue.hasCapacity(batch)
+        }
+    }
 
-        val videoOk = videoQueue?.hasCapacity(videoCount) ?: true
-        val audioOk = audioQueue?.hasCapacity(audioCount) ?: true
+    /**
+     * 배치를 받을 공간이 모자란 첫 큐가 비워질 때까지 대기 (디먹스 스레드)
+     * 큐마다 낮은 워터마크 아래로 내려간 시점에 한 번 깨어나므로 버퍼가 가득 찬 동안 CPU를 쓰지 않습니다.
+     * @return [SampleRingBuffer.WAIT_READY] 등 대기 결과, 모든 큐에 공간이 있으면 WAIT_READY
+     */
+    fun awaitCapacity(batch: DemuxedSampleBatch, timeoutMs: Int): Int {
+        val queue = activeQueues().firstOrNull { it.hasCapacity(batch).not() }
+            ?: return SampleRingBuffer.WAIT_READY
+        return queue.awaitCapacity(batch, timeoutMs)
+    }
 
-        return videoOk && audioOk
+    /**
+     * [awaitCapacity]로 대기 중인 디먹스 스레드를 깨움 (로딩 중단, seek)
+     */
+    fun interruptCapacityWait() {
+        sampleQueues.values.forEach { it.interruptWait() }
     }
 
     fun release() {
-        sampleQueues.values.forEach { it.clear() }
+        sampleQueues.values.forEach {
+            it.clear()
+            it.release()
+        }
         sampleQueues.clear()
         formats.clear()
         sampleStreams.clear()
+        trackIds = IntArray(0)
+        selectedTrackIds = null
+        onTracksSelected = null
+        onSeek = null
+        seekTable = null
         callback = null
     }
 }
@@ -11,7 +11,8 @@ import androidx.media3.exoplayer.source.MediaPeriod
 import androidx.media3.exoplayer.source.MediaSource
 import androidx.media3.exoplayer.source.SinglePeriodTimeline
 import androidx.media3.exoplayer.upstream.Allocator
-import com.yohan.yoplayersdk.demuxer.DemuxedSample
+import com.yohan.yoplayersdk.demuxer.DemuxedSampleBatch
+import com.yohan.yoplayersdk.demuxer.DemuxedSampleSink
 import com.yohan.yoplayersdk.demuxer.TrackFormat
 import com.yohan.yoplayersdk.demuxer.TsDemuxer
 import com.yohan.yoplayersdk.m3u8.DownloadedSegment
@@ -19,16 +20,40 @@ import com.yohan.yoplayersdk.m3u8.M3u8DownloadListener
 import com.yohan.yoplayersdk.m3u8.M3u8Downloader
 import com.yohan.yoplayersdk.m3u8.M3u8Playlist
 import com.yohan.yoplayersdk.m3u8.M3u8Segment
+import com.yohan.yoplayersdk.player.YoPlayerBufferConfig
+import java.nio.ByteBuffer
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.Executors
+import java.util.concurrent.TimeUnit
 
 private const val TAG = "CustomMediaSource"
 
+// 트랙 분석 전 첫 세그먼트를 이만큼 모은 뒤 분석하고 push 디먹싱을 시작
+private const val PUSH_PROBE_BYTES = 1024 * 1024
+private const val DEMUX_THREAD_NAME = "YoPlayerDemux"
+private const val DEMUX_SHUTDOWN_TIMEOUT_MS = 1000L
+// 큐가 비워지기를 기다리는 최대 시간 (대기 중 로딩 상태를 다시 확인하는 주기)
+private const val BACKPRESSURE_WAIT_TIMEOUT_MS = 1000
+
 /**
  * 커스텀 MediaSource 구현
  * M3U8 다운로드 + FFmpeg 디먹싱 결과를 ExoPlayer에 공급
+ *
+ * 세그먼트는 push 모드로 디먹싱됩니다. 다운로드 스레드가 받은 바이트를 바로 디먹서에 넘기고,
+ * 디먹스 스레드가 세그먼트 순서대로 샘플을 꺼내 큐에 넣으므로 세그먼트 전송이 끝나기 전에 재생을 시작할 수 있습니다.
+ * [YoPlayerBufferConfig.maxConcurrentSegments]가 2 이상이면 세그먼트를 동시에 미리 받고, 다 받은 세그먼트를
+ * 병렬 디먹스 풀에 제출하여 네이티브 워커들이 파싱한 결과를 디먹스 스레드가 순서대로 큐에 넣습니다.
+ *
+ * 종료된(VOD) 플레이리스트는 [SeekTable]로 seek을 지원합니다. seek 위치가 속한 세그먼트부터 다시 받으며,
+ * 이미 디먹싱한 세그먼트는 기록된 키프레임 패킷부터 Range 요청으로 받습니다.
+ *
+ * 세그먼트 수신 버퍼, 디먹서 입력/임시 메모리, 트랙별 큐는 [bufferConfig]로 만든 하나의 [BufferBudget]을
+ * 나누어 쓰며, 메모리나 버퍼 길이가 한도에 닿으면 다운로드와 디먹싱이 멈춥니다.
  */
 @UnstableApi
 internal class CustomMediaSource(
     private val url: String,
+    private val bufferConfig: YoPlayerBufferConfig = YoPlayerBufferConfig(),
     private val m3u8Downloader: M3u8Downloader = M3u8Downloader(),
     private val tsDemuxer: TsDemuxer = TsDemuxer()
 ) : BaseMediaSource() {
@@ -40,6 +65,38 @@ internal class CustomMediaSource(
 
     private var mediaPeriod: CustomMediaPeriod? = null
 
+    // 플레이어 메모리 예산 (디먹서와 큐보다 늦게 해제)
+    private var bufferBudget: BufferBudget? = null
+
+    // push 모드 디먹싱 전용 스레드 (세그먼트 순서대로 drain 작업 실행)
+    private var demuxExecutor: ExecutorService? = null
+
+    // 현재 세그먼트에서 디먹서로 넘긴 바이트 수와 drain 시작 여부 (feedLock 안에서만 접근)
+    private var segmentFedBytes = 0
+    private var segmentDrainStarted = false
+
+    // 세그먼트를 동시에 받아 병렬 디먹스 풀로 디먹싱하는지 여부
+    private val parallelDemux = bufferConfig.maxConcurrentSegments > 1
+
+    // 다운로드 세대 (seek마다 증가, 이전 다운로드의 늦은 콜백과 drain 작업을 무시하는 데 사용)
+    @Volatile
+    private var downloadGeneration = 0
+    private val feedLock = Any()
+    // 큐 추가와 seek의 큐 비우기를 직렬화 (이전 세대의 배치가 비운 큐에 들어가지 않도록)
+    private val queueLock = Any()
+
+    // 마지막 seek으로 받기 시작한 세그먼트 (불연속 재설정을 건너뜀), 없으면 -1
+    @Volatile
+    private var seekSegmentIndex = -1
+    // 세그먼트 중간부터 받기 시작한 세그먼트 (키프레임 인덱스를 기록하지 않음), 없으면 -1
+    @Volatile
+    private var partialSegmentIndex = -1
+
+    @Volatile
+    private var playlist: M3u8Playlist.Media? = null
+    @Volatile
+    private var seekTable: SeekTable? = null
+
     override fun getMediaItem(): MediaItem = mediaItem
 
     override fun prepareSourceInternal(mediaTransferListener: TransferListener?) {
@@ -54,9 +111,28 @@ internal class CustomMediaSource(
         startPositionUs: Long
     ): MediaPeriod {
         Log.d(TAG, "createPeriod called, startPositionUs=$startPositionUs")
-        val period = CustomMediaPeriod()
+        val budget = bufferBudget ?: BufferBudget(bufferConfig).also { budget ->
+            bufferBudget = budget
+            tsDemuxer.setMemoryBudget(budget.nativeHandle)
+            m3u8Downloader.onSegmentBufferResized = { bytes -> budget.setDownloadBytes(bytes) }
+        }
+        val period = CustomMediaPeriod(budget)
+        // 플레이어가 고르지 않은 트랙(다른 언어 오디오 등)은 디먹서에서 PES 조립 전에 버림
+        period.onTracksSelected = { trackIds -> tsDemuxer.selectTracks(trackIds) }
+        period.onSeek = { positionUs -> seekTo(positionUs) }
+        period.seekTable = seekTable
         mediaPeriod = period
-        startDownload()
+        tsDemuxer.startPushMode()
+        if (parallelDemux) {
+            val workers = tsDemuxer.startParallelDemux(bufferConfig.maxConcurrentSegments)
+            Log.d(TAG, "Parallel demux started: $workers workers")
+        }
+        if (demuxExecutor == null) {
+            demuxExecutor = Executors.newSingleThreadExecutor { runnable ->
+                Thread(runnable, DEMUX_THREAD_NAME)
+            }
+        }
+        startDownload(startSegmentIndex = 0, startByteOffset = 0L, generation = nextGeneration())
         return period
     }
 
@@ -73,9 +149,21 @@ internal class CustomMediaSource(
 
     override fun releaseSourceInternal() {
         m3u8Downloader.release()
-        tsDemuxer.release()
+        cancelDemux()
+        // 아직 실행되지 않은 seek 작업이 다운로드를 다시 시작하지 않도록
+        nextGeneration()
         mediaPeriod?.release()
         mediaPeriod = null
+        // 디먹스 스레드가 네이티브 컨텍스트를 쓰지 않게 된 뒤 해제
+        demuxExecutor?.let { executor ->
+            executor.shutdownNow()
+            executor.awaitTermination(DEMUX_SHUTDOWN_TIMEOUT_MS, TimeUnit.MILLISECONDS)
+        }
+        demuxExecutor = null
+        tsDemuxer.release()
+        m3u8Downloader.onSegmentBufferResized = null
+        bufferBudget?.release()
+        bufferBudget = null
     }
 
     /**
@@ -89,61 +177,195 @@ internal class CustomMediaSource(
 
     fun cancel() {
         m3u8Downloader.cancel()
+        cancelDemux()
         mediaPeriod?.setLoading(false)
         mediaPeriod?.signalEndOfStream()
     }
 
-    private fun startDownload() {
-        m3u8Downloader.download(url, downloadListener)
+    /**
+     * 디먹서 입력을 기다리는 drain 작업과 풀 제출 대기를 깨워 반환시킴
+     */
+    private fun cancelDemux() {
+        tsDemuxer.cancelPushMode()
+        if (parallelDemux) {
+            tsDemuxer.cancelParallelDemux()
+        }
+    }
+
+    /**
+     * 다운로드 세대를 올림
+     * 이전 다운로드의 콜백과 아직 실행되지 않은 drain 작업은 세대가 달라 무시됩니다.
+     */
+    private fun nextGeneration(): Int = synchronized(feedLock) {
+        segmentFedBytes = 0
+        segmentDrainStarted = false
+        ++downloadGeneration
+    }
+
+    /**
+     * [generation] 세대로 다운로드 시작
+     */
+    private fun startDownload(startSegmentIndex: Int, startByteOffset: Long, generation: Int) {
+        partialSegmentIndex = if (startByteOffset > 0) startSegmentIndex else -1
+        m3u8Downloader.download(
+            url,
+            DownloadListener(generation),
+            startSegmentIndex,
+            startByteOffset,
+            bufferConfig.maxConcurrentSegments
+        )
+    }
+
+    /**
+     * [positionUs]로 seek (플레이어 재생 스레드)
+     * 진행 중인 다운로드와 디먹싱을 멈추고 큐를 비운 뒤 바로 반환합니다.
+     * 디먹서 재설정과 새 다운로드 시작은 디먹스 스레드에 등록되어 이전 세대의 drain 작업이 반환된 뒤 실행되므로
+     * 재생 스레드가 drain 작업을 기다리지 않습니다.
+     * @return 디먹싱을 시작하는 위치 (키프레임 또는 세그먼트 시작)
+     */
+    private fun seekTo(positionUs: Long): Long {
+        val table = seekTable ?: return positionUs
+        val segments = playlist?.segments ?: return positionUs
+        val period = mediaPeriod ?: return positionUs
+        val executor = demuxExecutor ?: return positionUs
+        val point = table.lookup(positionUs)
+
+        m3u8Downloader.cancel()
+        cancelDemux()
+        val generation = nextGeneration()
+        // 큐가 비워지기를 기다리는 drain 작업을 깨움 (세대가 바뀌어 배치를 버리고 반환)
+        period.interruptCapacityWait()
+        synchronized(queueLock) {
+            period.discardSamples()
+        }
+        period.setLoading(true)
+
+        executor.execute {
+            // 그 사이 다시 seek했으면 마지막 seek의 작업만 실행
+            if (generation != downloadGeneration) return@execute
+            if (parallelDemux) {
+                tsDemuxer.resetParallelDemux()
+            }
+
+            val resumed = tsDemuxer.seekTo(point.timeUs, point.pts)
+            // AES-128은 CBC 체인 때문에 세그먼트 중간부터 복호화할 수 없으므로 처음부터 받음
+            val byteOffset =
+                if (resumed && segments[point.segmentIndex].encryptionInfo == null) point.byteOffset else 0L
+            Log.d(
+                TAG,
+                "Seek to ${positionUs}us: segment=${point.segmentIndex}, start=${point.timeUs}us, " +
+                    "byteOffset=$byteOffset"
+            )
+            seekSegmentIndex = point.segmentIndex
+            startDownload(point.segmentIndex, byteOffset, generation)
+        }
+        return point.timeUs
     }
 
-    private val downloadListener = object : M3u8DownloadListener {
+    private inner class DownloadListener(
+        private val generation: Int
+    ) : M3u8DownloadListener {
+
+        private val isStale: Boolean
+            get() = generation != downloadGeneration
 
         override fun onDownloadStarted(playlist: M3u8Playlist.Media, totalSegments: Int) {
+            if (isStale) return
             Log.d(TAG, "Download started: $totalSegments segments")
+            if (seekTable == null && playlist.isEndList) {
+                val table = SeekTable(playlist)
+                this@CustomMediaSource.playlist = playlist
+                seekTable = table
+                mediaPeriod?.seekTable = table
+                refreshTimeline()
+            }
             mediaPeriod?.setLoading(true)
         }
 
-        override fun onSegmentDownloaded(
+        override fun onSegmentTransferred(
             segment: M3u8Segment,
-            data: ByteArray,
+            receivedBytes: Long,
+            elapsedTimeMs: Long,
             currentIndex: Int,
             totalSegments: Int
         ) {
-            val period = mediaPeriod ?: return
-            if (period.isLoading.not()) return
+            if (isStale) return
+            val kbps = if (elapsedTimeMs > 0) receivedBytes * 8 / elapsedTimeMs else 0L
             Log.d(
                 TAG,
-                "Segment downloaded: ${currentIndex + 1}/$totalSegments, size=${data.size} bytes"
+                "Segment transferred: ${currentIndex + 1}/$totalSegments, $receivedBytes bytes " +
+                    "in ${elapsedTimeMs}ms (${kbps}kbps)"
             )
+        }
 
-            if (segment.hasDiscontinuity) {
-                tsDemuxer.resetForDiscontinuity()
+        override fun onSegmentDownloaded(
+            segment: M3u8Segment,
+            data: ByteArray,
+            currentIndex: Int,
+            totalSegments: Int
+        ) {
+            onSegmentDownloaded(segment, ByteBuffer.wrap(data), currentIndex, totalSegments)
+        }
+
+        override fun onSegmentKeyLoaded(
+            segment: M3u8Segment,
+            key: ByteArray,
+            iv: ByteArray,
+            currentIndex: Int,
+            totalSegments: Int
+        ) {
+            // 세그먼트의 첫 데이터(트랙 분석 포함)보다 먼저 설정되며, 세그먼트 끝에서 해제됨
+            if (isStale) return
+            val method = segment.encryptionInfo?.method ?: return
+            if (tsDemuxer.setSegmentDecryption(method, key, iv).not()) {
+                Log.e(TAG, "Failed to set decryption for segment ${currentIndex + 1}/$totalSegments")
             }
+        }
 
-            if (period.trackGroups.isEmpty) {
-                val tracks = tsDemuxer.probeSegment(data)
-                logTracks(tracks)
-                setTracks(tracks)
+        override fun onSegmentDataReceived(
+            segment: M3u8Segment,
+            data: ByteBuffer,
+            currentIndex: Int,
+            totalSegments: Int
+        ) {
+            val period = mediaPeriod ?: return
+            if (period.isLoading.not()) return
+
+            // 트랙 분석에 충분한 데이터가 모일 때까지 대기
+            if (period.trackGroups.isEmpty && data.limit() < PUSH_PROBE_BYTES) return
+
+            synchronized(feedLock) {
+                if (isStale) return
+                feedSegmentData(segment, data, currentIndex, generation)
             }
+        }
 
-            var videoCount = 0
-            var audioCount = 0
-            var keyFrameCount = 0
+        override fun onSegmentDownloaded(
+            segment: M3u8Segment,
+            data: ByteBuffer,
+            currentIndex: Int,
+            totalSegments: Int
+        ) {
+            val period = mediaPeriod ?: return
+            if (period.isLoading.not()) return
+            Log.d(
+                TAG,
+                "Segment downloaded: ${currentIndex + 1}/$totalSegments, size=${data.remaining()} bytes"
+            )
 
-            tsDemuxer.demuxSegmentStreaming(data) { sample ->
-                if (sample.isVideo) {
-                    videoCount++
-                    if (sample.isKeyFrame) {
-                        keyFrameCount++
-                    }
-                } else if (sample.isAudio) {
-                    audioCount++
-                }
-                queueSampleWithBackpressure(sample)
+            if (parallelDemux) {
+                submitSegment(segment, data, currentIndex, generation)
+                return
             }
 
-            logSamples(videoCount, audioCount, keyFrameCount, currentIndex)
+            // 아직 넘기지 않은 나머지를 전달하고 세그먼트 끝을 표시
+            synchronized(feedLock) {
+                if (isStale) return
+                feedSegmentData(segment, data, currentIndex, generation)
+                tsDemuxer.endSegmentData()
+                segmentFedBytes = 0
+                segmentDrainStarted = false
+            }
         }
 
         override fun onProgressUpdate(
@@ -166,43 +388,183 @@ internal class CustomMediaSource(
                 TAG,
                 "Download completed: ${segments.size} segments, $totalBytes bytes, ${elapsedTimeMs}ms"
             )
-            mediaPeriod?.setLoading(false)
-            mediaPeriod?.signalEndOfStream()
+            // 남은 세그먼트의 디먹싱이 끝난 뒤 스트림 종료
+            val executor = demuxExecutor ?: return
+            executor.execute {
+                if (isStale) return@execute
+                mediaPeriod?.setLoading(false)
+                mediaPeriod?.signalEndOfStream()
+            }
         }
 
         override fun onDownloadError(error: Throwable, segment: M3u8Segment?) {
+            if (isStale) return
             Log.e(TAG, "Download error: ${error.message}", error)
+            cancelDemux()
             mediaPeriod?.setLoading(false)
         }
 
         override fun onDownloadCancelled() {
+            if (isStale) return
             Log.d(TAG, "Download cancelled")
+            cancelDemux()
             mediaPeriod?.setLoading(false)
         }
     }
 
-    private fun queueSampleWithBackpressure(sample: DemuxedSample) {
-        if (sample.timeUs == C.TIME_UNSET) {
-            Log.w(TAG, "Drop sample with TIME_UNSET: trackType=${sample.trackType}")
+    /**
+     * 현재 세그먼트에서 아직 넘기지 않은 [segmentFedBytes] ~ limit 구간을 디먹서로 전달
+     * 세그먼트의 첫 전달 전에 필요하면 트랙을 분석하고 디먹스 스레드에 drain 작업을 등록합니다.
+     */
+    private fun feedSegmentData(
+        segment: M3u8Segment,
+        data: ByteBuffer,
+        segmentIndex: Int,
+        generation: Int
+    ) {
+        val period = mediaPeriod ?: return
+
+        if (segmentDrainStarted.not()) {
+            if (period.trackGroups.isEmpty) {
+                // 디먹스 스레드가 시작되기 전이므로 네이티브 컨텍스트를 분석에 써도 안전
+                val tracks = tsDemuxer.probeSegment(data.duplicate().apply { position(0) })
+                logTracks(tracks)
+                setTracks(tracks)
+            }
+            startSegmentDrain(segment, segmentIndex, generation, pooled = false)
+            segmentDrainStarted = true
+        }
+
+        val end = data.limit()
+        if (end > segmentFedBytes) {
+            val chunk = data.duplicate()
+            chunk.position(segmentFedBytes)
+            tsDemuxer.feedSegmentData(chunk)
+            segmentFedBytes = end
+        }
+    }
+
+    /**
+     * 다 받은 세그먼트를 병렬 디먹스 풀에 제출하고 drain 작업 등록 (다운로드 스레드)
+     * 풀에 쌓인 세그먼트가 한도를 넘으면 디먹스 스레드가 꺼낼 때까지 대기하므로 다운로드도 함께 멈춥니다.
+     */
+    private fun submitSegment(
+        segment: M3u8Segment,
+        data: ByteBuffer,
+        segmentIndex: Int,
+        generation: Int
+    ) {
+        val period = mediaPeriod ?: return
+        if (generation != downloadGeneration) return
+        if (period.trackGroups.isEmpty) {
+            // 첫 세그먼트의 drain 작업을 등록하기 전이므로 네이티브 컨텍스트를 분석에 써도 안전
+            val tracks = tsDemuxer.probeSegment(data.duplicate())
+            logTracks(tracks)
+            setTracks(tracks)
+        }
+        // 불연속 재설정은 풀이 이 세그먼트를 출력하기 직전에 적용 (seek 직후 첫 세그먼트는 seek에서 이미 다시 잡음)
+        val discontinuity = segment.hasDiscontinuity && segmentIndex != seekSegmentIndex
+        if (tsDemuxer.submitSegment(data, discontinuity).not()) {
             return
         }
-        val videoNeed = if (sample.isVideo) 1 else 0
-        val audioNeed = if (sample.isAudio) 1 else 0
+        startSegmentDrain(segment, segmentIndex, generation, pooled = true)
+    }
+
+    /**
+     * 디먹스 스레드에 세그먼트 drain 작업 등록
+     * 작업은 세그먼트 순서대로 실행되며, push 모드면 세그먼트 끝이 표시될 때까지 받은 만큼,
+     * [pooled]면 풀에서 파싱을 마친 세그먼트 하나의 샘플을 큐에 넣습니다.
+     * 세그먼트 전체를 디먹싱했으면 키프레임 인덱스를 seek 테이블에 기록합니다.
+     */
+    private fun startSegmentDrain(
+        segment: M3u8Segment,
+        segmentIndex: Int,
+        generation: Int,
+        pooled: Boolean
+    ) {
+        val executor = demuxExecutor ?: return
+        executor.execute {
+            if (generation != downloadGeneration) return@execute
+            try {
+                // seek 직후 첫 세그먼트는 seek에서 타임스탬프 기준을 이미 다시 잡음 (풀은 제출 시 지정)
+                if (pooled.not() && segment.hasDiscontinuity && segmentIndex != seekSegmentIndex) {
+                    tsDemuxer.resetForDiscontinuity()
+                }
+
+                var videoCount = 0
+                var audioCount = 0
+                var keyFrameCount = 0
+                var backpressureWaits = 0
+
+                val sink = DemuxedSampleSink { batch ->
+                    for (i in 0 until batch.sampleCount) {
+                        if (batch.isVideo(i)) {
+                            videoCount++
+                            if (batch.isKeyFrame(i)) {
+                                keyFrameCount++
+                            }
+                        } else if (batch.isAudio(i)) {
+                            audioCount++
+                        }
+                    }
+                    backpressureWaits += queueBatchWithBackpressure(batch, generation)
+                }
+                if (pooled) {
+                    tsDemuxer.drainSubmittedSegment(sink)
+                } else {
+                    tsDemuxer.drainSegment(sink)
+                }
+
+                logSamples(videoCount, audioCount, keyFrameCount, segmentIndex)
+                if (backpressureWaits > 0) {
+                    Log.d(
+                        TAG,
+                        "Segment[$segmentIndex] backpressure: $backpressureWaits waits, $bufferBudget"
+                    )
+                }
+                if (generation == downloadGeneration && segmentIndex != partialSegmentIndex) {
+                    seekTable?.setSegmentKeyframes(segmentIndex, tsDemuxer.takeKeyframeIndex())
+                }
+            } catch (e: Exception) {
+                Log.e(TAG, "Demux error: ${e.message}", e)
+            }
+        }
+    }
 
-        var waitCount = 0
+    /**
+     * 재생할 트랙의 큐가 배치를 받을 때까지 대기한 뒤 추가
+     * 큐보다 큰 배치는 큐가 비워질 때마다 나누어 넣습니다. 대기는 네이티브 링에서 잠들었다가 큐가 낮은 워터마크 아래로 비워질 때 깨어나며,
+     * 로딩 중단/seek/해제 시에는 바로 깨어나 배치를 버립니다.
+     * @return 대기한 횟수
+     */
+    private fun queueBatchWithBackpressure(batch: DemuxedSampleBatch, generation: Int): Int {
+        if (batch.sampleCount == 0) {
+            return 0
+        }
+
+        var waits = 0
+        var waitedMs = 0L
+        mediaPeriod?.beginBatch()
         while (true) {
             val period = mediaPeriod ?: break
             if (period.isLoading.not()) break
-            if (period.hasCapacity(videoNeed, audioNeed)) {
-                if (period.queueSample(sample)) break
+            // seek이 큐를 비운 뒤에는 이전 세대의 배치를 넣지 않음
+            val queued = synchronized(queueLock) {
+                if (generation != downloadGeneration) return waits
+                period.queueBatch(batch)
             }
-
-            Thread.sleep(10)
-            waitCount++
-            if (waitCount % 50 == 0) {
-                Log.d(TAG, "Backpressure: waiting for buffer to drain (${waitCount * 10}ms)")
+            if (queued) break
+
+            waits++
+            when (period.awaitCapacity(batch, BACKPRESSURE_WAIT_TIMEOUT_MS)) {
+                SampleRingBuffer.WAIT_CLOSED -> break
+                SampleRingBuffer.WAIT_TIMEOUT -> {
+                    waitedMs += BACKPRESSURE_WAIT_TIMEOUT_MS
+                    Log.d(TAG, "Backpressure: waiting for buffer to drain (${waitedMs}ms)")
+                }
             }
         }
+        return waits
     }
 
     private fun logTracks(tracks: List<TrackFormat>) {
@@ -221,10 +583,13 @@ internal class CustomMediaSource(
     }
 
     private fun refreshTimeline() {
-        Log.d(TAG, "refreshTimeline: durationUs=${C.TIME_UNSET}")
+        // 종료된 플레이리스트를 받은 뒤에는 EXTINF 합으로 길이를 알리고 seek을 허용
+        val table = seekTable
+        val durationUs = table?.durationUs ?: C.TIME_UNSET
+        Log.d(TAG, "refreshTimeline: durationUs=$durationUs, seekable=${table != null}")
         val timeline = SinglePeriodTimeline(
-            /* durationUs= */ C.TIME_UNSET,
-            /* isSeekable= */ false,
+            /* durationUs= */ durationUs,
+            /* isSeekable= */ table != null,
             /* isDynamic= */ false,  // false로 변경 - live stream이 아님
             /* useLiveConfiguration= */ false,
             /* manifest= */ null,
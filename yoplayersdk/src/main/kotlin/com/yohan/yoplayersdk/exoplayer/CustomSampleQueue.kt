@@ -5,40 +5,96 @@ import androidx.media3.common.C
 import androidx.media3.common.util.UnstableApi
 import androidx.media3.decoder.DecoderInputBuffer
 import com.yohan.yoplayersdk.demuxer.DemuxedSample
-import java.util.concurrent.ConcurrentLinkedQueue
-
+import com.yohan.yoplayersdk.demuxer.DemuxedSampleBatch
+
+/**
+ * 트랙별 샘플 큐
+ *
+ * 디먹서가 만든 [DemuxedSampleBatch]에서 이 트랙([trackId])의 샘플만 네이티브 링 버퍼([SampleRingBuffer])로
+ * 옮겨 보관합니다. 메타데이터와 페이로드가 Java 힙 밖에 연속으로 저장되므로 샘플 단위 객체가 없고,
+ * 읽을 때는 링에서 디코더 버퍼로 한 번만 복사합니다. 큐 용량은 샘플 수가 아니라 바이트로 제한됩니다.
+ *
+ * @param trackId 트랙 ID (MPEG-TS PID)
+ * @param trackType 트랙 타입 (큐 용량 결정에 사용)
+ * @param budget 큐 용량과 버퍼 길이 정책을 정하는 플레이어 메모리 예산
+ */
 internal class CustomSampleQueue(
-    private val trackType: Int
+    private val trackId: Int,
+    trackType: Int,
+    budget: BufferBudget
 ) {
     companion object {
-        // 메모리 보호를 위한 최대 샘플 수 (약 30초 분량)
-        private const val MAX_VIDEO_SAMPLES = 1000  // 30fps * 30초
-        private const val MAX_AUDIO_SAMPLES = 1500  // 약 30초 분량
+        // 대기 중인 디먹스 스레드를 깨우는 사용 바이트 (링 크기 대비)
+        private const val LOW_WATERMARK_PERCENT = 75
+    }
+
+    // 링 크기와 길이 워터마크는 플레이어 버퍼 정책에서 정함 ([BufferBudget] 참고)
+    // 최대 길이 이상 쌓이면 가득 찬 것으로 보고, 대기 중인 디먹스 스레드는
+    // 바이트와 길이가 모두 낮은 워터마크 아래로 내려갔을 때 깨어남
+    private val ring = SampleRingBuffer(
+        budget.ringCapacity(trackType == C.TRACK_TYPE_VIDEO),
+        budget
+    ).apply {
+        setWatermarks(
+            lowBytes = capacity.toLong() * LOW_WATERMARK_PERCENT / 100,
+            highDurationUs = budget.config.maxBufferDurationMs * 1000,
+            lowDurationUs = budget.config.resumeBufferDurationMs * 1000
+        )
     }
 
-    private val sampleQueue = ConcurrentLinkedQueue<DemuxedSample>()
-    private val maxSamples =
-        if (trackType == C.TRACK_TYPE_VIDEO) MAX_VIDEO_SAMPLES else MAX_AUDIO_SAMPLES
+    // 다음 샘플의 메타데이터 (재생 스레드에서만 접근, 샘플마다 재사용)
+    private val readMeta = LongArray(SampleRingBuffer.META_COUNT)
 
     @Volatile
     private var isEndOfStream = false
 
+    // 큐에 넣은 마지막 샘플이 디코딩 순서로 끝나는 시각 (DTS + 길이)
+    // B 프레임이 있으면 마지막 샘플의 PTS가 앞선 샘플보다 작을 수 있어 DTS를 기준으로 한다
     @Volatile
     private var lastTimeUs = C.TIME_UNSET
 
+    // 지금 넣는 배치에서 다음에 쓸 샘플 위치 (디먹스 스레드에서만 접근, [beginBatch]에서 초기화)
+    // 링보다 큰 배치는 링이 비워질 때마다 이어서 씀
+    private var batchPosition = 0
+
+    /**
+     * 새 배치를 넣기 시작 (배치마다 [queueBatch] 전에 호출)
+     */
+    fun beginBatch() {
+        batchPosition = 0
+    }
+
     /**
-     * 큐에 샘플 추가
+     * 배치 중 이 트랙의 유효한 샘플을 들어가는 데까지 큐에 추가
+     * 용량이 모자라면 아무것도 넣지 않고, 빈 큐에도 한 번에 들어가지 않는 배치는 들어간 만큼만 넣습니다.
+     * 나머지는 [awaitCapacity]로 기다린 뒤 다시 호출하면 이어서 넣습니다.
+     * @return 이 트랙의 샘플을 모두 넣었으면 true
      */
-    fun queueSample(sample: DemuxedSample): Boolean {
-        if (sample.trackType != trackType) {
+    fun queueBatch(batch: DemuxedSampleBatch): Boolean {
+        val start = batchPosition
+        if (start >= batch.sampleCount) {
             return true
         }
-        if (sampleQueue.size >= maxSamples) {
+        if (hasCapacity(batch).not()) {
             return false
         }
-        sampleQueue.offer(sample)
-        lastTimeUs = sample.timeUs
-        return true
+        val next = ring.write(batch, trackId, start)
+        if (next < 0) {
+            // 해제된 큐 (트랙 선택 해제 등): 넣을 곳이 없으므로 끝난 것으로 봄
+            batchPosition = batch.sampleCount
+            return true
+        }
+        var writtenLastTimeUs = C.TIME_UNSET
+        for (i in start until next) {
+            if (isReadable(batch, i)) {
+                writtenLastTimeUs = batch.decodeTimeUs[i] + batch.durationUs[i]
+            }
+        }
+        if (writtenLastTimeUs != C.TIME_UNSET) {
+            lastTimeUs = writtenLastTimeUs
+        }
+        batchPosition = next
+        return next >= batch.sampleCount
     }
 
     /**
@@ -53,7 +109,7 @@ internal class CustomSampleQueue(
      */
     @OptIn(UnstableApi::class)
     fun read(buffer: DecoderInputBuffer, omitSampleData: Boolean, peek: Boolean): Int {
-        val sample = sampleQueue.peek() ?: run {
+        if (ring.peek(readMeta).not()) {
             if (isEndOfStream) {
                 buffer.setFlags(C.BUFFER_FLAG_END_OF_STREAM)
                 return C.RESULT_BUFFER_READ
@@ -61,19 +117,23 @@ internal class CustomSampleQueue(
             return C.RESULT_NOTHING_READ
         }
 
-        buffer.timeUs = sample.timeUs
-
-        buffer.setFlags(if (sample.isKeyFrame) C.BUFFER_FLAG_KEY_FRAME else 0)
-
-        if (omitSampleData.not()) {
-            // 데이터 복사
-            buffer.ensureSpaceForWrite(sample.data.size)
-            buffer.data?.put(sample.data)
-        }
+        buffer.timeUs = readMeta[SampleRingBuffer.META_TIME_US]
+        val flags = readMeta[SampleRingBuffer.META_FLAGS].toInt()
+        buffer.setFlags(
+            if ((flags and DemuxedSample.FLAG_KEY_FRAME) != 0) C.BUFFER_FLAG_KEY_FRAME else 0
+        )
 
         // omit/peek 여부와 무관하게 읽기 포인터는 전진해야 함
-        if (peek.not()) {
-            sampleQueue.poll()
+        if (omitSampleData.not()) {
+            // 링의 페이로드를 디코더 버퍼로 바로 복사
+            val size = readMeta[SampleRingBuffer.META_SIZE].toInt()
+            buffer.ensureSpaceForWrite(size)
+            val data = buffer.data ?: return C.RESULT_NOTHING_READ
+            if (ring.read(data, size, advance = peek.not()).not()) {
+                return C.RESULT_NOTHING_READ
+            }
+        } else if (peek.not()) {
+            ring.skip()
         }
 
         return C.RESULT_BUFFER_READ
@@ -84,53 +144,101 @@ internal class CustomSampleQueue(
      */
     fun skipToPosition(positionUs: Long, toKeyframe: Boolean): Int {
         var skipped = 0
-        while (true) {
-            val sample = sampleQueue.peek() ?: break
-
-            if (sample.timeUs >= positionUs) {
+        while (ring.peek(readMeta)) {
+            if (readMeta[SampleRingBuffer.META_TIME_US] >= positionUs) {
                 break
             }
 
-            if (toKeyframe && sample.isKeyFrame) {
+            val flags = readMeta[SampleRingBuffer.META_FLAGS].toInt()
+            if (toKeyframe && (flags and DemuxedSample.FLAG_KEY_FRAME) != 0) {
                 // 키프레임 전까지만 스킵
                 break
             }
 
-            sampleQueue.poll()
+            ring.skip()
             skipped++
         }
         return skipped
     }
 
     /**
-     * 버퍼링된 가장 마지막 샘플의 타임스탬프 반환
+     * 버퍼링된 가장 마지막 샘플이 디코딩 순서로 끝나는 시각 반환 (디코딩 없이 샘플 길이까지 포함)
+     * 이 시각 이전에 표시되는 샘플은 모두 큐에 들어와 있습니다.
      */
     fun getBufferedPositionUs(): Long {
-        return if (isEndOfStream && sampleQueue.isEmpty()) C.TIME_END_OF_SOURCE else lastTimeUs
+        return if (isEndOfStream && ring.sampleCount == 0) C.TIME_END_OF_SOURCE else lastTimeUs
     }
 
     /**
      * 데이터 사용 가능 여부
      */
     fun isReady(): Boolean {
-        return sampleQueue.isNotEmpty() || isEndOfStream
+        return ring.sampleCount > 0 || isEndOfStream
+    }
+
+    /**
+     * 배치 중 아직 넣지 않은 이 트랙의 샘플을 모두 받을 수 있는지 여부
+     * 높은 길이 워터마크에 도달했으면 false입니다.
+     * 큐가 비어 있으면 링보다 큰 배치라도 받아들여 교착을 막습니다 (이 경우 들어가는 만큼 나누어 넣음).
+     */
+    fun hasCapacity(batch: DemuxedSampleBatch): Boolean {
+        return batchPosition >= batch.sampleCount || ring.sampleCount == 0 ||
+            ring.canWrite(batch, trackId, batchPosition)
+    }
+
+    /**
+     * [hasCapacity]가 false인 배치를 받을 수 있을 때까지 대기 (디먹스 스레드)
+     * @return [SampleRingBuffer.WAIT_READY] 등 대기 결과
+     */
+    fun awaitCapacity(batch: DemuxedSampleBatch, timeoutMs: Int): Int {
+        return ring.awaitWritable(batch, trackId, batchPosition, timeoutMs)
     }
 
-    fun hasCapacity(count: Int): Boolean {
-        return sampleQueue.size + count <= maxSamples
+    /**
+     * [awaitCapacity]로 대기 중인 디먹스 스레드를 깨움
+     */
+    fun interruptWait() {
+        ring.interrupt()
     }
 
     /**
      * 큐 초기화
      */
     fun clear() {
-        sampleQueue.clear()
+        ring.clear()
         isEndOfStream = false
         lastTimeUs = C.TIME_UNSET
     }
 
+    /**
+     * 네이티브 링 버퍼 해제 (이후 큐는 비어 있는 것으로 동작)
+     */
+    fun release() {
+        ring.release()
+        lastTimeUs = C.TIME_UNSET
+    }
+
     /**
      * 큐에 있는 샘플 수
      */
-    fun getSampleCount(): Int = sampleQueue.size
+    fun getSampleCount(): Int = ring.sampleCount
+
+    /**
+     * 큐가 차지하는 바이트
+     */
+    fun getUsedBytes(): Long = ring.usedBytes
+
+    /**
+     * 큐에 쌓인 길이 (마이크로초)
+     */
+    fun getBufferedDurationUs(): Long = ring.bufferedUs
+
+    /**
+     * [awaitCapacity] 대기 중 깨어난 횟수
+     */
+    fun getWakeupCount(): Long = ring.wakeupCount
+
+    private fun isReadable(batch: DemuxedSampleBatch, index: Int): Boolean {
+        return batch.trackId[index] == trackId && batch.timeUs[index] != C.TIME_UNSET
+    }
 }
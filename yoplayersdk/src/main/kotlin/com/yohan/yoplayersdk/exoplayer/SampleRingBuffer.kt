@@ -0,0 +1,245 @@
+package com.yohan.yoplayersdk.exoplayer
+
+import com.yohan.yoplayersdk.demuxer.DemuxedSampleBatch
+import java.nio.ByteBuffer
+
+/**
+ * 트랙별 네이티브 샘플 링 버퍼 JNI 래퍼
+ *
+ * 샘플 메타데이터와 페이로드를 Java 힙 밖의 고정 크기 메모리에 연속으로 저장합니다.
+ * 디먹스 스레드 하나가 쓰고([write]) 재생 스레드 하나가 읽으며([peek], [read]), 둘 사이에는 락이 없습니다.
+ * 쓰기/비우기/해제는 서로 배타적이므로 해제된 메모리에 쓰는 일이 없습니다.
+ *
+ * 가득 차면 디먹스 스레드는 [awaitWritable]로 잠들고, 재생 스레드가 낮은 워터마크(바이트, 버퍼 길이)
+ * 아래로 비웠을 때 한 번 깨어납니다. [interrupt]와 [release]는 대기를 바로 끝냅니다.
+ *
+ * @param capacity 바이트 크기 (메모리 사용 상한)
+ * @param budget 사용량을 반영할 플레이어 메모리 예산 (링보다 늦게 해제), 없으면 링 크기만 적용
+ */
+internal class SampleRingBuffer(val capacity: Int, budget: BufferBudget? = null) {
+
+    companion object {
+        // [peek]이 채우는 메타데이터 배열 인덱스 (네이티브 SampleRingMeta와 동일)
+        const val META_TIME_US = 0
+        const val META_DECODE_TIME_US = 1
+        const val META_DURATION_US = 2
+        const val META_SIZE = 3
+        const val META_FLAGS = 4
+        const val META_COUNT = 5
+
+        // [awaitWritable] 결과 (네이티브 SampleRingWaitResult와 동일)
+        const val WAIT_READY = 0
+        const val WAIT_TIMEOUT = 1
+        const val WAIT_INTERRUPTED = 2
+        const val WAIT_CLOSED = 3
+    }
+
+    private val lock = Any()
+
+    // 대기 중에는 이 락만 잡으므로 쓰기/비우기를 막지 않음 ([release]는 대기가 끝난 뒤 해제)
+    private val waitLock = Any()
+
+    @Volatile
+    private var nativeRing: Long = nativeCreateRing(capacity, budget?.nativeHandle ?: 0L)
+
+    init {
+        if (nativeRing == 0L) {
+            throw OutOfMemoryError("Failed to allocate sample ring: $capacity bytes")
+        }
+    }
+
+    /**
+     * 읽지 않은 샘플 수
+     */
+    val sampleCount: Int
+        get() = nativeGetSampleCount(nativeRing)
+
+    /**
+     * 사용 중인 바이트
+     */
+    val usedBytes: Long
+        get() = nativeGetUsedBytes(nativeRing)
+
+    /**
+     * 쌓인 길이 (다음 샘플의 DTS부터 마지막 샘플의 끝까지, 마이크로초)
+     */
+    val bufferedUs: Long
+        get() = nativeGetBufferedUs(nativeRing)
+
+    /**
+     * [awaitWritable] 대기 중 깨어난 횟수 (누적)
+     */
+    val wakeupCount: Long
+        get() = nativeGetWakeupCount(nativeRing)
+
+    /**
+     * 워터마크 설정
+     * 높은 바이트 워터마크는 [capacity]이며, 길이 워터마크를 넘으면 [canWrite]가 false를 반환합니다.
+     *
+     * @param lowBytes 대기 중인 생산자를 깨우는 사용 바이트
+     * @param highDurationUs 가득 찬 것으로 보는 버퍼 길이, 0이면 길이 제한 없음
+     * @param lowDurationUs 대기 중인 생산자를 깨우는 버퍼 길이
+     */
+    fun setWatermarks(lowBytes: Long, highDurationUs: Long, lowDurationUs: Long) =
+        synchronized(lock) {
+            nativeSetWatermarks(nativeRing, lowBytes, highDurationUs, lowDurationUs)
+        }
+
+    /**
+     * 배치 중 [start] 이후 [trackId] 트랙의 샘플이 모두 들어갈 공간이 있는지 여부
+     * 높은 길이 워터마크에 도달했거나 메모리 예산이 모자라면 false입니다.
+     */
+    fun canWrite(batch: DemuxedSampleBatch, trackId: Int, start: Int = 0): Boolean =
+        synchronized(lock) {
+            nativeCanWrite(nativeRing, batch.timeUs, batch.size, batch.trackId, trackId, start)
+        }
+
+    /**
+     * 배치 중 [start] 이후 [trackId] 트랙의 샘플이 들어가고 낮은 워터마크 아래로 내려갈 때까지 대기 (디먹스 스레드)
+     * 남은 샘플이 링보다 크면 링이 빌 때 깨어납니다 ([write]로 나누어 씀).
+     * @return [WAIT_READY], [WAIT_TIMEOUT], [WAIT_INTERRUPTED], [WAIT_CLOSED] 중 하나
+     */
+    fun awaitWritable(batch: DemuxedSampleBatch, trackId: Int, start: Int, timeoutMs: Int): Int =
+        synchronized(waitLock) {
+            nativeAwaitWritable(
+                nativeRing, batch.timeUs, batch.size, batch.trackId, trackId, start, timeoutMs
+            )
+        }
+
+    /**
+     * 대기 중인 [awaitWritable]을 깨움 (대기 중이 아니면 다음 대기가 바로 반환)
+     */
+    fun interrupt() = synchronized(lock) {
+        nativeInterrupt(nativeRing)
+    }
+
+    /**
+     * 배치 중 [start] 이후 [trackId] 트랙의 샘플을 들어가는 데까지 씀
+     * 링에 한 번에 들어가지 않으면 들어간 샘플까지만 공개하고, 나머지는 반환된 위치부터 이어서 씁니다.
+     * @return 다음에 쓸 샘플 위치 (모두 썼으면 [DemuxedSampleBatch.sampleCount] 이상), 해제되었으면 -1
+     */
+    fun write(batch: DemuxedSampleBatch, trackId: Int, start: Int = 0): Int = synchronized(lock) {
+        nativeWriteBatch(
+            nativeRing, batch.data, batch.timeUs, batch.decodeTimeUs, batch.durationUs,
+            batch.offset, batch.size, batch.flags, batch.trackId, trackId, start
+        )
+    }
+
+    /**
+     * 다음 샘플의 메타데이터를 [meta]([META_COUNT] 크기)에 채움
+     * @return 비어 있으면 false
+     */
+    fun peek(meta: LongArray): Boolean = nativePeek(nativeRing, meta)
+
+    /**
+     * 다음 샘플의 페이로드를 [target]의 position 위치에 복사하고 position을 옮김
+     * direct 버퍼는 네이티브 메모리에서 바로 한 번만 복사됩니다.
+     *
+     * @param size [peek]으로 얻은 페이로드 크기
+     * @param advance true면 복사 후 샘플을 꺼냄
+     * @return 비어 있거나 공간이 모자라면 false
+     */
+    fun read(target: ByteBuffer, size: Int, advance: Boolean): Boolean {
+        val position = target.position()
+        if (target.remaining() < size) {
+            return false
+        }
+        val copied = if (target.isDirect) {
+            nativeRead(nativeRing, target, position, advance)
+        } else if (target.hasArray()) {
+            nativeReadToArray(nativeRing, target.array(), target.arrayOffset() + position, advance)
+        } else {
+            false
+        }
+        if (copied) {
+            target.position(position + size)
+        }
+        return copied
+    }
+
+    /**
+     * 다음 샘플을 읽지 않고 꺼냄
+     */
+    fun skip() {
+        nativeSkip(nativeRing)
+    }
+
+    /**
+     * 모든 샘플 버림 (재생 스레드에서 호출)
+     */
+    fun clear() = synchronized(lock) {
+        nativeClear(nativeRing)
+    }
+
+    /**
+     * 네이티브 메모리 해제 (이후 쓰기는 실패하고 읽기는 빈 것으로 처리)
+     * 대기 중인 [awaitWritable]을 먼저 끝낸 뒤 해제합니다.
+     */
+    fun release() {
+        synchronized(lock) {
+            nativeClose(nativeRing)
+        }
+        synchronized(waitLock) {
+            synchronized(lock) {
+                val ring = nativeRing
+                nativeRing = 0L
+                nativeReleaseRing(ring)
+            }
+        }
+    }
+
+    private external fun nativeCreateRing(capacity: Int, budget: Long): Long
+    private external fun nativeReleaseRing(ring: Long)
+    private external fun nativeSetWatermarks(
+        ring: Long,
+        lowBytes: Long,
+        highDurationUs: Long,
+        lowDurationUs: Long
+    )
+    private external fun nativeCanWrite(
+        ring: Long,
+        timeUs: LongArray,
+        size: IntArray,
+        trackId: IntArray,
+        track: Int,
+        start: Int
+    ): Boolean
+    private external fun nativeAwaitWritable(
+        ring: Long,
+        timeUs: LongArray,
+        size: IntArray,
+        trackId: IntArray,
+        track: Int,
+        start: Int,
+        timeoutMs: Int
+    ): Int
+    private external fun nativeInterrupt(ring: Long)
+    private external fun nativeClose(ring: Long)
+    private external fun nativeWriteBatch(
+        ring: Long,
+        data: ByteBuffer,
+        timeUs: LongArray,
+        decodeTimeUs: LongArray,
+        durationUs: LongArray,
+        offset: IntArray,
+        size: IntArray,
+        flags: IntArray,
+        trackId: IntArray,
+        track: Int,
+        start: Int
+    ): Int
+    private external fun nativePeek(ring: Long, meta: LongArray): Boolean
+    private external fun nativeRead(ring: Long, target: ByteBuffer, position: Int, advance: Boolean): Boolean
+    private external fun nativeReadToArray(
+        ring: Long,
+        target: ByteArray,
+        offset: Int,
+        advance: Boolean
+    ): Boolean
+    private external fun nativeSkip(ring: Long)
+    private external fun nativeClear(ring: Long)
+    private external fun nativeGetSampleCount(ring: Long): Int
+    private external fun nativeGetUsedBytes(ring: Long): Long
+    private external fun nativeGetBufferedUs(ring: Long): Long
+    private external fun nativeGetWakeupCount(ring: Long): Long
+}
@@ -0,0 +1,91 @@
+package com.yohan.yoplayersdk.exoplayer
+
+import com.yohan.yoplayersdk.demuxer.SegmentKeyframe
+import com.yohan.yoplayersdk.m3u8.M3u8Playlist
+
+/**
+ * VOD seek 테이블
+ *
+ * 세그먼트 시작 시각은 EXTINF 길이의 누적으로 잡고, 디먹싱을 마친 세그먼트는 네이티브 키프레임 인덱스로
+ * 세그먼트 안의 키프레임 위치(시각, PTS, 바이트 오프셋)까지 기록합니다.
+ * 인덱스가 있는 세그먼트는 목표 직전 키프레임 패킷부터, 없는 세그먼트는 세그먼트 처음부터 다시 받습니다.
+ * 디먹스 스레드가 기록하고 재생 스레드가 조회하므로 모든 접근을 동기화합니다.
+ */
+internal class SeekTable(playlist: M3u8Playlist.Media) {
+
+    /**
+     * seek 위치
+     *
+     * @property segmentIndex 다운로드를 시작할 세그먼트 인덱스
+     * @property timeUs 디먹싱을 시작하는 위치의 시각 (키프레임 또는 세그먼트 시작)
+     * @property pts [timeUs]에 대응하는 90kHz PTS, 세그먼트 시작이면 -1
+     * @property byteOffset 세그먼트 안에서 데이터를 받기 시작할 바이트 오프셋
+     */
+    data class SeekPoint(
+        val segmentIndex: Int,
+        val timeUs: Long,
+        val pts: Long,
+        val byteOffset: Long
+    )
+
+    private val segmentStartUs = LongArray(playlist.segments.size)
+    private val keyframes = arrayOfNulls<List<SegmentKeyframe>>(playlist.segments.size)
+
+    /**
+     * 전체 길이 (마이크로초)
+     */
+    val durationUs: Long
+
+    init {
+        var timeUs = 0L
+        playlist.segments.forEachIndexed { index, segment ->
+            segmentStartUs[index] = timeUs
+            timeUs += (segment.duration * 1_000_000).toLong()
+        }
+        durationUs = timeUs
+    }
+
+    /**
+     * 세그먼트 전체를 디먹싱하여 얻은 키프레임 목록 기록
+     */
+    @Synchronized
+    fun setSegmentKeyframes(segmentIndex: Int, segmentKeyframes: List<SegmentKeyframe>) {
+        if (segmentIndex !in keyframes.indices || segmentKeyframes.isEmpty()) {
+            return
+        }
+        keyframes[segmentIndex] = segmentKeyframes
+    }
+
+    /**
+     * [positionUs] 이전의 가장 가까운 seek 위치
+     */
+    @Synchronized
+    fun lookup(positionUs: Long): SeekPoint {
+        val segmentIndex = findSegment(positionUs)
+        val keyframe = keyframes[segmentIndex]?.lastOrNull { it.timeUs <= positionUs }
+            ?: return SeekPoint(segmentIndex, segmentStartUs[segmentIndex], -1, 0)
+        return SeekPoint(segmentIndex, keyframe.timeUs, keyframe.pts, keyframe.byteOffset)
+    }
+
+    /**
+     * [positionUs] 앞뒤의 알려진 키프레임 시각 (SeekParameters 적용용)
+     * 인덱스가 없는 세그먼트는 세그먼트 시작을 키프레임으로 봅니다.
+     *
+     * @return (이전 키프레임, 다음 키프레임), 다음 키프레임을 모르면 두 값이 같음
+     */
+    @Synchronized
+    fun keyframesAround(positionUs: Long): Pair<Long, Long> {
+        val before = lookup(positionUs).timeUs
+        val segmentIndex = findSegment(positionUs)
+        val after = keyframes[segmentIndex]?.firstOrNull { it.timeUs > positionUs }?.timeUs
+            ?: segmentStartUs.getOrNull(segmentIndex + 1)
+            ?: before
+        return before to after
+    }
+
+    private fun findSegment(positionUs: Long): Int {
+        val index = segmentStartUs.binarySearch(positionUs)
+        val segmentIndex = if (index >= 0) index else -index - 2
+        return segmentIndex.coerceIn(0, segmentStartUs.size - 1)
+    }
+}
@@ -1,5 +1,7 @@
 package com.yohan.yoplayersdk.m3u8
 
+import java.nio.ByteBuffer
+
 /**
  * M3U8 다운로드 진행 상황 리스너
  */
@@ -13,6 +15,65 @@ interface M3u8DownloadListener {
      */
     fun onDownloadStarted(playlist: M3u8Playlist.Media, totalSegments: Int)
 
+    /**
+     * 세그먼트 복호화 키 준비 - AES-128 / SAMPLE-AES로 암호화된 세그먼트의 데이터를 전달하기 전에 호출
+     * 암호화 방식은 [M3u8Segment.encryptionInfo]에서 확인합니다.
+     * 기본 구현은 아무 작업도 하지 않습니다.
+     *
+     * @param segment 다운로드할 세그먼트 정보
+     * @param key 16바이트 AES 키
+     * @param iv 16바이트 IV (플레이리스트의 IV 또는 미디어 시퀀스 번호에서 유도)
+     * @param currentIndex 현재 인덱스 (0부터 시작)
+     * @param totalSegments 전체 세그먼트 수
+     */
+    fun onSegmentKeyLoaded(
+        segment: M3u8Segment,
+        key: ByteArray,
+        iv: ByteArray,
+        currentIndex: Int,
+        totalSegments: Int
+    ) {
+    }
+
+    /**
+     * 세그먼트 데이터 일부 수신 - 다운로드가 끝나기 전에 받은 만큼 전달
+     * 세그먼트 전송 도중 일정 크기마다 호출되며, 이후 [onSegmentDownloaded]로 전체 데이터가 다시 전달됩니다.
+     * 버퍼는 콜백이 반환된 뒤 계속 채워지거나 교체되므로 콜백 밖에서 보관하면 안 됩니다.
+     * 기본 구현은 아무 작업도 하지 않습니다.
+     *
+     * @param segment 수신 중인 세그먼트 정보
+     * @param data 지금까지 받은 데이터 (0 ~ limit 구간, position은 이번에 새로 받은 구간의 시작)
+     * @param currentIndex 현재 인덱스 (0부터 시작)
+     * @param totalSegments 전체 세그먼트 수
+     */
+    fun onSegmentDataReceived(
+        segment: M3u8Segment,
+        data: ByteBuffer,
+        currentIndex: Int,
+        totalSegments: Int
+    ) {
+    }
+
+    /**
+     * 세그먼트 요청 하나의 전송 기록 - 세그먼트 데이터를 전달하기 직전에 재생 순서대로 호출
+     * 여러 세그먼트를 동시에 받을 때도 요청마다 따로 집계됩니다.
+     * 기본 구현은 아무 작업도 하지 않습니다.
+     *
+     * @param segment 받은 세그먼트 정보
+     * @param receivedBytes 응답 본문에서 읽은 바이트 수 (Range를 무시한 응답에서 버린 구간 포함)
+     * @param elapsedTimeMs 요청 시작부터 본문을 다 받을 때까지 걸린 시간 (밀리초)
+     * @param currentIndex 현재 인덱스 (0부터 시작)
+     * @param totalSegments 전체 세그먼트 수
+     */
+    fun onSegmentTransferred(
+        segment: M3u8Segment,
+        receivedBytes: Long,
+        elapsedTimeMs: Long,
+        currentIndex: Int,
+        totalSegments: Int
+    ) {
+    }
+
     /**
      * 세그먼트 다운로드 완료 - 바이트 데이터와 함께 전달
      *
@@ -28,6 +89,27 @@ interface M3u8DownloadListener {
         totalSegments: Int
     )
 
+    /**
+     * 세그먼트 다운로드 완료 - direct 버퍼와 함께 전달
+     * 버퍼는 콜백이 반환된 뒤 다른 세그먼트 다운로드에 재사용되므로 콜백 밖에서 보관하면 안 됩니다.
+     * 기본 구현은 바이트 배열로 복사하여 바이트 배열 버전의 onSegmentDownloaded를 호출합니다.
+     *
+     * @param segment 완료된 세그먼트 정보
+     * @param data 다운로드된 데이터 (position ~ limit 구간)
+     * @param currentIndex 현재 인덱스 (0부터 시작)
+     * @param totalSegments 전체 세그먼트 수
+     */
+    fun onSegmentDownloaded(
+        segment: M3u8Segment,
+        data: ByteBuffer,
+        currentIndex: Int,
+        totalSegments: Int
+    ) {
+        val bytes = ByteArray(data.remaining())
+        data.duplicate().get(bytes)
+        onSegmentDownloaded(segment, bytes, currentIndex, totalSegments)
+    }
+
     /**
      * 전체 다운로드 진행률
      *
@@ -2,16 +2,21 @@ package com.yohan.yoplayersdk.m3u8
 
 import kotlinx.coroutines.CancellationException
 import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Deferred
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.Job
+import kotlinx.coroutines.NonCancellable
 import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.async
+import kotlinx.coroutines.coroutineScope
 import kotlinx.coroutines.ensureActive
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
+import okhttp3.Call
 import okhttp3.OkHttpClient
 import okhttp3.Request
-import java.io.ByteArrayOutputStream
 import java.io.IOException
+import java.nio.ByteBuffer
 import java.util.concurrent.TimeUnit
 import java.util.concurrent.atomic.AtomicLong
 import kotlin.coroutines.coroutineContext
@@ -21,6 +26,7 @@ import kotlin.coroutines.coroutineContext
  *
  * M3U8 주소를 입력받아 파싱하고, 모든 세그먼트를 메모리에 다운로드합니다.
  * 내부적으로 SupervisorJob을 사용하여 코루틴을 관리합니다.
+ * 세그먼트는 한 번에 하나씩 받거나, 최대 [MAX_CONCURRENT_SEGMENTS]개까지 동시에 미리 받아 재생 순서대로 전달합니다.
  *
  * @property httpClient OkHttp 클라이언트 (커스텀 설정 가능)
  */
@@ -29,11 +35,39 @@ class M3u8Downloader(
 ) {
     private val supervisorJob = SupervisorJob()
     private val scope = CoroutineScope(Dispatchers.IO + supervisorJob)
+    // 재생 스레드(cancel)와 디먹스 스레드(seek 후 download)에서 접근
+    @Volatile
     private var currentJob: Job? = null
     private val downloadedSegments: List<DownloadedSegment> = mutableListOf()
 
+    // 세그먼트 수신용 direct 버퍼 (동시에 받는 세그먼트마다 하나씩 빌려 쓰고 재사용하여 GC 부담을 줄임)
+    private val freeSegmentBuffers = ArrayDeque<ByteBuffer>()
+    // 할당된 수신 버퍼 전체 용량 (segmentBufferLock 안에서만 접근)
+    private var segmentBufferBytes = 0L
+    private val segmentBufferLock = Any()
+
+    // 진행 중인 세그먼트 요청 (취소 시 응답을 기다리는 읽기를 바로 끝냄)
+    private val activeCalls = HashSet<Call>()
+
+    /**
+     * 세그먼트 수신 버퍼 전체 크기(바이트)가 바뀔 때마다 호출 (플레이어 메모리 예산에 반영)
+     */
+    internal var onSegmentBufferResized: ((Long) -> Unit)? = null
+
+    // AES 키 캐시 (키 URL별, 같은 키를 쓰는 세그먼트마다 다시 받지 않음)
+    private val keyCache = HashMap<String, ByteArray>()
+
     companion object {
-        private const val BUFFER_SIZE = 8192
+        private const val INITIAL_SEGMENT_BUFFER_SIZE = 2 * 1024 * 1024
+        private const val AES_128_KEY_SIZE = 16
+        // 세그먼트 수신 중 리스너에 부분 데이터를 알리는 단위
+        private const val SEGMENT_DATA_NOTIFY_BYTES = 64 * 1024
+        private const val HTTP_PARTIAL_CONTENT = 206
+
+        /**
+         * 동시에 받을 수 있는 최대 세그먼트 수
+         */
+        const val MAX_CONCURRENT_SEGMENTS = 8
         private const val USER_AGENT =
             "Mozilla/5.0 (Linux; Android 14) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Mobile Safari/537.36"
 
@@ -60,12 +94,24 @@ class M3u8Downloader(
      *
      * @param m3u8Url M3U8 플레이리스트 URL
      * @param listener 다운로드 진행 리스너
+     * @param startSegmentIndex 다운로드를 시작할 세그먼트 인덱스 (seek, 이전 세그먼트는 건너뜀)
+     * @param startByteOffset 시작 세그먼트에서 건너뛸 바이트 수 (Range 요청으로 이후 구간만 받음)
+     * @param maxConcurrentSegments 동시에 받을 세그먼트 수 (1 ~ [MAX_CONCURRENT_SEGMENTS]).
+     *        1이면 받는 도중의 데이터도 [M3u8DownloadListener.onSegmentDataReceived]로 알리고,
+     *        2 이상이면 다 받은 세그먼트만 순서대로 전달합니다.
      */
     fun download(
         m3u8Url: String,
         listener: M3u8DownloadListener? = null,
+        startSegmentIndex: Int = 0,
+        startByteOffset: Long = 0L,
+        maxConcurrentSegments: Int = 1,
     ) {
+        require(maxConcurrentSegments in 1..MAX_CONCURRENT_SEGMENTS) {
+            "maxConcurrentSegments must be in 1..$MAX_CONCURRENT_SEGMENTS: $maxConcurrentSegments"
+        }
         currentJob?.cancel()
+        cancelActiveCalls()
         currentJob = scope.launch {
             val startTime = System.currentTimeMillis()
             val totalBytesDownloaded = AtomicLong(0)
@@ -94,14 +140,36 @@ class M3u8Downloader(
                     return@launch
                 }
 
+                if (startSegmentIndex !in mediaPlaylist.segments.indices) {
+                    listener?.onDownloadError(M3u8DownloadException("시작 세그먼트가 범위를 벗어났습니다: $startSegmentIndex"))
+                    return@launch
+                }
+
                 listener?.onDownloadStarted(mediaPlaylist, mediaPlaylist.segmentCount)
 
-                // 4. 세그먼트 다운로드
-                downloadSegments(
-                    mediaPlaylist.segments,
-                    listener,
-                    totalBytesDownloaded,
-                )
+                // 4. 세그먼트 다운로드 (끝나거나 실패/취소되면 미리 받느라 늘어난 수신 버퍼를 정리)
+                try {
+                    if (maxConcurrentSegments > 1) {
+                        prefetchSegments(
+                            mediaPlaylist.segments,
+                            listener,
+                            totalBytesDownloaded,
+                            startSegmentIndex,
+                            startByteOffset,
+                            maxConcurrentSegments,
+                        )
+                    } else {
+                        downloadSegments(
+                            mediaPlaylist.segments,
+                            listener,
+                            totalBytesDownloaded,
+                            startSegmentIndex,
+                            startByteOffset,
+                        )
+                    }
+                } finally {
+                    trimSegmentBuffers()
+                }
 
                 val elapsedTime = System.currentTimeMillis() - startTime
                 listener?.onDownloadCompleted(
@@ -119,30 +187,41 @@ class M3u8Downloader(
     }
 
     /**
-     * 세그먼트들을 다운로드합니다.
+     * 세그먼트들을 [startIndex]부터 다운로드합니다.
+     * 리스너에 전달하는 인덱스는 플레이리스트 전체 기준입니다.
      */
     private suspend fun downloadSegments(
         segments: List<M3u8Segment>,
         listener: M3u8DownloadListener?,
         totalBytesDownloaded: AtomicLong,
+        startIndex: Int,
+        startByteOffset: Long,
     ): List<DownloadedSegment> {
         val downloadedSegments = mutableListOf<DownloadedSegment>()
         val totalSegments = segments.size
 
-        segments.forEachIndexed { index, segment ->
+        for (index in startIndex until totalSegments) {
+            val segment = segments[index]
             coroutineContext.ensureActive()
 
             try {
-                val data = downloadSegmentAndToByteArray(segment)
-                totalBytesDownloaded.addAndGet(data.size.toLong())
-                listener?.onSegmentDownloaded(segment, data, index, totalSegments)
+                notifySegmentKey(segment, listener, index, totalSegments)
 
-                val progress = (index + 1).toFloat() / totalSegments
-                listener?.onProgressUpdate(progress, index + 1, totalSegments)
+                val skipBytes = if (index == startIndex) startByteOffset else 0L
+                val transfer = fetchSegment(segment, skipBytes) { received ->
+                    listener?.onSegmentDataReceived(segment, received, index, totalSegments)
+                }
+                try {
+                    deliverSegment(segment, transfer, listener, totalBytesDownloaded, index, totalSegments)
+                } finally {
+                    releaseSegmentBuffer(transfer.buffer)
+                }
 
             } catch (e: CancellationException) {
                 throw e
             } catch (e: Exception) {
+                // 취소로 요청이 끊긴 경우는 오류로 알리지 않음
+                coroutineContext.ensureActive()
                 listener?.onDownloadError(e, segment)
                 throw M3u8DownloadException("세그먼트 다운로드 실패: ${segment.url}", e)
             }
@@ -152,42 +231,315 @@ class M3u8Downloader(
     }
 
     /**
-     * 단일 세그먼트를 메모리에 다운로드합니다.
+     * 세그먼트들을 [startIndex]부터 최대 [maxConcurrent]개씩 동시에 받아 재생 순서대로 전달합니다.
+     * 앞 세그먼트를 넘기는 동안 뒤 세그먼트를 미리 받아 두므로, 요청마다의 왕복 지연이 겹쳐 연결 하나의
+     * 전송 속도에 묶이지 않습니다. 뒤 세그먼트가 먼저 끝나도 앞 세그먼트를 넘길 때까지 보관하며,
+     * 리스너가 반환해야 창이 밀리므로 미리 받아 두는 세그먼트는 [maxConcurrent]개를 넘지 않습니다.
+     * 실패는 해당 세그먼트의 차례에 알리며, 취소되면 진행 중인 요청을 모두 끊고 버퍼를 회수합니다.
+     */
+    private suspend fun prefetchSegments(
+        segments: List<M3u8Segment>,
+        listener: M3u8DownloadListener?,
+        totalBytesDownloaded: AtomicLong,
+        startIndex: Int,
+        startByteOffset: Long,
+        maxConcurrent: Int,
+    ) = coroutineScope {
+        val totalSegments = segments.size
+        // 받는 중이거나 받았지만 아직 넘기지 않은 세그먼트 (재생 순서)
+        val window = ArrayDeque<Deferred<Result<SegmentTransfer>>>()
+        var nextIndex = startIndex
+
+        try {
+            for (index in startIndex until totalSegments) {
+                while (nextIndex < totalSegments && nextIndex - index < maxConcurrent) {
+                    val segment = segments[nextIndex]
+                    val skipBytes = if (nextIndex == startIndex) startByteOffset else 0L
+                    // 실패가 형제 요청을 취소하지 않도록 결과로 받아 차례가 왔을 때 처리
+                    window.addLast(async { runCatching { fetchSegment(segment, skipBytes) } })
+                    nextIndex++
+                }
+
+                val segment = segments[index]
+                try {
+                    val transfer = window.removeFirst().await().getOrThrow()
+                    try {
+                        notifySegmentKey(segment, listener, index, totalSegments)
+                        deliverSegment(segment, transfer, listener, totalBytesDownloaded, index, totalSegments)
+                    } finally {
+                        releaseSegmentBuffer(transfer.buffer)
+                    }
+                } catch (e: CancellationException) {
+                    throw e
+                } catch (e: Exception) {
+                    coroutineContext.ensureActive()
+                    listener?.onDownloadError(e, segment)
+                    throw M3u8DownloadException("세그먼트 다운로드 실패: ${segment.url}", e)
+                }
+            }
+        } finally {
+            // 넘기지 못한 세그먼트의 요청을 끊고 받은 버퍼를 회수
+            withContext(NonCancellable) {
+                window.forEach { it.cancel() }
+                window.forEach { deferred ->
+                    runCatching { deferred.await() }.getOrNull()?.getOrNull()?.let {
+                        releaseSegmentBuffer(it.buffer)
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * AES-128 / SAMPLE-AES 세그먼트면 키를 받아 리스너에 알림 (세그먼트 데이터보다 먼저 호출)
+     */
+    private suspend fun notifySegmentKey(
+        segment: M3u8Segment,
+        listener: M3u8DownloadListener?,
+        index: Int,
+        totalSegments: Int
+    ) {
+        val info = segment.encryptionInfo ?: return
+        if (info.method == M3u8Segment.EncryptionInfo.METHOD_AES_128 ||
+            info.method == M3u8Segment.EncryptionInfo.METHOD_SAMPLE_AES
+        ) {
+            val key = loadKey(info.keyUrl)
+            val iv = info.resolveIv(segment.sequenceNumber)
+            listener?.onSegmentKeyLoaded(segment, key, iv, index, totalSegments)
+        }
+    }
+
+    /**
+     * 받은 세그먼트의 전송량과 데이터, 진행률을 리스너에 전달
+     */
+    private fun deliverSegment(
+        segment: M3u8Segment,
+        transfer: SegmentTransfer,
+        listener: M3u8DownloadListener?,
+        totalBytesDownloaded: AtomicLong,
+        index: Int,
+        totalSegments: Int
+    ) {
+        totalBytesDownloaded.addAndGet(transfer.receivedBytes)
+        listener?.onSegmentTransferred(
+            segment,
+            transfer.receivedBytes,
+            transfer.elapsedTimeMs,
+            index,
+            totalSegments
+        )
+        listener?.onSegmentDownloaded(segment, transfer.buffer, index, totalSegments)
+
+        val progress = (index + 1).toFloat() / totalSegments
+        listener?.onProgressUpdate(progress, index + 1, totalSegments)
+    }
+
+    /**
+     * 수신 버퍼를 빌려 세그먼트 하나를 받음 (실패하면 버퍼를 돌려줌)
+     * 받은 데이터는 [SegmentTransfer.buffer]의 position ~ limit 구간이며, 다 쓴 뒤 버퍼를 돌려주어야 합니다.
      */
-    private suspend fun downloadSegmentAndToByteArray(
-        segment: M3u8Segment
-    ): ByteArray = withContext(Dispatchers.IO) {
+    private suspend fun fetchSegment(
+        segment: M3u8Segment,
+        skipBytes: Long,
+        onDataReceived: (ByteBuffer) -> Unit = {}
+    ): SegmentTransfer {
+        val transfer = SegmentTransfer(acquireSegmentBuffer())
+        try {
+            downloadSegmentToDirectBuffer(segment, skipBytes, transfer, onDataReceived)
+            return transfer
+        } catch (e: Throwable) {
+            releaseSegmentBuffer(transfer.buffer)
+            throw e
+        }
+    }
+
+    /**
+     * 단일 세그먼트를 [transfer]의 재사용 direct 버퍼에 다운로드합니다.
+     * 응답 본문을 버퍼로 바로 읽어 Java 힙에 세그먼트 크기의 배열을 만들지 않습니다.
+     * 버퍼가 모자라면 더 큰 버퍼로 바꾸고, 끝나면 받은 구간으로 flip하고 전송량과 소요 시간을 기록합니다.
+     *
+     * @param skipBytes 세그먼트 앞에서 건너뛸 바이트 수 (서버가 Range를 무시하면 받은 뒤 버림)
+     * @param onDataReceived 수신 도중 [SEGMENT_DATA_NOTIFY_BYTES]마다 지금까지 받은 구간을 전달
+     */
+    private suspend fun downloadSegmentToDirectBuffer(
+        segment: M3u8Segment,
+        skipBytes: Long,
+        transfer: SegmentTransfer,
+        onDataReceived: (ByteBuffer) -> Unit
+    ): Unit = withContext(Dispatchers.IO) {
+        val startTime = System.currentTimeMillis()
         val requestBuilder = Request.Builder().url(segment.url).get()
 
         // 바이트 범위 설정
         if (segment.byteRangeLength != null && segment.byteRangeOffset != null) {
             val rangeEnd = segment.byteRangeOffset + segment.byteRangeLength - 1
-            requestBuilder.header("Range", "bytes=${segment.byteRangeOffset}-$rangeEnd")
+            requestBuilder.header("Range", "bytes=${segment.byteRangeOffset + skipBytes}-$rangeEnd")
+        } else if (skipBytes > 0) {
+            requestBuilder.header("Range", "bytes=$skipBytes-")
         }
 
-        val request = requestBuilder.build()
-        val response = httpClient.newCall(request).execute()
-
-        if (response.isSuccessful.not()) {
-            throw IOException("HTTP 오류: ${response.code} - ${response.message}")
+        val call = httpClient.newCall(requestBuilder.build())
+        synchronized(activeCalls) {
+            activeCalls.add(call)
         }
+        try {
+            // 등록 전에 취소되었으면 cancelActiveCalls가 이 요청을 보지 못했으므로 여기서 멈춤
+            coroutineContext.ensureActive()
+            val response = call.execute()
 
-        val body = response.body ?: throw IOException("응답 본문이 비어있습니다.")
+            if (response.isSuccessful.not()) {
+                response.close()
+                throw IOException("HTTP 오류: ${response.code} - ${response.message}")
+            }
 
-        ByteArrayOutputStream().use { outputStream ->
-            body.byteStream().use { inputStream ->
-                val buffer = ByteArray(BUFFER_SIZE)
-                var bytesRead: Int
+            val body = response.body ?: throw IOException("응답 본문이 비어있습니다.")
 
-                while (inputStream.read(buffer).also { bytesRead = it } != -1) {
+            body.use {
+                val contentLength = body.contentLength()
+                var buffer = obtainSegmentBuffer(
+                    transfer.buffer,
+                    if (contentLength > 0) contentLength.toInt() else 0
+                )
+                transfer.buffer = buffer
+                val source = body.source()
+                var notifiedBytes = 0
+                var skippedBytes = 0L
+                if (skipBytes > 0 && response.code != HTTP_PARTIAL_CONTENT) {
+                    // Range를 무시하고 처음부터 보낸 응답: 원래 범위 시작부터 건너뛸 구간을 버림
+                    skippedBytes = (segment.byteRangeOffset ?: 0L) + skipBytes
+                    source.skip(skippedBytes)
+                }
+                while (true) {
                     coroutineContext.ensureActive()
-                    outputStream.write(buffer, 0, bytesRead)
+                    if (buffer.hasRemaining().not()) {
+                        buffer = growSegmentBuffer(buffer)
+                        transfer.buffer = buffer
+                    }
+                    if (source.read(buffer) == -1) break
+                    if (buffer.position() - notifiedBytes >= SEGMENT_DATA_NOTIFY_BYTES) {
+                        val received = buffer.duplicate()
+                        received.flip()
+                        received.position(notifiedBytes)
+                        onDataReceived(received)
+                        notifiedBytes = buffer.position()
+                    }
                 }
+                buffer.flip()
+                transfer.receivedBytes = skippedBytes + buffer.remaining()
+                transfer.elapsedTimeMs = System.currentTimeMillis() - startTime
+            }
+        } finally {
+            synchronized(activeCalls) {
+                activeCalls.remove(call)
+            }
+        }
+    }
+
+    /**
+     * 세그먼트 요청 하나의 수신 버퍼와 전송 기록
+     * 버퍼는 수신 중 커지면 교체되므로 다 쓴 뒤에는 마지막 [buffer]를 돌려줍니다.
+     */
+    private class SegmentTransfer(var buffer: ByteBuffer) {
+        var receivedBytes = 0L
+        var elapsedTimeMs = 0L
+    }
+
+    /**
+     * 쉬고 있는 수신 버퍼를 빌림 (없으면 새로 할당)
+     */
+    private fun acquireSegmentBuffer(): ByteBuffer = synchronized(segmentBufferLock) {
+        freeSegmentBuffers.removeLastOrNull() ?: ByteBuffer.allocateDirect(INITIAL_SEGMENT_BUFFER_SIZE)
+            .also { resizeSegmentBuffers(it.capacity().toLong()) }
+    }
+
+    /**
+     * 빌린 수신 버퍼를 돌려줌 (다음 세그먼트에 재사용)
+     */
+    private fun releaseSegmentBuffer(buffer: ByteBuffer) = synchronized(segmentBufferLock) {
+        freeSegmentBuffers.addLast(buffer)
+    }
+
+    /**
+     * 쉬고 있는 수신 버퍼를 가장 최근에 쓴 하나만 남기고 해제
+     * 동시에 받던 세그먼트 수만큼 늘어난 버퍼가 다운로드가 끝난 뒤에도 남아 있지 않도록 합니다.
+     * 다른 다운로드가 빌려 간 버퍼는 건드리지 않습니다.
+     */
+    private fun trimSegmentBuffers() {
+        synchronized(segmentBufferLock) {
+            var released = 0L
+            while (freeSegmentBuffers.size > 1) {
+                released += freeSegmentBuffers.removeFirst().capacity()
+            }
+            if (released > 0) {
+                resizeSegmentBuffers(-released)
             }
-            outputStream.toByteArray()
         }
     }
 
+    /**
+     * 최소 [capacity] 크기의 비워진 세그먼트 버퍼 반환 ([buffer]가 작으면 새로 할당하여 교체)
+     */
+    private fun obtainSegmentBuffer(buffer: ByteBuffer, capacity: Int): ByteBuffer {
+        if (buffer.capacity() >= capacity) {
+            buffer.clear()
+            return buffer
+        }
+        val replaced = ByteBuffer.allocateDirect(capacity)
+        synchronized(segmentBufferLock) {
+            resizeSegmentBuffers(replaced.capacity().toLong() - buffer.capacity())
+        }
+        return replaced
+    }
+
+    /**
+     * 세그먼트 버퍼를 두 배로 늘리고 기존 내용을 이어서 유지
+     */
+    private fun growSegmentBuffer(buffer: ByteBuffer): ByteBuffer {
+        val grown = ByteBuffer.allocateDirect(buffer.capacity() * 2)
+        buffer.flip()
+        grown.put(buffer)
+        synchronized(segmentBufferLock) {
+            resizeSegmentBuffers(grown.capacity().toLong() - buffer.capacity())
+        }
+        return grown
+    }
+
+    // 수신 버퍼 전체 용량 갱신 (segmentBufferLock 안에서 호출)
+    private fun resizeSegmentBuffers(delta: Long) {
+        segmentBufferBytes += delta
+        onSegmentBufferResized?.invoke(segmentBufferBytes)
+    }
+
+    /**
+     * 진행 중인 세그먼트 요청을 모두 끊음 (응답을 기다리거나 읽는 중이면 바로 IOException으로 끝남)
+     */
+    private fun cancelActiveCalls() {
+        val calls = synchronized(activeCalls) { activeCalls.toList() }
+        calls.forEach { it.cancel() }
+    }
+
+    /**
+     * AES-128 / SAMPLE-AES 키를 가져옵니다. 키 URL별로 캐시하여 재사용합니다.
+     */
+    private suspend fun loadKey(keyUrl: String): ByteArray {
+        keyCache[keyUrl]?.let { return it }
+
+        val key = withContext(Dispatchers.IO) {
+            val request = Request.Builder().url(keyUrl).get().build()
+            httpClient.newCall(request).execute().use { response ->
+                if (response.isSuccessful.not()) {
+                    throw IOException("HTTP 오류: ${response.code} - ${response.message}")
+                }
+                response.body?.bytes() ?: throw IOException("응답 본문이 비어있습니다.")
+            }
+        }
+        if (key.size != AES_128_KEY_SIZE) {
+            throw IOException("AES-128 키 크기가 올바르지 않습니다: ${key.size} bytes")
+        }
+        keyCache[keyUrl] = key
+        return key
+    }
+
     /**
      * URL에서 텍스트 콘텐츠를 가져옵니다.
      */
@@ -210,6 +562,7 @@ class M3u8Downloader(
      */
     fun cancel() {
         currentJob?.cancel()
+        cancelActiveCalls()
     }
 
     /**
@@ -33,5 +33,35 @@ data class M3u8Segment(
         val method: String,
         val keyUrl: String,
         val iv: String? = null
-    )
+    ) {
+        /**
+         * 세그먼트 복호화에 쓸 16바이트 IV
+         * IV 속성이 없으면 미디어 시퀀스 번호를 128비트 빅엔디언 정수로 사용합니다 (RFC 8216 5.2).
+         *
+         * @param sequenceNumber 세그먼트의 미디어 시퀀스 번호
+         */
+        fun resolveIv(sequenceNumber: Int): ByteArray {
+            val result = ByteArray(IV_SIZE)
+            val hex = iv?.removePrefix("0x")?.removePrefix("0X")
+            if (hex != null) {
+                // 앞자리가 생략된 값은 오른쪽 정렬
+                val digits = hex.padStart(IV_SIZE * 2, '0').takeLast(IV_SIZE * 2)
+                for (i in 0 until IV_SIZE) {
+                    result[i] = digits.substring(i * 2, i * 2 + 2).toInt(16).toByte()
+                }
+            } else {
+                val sequence = sequenceNumber.toLong() and 0xFFFFFFFFL
+                for (i in 0 until 4) {
+                    result[IV_SIZE - 1 - i] = (sequence shr (i * 8)).toByte()
+                }
+            }
+            return result
+        }
+
+        companion object {
+            const val METHOD_AES_128 = "AES-128"
+            const val METHOD_SAMPLE_AES = "SAMPLE-AES"
+            private const val IV_SIZE = 16
+        }
+    }
 }
@@ -0,0 +1,63 @@
+package com.yohan.yoplayersdk.player
+
+/**
+ * 플레이어 버퍼 정책
+ *
+ * 세그먼트 수신 버퍼, 디먹서 입력/임시 메모리, 트랙별로 쌓인 샘플을 합친 네이티브 메모리 한도와
+ * 트랙별로 미리 쌓아 두는 재생 길이를 정합니다. 둘 중 먼저 닿는 한도에서 다운로드와 디먹싱이 멈추고,
+ * 쌓인 길이가 [resumeBufferDurationMs] 아래로 내려가면 다시 시작합니다.
+ *
+ * [maxConcurrentSegments]는 기본 1로, 세그먼트를 하나씩 받으며 받는 도중의 데이터를 바로 디먹싱합니다
+ * (첫 화면이 빠르고 메모리를 적게 씀). 2 이상이면 세그먼트를 그만큼 동시에 미리 받아 재생 순서대로 넘기고,
+ * 받은 세그먼트는 같은 수의 네이티브 워커가 병렬로 디먹싱합니다. 세그먼트를 다 받아야 디먹싱을 시작하므로
+ * 첫 화면이 늦어지고 수신 버퍼가 세그먼트 수만큼 늘어나, 왕복 지연이 큰 망에서 처리량이 모자랄 때만 올립니다.
+ *
+ * @property maxMemoryBytes 네이티브 버퍼 메모리 한도 (바이트)
+ * @property maxBufferDurationMs 트랙별로 쌓아 두는 최대 재생 길이 (밀리초)
+ * @property resumeBufferDurationMs 한도에 닿은 뒤 디먹싱을 다시 시작하는 재생 길이 (밀리초)
+ * @property maxConcurrentSegments 동시에 받는 세그먼트 수 (1 ~ [MAX_CONCURRENT_SEGMENTS])
+ */
+data class YoPlayerBufferConfig(
+    val maxMemoryBytes: Long = DEFAULT_MAX_MEMORY_BYTES,
+    val maxBufferDurationMs: Long = DEFAULT_MAX_BUFFER_DURATION_MS,
+    val resumeBufferDurationMs: Long = DEFAULT_RESUME_BUFFER_DURATION_MS,
+    val maxConcurrentSegments: Int = DEFAULT_CONCURRENT_SEGMENTS
+) {
+    init {
+        require(maxMemoryBytes >= MIN_MEMORY_BYTES) {
+            "maxMemoryBytes must be at least $MIN_MEMORY_BYTES: $maxMemoryBytes"
+        }
+        require(maxBufferDurationMs > 0) {
+            "maxBufferDurationMs must be positive: $maxBufferDurationMs"
+        }
+        require(resumeBufferDurationMs in 0..maxBufferDurationMs) {
+            "resumeBufferDurationMs must be in 0..$maxBufferDurationMs: $resumeBufferDurationMs"
+        }
+        require(maxConcurrentSegments in 1..MAX_CONCURRENT_SEGMENTS) {
+            "maxConcurrentSegments must be in 1..$MAX_CONCURRENT_SEGMENTS: $maxConcurrentSegments"
+        }
+    }
+
+    companion object {
+        const val DEFAULT_MAX_MEMORY_BYTES = 48L * 1024 * 1024
+        const val DEFAULT_MAX_BUFFER_DURATION_MS = 30_000L
+        const val DEFAULT_RESUME_BUFFER_DURATION_MS = 20_000L
+        const val DEFAULT_CONCURRENT_SEGMENTS = 1
+
+        // 네이티브 디먹스 워커 수 상한과 같음
+        const val MAX_CONCURRENT_SEGMENTS = 8
+
+        // 세그먼트 하나를 받고 디먹싱할 수 있는 최소 메모리
+        const val MIN_MEMORY_BYTES = 8L * 1024 * 1024
+
+        /**
+         * 1GB 램 Android TV 등 메모리가 작은 기기용 정책
+         */
+        val LOW_MEMORY = YoPlayerBufferConfig(
+            maxMemoryBytes = 24L * 1024 * 1024,
+            maxBufferDurationMs = 20_000L,
+            resumeBufferDurationMs = 12_000L,
+            maxConcurrentSegments = 1
+        )
+    }
+}
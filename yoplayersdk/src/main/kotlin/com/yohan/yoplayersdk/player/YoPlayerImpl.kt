@@ -12,10 +12,12 @@ import com.yohan.yoplayersdk.exoplayer.CustomMediaSource
 
 /**
  * @param context Android Context
+ * @param bufferConfig 버퍼 메모리/길이 정책
  */
 @UnstableApi
 internal class YoPlayerImpl(
-    private val context: Context
+    private val context: Context,
+    private val bufferConfig: YoPlayerBufferConfig = YoPlayerBufferConfig()
 ) : YoPlayer {
 
     private var exoPlayer: ExoPlayer? = null
@@ -55,7 +57,7 @@ internal class YoPlayerImpl(
 
         surface?.let { player.setVideoSurface(it) }
 
-        val mediaSource = CustomMediaSource(url)
+        val mediaSource = CustomMediaSource(url, bufferConfig)
         customMediaSource = mediaSource
 
         player.setMediaSource(mediaSource)
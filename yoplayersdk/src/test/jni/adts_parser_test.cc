@@ -0,0 +1,126 @@
+/*
+ * ADTS 헤더 파서 테스트 (raw_data_block 분리)
+ */
+#include <vector>
+
+#include "adts_parser.h"
+#include "test_util.h"
+#include "ts_fixture.h"
+
+static const int SAMPLE_RATE_48000 = 3;
+
+/**
+ * CRC가 있는 3블록 프레임은 블록 위치대로 나뉘고 블록마다 붙은 CRC는 빠지는지 확인
+ */
+static void test_split_protected_multi_block() {
+    const int sizes[] = {100, 57, 300};
+    uint32_t seed = 1;
+    std::vector<uint8_t> frame;
+    fixture_adts_frame(&seed, sizes, 3, SAMPLE_RATE_48000, true, &frame);
+
+    AdtsHeader header;
+    CHECK(parse_adts_header(frame.data(), frame.size(), &header));
+    CHECK_EQ(3, header.raw_blocks);
+    CHECK_EQ(7 + 2 * 3, header.header_size);
+    CHECK_EQ(frame.size(), header.frame_size);
+    CHECK_EQ(3 * 1920, adts_frame_duration(&header));
+
+    AdtsRawBlock blocks[ADTS_MAX_RAW_BLOCKS];
+    CHECK_EQ(3, adts_split_raw_blocks(frame.data(), &header, blocks));
+    int expected_offset = header.header_size;
+    for (int i = 0; i < 3; i++) {
+        CHECK_EQ(expected_offset, blocks[i].offset);
+        CHECK_EQ(sizes[i], blocks[i].size);
+        CHECK_EQ(0x10 + i, frame[blocks[i].offset]);
+        // 블록 바로 뒤가 그 블록의 CRC
+        CHECK_EQ(0xB0, frame[blocks[i].offset + blocks[i].size]);
+        CHECK_EQ(0xB0 + i, frame[blocks[i].offset + blocks[i].size + 1]);
+        expected_offset += sizes[i] + 2;
+    }
+}
+
+/**
+ * 단일 블록 프레임은 CRC 유무와 관계없이 헤더 뒤 전체가 블록 하나인지 확인
+ */
+static void test_split_single_block() {
+    const int size = 371;
+    for (int crc = 0; crc <= 1; crc++) {
+        uint32_t seed = 2;
+        std::vector<uint8_t> frame;
+        fixture_adts_frame(&seed, &size, 1, SAMPLE_RATE_48000, crc != 0, &frame);
+
+        AdtsHeader header;
+        CHECK(parse_adts_header(frame.data(), frame.size(), &header));
+        CHECK_EQ(crc ? 9 : 7, header.header_size);
+        AdtsRawBlock blocks[ADTS_MAX_RAW_BLOCKS];
+        CHECK_EQ(1, adts_split_raw_blocks(frame.data(), &header, blocks));
+        CHECK_EQ(header.header_size, blocks[0].offset);
+        CHECK_EQ(size, blocks[0].size);
+    }
+}
+
+/**
+ * CRC가 없는 다중 블록 프레임은 블록 경계를 알 수 없으므로 나누지 않는지 확인
+ */
+static void test_unprotected_multi_block_not_split() {
+    const int sizes[] = {80, 90};
+    uint32_t seed = 3;
+    std::vector<uint8_t> frame;
+    fixture_adts_frame(&seed, sizes, 2, SAMPLE_RATE_48000, false, &frame);
+
+    AdtsHeader header;
+    CHECK(parse_adts_header(frame.data(), frame.size(), &header));
+    CHECK_EQ(2, header.raw_blocks);
+    CHECK_EQ(7, header.header_size);
+    AdtsRawBlock blocks[ADTS_MAX_RAW_BLOCKS];
+    CHECK_EQ(1, adts_split_raw_blocks(frame.data(), &header, blocks));
+    CHECK_EQ(7, blocks[0].offset);
+    CHECK_EQ(80 + 90, blocks[0].size);
+}
+
+/**
+ * 블록 위치가 프레임을 벗어나거나 역순이면 블록 하나로 처리하는지 확인
+ */
+static void test_invalid_block_position() {
+    const int sizes[] = {64, 64};
+    uint32_t seed = 4;
+    std::vector<uint8_t> frame;
+    fixture_adts_frame(&seed, sizes, 2, SAMPLE_RATE_48000, true, &frame);
+    AdtsHeader header;
+    CHECK(parse_adts_header(frame.data(), frame.size(), &header));
+
+    // raw_data_block_position[1]을 헤더 안쪽으로
+    frame[7] = 0x00;
+    frame[8] = 0x05;
+    AdtsRawBlock blocks[ADTS_MAX_RAW_BLOCKS];
+    CHECK_EQ(1, adts_split_raw_blocks(frame.data(), &header, blocks));
+    CHECK_EQ(header.frame_size - header.header_size, blocks[0].size);
+
+    // 프레임 끝 너머로
+    frame[7] = 0x7F;
+    frame[8] = 0xFF;
+    CHECK_EQ(1, adts_split_raw_blocks(frame.data(), &header, blocks));
+}
+
+/**
+ * 헤더만 있는 빈 프레임은 블록이 없는지 확인
+ */
+static void test_empty_frame() {
+    uint32_t seed = 5;
+    const int size = 0;
+    std::vector<uint8_t> frame;
+    fixture_adts_frame(&seed, &size, 1, SAMPLE_RATE_48000, false, &frame);
+    AdtsHeader header;
+    CHECK(parse_adts_header(frame.data(), frame.size(), &header));
+    AdtsRawBlock blocks[ADTS_MAX_RAW_BLOCKS];
+    CHECK_EQ(0, adts_split_raw_blocks(frame.data(), &header, blocks));
+}
+
+int main() {
+    RUN_TEST(test_split_protected_multi_block);
+    RUN_TEST(test_split_single_block);
+    RUN_TEST(test_unprotected_multi_block_not_split);
+    RUN_TEST(test_invalid_block_position);
+    RUN_TEST(test_empty_frame);
+    return test_exit_code();
+}
@@ -0,0 +1,176 @@
+/*
+ * 세그먼트 복호화 오버헤드 (1080p 세그먼트당)
+ *
+ * 2초 1080p60 + AAC 세그먼트(약 4MB)에 대해 다음 시간을 비교한다.
+ *  - 경량 TS 디먹서로 디먹싱만 하는 시간 (기준)
+ *  - AES-128: 세그먼트 전체 CBC 복호화 + 패딩 제거
+ *  - SAMPLE-AES: 디먹싱한 H.264 액세스 유닛 / ADTS 프레임마다 샘플 복호화
+ * SAMPLE-AES는 디먹서가 샘플을 작업 버퍼로 복사한 뒤 제자리에서 복호화하므로 같은 복사를 포함해 재고,
+ * 복사만 하는 시간을 따로 빼서 순수 복호화 비용을 보인다.
+ * 바이트는 실제 암호문이 아니지만 처리하는 블록 수와 경로는 같다.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "adts_parser.h"
+#include "aes_decryptor.h"
+#include "bench_util.h"
+#include "sample_aes.h"
+#include "ts_demuxer.h"
+#include "ts_fixture.h"
+
+static const int PASSES = 50;
+static const int QUICK_PASSES = 2;
+
+struct CollectedUnit {
+    int codec;
+    size_t offset;
+    int size;
+};
+
+struct Collector {
+    std::vector<CollectedUnit> units;
+    std::vector<uint8_t> payload;
+};
+
+static bool collect_unit(void* opaque, const TsAccessUnit* unit) {
+    Collector* collector = (Collector*)opaque;
+    CollectedUnit collected = {unit->codec, collector->payload.size(), unit->size};
+    collector->units.push_back(collected);
+    collector->payload.insert(collector->payload.end(), unit->data, unit->data + unit->size);
+    return true;
+}
+
+static bool count_unit(void* /* opaque */, const TsAccessUnit* unit) {
+    bench_sink += unit->size;
+    return true;
+}
+
+static int64_t demux_segment(TsDemuxer* demuxer, const std::vector<uint8_t>& segment) {
+    int64_t start_us = bench_now_us();
+    ts_demuxer_reset(demuxer);
+    size_t consumed = 0;
+    ts_demuxer_feed(demuxer, segment.data(), segment.size(), count_unit, nullptr, &consumed);
+    ts_demuxer_flush(demuxer, count_unit, nullptr);
+    return bench_now_us() - start_us;
+}
+
+static int64_t decrypt_aes_128(const AesKey* key, const uint8_t* iv,
+                               const std::vector<uint8_t>& segment, std::vector<uint8_t>* plain) {
+    int64_t start_us = bench_now_us();
+    AesCbcState state;
+    aes_cbc_start(&state, iv);
+    size_t size = aes_cbc_update(key, &state, segment.data(), segment.size(), plain->data());
+    bool padding_valid = false;
+    size += aes_cbc_finish(key, &state, plain->data() + size, &padding_valid);
+    bench_sink += (int64_t)size;
+    return bench_now_us() - start_us;
+}
+
+/**
+ * SAMPLE-AES 오디오는 ADTS 헤더가 붙은 패킷 단위로 복호화하므로 디먹서가 뗀 헤더를 다시 붙임
+ * (AAC-LC 48kHz 스테레오, CRC 없음)
+ */
+static void write_adts_header(uint8_t* out, int frame_size) {
+    out[0] = 0xFF;
+    out[1] = 0xF1;
+    out[2] = (1 << 6) | (3 << 2);
+    out[3] = (uint8_t)((2 << 6) | ((frame_size >> 11) & 0x03));
+    out[4] = (uint8_t)((frame_size >> 3) & 0xFF);
+    out[5] = (uint8_t)(((frame_size & 0x07) << 5) | 0x1F);
+    out[6] = 0xFC;
+}
+
+/**
+ * 샘플마다 작업 버퍼로 복사하고 decrypt면 SAMPLE-AES 복호화
+ */
+static int64_t process_samples(const AesKey* key, const uint8_t* iv, const Collector& collector,
+                               std::vector<uint8_t>* work, bool decrypt) {
+    int64_t start_us = bench_now_us();
+    for (size_t i = 0; i < collector.units.size(); i++) {
+        const CollectedUnit& unit = collector.units[i];
+        uint8_t* data = work->data();
+        int size = unit.size;
+        if (unit.codec == TS_CODEC_AAC) {
+            size += ADTS_HEADER_SIZE;
+            write_adts_header(data, size);
+            memcpy(data + ADTS_HEADER_SIZE, collector.payload.data() + unit.offset, unit.size);
+        } else {
+            memcpy(data, collector.payload.data() + unit.offset, unit.size);
+        }
+        if (!decrypt) {
+            bench_sink += data[size - 1];
+        } else if (unit.codec == TS_CODEC_AAC) {
+            sample_aes_decrypt_adts(key, iv, data, size);
+        } else {
+            bench_sink += sample_aes_decrypt_h264(key, iv, data, size);
+        }
+    }
+    return bench_now_us() - start_us;
+}
+
+int main(int argc, char** argv) {
+    int passes = bench_quick(argc, argv) ? QUICK_PASSES : PASSES;
+
+    TsSegmentSpec spec = fixture_hls_segment_spec();
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 1);
+    ts_fixture_write_segment(&fixture, &spec);
+    const std::vector<uint8_t>& segment = fixture.data;
+
+    TsDemuxer demuxer;
+    ts_demuxer_reset(&demuxer);
+    ts_demuxer_select_pids(&demuxer, nullptr, 0);
+    Collector collector;
+    size_t consumed = 0;
+    ts_demuxer_feed(&demuxer, segment.data(), segment.size(), collect_unit, &collector, &consumed);
+    ts_demuxer_flush(&demuxer, collect_unit, &collector);
+    int max_unit = 0;
+    for (size_t i = 0; i < collector.units.size(); i++) {
+        max_unit = collector.units[i].size > max_unit ? collector.units[i].size : max_unit;
+    }
+
+    uint8_t key_bytes[AES_BLOCK_SIZE];
+    uint8_t iv[AES_BLOCK_SIZE];
+    for (int i = 0; i < AES_BLOCK_SIZE; i++) {
+        key_bytes[i] = (uint8_t)(0x10 + i);
+        iv[i] = (uint8_t)(0xA0 + i);
+    }
+    AesKey key;
+    aes_key_init(&key);
+    aes_key_set(&key, key_bytes);
+
+    // AES-128 입력은 블록 크기의 배수여야 한다
+    std::vector<uint8_t> encrypted(segment);
+    encrypted.resize((segment.size() / AES_BLOCK_SIZE + 1) * AES_BLOCK_SIZE, 0x10);
+    std::vector<uint8_t> plain(encrypted.size() + AES_BLOCK_SIZE);
+    std::vector<uint8_t> work(max_unit + ADTS_HEADER_SIZE);
+
+    int64_t demux_us = 0;
+    int64_t aes_128_us = 0;
+    int64_t copy_us = 0;
+    int64_t sample_aes_us = 0;
+    for (int pass = 0; pass < passes; pass++) {
+        demux_us += demux_segment(&demuxer, segment);
+        aes_128_us += decrypt_aes_128(&key, iv, encrypted, &plain);
+        copy_us += process_samples(&key, iv, collector, &work, false);
+        sample_aes_us += process_samples(&key, iv, collector, &work, true);
+    }
+    aes_key_release(&key);
+
+    double demux_ms = demux_us / 1000.0 / passes;
+    double aes_128_ms = aes_128_us / 1000.0 / passes;
+    double sample_aes_ms = (sample_aes_us - copy_us) / 1000.0 / passes;
+    printf("segment: %.1f MB, %zu samples, AES implementation: %s, %d passes\n",
+           segment.size() / (1024.0 * 1024.0), collector.units.size(),
+           aes_implementation_name(), passes);
+    printf("demux only:            %7.3f ms/segment\n", demux_ms);
+    printf("AES-128 segment:       %7.3f ms/segment (+%.1f%% of demux)\n", aes_128_ms,
+           demux_ms > 0 ? aes_128_ms * 100.0 / demux_ms : 0.0);
+    printf("SAMPLE-AES samples:    %7.3f ms/segment (+%.1f%% of demux, excluding %.3f ms copy)\n",
+           sample_aes_ms, demux_ms > 0 ? sample_aes_ms * 100.0 / demux_ms : 0.0,
+           copy_us / 1000.0 / passes);
+    return 0;
+}
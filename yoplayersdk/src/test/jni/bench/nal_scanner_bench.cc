@@ -0,0 +1,107 @@
+/*
+ * NAL 유닛 경계 탐색 처리량 (GB/s)
+ *
+ * 1080p IDR 액세스 유닛(약 200KB, AUD/SPS/PPS/슬라이스)에서 모든 NAL 경계를 찾는 시간을
+ * 이전 find_h264_sps_pps의 바이트 단위 탐색(시작 코드마다 다음 시작 코드를 다시 훑음)과
+ * find_nal_units(SIMD 선형 탐색)로 비교한다. 두 결과의 경계가 같은지도 확인한다.
+ */
+#include <stdio.h>
+
+#include <vector>
+
+#include "bench_util.h"
+#include "nal_scanner.h"
+#include "ts_fixture.h"
+
+static const int FRAME_COUNT = 32;
+static const int FRAME_BYTES = 200 * 1024;
+static const int PASSES = 200;
+static const int QUICK_PASSES = 5;
+
+/**
+ * 이전 구현의 탐색 방식으로 모든 NAL 유닛 찾기
+ */
+static int find_nal_units_bytewise(const uint8_t* data, int size, std::vector<NalUnit>* out) {
+    out->clear();
+    int i = 0;
+    while (i < size - 4) {
+        if (data[i] == 0 && data[i + 1] == 0) {
+            int start_code_len = 0;
+            if (data[i + 2] == 1) {
+                start_code_len = 3;
+            } else if (data[i + 2] == 0 && data[i + 3] == 1) {
+                start_code_len = 4;
+            }
+            if (start_code_len > 0) {
+                int nal_start = i + start_code_len;
+                int nal_end = size;
+                for (int j = nal_start + 1; j < size - 3; j++) {
+                    if (data[j] == 0 && data[j + 1] == 0 &&
+                        (data[j + 2] == 1 || (data[j + 2] == 0 && data[j + 3] == 1))) {
+                        nal_end = j;
+                        break;
+                    }
+                }
+                NalUnit unit = {data + nal_start, nal_end - nal_start, start_code_len};
+                out->push_back(unit);
+                i = nal_end;
+                continue;
+            }
+        }
+        i++;
+    }
+    return (int)out->size();
+}
+
+typedef int (*FindNalUnits)(const uint8_t* data, int size, std::vector<NalUnit>* out);
+
+static double measure(FindNalUnits find, const std::vector<std::vector<uint8_t> >& frames,
+                      int passes) {
+    std::vector<NalUnit> units;
+    size_t bytes = 0;
+    int64_t start_us = bench_now_us();
+    for (int pass = 0; pass < passes; pass++) {
+        for (size_t i = 0; i < frames.size(); i++) {
+            bench_sink += find(frames[i].data(), (int)frames[i].size(), &units);
+            bytes += frames[i].size();
+        }
+    }
+    int64_t elapsed_us = bench_now_us() - start_us;
+    return bench_per_second((double)bytes, elapsed_us) / 1e9;
+}
+
+int main(int argc, char** argv) {
+    int passes = bench_quick(argc, argv) ? QUICK_PASSES : PASSES;
+
+    uint32_t seed = 1;
+    std::vector<std::vector<uint8_t> > frames(FRAME_COUNT);
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        fixture_h264_access_unit(&seed, FRAME_BYTES, true, &frames[i]);
+    }
+
+    // 두 구현이 같은 경계를 찾는지 확인
+    std::vector<NalUnit> expected;
+    std::vector<NalUnit> actual;
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        const std::vector<uint8_t>& frame = frames[i];
+        find_nal_units_bytewise(frame.data(), (int)frame.size(), &expected);
+        find_nal_units(frame.data(), (int)frame.size(), &actual);
+        bool same = expected.size() == actual.size();
+        for (size_t j = 0; same && j < expected.size(); j++) {
+            same = expected[j].data == actual[j].data && expected[j].size == actual[j].size &&
+                   expected[j].start_code_size == actual[j].start_code_size;
+        }
+        if (!same) {
+            fprintf(stderr, "frame %d: NAL boundaries differ\n", i);
+            return 1;
+        }
+    }
+
+    double bytewise = measure(find_nal_units_bytewise, frames, passes);
+    double vectorized = measure(find_nal_units, frames, passes);
+    printf("%d IDR frames x %d KB, %d passes\n", FRAME_COUNT, FRAME_BYTES / 1024, passes);
+    printf("bytewise search:  %6.2f GB/s\n", bytewise);
+    printf("find_nal_units:   %6.2f GB/s\n", vectorized);
+    printf("speedup: %.2fx\n", bytewise > 0 ? vectorized / bytewise : 0.0);
+    return 0;
+}
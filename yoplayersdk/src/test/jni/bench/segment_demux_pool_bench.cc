@@ -0,0 +1,109 @@
+/*
+ * 병렬 디먹스 풀의 워커 수별 버퍼 채움 처리량
+ *
+ * 다운로드를 마친 2초 1080p60 + AAC 세그먼트(약 4MB)를 풀에 연속으로 제출하고, 디먹스 스레드처럼
+ * 제출 순서대로 꺼내 샘플 페이로드를 큐 버퍼로 복사하는 시간을 워커 1/2/4/8개로 비교한다.
+ * 처리량은 재생 시간 기준(초당 채운 미디어 초)과 입력 바이트 기준으로 출력한다.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "segment_demux_pool.h"
+#include "ts_fixture.h"
+
+static const int SEGMENT_COUNT = 64;
+static const int QUICK_SEGMENT_COUNT = 8;
+static const int WORKER_COUNTS[] = {1, 2, 4, 8};
+static const size_t MAX_PENDING_BYTES = 64 * 1024 * 1024;
+
+/**
+ * segments를 모두 제출하고 순서대로 꺼내 페이로드를 queue_buffer로 복사
+ * @return 걸린 시간 (마이크로초), 실패 시 -1
+ */
+static int64_t fill_buffer(int workers, const std::vector<std::vector<uint8_t> >& segments,
+                           std::vector<uint8_t>* queue_buffer) {
+    SegmentDemuxPool* pool = segment_demux_pool_create(workers, MAX_PENDING_BYTES, nullptr);
+    SegmentDemuxParams params;
+    memset(&params, 0, sizeof(params));
+
+    int64_t start_us = bench_now_us();
+    std::thread downloader([&] {
+        for (size_t i = 0; i < segments.size(); i++) {
+            if (segment_demux_pool_submit(pool, segments[i].data(), segments[i].size(),
+                                          &params) < 0) {
+                break;
+            }
+        }
+    });
+
+    bool ok = true;
+    for (size_t i = 0; i < segments.size(); i++) {
+        SegmentDemuxJob* job = segment_demux_pool_take(pool);
+        if (!job || job->status != SEGMENT_DEMUX_DONE) {
+            ok = false;
+            if (job) {
+                segment_demux_pool_recycle(pool, job);
+            }
+            segment_demux_pool_cancel(pool);
+            break;
+        }
+        size_t pos = 0;
+        for (size_t u = 0; u < job->units.size(); u++) {
+            const SegmentDemuxUnit& unit = job->units[u];
+            if (pos + unit.size > queue_buffer->size()) {
+                pos = 0;
+            }
+            memcpy(queue_buffer->data() + pos, job->payload.data() + unit.offset, unit.size);
+            pos += unit.size;
+        }
+        bench_sink += (int64_t)job->units.size();
+        segment_demux_pool_recycle(pool, job);
+    }
+    downloader.join();
+    int64_t elapsed_us = bench_now_us() - start_us;
+    segment_demux_pool_destroy(pool);
+    return ok ? elapsed_us : -1;
+}
+
+int main(int argc, char** argv) {
+    int count = bench_quick(argc, argv) ? QUICK_SEGMENT_COUNT : SEGMENT_COUNT;
+
+    TsSegmentSpec spec = fixture_hls_segment_spec();
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 1);
+    std::vector<std::vector<uint8_t> > segments(count);
+    size_t total_bytes = 0;
+    for (int i = 0; i < count; i++) {
+        fixture.data.clear();
+        spec.start_pts = 126000 + (int64_t)i * spec.video_frames * spec.frame_duration;
+        ts_fixture_write_segment(&fixture, &spec);
+        segments[i] = fixture.data;
+        total_bytes += fixture.data.size();
+    }
+    double media_seconds = count * spec.video_frames * spec.frame_duration / 90000.0;
+    std::vector<uint8_t> queue_buffer(16 * 1024 * 1024);
+
+    printf("%d segments, %.1f MB, %.0f s of media, %u hardware threads\n", count,
+           total_bytes / (1024.0 * 1024.0), media_seconds, std::thread::hardware_concurrency());
+    int64_t single_us = 0;
+    for (size_t w = 0; w < sizeof(WORKER_COUNTS) / sizeof(WORKER_COUNTS[0]); w++) {
+        int64_t elapsed_us = fill_buffer(WORKER_COUNTS[w], segments, &queue_buffer);
+        if (elapsed_us < 0) {
+            fprintf(stderr, "workers=%d: segment demux failed\n", WORKER_COUNTS[w]);
+            return 1;
+        }
+        if (w == 0) {
+            single_us = elapsed_us;
+        }
+        printf("workers=%d: %8.2f ms/segment, %7.1f media s/s, %7.1f MB/s, speedup %.2fx\n",
+               WORKER_COUNTS[w], elapsed_us / 1000.0 / count,
+               bench_per_second(media_seconds, elapsed_us),
+               bench_per_second(total_bytes / (1024.0 * 1024.0), elapsed_us),
+               elapsed_us > 0 ? (double)single_us / elapsed_us : 0.0);
+    }
+    return 0;
+}
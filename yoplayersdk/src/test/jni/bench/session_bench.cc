@@ -0,0 +1,304 @@
+/*
+ * 세그먼트마다 디먹서 상태를 새로 잡는 방식과 디먹스 세션 하나로 이어 읽는 방식 비교
+ *
+ * 500개 세그먼트(약 1MB, 2초)를 같은 순서로 디먹싱하여 세그먼트당 시간을 본다.
+ * 세션 경로는 nativeDemuxSessionSegment의 경량 TS 경로(demux_session/read_ts_packets)와 같은 순서로
+ * 32KB씩 읽어 세그먼트를 넘어 유지되는 TsDemuxer에 넣고, 액세스 유닛마다 타임스탬프를 정규화해
+ * 싱크 모드 SampleChunkWriter로 1MB 청크 버퍼에 모은다 (JNI 객체 생성과 싱크 호출만 빠짐).
+ * 비교 대상은 같은 경로에서 세그먼트마다 TsDemuxer를 리셋해 PAT/PMT부터 다시 찾는 방식이다.
+ * 시스템 FFmpeg으로 빌드한 경우(YOPLAYER_HAVE_FFMPEG) 세그먼트마다 libavformat 입력을 다시 여는
+ * 이전 경로(nativeDemuxSegment)와 전환된 libavformat 세션 경로도 함께 잰다.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#if defined(YOPLAYER_HAVE_FFMPEG)
+extern "C" {
+#include <libavformat/avformat.h>
+}
+#endif
+
+#include "bench_util.h"
+#include "sample_chunk.h"
+#include "scratch_arena.h"
+#include "timestamp_normalizer.h"
+#include "ts_demuxer.h"
+#include "ts_fixture.h"
+
+static const int AVIO_BUFFER_SIZE = 32768;
+static const size_t SCRATCH_INITIAL_SIZE = 64 * 1024;
+static const int SEGMENT_COUNT = 500;
+static const int QUICK_SEGMENT_COUNT = 40;
+
+struct BenchResult {
+    int64_t samples;
+    int64_t elapsed_us;
+};
+
+/**
+ * 경량 TS 세션 상태 (DemuxerContext의 TsSession, 타임스탬프 정규화, 임시 메모리, 싱크 청크 버퍼)
+ */
+struct TsBenchSession {
+    TsDemuxer demuxer;
+    std::vector<uint8_t> read_buffer;
+    TimestampNormalizer timestamps;
+    ScratchArena scratch;
+    std::vector<uint8_t> chunk_buffer;
+    std::vector<uint8_t> grown;
+    SampleChunkWriter writer;
+    int64_t chunks;
+};
+
+// 싱크 흉내: 청크를 받은 것으로 치고 같은 청크 버퍼로 새 청크 시작
+static bool deliver_chunk(void* opaque, SampleChunk* chunk) {
+    TsBenchSession* session = (TsBenchSession*)opaque;
+    bench_sink += (int64_t)chunk->payload_size;
+    session->chunks++;
+    sample_chunk_restart(chunk, session->chunk_buffer.data(), session->chunk_buffer.size());
+    return true;
+}
+
+static bool grow_chunk(void* opaque, SampleChunk* chunk, size_t capacity) {
+    TsBenchSession* session = (TsBenchSession*)opaque;
+    std::vector<uint8_t> grown(capacity);
+    memcpy(grown.data(), chunk->payload, chunk->payload_size);
+    session->grown.swap(grown);
+    chunk->payload = session->grown.data();
+    chunk->payload_capacity = capacity;
+    return true;
+}
+
+// on_ts_access_unit과 같은 변환 (키프레임 인덱스 기록 제외)
+static bool emit_unit(void* opaque, const TsAccessUnit* unit) {
+    TsBenchSession* session = (TsBenchSession*)opaque;
+    SampleTiming timing;
+    sample_timing_from_ts_unit(&session->timestamps, unit, &timing);
+    return sample_chunk_write(&session->writer, unit->codec == TS_CODEC_AAC ? 1 : 2, unit->pid,
+                              &timing, unit->key_frame ? 1 : 0, unit->data, unit->size);
+}
+
+/**
+ * 세그먼트 하나를 세션 입력처럼 읽어 싱크 모드로 출력
+ * @return 출력한 샘플 수, 경량 디먹서로 처리할 수 없으면 -1
+ */
+static int demux_ts_segment(TsBenchSession* session, const std::vector<uint8_t>& segment) {
+    scratch_arena_reset(&session->scratch);
+    SampleChunkCallbacks callbacks = {deliver_chunk, grow_chunk, session};
+    sample_chunk_writer_init(&session->writer, &session->scratch, &callbacks,
+                             session->chunk_buffer.data(), session->chunk_buffer.size(), true);
+    size_t pos = 0;
+    while (!session->writer.failed) {
+        size_t read = segment.size() - pos;
+        if (read == 0) {
+            ts_demuxer_flush(&session->demuxer, emit_unit, session);
+            break;
+        }
+        read = read < session->read_buffer.size() ? read : session->read_buffer.size();
+        memcpy(session->read_buffer.data(), segment.data() + pos, read);
+        pos += read;
+        size_t consumed = 0;
+        if (ts_demuxer_feed(&session->demuxer, session->read_buffer.data(), read, emit_unit,
+                            session, &consumed) != TS_FEED_OK) {
+            return -1;
+        }
+    }
+    return sample_chunk_writer_finish(&session->writer);
+}
+
+/**
+ * 경량 TS 경로로 모든 세그먼트 디먹싱
+ * @param persistent true면 세션처럼 TsDemuxer 상태를 이어 쓰고, false면 세그먼트마다 리셋
+ */
+static BenchResult demux_ts(const std::vector<std::vector<uint8_t> >& segments, bool persistent) {
+    TsBenchSession session;
+    ts_demuxer_reset(&session.demuxer);
+    ts_demuxer_select_pids(&session.demuxer, nullptr, 0);
+    session.read_buffer.resize(AVIO_BUFFER_SIZE);
+    timestamp_normalizer_reset(&session.timestamps);
+    scratch_arena_init(&session.scratch, SCRATCH_INITIAL_SIZE);
+    session.chunk_buffer.resize(SAMPLE_CHUNK_BYTES);
+    session.chunks = 0;
+
+    BenchResult result = {0, 0};
+    int64_t start_us = bench_now_us();
+    for (size_t i = 0; i < segments.size(); i++) {
+        if (!persistent) {
+            ts_demuxer_reset(&session.demuxer);
+        }
+        int samples = demux_ts_segment(&session, segments[i]);
+        if (samples < 0) {
+            fprintf(stderr, "segment %zu: TS fast path unsupported\n", i);
+            break;
+        }
+        result.samples += samples;
+    }
+    result.elapsed_us = bench_now_us() - start_us;
+    scratch_arena_release(&session.scratch);
+    return result;
+}
+
+#if defined(YOPLAYER_HAVE_FFMPEG)
+
+struct MemoryInput {
+    const std::vector<uint8_t>* segment;
+    size_t pos;
+};
+
+static int read_memory(void* opaque, uint8_t* buf, int buf_size) {
+    MemoryInput* in = (MemoryInput*)opaque;
+    size_t remaining = in->segment->size() - in->pos;
+    if (remaining == 0) {
+        return AVERROR_EOF;
+    }
+    size_t size = remaining < (size_t)buf_size ? remaining : (size_t)buf_size;
+    memcpy(buf, in->segment->data() + in->pos, size);
+    in->pos += size;
+    return (int)size;
+}
+
+static AVFormatContext* open_memory_input(MemoryInput* in) {
+    uint8_t* buffer = (uint8_t*)av_malloc(AVIO_BUFFER_SIZE);
+    AVIOContext* avio = avio_alloc_context(buffer, AVIO_BUFFER_SIZE, 0, in, read_memory,
+                                           nullptr, nullptr);
+    AVFormatContext* fmt_ctx = avformat_alloc_context();
+    fmt_ctx->pb = avio;
+    fmt_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
+    if (avformat_open_input(&fmt_ctx, nullptr, nullptr, nullptr) < 0) {
+        av_freep(&avio->buffer);
+        avio_context_free(&avio);
+        return nullptr;
+    }
+    return fmt_ctx;
+}
+
+static void close_memory_input(AVFormatContext* fmt_ctx) {
+    AVIOContext* avio = fmt_ctx->pb;
+    avformat_close_input(&fmt_ctx);
+    av_freep(&avio->buffer);
+    avio_context_free(&avio);
+}
+
+static int64_t read_all_packets(AVFormatContext* fmt_ctx, AVPacket* pkt) {
+    int64_t count = 0;
+    while (av_read_frame(fmt_ctx, pkt) >= 0) {
+        bench_sink += pkt->size;
+        count++;
+        av_packet_unref(pkt);
+    }
+    return count;
+}
+
+/**
+ * 이전 경로: 세그먼트마다 AVIO/AVFormatContext를 만들고 avformat_find_stream_info까지 수행
+ */
+static BenchResult demux_av_reopen(const std::vector<std::vector<uint8_t> >& segments) {
+    AVPacket* pkt = av_packet_alloc();
+    BenchResult result = {0, 0};
+    int64_t start_us = bench_now_us();
+    for (size_t i = 0; i < segments.size(); i++) {
+        MemoryInput in = {&segments[i], 0};
+        AVFormatContext* fmt_ctx = open_memory_input(&in);
+        if (!fmt_ctx) {
+            fprintf(stderr, "segment %zu: avformat_open_input failed\n", i);
+            break;
+        }
+        avformat_find_stream_info(fmt_ctx, nullptr);
+        result.samples += read_all_packets(fmt_ctx, pkt);
+        close_memory_input(fmt_ctx);
+    }
+    result.elapsed_us = bench_now_us() - start_us;
+    av_packet_free(&pkt);
+    return result;
+}
+
+/**
+ * libavformat 세션: 첫 세그먼트에서만 열고 이후 세그먼트는 EOF를 풀어 같은 컨텍스트로 이어 읽음
+ */
+static BenchResult demux_av_session(const std::vector<std::vector<uint8_t> >& segments) {
+    AVPacket* pkt = av_packet_alloc();
+    BenchResult result = {0, 0};
+    MemoryInput in = {&segments[0], 0};
+    AVFormatContext* fmt_ctx = nullptr;
+    int64_t start_us = bench_now_us();
+    for (size_t i = 0; i < segments.size(); i++) {
+        in.segment = &segments[i];
+        in.pos = 0;
+        if (!fmt_ctx) {
+            fmt_ctx = open_memory_input(&in);
+            if (!fmt_ctx) {
+                fprintf(stderr, "avformat_open_input failed\n");
+                break;
+            }
+        } else {
+            fmt_ctx->pb->eof_reached = 0;
+        }
+        result.samples += read_all_packets(fmt_ctx, pkt);
+    }
+    result.elapsed_us = bench_now_us() - start_us;
+    if (fmt_ctx) {
+        close_memory_input(fmt_ctx);
+    }
+    av_packet_free(&pkt);
+    return result;
+}
+
+#endif  // YOPLAYER_HAVE_FFMPEG
+
+static void print_result(const char* name, const BenchResult& result, int count) {
+    printf("%-24s %8.3f ms/segment, %lld samples\n", name, result.elapsed_us / 1000.0 / count,
+           (long long)result.samples);
+}
+
+int main(int argc, char** argv) {
+    int count = bench_quick(argc, argv) ? QUICK_SEGMENT_COUNT : SEGMENT_COUNT;
+
+    // 연속된 방송처럼 PTS와 continuity_counter가 세그먼트를 넘어 이어지는 720p 세그먼트
+    TsSegmentSpec spec = fixture_hls_segment_spec();
+    spec.key_frame_bytes = 60 * 1024;
+    spec.frame_bytes = 8 * 1024;
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 1);
+    std::vector<std::vector<uint8_t> > segments(count);
+    size_t total_bytes = 0;
+    int64_t expected = 0;
+    for (int i = 0; i < count; i++) {
+        fixture.data.clear();
+        spec.start_pts = 126000 + (int64_t)i * spec.video_frames * spec.frame_duration;
+        expected += ts_fixture_write_segment(&fixture, &spec);
+        segments[i] = fixture.data;
+        total_bytes += fixture.data.size();
+    }
+    printf("%d segments, %.1f MB, %lld access units\n", count, total_bytes / (1024.0 * 1024.0),
+           (long long)expected);
+
+    BenchResult reset = demux_ts(segments, false);
+    print_result("ts reset per segment", reset, count);
+    BenchResult session = demux_ts(segments, true);
+    print_result("ts session", session, count);
+    printf("ts session speedup: %.2fx\n",
+           session.elapsed_us > 0 ? (double)reset.elapsed_us / session.elapsed_us : 0.0);
+
+    // 세션이 세그먼트 경계에서 샘플을 잃지 않아야 비교가 의미 있다
+    bool matched = reset.samples == expected && session.samples == expected;
+
+#if defined(YOPLAYER_HAVE_FFMPEG)
+    av_log_set_level(AV_LOG_QUIET);
+    BenchResult av_reopen = demux_av_reopen(segments);
+    print_result("libavformat reopen", av_reopen, count);
+    BenchResult av_session = demux_av_session(segments);
+    print_result("libavformat session", av_session, count);
+    printf("ts session vs libavformat reopen: %.2fx\n",
+           session.elapsed_us > 0 ? (double)av_reopen.elapsed_us / session.elapsed_us : 0.0);
+    matched = matched && av_reopen.samples == expected && av_session.samples == expected;
+#else
+    printf("libavformat comparison requires system FFmpeg (pkg-config libavformat)\n");
+#endif
+
+    if (!matched) {
+        fprintf(stderr, "sample count mismatch\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * 경량 TS 디먹서 처리량 (TS 패킷/초)
+ *
+ * 2초 1080p60 + AAC 세그먼트를 경량 TS 디먹서로 디먹싱하는 속도를 잰다.
+ * 시스템 FFmpeg으로 빌드한 경우(YOPLAYER_HAVE_FFMPEG) 같은 세그먼트를 이전 경로인
+ * libavformat av_read_frame 루프로도 디먹싱하여 비교하고, 액세스 유닛 수가 같은지 확인한다.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#if defined(YOPLAYER_HAVE_FFMPEG)
+extern "C" {
+#include <libavformat/avformat.h>
+}
+#endif
+
+#include "bench_util.h"
+#include "ts_demuxer.h"
+#include "ts_fixture.h"
+
+static const int SEGMENT_COUNT = 8;
+static const int PASSES = 20;
+static const int QUICK_PASSES = 1;
+
+struct BenchResult {
+    int64_t access_units;
+    int64_t elapsed_us;
+};
+
+static bool count_unit(void* opaque, const TsAccessUnit* unit) {
+    bench_sink += unit->size;
+    (*(int64_t*)opaque)++;
+    return true;
+}
+
+static BenchResult demux_fast_path(const std::vector<std::vector<uint8_t> >& segments,
+                                   int passes) {
+    TsDemuxer demuxer;
+    ts_demuxer_reset(&demuxer);
+    ts_demuxer_select_pids(&demuxer, nullptr, 0);
+    BenchResult result = {0, 0};
+    int64_t start_us = bench_now_us();
+    for (int pass = 0; pass < passes; pass++) {
+        for (size_t i = 0; i < segments.size(); i++) {
+            ts_demuxer_reset(&demuxer);
+            size_t consumed = 0;
+            ts_demuxer_feed(&demuxer, segments[i].data(), segments[i].size(), count_unit,
+                            &result.access_units, &consumed);
+            ts_demuxer_flush(&demuxer, count_unit, &result.access_units);
+        }
+    }
+    result.elapsed_us = bench_now_us() - start_us;
+    return result;
+}
+
+#if defined(YOPLAYER_HAVE_FFMPEG)
+
+static const int AVIO_BUFFER_SIZE = 32768;
+
+struct MemoryInput {
+    const std::vector<uint8_t>* segment;
+    size_t pos;
+};
+
+static int read_memory(void* opaque, uint8_t* buf, int buf_size) {
+    MemoryInput* in = (MemoryInput*)opaque;
+    size_t remaining = in->segment->size() - in->pos;
+    if (remaining == 0) {
+        return AVERROR_EOF;
+    }
+    size_t size = remaining < (size_t)buf_size ? remaining : (size_t)buf_size;
+    memcpy(buf, in->segment->data() + in->pos, size);
+    in->pos += size;
+    return (int)size;
+}
+
+/**
+ * 이전 경로: 세그먼트마다 입력을 열고 av_read_frame으로 EOF까지 읽음 (파서가 AAC를 프레임 단위로 나눔)
+ */
+static BenchResult demux_av_read_frame(const std::vector<std::vector<uint8_t> >& segments,
+                                       int passes) {
+    BenchResult result = {0, 0};
+    AVPacket* pkt = av_packet_alloc();
+    int64_t start_us = bench_now_us();
+    for (int pass = 0; pass < passes; pass++) {
+        for (size_t i = 0; i < segments.size(); i++) {
+            MemoryInput in = {&segments[i], 0};
+            uint8_t* buffer = (uint8_t*)av_malloc(AVIO_BUFFER_SIZE);
+            AVIOContext* avio = avio_alloc_context(buffer, AVIO_BUFFER_SIZE, 0, &in, read_memory,
+                                                   nullptr, nullptr);
+            AVFormatContext* fmt_ctx = avformat_alloc_context();
+            fmt_ctx->pb = avio;
+            fmt_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
+            if (avformat_open_input(&fmt_ctx, nullptr, nullptr, nullptr) == 0) {
+                avformat_find_stream_info(fmt_ctx, nullptr);
+                while (av_read_frame(fmt_ctx, pkt) >= 0) {
+                    bench_sink += pkt->size;
+                    result.access_units++;
+                    av_packet_unref(pkt);
+                }
+                avformat_close_input(&fmt_ctx);
+            }
+            av_freep(&avio->buffer);
+            avio_context_free(&avio);
+        }
+    }
+    result.elapsed_us = bench_now_us() - start_us;
+    av_packet_free(&pkt);
+    return result;
+}
+
+#endif  // YOPLAYER_HAVE_FFMPEG
+
+static void print_result(const char* name, const BenchResult& result, double packets) {
+    printf("%-16s %10.0f packets/s, %8.1f MB/s, %lld access units\n", name,
+           bench_per_second(packets, result.elapsed_us),
+           bench_per_second(packets * TS_PACKET_SIZE, result.elapsed_us) / (1024.0 * 1024.0),
+           (long long)result.access_units);
+}
+
+int main(int argc, char** argv) {
+    int passes = bench_quick(argc, argv) ? QUICK_PASSES : PASSES;
+
+    TsSegmentSpec spec = fixture_hls_segment_spec();
+    spec.audio_tracks = 2;
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 1);
+    std::vector<std::vector<uint8_t> > segments(SEGMENT_COUNT);
+    size_t total_bytes = 0;
+    for (int i = 0; i < SEGMENT_COUNT; i++) {
+        fixture.data.clear();
+        spec.start_pts = 126000 + (int64_t)i * spec.video_frames * spec.frame_duration;
+        ts_fixture_write_segment(&fixture, &spec);
+        segments[i] = fixture.data;
+        total_bytes += fixture.data.size();
+    }
+    double packets = (double)(total_bytes / TS_PACKET_SIZE) * passes;
+    printf("%d segments x %d passes, %.1f MB per pass\n", SEGMENT_COUNT, passes,
+           total_bytes / (1024.0 * 1024.0));
+
+    BenchResult fast_path = demux_fast_path(segments, passes);
+    print_result("ts_demuxer", fast_path, packets);
+
+#if defined(YOPLAYER_HAVE_FFMPEG)
+    av_log_set_level(AV_LOG_QUIET);
+    BenchResult av_read_frame_loop = demux_av_read_frame(segments, passes);
+    print_result("av_read_frame", av_read_frame_loop, packets);
+    printf("speedup: %.2fx\n", fast_path.elapsed_us > 0
+                                   ? (double)av_read_frame_loop.elapsed_us / fast_path.elapsed_us
+                                   : 0.0);
+    if (av_read_frame_loop.access_units != fast_path.access_units) {
+        fprintf(stderr, "access unit count mismatch\n");
+        return 1;
+    }
+#else
+    printf("av_read_frame comparison requires system FFmpeg (pkg-config libavformat)\n");
+#endif
+    return 0;
+}
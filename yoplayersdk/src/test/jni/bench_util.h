@@ -0,0 +1,36 @@
+/*
+ * 호스트 벤치마크 공통 도구
+ *
+ * 벤치마크는 인자 없이 실행하면 전체 반복 횟수로, --quick이면 ctest용으로 짧게 실행한다.
+ * 결과는 사람이 읽는 한 줄 요약으로 출력한다.
+ */
+#ifndef YOPLAYER_BENCH_UTIL_H
+#define YOPLAYER_BENCH_UTIL_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <chrono>
+
+static inline int64_t bench_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static inline bool bench_quick(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 최적화로 측정 대상이 사라지지 않도록 결과를 흘려보내는 곳
+static volatile int64_t bench_sink;
+
+static inline double bench_per_second(double count, int64_t elapsed_us) {
+    return elapsed_us > 0 ? count * 1000000.0 / (double)elapsed_us : 0.0;
+}
+
+#endif  // YOPLAYER_BENCH_UTIL_H
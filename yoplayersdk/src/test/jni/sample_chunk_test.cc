@@ -0,0 +1,334 @@
+/*
+ * 샘플 청크 출력 테스트 (싱크 모드 청크 나누기, 샘플 하나가 청크 버퍼보다 큰 경우, 단일 배치 모드)
+ */
+#include <string.h>
+
+#include <vector>
+
+#include "sample_chunk.h"
+#include "scratch_arena.h"
+#include "test_util.h"
+#include "timestamp_normalizer.h"
+#include "ts_demuxer.h"
+#include "ts_fixture.h"
+
+struct DeliveredSample {
+    int track_id;
+    int size;
+    int flags;
+    int64_t time_us;
+    uint32_t checksum;
+};
+
+/**
+ * 싱크 흉내: 청크를 받을 때마다 샘플을 복사해 두고 같은 청크 버퍼로 새 청크를 시작한다
+ * (JNI의 DemuxedSampleSink와 공유 direct ByteBuffer에 해당)
+ */
+struct HostSink {
+    std::vector<uint8_t> chunk_buffer;
+    std::vector<std::vector<uint8_t> > grown;
+    std::vector<DeliveredSample> samples;
+    int chunks;
+    int max_chunk_samples;
+    int count_limited;          // 샘플 수 한도로 넘긴 청크
+    int oversized_chunks;       // 페이로드가 청크 버퍼보다 큰 청크 (샘플 하나만 있어야 함)
+    int fail_after_chunks;      // 이만큼 넘긴 뒤 flush 실패 (음수면 실패하지 않음)
+};
+
+static uint32_t checksum(const uint8_t* data, int size) {
+    uint32_t hash = 2166136261u;   // FNV-1a
+    for (int i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void collect_chunk(HostSink* sink, const SampleChunk* chunk) {
+    for (size_t i = 0; i < sample_chunk_count(chunk); i++) {
+        DeliveredSample sample;
+        sample.track_id = chunk->track_id.items[i];
+        sample.size = chunk->size.items[i];
+        sample.flags = chunk->flags.items[i];
+        sample.time_us = chunk->time_us.items[i];
+        sample.checksum = checksum(chunk->payload + chunk->offset.items[i], sample.size);
+        sink->samples.push_back(sample);
+    }
+}
+
+static bool sink_flush(void* opaque, SampleChunk* chunk) {
+    HostSink* sink = (HostSink*)opaque;
+    if (sink->fail_after_chunks >= 0 && sink->chunks == sink->fail_after_chunks) {
+        return false;
+    }
+    int count = (int)sample_chunk_count(chunk);
+    sink->chunks++;
+    if (count > sink->max_chunk_samples) {
+        sink->max_chunk_samples = count;
+    }
+    if ((size_t)count == SAMPLE_CHUNK_MAX_SAMPLES) {
+        sink->count_limited++;
+    }
+    if (chunk->payload_size > sink->chunk_buffer.size()) {
+        sink->oversized_chunks++;
+        CHECK_EQ(1, count);
+    }
+    collect_chunk(sink, chunk);
+    sample_chunk_restart(chunk, sink->chunk_buffer.data(), sink->chunk_buffer.size());
+    return true;
+}
+
+static bool sink_grow(void* opaque, SampleChunk* chunk, size_t capacity) {
+    HostSink* sink = (HostSink*)opaque;
+    sink->grown.push_back(std::vector<uint8_t>(capacity));
+    uint8_t* grown = sink->grown.back().data();
+    memcpy(grown, chunk->payload, chunk->payload_size);
+    chunk->payload = grown;
+    chunk->payload_capacity = capacity;
+    return true;
+}
+
+static void sink_init(HostSink* sink, size_t chunk_bytes) {
+    sink->chunk_buffer.assign(chunk_bytes, 0);
+    sink->grown.clear();
+    sink->samples.clear();
+    sink->chunks = 0;
+    sink->max_chunk_samples = 0;
+    sink->count_limited = 0;
+    sink->oversized_chunks = 0;
+    sink->fail_after_chunks = -1;
+}
+
+static void writer_init(SampleChunkWriter* writer, ScratchArena* scratch, HostSink* sink,
+                        bool streaming) {
+    SampleChunkCallbacks callbacks = {sink_flush, sink_grow, sink};
+    sample_chunk_writer_init(writer, scratch, &callbacks, sink->chunk_buffer.data(),
+                             sink->chunk_buffer.size(), streaming);
+}
+
+static SampleTiming timing_at(int index) {
+    SampleTiming timing;
+    timing.time_us = index * 1000LL;
+    timing.decode_time_us = timing.time_us;
+    timing.duration_us = 1000;
+    return timing;
+}
+
+static std::vector<uint8_t> sample_payload(int index, int size) {
+    std::vector<uint8_t> payload((size_t)size);
+    for (int k = 0; k < size; k++) {
+        payload[k] = (uint8_t)(index * 7 + k);
+    }
+    return payload;
+}
+
+// 경량 TS 디먹서 콜백: 순차 세션 경로(on_ts_access_unit)처럼 시각을 정규화해 청크에 쓰고 원본을 기록
+struct SessionOutput {
+    TimestampNormalizer timestamps;
+    SampleChunkWriter writer;
+    std::vector<DeliveredSample> units;
+};
+
+static bool write_unit(void* opaque, const TsAccessUnit* unit) {
+    SessionOutput* out = (SessionOutput*)opaque;
+    SampleTiming timing;
+    sample_timing_from_ts_unit(&out->timestamps, unit, &timing);
+    DeliveredSample reference;
+    reference.track_id = unit->pid;
+    reference.size = unit->size;
+    reference.flags = unit->key_frame ? 1 : 0;
+    reference.time_us = timing.time_us;
+    reference.checksum = checksum(unit->data, unit->size);
+    out->units.push_back(reference);
+    return sample_chunk_write(&out->writer, unit->codec == TS_CODEC_AAC ? 1 : 2, unit->pid,
+                              &timing, reference.flags, unit->data, unit->size);
+}
+
+/**
+ * 액세스 유닛 2만 개 이상의 세그먼트를 임의 크기 읽기로 디먹싱해 싱크 모드로 출력하고,
+ * 모든 유닛이 순서, 크기, 내용, 시각 그대로 청크 한도 안에서 전달되는지 확인
+ * @param chunk_bytes 청크 버퍼 크기 (작으면 페이로드 크기로, 크면 샘플 수로 청크가 나뉜다)
+ */
+static void check_session_units_streamed(size_t chunk_bytes) {
+    TsSegmentSpec spec = fixture_hls_segment_spec();
+    spec.video_frames = 8000;
+    spec.key_frame_bytes = 1200;
+    spec.frame_bytes = 300;
+    spec.audio_tracks = 2;
+    spec.audio_frames_per_pes = 1;
+    spec.audio_frame_bytes = 200;
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 11);
+    int expected = ts_fixture_write_segment(&fixture, &spec);
+    CHECK(expected >= 20000);
+
+    HostSink sink;
+    sink_init(&sink, chunk_bytes);
+    ScratchArena scratch;
+    scratch_arena_init(&scratch, 64 * 1024);
+    SessionOutput out;
+    timestamp_normalizer_reset(&out.timestamps);
+    writer_init(&out.writer, &scratch, &sink, true);
+
+    TsDemuxer demuxer;
+    ts_demuxer_reset(&demuxer);
+    ts_demuxer_select_pids(&demuxer, nullptr, 0);
+    uint32_t chunk_seed = 5;
+    size_t pos = 0;
+    while (pos < fixture.data.size()) {
+        size_t read = 1 + fixture_random(&chunk_seed) % 32768;
+        read = read < fixture.data.size() - pos ? read : fixture.data.size() - pos;
+        size_t consumed = 0;
+        CHECK_EQ(TS_FEED_OK, ts_demuxer_feed(&demuxer, fixture.data.data() + pos, read,
+                                             write_unit, &out, &consumed));
+        pos += read;
+    }
+    ts_demuxer_flush(&demuxer, write_unit, &out);
+    int count = sample_chunk_writer_finish(&out.writer);
+
+    CHECK(!out.writer.failed);
+    CHECK_EQ(expected, out.units.size());
+    CHECK_EQ(expected, count);
+    CHECK_EQ(expected, sink.samples.size());
+    CHECK(sink.max_chunk_samples <= (int)SAMPLE_CHUNK_MAX_SAMPLES);
+    CHECK_EQ(0, sink.oversized_chunks);
+    CHECK(sink.grown.empty());
+    CHECK(sink.chunks > expected / (int)SAMPLE_CHUNK_MAX_SAMPLES);
+    if (chunk_bytes >= SAMPLE_CHUNK_BYTES) {
+        CHECK_EQ(expected / (int)SAMPLE_CHUNK_MAX_SAMPLES, sink.count_limited);
+    } else {
+        CHECK_EQ(0, sink.count_limited);
+    }
+    int mismatches = 0;
+    int unset_times = 0;
+    for (size_t i = 0; i < out.units.size() && i < sink.samples.size(); i++) {
+        const DeliveredSample& unit = out.units[i];
+        const DeliveredSample& sample = sink.samples[i];
+        mismatches += unit.track_id != sample.track_id || unit.size != sample.size ||
+                      unit.flags != sample.flags || unit.time_us != sample.time_us ||
+                      unit.checksum != sample.checksum;
+        unset_times += sample.time_us == TIMESTAMP_UNSET_US;
+    }
+    CHECK_EQ(0, mismatches);
+    CHECK_EQ(0, unset_times);
+    scratch_arena_release(&scratch);
+}
+
+static void test_20000_units_streamed_by_sample_count() {
+    check_session_units_streamed(SAMPLE_CHUNK_BYTES);
+}
+
+static void test_20000_units_streamed_by_payload_size() {
+    check_session_units_streamed(16 * 1024);
+}
+
+/**
+ * 청크 버퍼보다 큰 샘플은 쌓인 청크를 먼저 넘긴 뒤 더 큰 버퍼로 옮겨 잘리지 않고 혼자 넘어가며,
+ * 다음 청크는 다시 청크 버퍼를 쓰는지 확인
+ */
+static void test_oversized_sample_not_truncated() {
+    HostSink sink;
+    sink_init(&sink, 4096);
+    ScratchArena scratch;
+    scratch_arena_init(&scratch, 4096);
+    SampleChunkWriter writer;
+    writer_init(&writer, &scratch, &sink, true);
+
+    const int sizes[] = {100, 200, 10000, 300, 4096, 1};
+    const int count = (int)(sizeof(sizes) / sizeof(sizes[0]));
+    for (int i = 0; i < count; i++) {
+        std::vector<uint8_t> payload = sample_payload(i, sizes[i]);
+        SampleTiming timing = timing_at(i);
+        CHECK(sample_chunk_write(&writer, 2, 0x100, &timing, 0, payload.data(), sizes[i]));
+    }
+    CHECK_EQ(count, sample_chunk_writer_finish(&writer));
+
+    // [100, 200] [10000] [300] [4096] [1]
+    CHECK_EQ(5, sink.chunks);
+    CHECK_EQ(1, sink.oversized_chunks);
+    CHECK_EQ(1, sink.grown.size());
+    CHECK(writer.chunk.payload == sink.chunk_buffer.data());
+    CHECK_EQ(count, sink.samples.size());
+    for (int i = 0; i < count && i < (int)sink.samples.size(); i++) {
+        std::vector<uint8_t> payload = sample_payload(i, sizes[i]);
+        CHECK_EQ(sizes[i], sink.samples[i].size);
+        CHECK_EQ(checksum(payload.data(), sizes[i]), sink.samples[i].checksum);
+        CHECK_EQ(i * 1000LL, sink.samples[i].time_us);
+    }
+    scratch_arena_release(&scratch);
+}
+
+/**
+ * 단일 배치 모드는 청크를 나누지 않고 버퍼를 키워 모든 샘플을 청크 하나에 남기는지 확인
+ */
+static void test_single_batch_keeps_all_samples() {
+    HostSink sink;
+    sink_init(&sink, 1024);
+    ScratchArena scratch;
+    scratch_arena_init(&scratch, 4096);
+    SampleChunkWriter writer;
+    writer_init(&writer, &scratch, &sink, false);
+
+    const int count = 1000;
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        int size = (i * 37) % 697 | 1;
+        std::vector<uint8_t> payload = sample_payload(i, size);
+        SampleTiming timing = timing_at(i);
+        CHECK(sample_chunk_write(&writer, 1, 0x101, &timing, 1, payload.data(), size));
+        total += (size_t)size;
+    }
+    CHECK(sample_chunk_writer_flush(&writer));
+    CHECK_EQ(count, sample_chunk_writer_finish(&writer));
+
+    CHECK_EQ(0, sink.chunks);
+    CHECK(!sink.grown.empty());
+    CHECK_EQ(count, sample_chunk_count(&writer.chunk));
+    CHECK_EQ(total, writer.chunk.payload_size);
+    collect_chunk(&sink, &writer.chunk);
+    for (int i = 0; i < count; i++) {
+        int size = (i * 37) % 697 | 1;
+        std::vector<uint8_t> payload = sample_payload(i, size);
+        CHECK_EQ(checksum(payload.data(), size), sink.samples[i].checksum);
+    }
+    scratch_arena_release(&scratch);
+}
+
+/**
+ * 싱크가 실패하면 출력을 멈추고, 넘긴 청크까지만 센다
+ */
+static void test_flush_failure_stops_output() {
+    HostSink sink;
+    sink_init(&sink, SAMPLE_CHUNK_BYTES);
+    sink.fail_after_chunks = 1;
+    ScratchArena scratch;
+    scratch_arena_init(&scratch, 4096);
+    SampleChunkWriter writer;
+    writer_init(&writer, &scratch, &sink, true);
+
+    std::vector<uint8_t> payload = sample_payload(0, 10);
+    int written = 0;
+    for (int i = 0; i < 3 * (int)SAMPLE_CHUNK_MAX_SAMPLES; i++) {
+        SampleTiming timing = timing_at(i);
+        if (!sample_chunk_write(&writer, 2, 0x100, &timing, 0, payload.data(), 10)) {
+            break;
+        }
+        written++;
+    }
+    CHECK_EQ(2 * SAMPLE_CHUNK_MAX_SAMPLES, written);
+    CHECK(writer.failed);
+    CHECK(!sample_chunk_writer_flush(&writer));
+    // 실패한 청크까지 싱크에 넘긴 것으로 센다 (JNI에서는 예외가 호출자에게 전파됨)
+    CHECK_EQ(2 * SAMPLE_CHUNK_MAX_SAMPLES, sample_chunk_writer_finish(&writer));
+    CHECK_EQ(1, sink.chunks);
+    CHECK_EQ(SAMPLE_CHUNK_MAX_SAMPLES, sink.samples.size());
+    scratch_arena_release(&scratch);
+}
+
+int main() {
+    RUN_TEST(test_20000_units_streamed_by_sample_count);
+    RUN_TEST(test_20000_units_streamed_by_payload_size);
+    RUN_TEST(test_oversized_sample_not_truncated);
+    RUN_TEST(test_single_batch_keeps_all_samples);
+    RUN_TEST(test_flush_failure_stops_output);
+    return test_exit_code();
+}
@@ -0,0 +1,497 @@
+/*
+ * 샘플 링 버퍼 테스트 (버퍼 끝을 넘는 홀수 크기 레코드, 배치 단위 쓰기와 나누어 쓰기, 워터마크 대기)
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "sample_ring.h"
+#include "test_util.h"
+#include "timestamp_normalizer.h"
+
+// 샘플 번호로 정해지는 홀수 페이로드 크기 (1 ~ 697바이트)
+static int odd_size(int index) {
+    return (index * 37) % 697 | 1;
+}
+
+static void fill_payload(int index, int size, std::vector<uint8_t>* payload) {
+    payload->resize((size_t)size);
+    for (int k = 0; k < size; k++) {
+        (*payload)[k] = (uint8_t)(index + k);
+    }
+}
+
+static bool payload_matches(const SampleRingRecord* record, int index) {
+    const uint8_t* data = (const uint8_t*)(record + 1);
+    for (int k = 0; k < record->size; k++) {
+        if (data[k] != (uint8_t)(index + k)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static SampleRingRecord make_record(int index, int size) {
+    SampleRingRecord record;
+    record.time_us = index * 1000LL;
+    record.decode_time_us = index * 1000LL;
+    record.duration_us = 1000;
+    record.size = size;
+    record.flags = index;
+    return record;
+}
+
+/**
+ * 홀수 크기 레코드를 쓰고 읽기를 반복해 버퍼 끝을 여러 바퀴 넘어도
+ * (끝에 헤더도 들어가지 않는 공간이 남는 경우 포함) 순서와 내용이 그대로인지 확인
+ */
+static void test_wrap_around_odd_sizes() {
+    SampleRing* ring = sample_ring_create(4096, nullptr);
+    CHECK(ring != nullptr);
+    std::vector<uint8_t> payload;
+    const int count = 20000;
+    int written = 0;
+    int read = 0;
+    int bad = 0;
+    int short_tails = 0;
+    while (read < count) {
+        // 들어가는 만큼 쓰고, 가득 차면 절반 정도 읽기
+        while (written < count) {
+            int size = odd_size(written);
+            fill_payload(written, size, &payload);
+            SampleRingRecord record = make_record(written, size);
+            size_t tail = ring->capacity - (size_t)(ring->write_pos.load() % ring->capacity);
+            SampleRingWriter writer;
+            sample_ring_begin_write(ring, &writer);
+            if (!sample_ring_write(ring, &writer, &record, payload.data())) {
+                break;
+            }
+            short_tails += tail < sizeof(SampleRingRecord) && tail < sample_ring_record_size(size);
+            sample_ring_commit(ring, &writer);
+            written++;
+        }
+        int to_read = ring->count.load() / 2 + 1;
+        for (int i = 0; i < to_read && read < written; i++) {
+            const SampleRingRecord* record = sample_ring_peek(ring);
+            if (!record) {
+                bad++;
+                break;
+            }
+            bad += record->flags != read || record->size != odd_size(read) ||
+                   record->time_us != read * 1000LL || !payload_matches(record, read);
+            sample_ring_pop(ring);
+            read++;
+        }
+    }
+    CHECK_EQ(0, bad);
+    CHECK_EQ(0, ring->count.load());
+    CHECK_EQ(0, sample_ring_used(ring));
+    CHECK(sample_ring_peek(ring) == nullptr);
+    CHECK(ring->write_pos.load() > 100 * ring->capacity);
+    CHECK(short_tails > 0);
+    sample_ring_destroy(ring);
+}
+
+/**
+ * 생산자/소비자 스레드가 동시에 홀수 크기 레코드를 배치로 쓰고 읽어도 순서와 내용이 그대로인지 확인
+ */
+static void test_concurrent_odd_sizes() {
+    SampleRing* ring = sample_ring_create(10000, nullptr);
+    const int count = 200000;
+    const int batch_size = 3;
+    std::atomic<int> write_failures(0);
+    std::thread producer([&] {
+        std::vector<uint8_t> payload;
+        int index = 0;
+        while (index < count) {
+            int batch = count - index < batch_size ? count - index : batch_size;
+            SampleRingWriter writer;
+            sample_ring_begin_write(ring, &writer);
+            bool fits = true;
+            for (int j = 0; j < batch && fits; j++) {
+                fits = sample_ring_reserve(ring, &writer, odd_size(index + j));
+            }
+            if (!fits) {
+                std::this_thread::yield();
+                continue;
+            }
+            sample_ring_begin_write(ring, &writer);
+            for (int j = 0; j < batch; j++) {
+                int size = odd_size(index + j);
+                fill_payload(index + j, size, &payload);
+                SampleRingRecord record = make_record(index + j, size);
+                if (!sample_ring_write(ring, &writer, &record, payload.data())) {
+                    write_failures++;
+                }
+            }
+            sample_ring_commit(ring, &writer);
+            index += batch;
+        }
+    });
+
+    int bad = 0;
+    for (int expected = 0; expected < count;) {
+        const SampleRingRecord* record = sample_ring_peek(ring);
+        if (!record) {
+            std::this_thread::yield();
+            continue;
+        }
+        bad += record->flags != expected || record->size != odd_size(expected) ||
+               !payload_matches(record, expected);
+        sample_ring_pop(ring);
+        expected++;
+    }
+    producer.join();
+    // 공간을 확인한 배치는 쓰는 도중에 실패하지 않아야 한다
+    CHECK_EQ(0, write_failures.load());
+    CHECK_EQ(0, bad);
+    CHECK_EQ(0, sample_ring_used(ring));
+    sample_ring_destroy(ring);
+}
+
+/**
+ * 배치 쓰기는 commit 전까지 보이지 않고, 들어가지 않는 샘플은 writer를 바꾸지 않으며,
+ * commit하지 않은 배치는 흔적 없이 버려지는지 확인
+ */
+static void test_batch_all_or_nothing() {
+    MemoryBudget* budget = memory_budget_create(1024 * 1024, 0);
+    SampleRing* ring = sample_ring_create(1024, budget);
+    std::vector<uint8_t> payload;
+
+    // 들어가지 않을 때까지 쓰지만 commit하지 않음
+    SampleRingWriter writer;
+    sample_ring_begin_write(ring, &writer);
+    int written = 0;
+    while (true) {
+        int size = odd_size(written);
+        fill_payload(written, size, &payload);
+        SampleRingRecord record = make_record(written, size);
+        SampleRingWriter before = writer;
+        if (!sample_ring_write(ring, &writer, &record, payload.data())) {
+            CHECK_EQ(before.pos, writer.pos);
+            CHECK_EQ(before.count, writer.count);
+            break;
+        }
+        written++;
+    }
+    CHECK(written > 1);
+    CHECK_EQ(written, writer.count);
+    CHECK(sample_ring_peek(ring) == nullptr);
+    CHECK_EQ(0, ring->count.load());
+    CHECK_EQ(0, sample_ring_used(ring));
+    CHECK_EQ(0, memory_budget_used(budget, MEMORY_BUDGET_SAMPLES));
+
+    // 같은 위치에서 다시 시작한 배치를 commit하면 한꺼번에 보임
+    sample_ring_begin_write(ring, &writer);
+    const int batch = 3;
+    for (int i = 0; i < batch; i++) {
+        int size = odd_size(100 + i);
+        fill_payload(100 + i, size, &payload);
+        SampleRingRecord record = make_record(100 + i, size);
+        CHECK(sample_ring_write(ring, &writer, &record, payload.data()));
+        CHECK_EQ(0, ring->count.load());
+    }
+    sample_ring_commit(ring, &writer);
+    CHECK_EQ(batch, ring->count.load());
+    CHECK_EQ(writer.pos, ring->write_pos.load());
+    CHECK_EQ(sample_ring_used(ring), memory_budget_used(budget, MEMORY_BUDGET_SAMPLES));
+    for (int i = 0; i < batch; i++) {
+        const SampleRingRecord* record = sample_ring_peek(ring);
+        CHECK(record != nullptr);
+        if (record) {
+            CHECK_EQ(100 + i, record->flags);
+            CHECK(payload_matches(record, 100 + i));
+        }
+        sample_ring_pop(ring);
+    }
+
+    // 공간 확인(reserve)만으로는 아무것도 쓰이지 않음
+    sample_ring_begin_write(ring, &writer);
+    int reserved = 0;
+    while (sample_ring_reserve(ring, &writer, odd_size(reserved))) {
+        reserved++;
+    }
+    CHECK(reserved > 0);
+    CHECK_EQ(0, ring->count.load());
+    CHECK(sample_ring_peek(ring) == nullptr);
+
+    sample_ring_destroy(ring);
+    CHECK_EQ(0, memory_budget_total(budget));
+    memory_budget_destroy(budget);
+}
+
+/**
+ * 링보다 큰 배치가 링이 비워질 때마다 나누어 쓰여 이 트랙의 샘플이 하나도 빠지지 않고 순서대로 나오는지 확인
+ * 다른 트랙과 타임스탬프 없는 샘플은 건너뛰고, 링보다 큰 샘플만 버려진다.
+ */
+static void test_batch_split_across_commits() {
+    const int track = 1;
+    const int count = 120;
+    const int unset_index = 50;
+    const int oversized_index = 70;
+    MemoryBudget* budget = memory_budget_create(1024 * 1024, 0);
+    SampleRing* ring = sample_ring_create(4096, budget);
+
+    std::vector<int64_t> times(count);
+    std::vector<int32_t> offsets(count);
+    std::vector<int32_t> sizes(count);
+    std::vector<int32_t> flags(count);
+    std::vector<int32_t> tracks(count);
+    std::vector<uint8_t> payload;
+    std::vector<uint8_t> sample;
+    std::vector<int> expected;
+    for (int i = 0; i < count; i++) {
+        int size = i == oversized_index ? 5000 : odd_size(i);
+        fill_payload(i, size, &sample);
+        times[i] = i == unset_index ? TIMESTAMP_UNSET_US : i * 1000LL;
+        offsets[i] = (int32_t)payload.size();
+        sizes[i] = size;
+        flags[i] = i;
+        tracks[i] = i % 3 == 2 ? track + 1 : track;
+        payload.insert(payload.end(), sample.begin(), sample.end());
+        if (tracks[i] == track && i != unset_index && i != oversized_index) {
+            expected.push_back(i);
+        }
+    }
+    SampleRingBatch batch;
+    batch.count = count;
+    batch.time_us = times.data();
+    batch.decode_time_us = times.data();
+    batch.duration_us = times.data();
+    batch.offset = offsets.data();
+    batch.size = sizes.data();
+    batch.flags = flags.data();
+    batch.track_id = tracks.data();
+    batch.payload = payload.data();
+    batch.payload_size = (int64_t)payload.size();
+
+    // 링보다 크므로 한 번에 들어가지 않고, 대기는 링이 빌 때 깨어나도록 링 크기로 줄어듦
+    CHECK(!sample_ring_batch_fits(ring, &batch, track, 0));
+    CHECK_EQ(ring->capacity, sample_ring_batch_required(ring, &batch, track, 0));
+
+    std::vector<int> received;
+    int mismatches = 0;
+    int dropped = 0;
+    int commits = 0;
+    int start = 0;
+    while (start < count && commits < count) {
+        int next = sample_ring_write_batch(ring, &batch, track, start, &dropped);
+        CHECK(next > start);
+        if (next <= start) {
+            break;
+        }
+        commits++;
+        start = next;
+        while (const SampleRingRecord* record = sample_ring_peek(ring)) {
+            received.push_back(record->flags);
+            mismatches += !payload_matches(record, record->flags);
+            sample_ring_pop(ring);
+        }
+    }
+    CHECK_EQ(count, start);
+    CHECK(commits > 1);
+    CHECK_EQ(1, dropped);
+    CHECK_EQ(0, mismatches);
+    CHECK(received == expected);
+    CHECK(sample_ring_batch_fits(ring, &batch, track, count));
+    CHECK_EQ(0, memory_budget_used(budget, MEMORY_BUDGET_SAMPLES));
+
+    sample_ring_destroy(ring);
+    memory_budget_destroy(budget);
+}
+
+static bool write_one(SampleRing* ring, int index, int size, int64_t duration_us,
+                      std::vector<uint8_t>* payload) {
+    fill_payload(index, size, payload);
+    SampleRingRecord record = make_record(index, size);
+    record.duration_us = duration_us;
+    record.decode_time_us = index * duration_us;
+    record.time_us = record.decode_time_us;
+    SampleRingWriter writer;
+    sample_ring_begin_write(ring, &writer);
+    if (!sample_ring_write(ring, &writer, &record, payload->data())) {
+        return false;
+    }
+    sample_ring_commit(ring, &writer);
+    return true;
+}
+
+static void sleep_ms(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// 생산자가 대기에 들어갈 때까지 기다림
+static bool wait_for_waiting(SampleRing* ring) {
+    for (int i = 0; i < 2000 && !ring->waiting.load(); i++) {
+        sleep_ms(1);
+    }
+    return ring->waiting.load();
+}
+
+/**
+ * 가득 찬 링에서 기다리는 생산자가 소비자가 샘플을 꺼낼 때마다 깨어나지 않고,
+ * 사용량이 낮은 바이트 워터마크 아래로 내려간 시점에 한 번만 깨어나는지 확인
+ */
+static void test_byte_watermark_wakeup() {
+    const size_t low_bytes = 16 * 1024;
+    SampleRing* ring = sample_ring_create(64 * 1024, nullptr);
+    sample_ring_set_watermarks(ring, low_bytes, 0, 0);
+    std::vector<uint8_t> payload;
+    int written = 0;
+    while (write_one(ring, written, 1000, 1000, &payload)) {
+        written++;
+    }
+
+    std::atomic<int> result(-1);
+    std::atomic<size_t> used_at_wakeup(0);
+    std::thread producer([&] {
+        int status = sample_ring_wait_writable(ring, sample_ring_record_size(1000), 5000);
+        used_at_wakeup.store(sample_ring_used(ring));
+        result.store(status);
+    });
+    CHECK(wait_for_waiting(ring));
+
+    // 한 샘플씩 천천히 꺼내며, 워터마크 위에서 생산자가 깨어났는지 확인
+    int pops = 0;
+    int early_wakeups = 0;
+    while (result.load() < 0 && ring->count.load() > 0) {
+        sample_ring_pop(ring);
+        pops++;
+        sleep_ms(1);
+        early_wakeups += result.load() >= 0 && sample_ring_used(ring) > low_bytes;
+    }
+    producer.join();
+
+    CHECK_EQ(SAMPLE_RING_WAIT_READY, result.load());
+    CHECK(used_at_wakeup.load() <= low_bytes);
+    CHECK_EQ(0, early_wakeups);
+    CHECK(pops > 1);
+    CHECK_EQ(1, ring->waits.load());
+    // 스퓨리어스 웨이크업 하나까지는 허용
+    CHECK(ring->wakeups.load() <= 2);
+    sample_ring_destroy(ring);
+}
+
+/**
+ * 높은 길이 워터마크에 도달해 기다리는 생산자가 버퍼 길이가 낮은 길이 워터마크 아래로
+ * 내려간 뒤에 깨어나는지 확인
+ */
+static void test_duration_watermark_wakeup() {
+    const int64_t sample_us = 10000;
+    SampleRing* ring = sample_ring_create(1024 * 1024, nullptr);
+    sample_ring_set_watermarks(ring, ring->capacity, 2000000, 1000000);
+    std::vector<uint8_t> payload;
+    for (int i = 0; i < 300; i++) {
+        CHECK(write_one(ring, i, 100, sample_us, &payload));
+    }
+    CHECK(sample_ring_above_high_watermark(ring));
+    CHECK_EQ(300 * sample_us, sample_ring_buffered_us(ring));
+
+    std::atomic<int> result(-1);
+    std::atomic<int64_t> buffered_at_wakeup(0);
+    std::thread producer([&] {
+        int status = sample_ring_wait_writable(ring, sample_ring_record_size(100), 5000);
+        buffered_at_wakeup.store(sample_ring_buffered_us(ring));
+        result.store(status);
+    });
+    CHECK(wait_for_waiting(ring));
+
+    int early_wakeups = 0;
+    while (result.load() < 0 && ring->count.load() > 0) {
+        sample_ring_pop(ring);
+        sleep_ms(1);
+        early_wakeups += result.load() >= 0 && sample_ring_buffered_us(ring) > 1000000;
+    }
+    producer.join();
+
+    CHECK_EQ(SAMPLE_RING_WAIT_READY, result.load());
+    CHECK(buffered_at_wakeup.load() <= 1000000);
+    CHECK_EQ(0, early_wakeups);
+    CHECK(sample_ring_above_high_watermark(ring) == false);
+    CHECK(ring->wakeups.load() <= 2);
+    sample_ring_destroy(ring);
+}
+
+/**
+ * 생산자가 링이 가득 찰 때마다 기다리는 스트리밍에서, 깨어난 횟수가 대기 중에 꺼낸 샘플 수
+ * (샘플마다 깨우는 방식의 깨우기 횟수)보다 훨씬 적은지 확인
+ */
+static void test_wakeups_reduced() {
+    SampleRing* ring = sample_ring_create(64 * 1024, nullptr);
+    sample_ring_set_watermarks(ring, 32 * 1024, 0, 0);
+    const int count = 20000;
+    int timeouts = 0;
+    std::thread producer([&] {
+        std::vector<uint8_t> payload;
+        for (int i = 0; i < count; i++) {
+            int size = 100 + (i * 37) % 900;
+            while (!write_one(ring, i, size, 1000, &payload)) {
+                int status = sample_ring_wait_writable(ring, sample_ring_record_size(size), 1000);
+                timeouts += status == SAMPLE_RING_WAIT_TIMEOUT;
+            }
+        }
+    });
+
+    int bad = 0;
+    int64_t pops_while_waiting = 0;
+    for (int i = 0; i < count;) {
+        const SampleRingRecord* record = sample_ring_peek(ring);
+        if (!record) {
+            std::this_thread::yield();
+            continue;
+        }
+        bad += record->flags != i || !payload_matches(record, i);
+        pops_while_waiting += ring->waiting.load();
+        sample_ring_pop(ring);
+        i++;
+        if (i % 200 == 0) {
+            sleep_ms(1);
+        }
+    }
+    producer.join();
+
+    int64_t waits = ring->waits.load();
+    int64_t wakeups = ring->wakeups.load();
+    printf("waits=%lld wakeups=%lld pops while waiting=%lld\n", (long long)waits,
+           (long long)wakeups, (long long)pops_while_waiting);
+    CHECK_EQ(0, bad);
+    CHECK_EQ(0, timeouts);
+    CHECK(waits > 0);
+    // 대기 한 번에 (스퓨리어스 웨이크업을 빼면) 한 번만 깨어난다
+    CHECK(wakeups <= waits + waits / 10 + 1);
+    CHECK(wakeups * 10 < pops_while_waiting);
+    sample_ring_destroy(ring);
+}
+
+/**
+ * interrupt는 다음 대기 한 번만, close는 이후 모든 대기를 바로 반환시키는지 확인
+ */
+static void test_interrupt_and_close() {
+    SampleRing* ring = sample_ring_create(4096, nullptr);
+    std::vector<uint8_t> payload;
+    while (write_one(ring, 0, 500, 1000, &payload)) {
+    }
+    sample_ring_interrupt(ring);
+    CHECK_EQ(SAMPLE_RING_WAIT_INTERRUPTED, sample_ring_wait_writable(ring, 4096, 1000));
+    CHECK_EQ(SAMPLE_RING_WAIT_TIMEOUT, sample_ring_wait_writable(ring, 4096, 10));
+    sample_ring_close(ring);
+    CHECK_EQ(SAMPLE_RING_WAIT_CLOSED, sample_ring_wait_writable(ring, 4096, 1000));
+    CHECK_EQ(SAMPLE_RING_WAIT_CLOSED, sample_ring_wait_writable(ring, 4096, 1000));
+    sample_ring_destroy(ring);
+}
+
+int main() {
+    RUN_TEST(test_wrap_around_odd_sizes);
+    RUN_TEST(test_concurrent_odd_sizes);
+    RUN_TEST(test_batch_all_or_nothing);
+    RUN_TEST(test_batch_split_across_commits);
+    RUN_TEST(test_byte_watermark_wakeup);
+    RUN_TEST(test_duration_watermark_wakeup);
+    RUN_TEST(test_wakeups_reduced);
+    RUN_TEST(test_interrupt_and_close);
+    return test_exit_code();
+}
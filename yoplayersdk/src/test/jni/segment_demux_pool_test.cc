@@ -0,0 +1,284 @@
+/*
+ * 병렬 디먹스 풀 테스트
+ *
+ * 워커 1/2/4/8개로 64개 세그먼트(일부 AES-128)를 동시에 제출/파싱/꺼내면서 결과가 제출 순서대로,
+ * 순차 디먹싱과 같은 내용으로 나오는지 확인한다. 취소/재설정 경로도 함께 실행한다.
+ * 스레드 경합 검증은 ThreadSanitizer 빌드로 실행한다:
+ *
+ *   cmake -S yoplayersdk/src/test/jni -B build/native-tsan -DYOPLAYER_TSAN=ON
+ *   cmake --build build/native-tsan -j --target segment_demux_pool_test
+ *   ctest --test-dir build/native-tsan -R segment_demux_pool_test --output-on-failure
+ */
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <libavutil/aes.h>
+#include <libavutil/mem.h>
+}
+
+#include "segment_demux_pool.h"
+#include "test_util.h"
+#include "ts_demuxer.h"
+#include "ts_fixture.h"
+
+static const int SEGMENT_COUNT = 64;
+static const int WORKER_COUNTS[] = {1, 2, 4, 8};
+
+struct SegmentDigest {
+    int units;
+    uint32_t checksum;      // 모든 유닛의 PID, 타임스탬프, 페이로드
+};
+
+struct TestSegment {
+    std::vector<uint8_t> data;      // 제출할 바이트 (AES-128이면 암호문)
+    SegmentDemuxParams params;
+    SegmentDigest expected;
+};
+
+static uint32_t mix(uint32_t hash, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;   // FNV-1a
+    }
+    return hash;
+}
+
+static uint32_t mix_unit(uint32_t hash, int pid, int64_t pts, int64_t dts, const uint8_t* data,
+                         int size) {
+    hash = mix(hash, (const uint8_t*)&pid, sizeof(pid));
+    hash = mix(hash, (const uint8_t*)&pts, sizeof(pts));
+    hash = mix(hash, (const uint8_t*)&dts, sizeof(dts));
+    return mix(hash, data, (size_t)size);
+}
+
+static bool digest_unit(void* opaque, const TsAccessUnit* unit) {
+    SegmentDigest* digest = (SegmentDigest*)opaque;
+    digest->units++;
+    digest->checksum =
+        mix_unit(digest->checksum, unit->pid, unit->pts, unit->dts, unit->data, unit->size);
+    return true;
+}
+
+static SegmentDigest digest_job(const SegmentDemuxJob* job) {
+    SegmentDigest digest = {0, 2166136261u};
+    for (size_t i = 0; i < job->units.size(); i++) {
+        const SegmentDemuxUnit& unit = job->units[i];
+        digest.units++;
+        digest.checksum = mix_unit(digest.checksum, unit.pid, unit.pts, unit.dts,
+                                   job->payload.data() + unit.offset, unit.size);
+    }
+    return digest;
+}
+
+/**
+ * AES-128 CBC + PKCS#7 패딩으로 암호화 (HLS METHOD=AES-128)
+ */
+static std::vector<uint8_t> encrypt_aes_128(const std::vector<uint8_t>& plain,
+                                            const uint8_t* key, const uint8_t* iv) {
+    size_t padding = AES_BLOCK_SIZE - plain.size() % AES_BLOCK_SIZE;
+    std::vector<uint8_t> padded(plain);
+    padded.insert(padded.end(), padding, (uint8_t)padding);
+    std::vector<uint8_t> cipher(padded.size());
+    uint8_t chain[AES_BLOCK_SIZE];
+    memcpy(chain, iv, AES_BLOCK_SIZE);
+    struct AVAES* aes = av_aes_alloc();
+    av_aes_init(aes, key, 128, 0);
+    av_aes_crypt(aes, cipher.data(), padded.data(), (int)(padded.size() / AES_BLOCK_SIZE), chain,
+                 0);
+    av_free(aes);
+    return cipher;
+}
+
+/**
+ * 방송처럼 PTS와 continuity_counter가 이어지는 세그먼트 (4번째마다 AES-128)
+ */
+static std::vector<TestSegment> build_segments() {
+    TsSegmentSpec spec = fixture_hls_segment_spec();
+    spec.video_frames = 30;
+    spec.key_frame_bytes = 6000;
+    spec.frame_bytes = 1500;
+    spec.gop = 30;
+    spec.audio_tracks = 2;
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 21);
+    std::vector<TestSegment> segments(SEGMENT_COUNT);
+    for (int i = 0; i < SEGMENT_COUNT; i++) {
+        fixture.data.clear();
+        spec.start_pts = 126000 + (int64_t)i * spec.video_frames * spec.frame_duration;
+        ts_fixture_write_segment(&fixture, &spec);
+
+        TestSegment& segment = segments[i];
+        memset(&segment.params, 0, sizeof(segment.params));
+        segment.expected.units = 0;
+        segment.expected.checksum = 2166136261u;
+        TsDemuxer demuxer;
+        ts_demuxer_reset(&demuxer);
+        ts_demuxer_select_pids(&demuxer, nullptr, 0);
+        size_t consumed = 0;
+        ts_demuxer_feed(&demuxer, fixture.data.data(), fixture.data.size(), digest_unit,
+                        &segment.expected, &consumed);
+        ts_demuxer_flush(&demuxer, digest_unit, &segment.expected);
+
+        if (i % 4 == 3) {
+            segment.params.encryption = SEGMENT_ENCRYPTION_AES_128;
+            for (int k = 0; k < AES_BLOCK_SIZE; k++) {
+                segment.params.key[k] = (uint8_t)(i * 7 + k);
+                segment.params.iv[k] = (uint8_t)(i + k * 3);
+            }
+            segment.data = encrypt_aes_128(fixture.data, segment.params.key, segment.params.iv);
+        } else {
+            segment.data = fixture.data;
+        }
+    }
+    return segments;
+}
+
+// 모든 테스트가 같이 쓰는 세그먼트 (처음 한 번만 생성)
+static const std::vector<TestSegment>& test_segments() {
+    static std::vector<TestSegment> segments = build_segments();
+    return segments;
+}
+
+// 꺼내지 않은 작업의 바이트 (워커가 아직 돌 수 있으므로 lock 안에서 읽음)
+static int64_t pending_bytes(SegmentDemuxPool* pool) {
+    std::lock_guard<std::mutex> guard(pool->lock);
+    return pool->pending_bytes;
+}
+
+/**
+ * 제출 스레드와 꺼내는 스레드가 동시에 돌 때 워커 수와 관계없이 제출 순서대로 같은 결과가 나오는지 확인
+ */
+static void test_parallel_output_in_order() {
+    const std::vector<TestSegment>& segments = test_segments();
+    for (size_t w = 0; w < sizeof(WORKER_COUNTS) / sizeof(WORKER_COUNTS[0]); w++) {
+        MemoryBudget* budget = memory_budget_create(64 * 1024 * 1024, 0);
+        // 세그먼트 몇 개만 쌓이도록 한도를 작게 두어 제출 대기도 함께 실행
+        SegmentDemuxPool* pool =
+            segment_demux_pool_create(WORKER_COUNTS[w], 4 * segments[0].data.size(), budget);
+        CHECK_EQ(WORKER_COUNTS[w], segment_demux_pool_worker_count(pool));
+
+        int submit_failures = 0;
+        std::thread producer([&] {
+            for (int i = 0; i < SEGMENT_COUNT; i++) {
+                submit_failures += segment_demux_pool_submit(pool, segments[i].data.data(),
+                                                             segments[i].data.size(),
+                                                             &segments[i].params) != i;
+            }
+        });
+
+        int out_of_order = 0;
+        int mismatches = 0;
+        for (int i = 0; i < SEGMENT_COUNT; i++) {
+            SegmentDemuxJob* job = segment_demux_pool_take(pool);
+            if (!job) {
+                out_of_order++;
+                break;
+            }
+            out_of_order += job->sequence != i;
+            SegmentDigest digest = digest_job(job);
+            mismatches += job->status != SEGMENT_DEMUX_DONE || job->invalid_padding ||
+                          digest.units != segments[i].expected.units ||
+                          digest.checksum != segments[i].expected.checksum;
+            segment_demux_pool_recycle(pool, job);
+        }
+        producer.join();
+
+        CHECK_EQ(0, submit_failures);
+        CHECK_EQ(0, out_of_order);
+        CHECK_EQ(0, mismatches);
+        CHECK_EQ(0, segment_demux_pool_pending(pool));
+        // destroy는 예산을 0으로 지우므로 그 전에 AES-128 패딩까지 모두 돌려받았는지 확인
+        CHECK_EQ(0, pending_bytes(pool));
+        CHECK_EQ(0, memory_budget_used(budget, MEMORY_BUDGET_POOL));
+        segment_demux_pool_destroy(pool);
+        memory_budget_destroy(budget);
+    }
+}
+
+/**
+ * 제출이 한도에 막혀 있는 동안 취소하면 제출과 꺼내기가 반환하고,
+ * 재설정 뒤에는 파싱 중이던 작업을 버리고 새 제출부터 다시 순서대로 나오는지 확인 (seek)
+ */
+static void test_cancel_and_reset() {
+    const std::vector<TestSegment>& segments = test_segments();
+    for (size_t w = 0; w < sizeof(WORKER_COUNTS) / sizeof(WORKER_COUNTS[0]); w++) {
+        MemoryBudget* budget = memory_budget_create(64 * 1024 * 1024, 0);
+        SegmentDemuxPool* pool =
+            segment_demux_pool_create(WORKER_COUNTS[w], 2 * segments[0].data.size(), budget);
+
+        int64_t last_sequence = 0;
+        std::thread producer([&] {
+            for (int i = 0; i < SEGMENT_COUNT; i++) {
+                last_sequence = segment_demux_pool_submit(pool, segments[i].data.data(),
+                                                          segments[i].data.size(),
+                                                          &segments[i].params);
+                if (last_sequence < 0) {
+                    break;
+                }
+            }
+        });
+        SegmentDemuxJob* job = segment_demux_pool_take(pool);
+        CHECK(job != nullptr);
+        if (job) {
+            CHECK_EQ(0, job->sequence);
+            segment_demux_pool_recycle(pool, job);
+        }
+        segment_demux_pool_cancel(pool);
+        producer.join();
+        CHECK_EQ(-1, last_sequence);
+        CHECK(segment_demux_pool_take(pool) == nullptr);
+
+        segment_demux_pool_reset(pool);
+        CHECK_EQ(0, segment_demux_pool_pending(pool));
+        // 한도가 세그먼트 두 개 정도이므로 하나씩 제출하고 꺼냄
+        for (int i = 0; i < 3; i++) {
+            CHECK(segment_demux_pool_submit(pool, segments[i].data.data(), segments[i].data.size(),
+                                            &segments[i].params) >= 0);
+            job = segment_demux_pool_take(pool);
+            CHECK(job != nullptr);
+            if (!job) {
+                break;
+            }
+            SegmentDigest digest = digest_job(job);
+            CHECK_EQ(SEGMENT_DEMUX_DONE, job->status);
+            CHECK_EQ(segments[i].expected.units, digest.units);
+            CHECK_EQ(segments[i].expected.checksum, digest.checksum);
+            segment_demux_pool_recycle(pool, job);
+        }
+        CHECK_EQ(0, pending_bytes(pool));
+        CHECK_EQ(0, memory_budget_used(budget, MEMORY_BUDGET_POOL));
+        segment_demux_pool_destroy(pool);
+        memory_budget_destroy(budget);
+    }
+}
+
+/**
+ * SAMPLE-AES 세그먼트는 파싱하지 않고 입력을 그대로 남겨 순차 경로로 넘기는지 확인
+ */
+static void test_sample_aes_unsupported() {
+    const std::vector<TestSegment>& segments = test_segments();
+    SegmentDemuxPool* pool = segment_demux_pool_create(2, 64 * 1024 * 1024, nullptr);
+    SegmentDemuxParams params;
+    memset(&params, 0, sizeof(params));
+    params.encryption = SEGMENT_ENCRYPTION_SAMPLE_AES;
+    const std::vector<uint8_t>& data = segments[0].data;
+    CHECK_EQ(0, segment_demux_pool_submit(pool, data.data(), data.size(), &params));
+    SegmentDemuxJob* job = segment_demux_pool_take(pool);
+    CHECK(job != nullptr);
+    if (job) {
+        CHECK_EQ(SEGMENT_DEMUX_UNSUPPORTED, job->status);
+        CHECK_EQ(data.size(), job->input_size);
+        CHECK(memcmp(job->input.data(), data.data(), data.size()) == 0);
+        segment_demux_pool_recycle(pool, job);
+    }
+    segment_demux_pool_destroy(pool);
+}
+
+int main() {
+    RUN_TEST(test_parallel_output_in_order);
+    RUN_TEST(test_cancel_and_reset);
+    RUN_TEST(test_sample_aes_unsupported);
+    return test_exit_code();
+}
@@ -0,0 +1,50 @@
+/*
+ * 호스트 테스트용 최소 검사 매크로
+ *
+ * 실패한 검사는 위치와 식을 출력하고 테스트를 실패로 표시한 뒤 계속 진행한다.
+ * main에서 RUN_TEST로 테스트 함수를 실행하고 test_exit_code()를 반환한다.
+ */
+#ifndef YOPLAYER_TEST_UTIL_H
+#define YOPLAYER_TEST_UTIL_H
+
+#include <stdio.h>
+
+static int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__,   \
+                    #cond);                                                     \
+            test_failures()++;                                                  \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_EQ(expected, actual)                                              \
+    do {                                                                        \
+        long long check_expected = (long long)(expected);                       \
+        long long check_actual = (long long)(actual);                           \
+        if (check_expected != check_actual) {                                   \
+            fprintf(stderr, "%s:%d: CHECK_EQ failed: %s == %s (%lld != %lld)\n", \
+                    __FILE__, __LINE__, #expected, #actual, check_expected,     \
+                    check_actual);                                              \
+            test_failures()++;                                                  \
+        }                                                                       \
+    } while (0)
+
+#define RUN_TEST(test)                                                          \
+    do {                                                                        \
+        int failures_before = test_failures();                                  \
+        test();                                                                 \
+        printf("[%s] %s\n", test_failures() == failures_before ? "  OK  " : " FAIL ", \
+               #test);                                                          \
+    } while (0)
+
+static int test_exit_code() {
+    return test_failures() == 0 ? 0 : 1;
+}
+
+#endif  // YOPLAYER_TEST_UTIL_H
@@ -0,0 +1,166 @@
+/*
+ * 타임스탬프 정규화 테스트 (33비트 PTS 순환)
+ */
+#include <vector>
+
+#include "test_util.h"
+#include "timestamp_normalizer.h"
+#include "ts_demuxer.h"
+#include "ts_fixture.h"
+
+static const int64_t PTS_WRAP = (int64_t)1 << 33;
+static const int VIDEO_TRACK = 0x100;
+static const int AUDIO_TRACK = 0x101;
+
+static int64_t ticks_to_us(int64_t ticks) {
+    return ticks * 1000000 / 90000;
+}
+
+/**
+ * 순환 2초 전부터 4초 동안의 비디오 PTS가 끊김 없이 이어지는지 확인
+ */
+static void test_video_crosses_wrap() {
+    TimestampNormalizer normalizer;
+    timestamp_normalizer_reset(&normalizer);
+    int64_t start = PTS_WRAP - 2 * 90000;
+    int mismatches = 0;
+    for (int i = 0; i < 240; i++) {
+        int64_t pts = (start + i * 1500) % PTS_WRAP;
+        int64_t time_us = timestamp_normalize(&normalizer, VIDEO_TRACK, pts, 1500, false);
+        mismatches += time_us != ticks_to_us(i * 1500);
+    }
+    CHECK_EQ(0, mismatches);
+    CHECK_EQ(0, normalizer.discontinuity_count);
+}
+
+/**
+ * 33비트 범위를 넘는 입력은 하위 33비트만 사용
+ */
+static void test_input_above_33_bits_is_masked() {
+    TimestampNormalizer normalizer;
+    timestamp_normalizer_reset(&normalizer);
+    CHECK_EQ(0, timestamp_normalize(&normalizer, VIDEO_TRACK, PTS_WRAP + 1000, 0, false));
+    CHECK_EQ(ticks_to_us(3000),
+             timestamp_normalize(&normalizer, VIDEO_TRACK, 3 * PTS_WRAP + 4000, 0, false));
+}
+
+/**
+ * 오디오(단조 보정 트랙)가 순환을 넘어도 보정 없이 PTS 그대로 이어지는지 확인
+ */
+static void test_audio_crosses_wrap() {
+    TimestampNormalizer normalizer;
+    timestamp_normalizer_reset(&normalizer);
+    int64_t start = PTS_WRAP - 10 * 1920;
+    int64_t last_us = TIMESTAMP_UNSET_US;
+    int mismatches = 0;
+    for (int i = 0; i < 20; i++) {
+        int64_t pts = (start + i * 1920) % PTS_WRAP;
+        int64_t time_us = timestamp_normalize(&normalizer, AUDIO_TRACK, pts, 1920, true);
+        mismatches += time_us != ticks_to_us(i * 1920);
+        CHECK(last_us == TIMESTAMP_UNSET_US || time_us > last_us);
+        last_us = time_us;
+    }
+    CHECK_EQ(0, mismatches);
+}
+
+/**
+ * PTS는 순환 뒤, DTS는 순환 앞인 샘플의 디코딩 시각과 DTS 간격 길이
+ */
+static void test_decode_time_and_duration_across_wrap() {
+    TimestampNormalizer normalizer;
+    timestamp_normalizer_reset(&normalizer);
+    int64_t dts = PTS_WRAP - 1500;
+    int64_t pts = 1500;    // DTS + 3000 (순환 후)
+    CHECK_EQ(0, timestamp_estimate_duration(&normalizer, VIDEO_TRACK, dts - 1500));
+    CHECK_EQ(1500, timestamp_estimate_duration(&normalizer, VIDEO_TRACK, dts));
+    int64_t time_us = timestamp_normalize(&normalizer, VIDEO_TRACK, pts, 1500, false);
+    CHECK_EQ(ticks_to_us(3000), time_us - timestamp_decode_time(time_us, pts, dts));
+    // 다음 DTS는 순환 뒤의 0
+    CHECK_EQ(1500, timestamp_estimate_duration(&normalizer, VIDEO_TRACK, 0));
+}
+
+/**
+ * 순환 직후의 큰 점프는 순환이 아니라 불연속으로 처리되어 지금까지의 출력에 이어지는지 확인
+ */
+static void test_jump_after_wrap_is_discontinuity() {
+    TimestampNormalizer normalizer;
+    timestamp_normalizer_reset(&normalizer);
+    timestamp_normalize(&normalizer, VIDEO_TRACK, PTS_WRAP - 3000, 0, false);
+    timestamp_normalize(&normalizer, VIDEO_TRACK, 0, 0, false);
+    int64_t last_us = timestamp_normalize(&normalizer, VIDEO_TRACK, 3000, 0, false);
+    CHECK_EQ(ticks_to_us(6000), last_us);
+    CHECK_EQ(0, normalizer.discontinuity_count);
+
+    int64_t jumped_us = timestamp_normalize(&normalizer, VIDEO_TRACK, 40 * 90000, 0, false);
+    CHECK_EQ(1, normalizer.discontinuity_count);
+    CHECK_EQ(last_us, jumped_us);
+}
+
+struct NormalizedUnits {
+    TimestampNormalizer* normalizer;
+    std::vector<int64_t> video_decode_us;
+    std::vector<int64_t> audio_us;
+};
+
+static bool normalize_unit(void* opaque, const TsAccessUnit* unit) {
+    NormalizedUnits* out = (NormalizedUnits*)opaque;
+    bool audio = unit->codec == TS_CODEC_AAC;
+    int64_t time_us = timestamp_normalize(out->normalizer, unit->pid, unit->pts, unit->duration,
+                                          audio);
+    if (audio) {
+        out->audio_us.push_back(time_us);
+    } else {
+        out->video_decode_us.push_back(timestamp_decode_time(time_us, unit->pts, unit->dts));
+    }
+    return true;
+}
+
+/**
+ * 순환을 가로지르는 TS 세그먼트를 디먹싱해 정규화하면 비디오 DTS와 오디오 PTS가 단조 증가하는지 확인
+ */
+static void test_segment_across_wrap() {
+    TsSegmentSpec spec = fixture_hls_segment_spec();
+    spec.key_frame_bytes = 4000;
+    spec.frame_bytes = 1000;
+    spec.start_pts = PTS_WRAP - 90000;    // 2초 세그먼트의 1초 지점에서 순환
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 7);
+    ts_fixture_write_segment(&fixture, &spec);
+
+    TimestampNormalizer normalizer;
+    timestamp_normalizer_reset(&normalizer);
+    NormalizedUnits units;
+    units.normalizer = &normalizer;
+    TsDemuxer demuxer;
+    ts_demuxer_reset(&demuxer);
+    ts_demuxer_select_pids(&demuxer, nullptr, 0);
+    size_t consumed = 0;
+    ts_demuxer_feed(&demuxer, fixture.data.data(), fixture.data.size(), normalize_unit, &units,
+                    &consumed);
+    ts_demuxer_flush(&demuxer, normalize_unit, &units);
+
+    CHECK_EQ(spec.video_frames, units.video_decode_us.size());
+    CHECK(!units.audio_us.empty());
+    int video_steps = 0;
+    for (size_t i = 1; i < units.video_decode_us.size(); i++) {
+        int64_t step = units.video_decode_us[i] - units.video_decode_us[i - 1];
+        video_steps += step >= 16666 && step <= 16667;
+    }
+    CHECK_EQ(spec.video_frames - 1, video_steps);
+    int audio_regressions = 0;
+    for (size_t i = 1; i < units.audio_us.size(); i++) {
+        audio_regressions += units.audio_us[i] <= units.audio_us[i - 1];
+    }
+    CHECK_EQ(0, audio_regressions);
+    CHECK_EQ(0, normalizer.discontinuity_count);
+}
+
+int main() {
+    RUN_TEST(test_video_crosses_wrap);
+    RUN_TEST(test_input_above_33_bits_is_masked);
+    RUN_TEST(test_audio_crosses_wrap);
+    RUN_TEST(test_decode_time_and_duration_across_wrap);
+    RUN_TEST(test_jump_after_wrap_is_discontinuity);
+    RUN_TEST(test_segment_across_wrap);
+    return test_exit_code();
+}
@@ -0,0 +1,198 @@
+/*
+ * 경량 TS 디먹서와 libavformat(av_read_frame) 출력 비교 테스트
+ *
+ * 같은 합성 세그먼트를 두 경로로 디먹싱하여 PID별 액세스 유닛의 바이트와 타임스탬프가 같은지 확인한다.
+ * libavformat은 AAC 패킷에 ADTS 헤더를 남기므로 세션 경로(emit_adts_packet)처럼 헤더를 떼고 비교한다.
+ * 시스템 FFmpeg이 있을 때만 빌드된다.
+ */
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+#include "adts_parser.h"
+#include "test_util.h"
+#include "ts_demuxer.h"
+#include "ts_fixture.h"
+
+static const int AVIO_BUFFER_SIZE = 32768;
+
+struct Unit {
+    int pid;
+    std::vector<uint8_t> data;
+    int64_t pts;   // 없으면 TS_NO_TIMESTAMP
+    int64_t dts;
+};
+
+struct MemoryInput {
+    const std::vector<uint8_t>* data;
+    size_t pos;
+};
+
+static int read_memory(void* opaque, uint8_t* buf, int buf_size) {
+    MemoryInput* in = (MemoryInput*)opaque;
+    size_t remaining = in->data->size() - in->pos;
+    if (remaining == 0) {
+        return AVERROR_EOF;
+    }
+    size_t size = remaining < (size_t)buf_size ? remaining : (size_t)buf_size;
+    memcpy(buf, in->data->data() + in->pos, size);
+    in->pos += size;
+    return (int)size;
+}
+
+static bool collect_unit(void* opaque, const TsAccessUnit* unit) {
+    std::vector<Unit>* units = (std::vector<Unit>*)opaque;
+    Unit collected;
+    collected.pid = unit->pid;
+    collected.data.assign(unit->data, unit->data + unit->size);
+    collected.pts = unit->pts;
+    collected.dts = unit->dts;
+    units->push_back(collected);
+    return true;
+}
+
+static void demux_fast_path(const std::vector<uint8_t>& data, std::vector<Unit>* units) {
+    TsDemuxer demuxer;
+    ts_demuxer_reset(&demuxer);
+    ts_demuxer_select_pids(&demuxer, nullptr, 0);
+    size_t consumed = 0;
+    CHECK_EQ(TS_FEED_OK, ts_demuxer_feed(&demuxer, data.data(), data.size(), collect_unit, units,
+                                         &consumed));
+    ts_demuxer_flush(&demuxer, collect_unit, units);
+}
+
+/**
+ * libavformat으로 디먹싱 (AAC는 ADTS 헤더를 뗀 raw 프레임)
+ */
+static bool demux_libavformat(const std::vector<uint8_t>& data, std::vector<Unit>* units) {
+    MemoryInput in = {&data, 0};
+    uint8_t* buffer = (uint8_t*)av_malloc(AVIO_BUFFER_SIZE);
+    AVIOContext* avio = avio_alloc_context(buffer, AVIO_BUFFER_SIZE, 0, &in, read_memory,
+                                           nullptr, nullptr);
+    AVFormatContext* fmt_ctx = avformat_alloc_context();
+    fmt_ctx->pb = avio;
+    fmt_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
+    if (avformat_open_input(&fmt_ctx, nullptr, nullptr, nullptr) < 0) {
+        av_freep(&avio->buffer);
+        avio_context_free(&avio);
+        return false;
+    }
+
+    AVPacket* pkt = av_packet_alloc();
+    bool ok = true;
+    while (ok && av_read_frame(fmt_ctx, pkt) >= 0) {
+        AVStream* stream = fmt_ctx->streams[pkt->stream_index];
+        Unit unit;
+        unit.pid = stream->id;
+        unit.pts = pkt->pts != AV_NOPTS_VALUE ? pkt->pts : TS_NO_TIMESTAMP;
+        unit.dts = pkt->dts != AV_NOPTS_VALUE ? pkt->dts : TS_NO_TIMESTAMP;
+        const uint8_t* payload = pkt->data;
+        int size = pkt->size;
+        if (stream->codecpar->codec_id == AV_CODEC_ID_AAC) {
+            AdtsHeader header;
+            ok = parse_adts_header(payload, (size_t)size, &header) && header.frame_size == size;
+            payload += header.header_size;
+            size -= header.header_size;
+        }
+        if (ok) {
+            unit.data.assign(payload, payload + size);
+            units->push_back(unit);
+        }
+        av_packet_unref(pkt);
+    }
+    av_packet_free(&pkt);
+    avformat_close_input(&fmt_ctx);
+    av_freep(&avio->buffer);
+    avio_context_free(&avio);
+    return ok;
+}
+
+/**
+ * PID별로 순서대로 비교 (바이트는 항상, 타임스탬프는 libavformat이 값을 준 경우)
+ */
+static void compare_units(const std::vector<Unit>& expected, const std::vector<Unit>& actual) {
+    CHECK_EQ(expected.size(), actual.size());
+    std::vector<int> pids;
+    for (size_t i = 0; i < expected.size(); i++) {
+        bool known = false;
+        for (size_t j = 0; j < pids.size(); j++) {
+            known = known || pids[j] == expected[i].pid;
+        }
+        if (!known) {
+            pids.push_back(expected[i].pid);
+        }
+    }
+
+    for (size_t p = 0; p < pids.size(); p++) {
+        std::vector<const Unit*> lhs;
+        std::vector<const Unit*> rhs;
+        for (size_t i = 0; i < expected.size(); i++) {
+            if (expected[i].pid == pids[p]) {
+                lhs.push_back(&expected[i]);
+            }
+        }
+        for (size_t i = 0; i < actual.size(); i++) {
+            if (actual[i].pid == pids[p]) {
+                rhs.push_back(&actual[i]);
+            }
+        }
+        CHECK_EQ(lhs.size(), rhs.size());
+        int data_mismatches = 0;
+        int timestamp_mismatches = 0;
+        for (size_t i = 0; i < lhs.size() && i < rhs.size(); i++) {
+            data_mismatches += lhs[i]->data != rhs[i]->data;
+            timestamp_mismatches +=
+                    (lhs[i]->pts != TS_NO_TIMESTAMP && lhs[i]->pts != rhs[i]->pts) ||
+                    (lhs[i]->dts != TS_NO_TIMESTAMP && lhs[i]->dts != rhs[i]->dts);
+        }
+        CHECK_EQ(0, data_mismatches);
+        CHECK_EQ(0, timestamp_mismatches);
+    }
+}
+
+/**
+ * 일반적인 HLS 세그먼트 (H.264 + AAC 2트랙, PES마다 ADTS 프레임 5개)
+ */
+static void test_segment_matches_libavformat() {
+    TsSegmentSpec spec = fixture_hls_segment_spec();
+    spec.key_frame_bytes = 30000;
+    spec.frame_bytes = 5000;
+    spec.audio_tracks = 2;
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 11);
+    ts_fixture_write_segment(&fixture, &spec);
+
+    std::vector<Unit> expected;
+    CHECK(demux_libavformat(fixture.data, &expected));
+    std::vector<Unit> actual;
+    demux_fast_path(fixture.data, &actual);
+    compare_units(expected, actual);
+}
+
+/**
+ * 크기가 제각각이고 PES 경계에 걸친 ADTS 프레임 (일부 CRC 포함)
+ */
+static void test_adts_stream_matches_libavformat() {
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 12);
+    std::vector<std::vector<uint8_t> > frames;
+    ts_fixture_write_adts_stream(&fixture, 800, &frames);
+
+    std::vector<Unit> expected;
+    CHECK(demux_libavformat(fixture.data, &expected));
+    CHECK_EQ(frames.size(), expected.size());
+    std::vector<Unit> actual;
+    demux_fast_path(fixture.data, &actual);
+    compare_units(expected, actual);
+}
+
+int main() {
+    av_log_set_level(AV_LOG_QUIET);
+    RUN_TEST(test_segment_matches_libavformat);
+    RUN_TEST(test_adts_stream_matches_libavformat);
+    return test_exit_code();
+}
@@ -0,0 +1,287 @@
+/*
+ * 경량 TS 디먹서 테스트
+ */
+#include <string.h>
+
+#include <vector>
+
+#include "test_util.h"
+#include "ts_demuxer.h"
+#include "ts_fixture.h"
+
+struct CollectedUnit {
+    int pid;
+    int size;
+    int64_t pts;
+    int64_t dts;
+    int64_t duration;
+    bool key_frame;
+    uint32_t checksum;
+};
+
+static uint32_t checksum(const uint8_t* data, int size) {
+    uint32_t hash = 2166136261u;   // FNV-1a
+    for (int i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static bool collect_unit(void* opaque, const TsAccessUnit* unit) {
+    std::vector<CollectedUnit>* units = (std::vector<CollectedUnit>*)opaque;
+    CollectedUnit collected;
+    collected.pid = unit->pid;
+    collected.size = unit->size;
+    collected.pts = unit->pts;
+    collected.dts = unit->dts;
+    collected.duration = unit->duration;
+    collected.key_frame = unit->key_frame;
+    collected.checksum = checksum(unit->data, unit->size);
+    units->push_back(collected);
+    return true;
+}
+
+/**
+ * data를 chunk_seed로 정한 임의 크기(1 ~ 4096바이트)로 나누어 디먹싱 (0이면 한 번에)
+ */
+static int demux(TsDemuxer* demuxer, const std::vector<uint8_t>& data, uint32_t chunk_seed,
+                 std::vector<CollectedUnit>* units) {
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t chunk = data.size() - pos;
+        if (chunk_seed != 0) {
+            size_t limit = 1 + fixture_random(&chunk_seed) % 4096;
+            chunk = chunk < limit ? chunk : limit;
+        }
+        size_t consumed = 0;
+        int status = ts_demuxer_feed(demuxer, data.data() + pos, chunk, collect_unit, units,
+                                     &consumed);
+        if (status != TS_FEED_OK) {
+            return status;
+        }
+        pos += chunk;
+    }
+    ts_demuxer_flush(demuxer, collect_unit, units);
+    return TS_FEED_OK;
+}
+
+static int count_pid(const std::vector<CollectedUnit>& units, int pid) {
+    int count = 0;
+    for (size_t i = 0; i < units.size(); i++) {
+        if (units[i].pid == pid) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * 60fps 비디오와 AAC 2트랙의 긴 세그먼트(액세스 유닛 2만 개 이상)가 잘리지 않고 모두 나오는지 확인
+ */
+static void test_20000_access_units_not_truncated() {
+    TsSegmentSpec spec = fixture_hls_segment_spec();
+    spec.video_frames = 8000;
+    spec.key_frame_bytes = 1200;
+    spec.frame_bytes = 300;
+    spec.audio_tracks = 2;
+    spec.audio_frames_per_pes = 1;
+    spec.audio_frame_bytes = 200;
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 4);
+    int expected = ts_fixture_write_segment(&fixture, &spec);
+    CHECK(expected >= 20000);
+
+    TsDemuxer demuxer;
+    ts_demuxer_reset(&demuxer);
+    ts_demuxer_select_pids(&demuxer, nullptr, 0);
+    std::vector<CollectedUnit> units;
+    CHECK_EQ(TS_FEED_OK, demux(&demuxer, fixture.data, 0, &units));
+
+    CHECK_EQ(expected, units.size());
+    CHECK_EQ(spec.video_frames, count_pid(units, FIXTURE_VIDEO_PID));
+    int audio_frames = (expected - spec.video_frames) / spec.audio_tracks;
+    CHECK_EQ(audio_frames, count_pid(units, FIXTURE_AUDIO_PID));
+    CHECK_EQ(audio_frames, count_pid(units, FIXTURE_AUDIO_PID + 1));
+    CHECK_EQ(0, demuxer.continuity_errors);
+    CHECK_EQ(0, demuxer.sync_errors);
+
+    // 마지막 프레임까지 크기와 타임스탬프가 그대로여야 한다
+    int key_frames = 0;
+    int64_t last_video_dts = -1;
+    int bad_sizes = 0;
+    for (size_t i = 0; i < units.size(); i++) {
+        const CollectedUnit& unit = units[i];
+        if (unit.pid == FIXTURE_VIDEO_PID) {
+            key_frames += unit.key_frame ? 1 : 0;
+            bad_sizes += unit.size != (unit.key_frame ? spec.key_frame_bytes : spec.frame_bytes);
+            CHECK(unit.dts > last_video_dts);
+            last_video_dts = unit.dts;
+        } else {
+            bad_sizes += unit.size != spec.audio_frame_bytes;
+        }
+    }
+    CHECK_EQ(0, bad_sizes);
+    CHECK_EQ((spec.video_frames + spec.gop - 1) / spec.gop, key_frames);
+    CHECK_EQ(spec.start_pts + (int64_t)(spec.video_frames - 1) * spec.frame_duration,
+             last_video_dts);
+}
+
+/**
+ * 패킷 경계와 무관한 크기로 나누어 넣어도 한 번에 넣은 것과 같은 결과인지 확인
+ */
+static void test_chunked_feed_matches_whole() {
+    TsSegmentSpec spec = fixture_hls_segment_spec();
+    spec.key_frame_bytes = 20000;
+    spec.frame_bytes = 3000;
+    spec.audio_tracks = 2;
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 5);
+    ts_fixture_write_segment(&fixture, &spec);
+
+    TsDemuxer whole;
+    ts_demuxer_reset(&whole);
+    ts_demuxer_select_pids(&whole, nullptr, 0);
+    std::vector<CollectedUnit> expected;
+    demux(&whole, fixture.data, 0, &expected);
+
+    TsDemuxer chunked;
+    ts_demuxer_reset(&chunked);
+    ts_demuxer_select_pids(&chunked, nullptr, 0);
+    std::vector<CollectedUnit> actual;
+    CHECK_EQ(TS_FEED_OK, demux(&chunked, fixture.data, 77, &actual));
+
+    CHECK_EQ(expected.size(), actual.size());
+    int mismatches = 0;
+    for (size_t i = 0; i < expected.size() && i < actual.size(); i++) {
+        mismatches += expected[i].pid != actual[i].pid || expected[i].size != actual[i].size ||
+                      expected[i].pts != actual[i].pts || expected[i].dts != actual[i].dts ||
+                      expected[i].checksum != actual[i].checksum;
+    }
+    CHECK_EQ(0, mismatches);
+}
+
+/**
+ * 선택하지 않은 PID의 액세스 유닛은 나오지 않는지 확인
+ */
+static void test_pid_selection() {
+    TsSegmentSpec spec = fixture_hls_segment_spec();
+    spec.key_frame_bytes = 4000;
+    spec.frame_bytes = 1000;
+    spec.audio_tracks = 2;
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 6);
+    ts_fixture_write_segment(&fixture, &spec);
+
+    TsDemuxer demuxer;
+    ts_demuxer_reset(&demuxer);
+    const int pids[] = {FIXTURE_VIDEO_PID, FIXTURE_AUDIO_PID + 1};
+    ts_demuxer_select_pids(&demuxer, pids, 2);
+    std::vector<CollectedUnit> units;
+    CHECK_EQ(TS_FEED_OK, demux(&demuxer, fixture.data, 0, &units));
+
+    CHECK_EQ(spec.video_frames, count_pid(units, FIXTURE_VIDEO_PID));
+    CHECK_EQ(0, count_pid(units, FIXTURE_AUDIO_PID));
+    CHECK(count_pid(units, FIXTURE_AUDIO_PID + 1) > 0);
+}
+
+/**
+ * 이전 Kotlin 경로(stripAdtsHeader)의 결과: ADTS 헤더 7바이트(CRC가 있으면 9바이트)를 뗀 나머지
+ */
+static CollectedUnit reference_aac_unit(const std::vector<uint8_t>& frame, int64_t pts) {
+    int header_size = (frame[1] & 0x01) != 0 ? 7 : 9;
+    CollectedUnit unit;
+    unit.pid = FIXTURE_AUDIO_PID;
+    unit.size = (int)frame.size() - header_size;
+    unit.pts = pts;
+    unit.dts = pts;
+    unit.duration = 1920;
+    unit.key_frame = true;
+    unit.checksum = checksum(frame.data() + header_size, unit.size);
+    return unit;
+}
+
+/**
+ * PES에 여러 개 묶이거나 PES 경계에 걸친 단일 블록 ADTS 프레임이 이전 경로와 같은 바이트, 정확한
+ * 프레임별 타임스탬프로 나오는지 확인 (입력을 임의 크기로 나누어 넣어도 동일)
+ */
+static void test_adts_frames_match_reference() {
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 7);
+    std::vector<std::vector<uint8_t> > frames;
+    int64_t start_pts = ts_fixture_write_adts_stream(&fixture, 800, &frames);
+
+    std::vector<CollectedUnit> expected;
+    for (size_t i = 0; i < frames.size(); i++) {
+        expected.push_back(reference_aac_unit(frames[i], start_pts + (int64_t)i * 1920));
+    }
+
+    const uint32_t chunk_seeds[] = {0, 91};
+    for (size_t s = 0; s < sizeof(chunk_seeds) / sizeof(chunk_seeds[0]); s++) {
+        TsDemuxer demuxer;
+        ts_demuxer_reset(&demuxer);
+        ts_demuxer_select_pids(&demuxer, nullptr, 0);
+        std::vector<CollectedUnit> actual;
+        CHECK_EQ(TS_FEED_OK, demux(&demuxer, fixture.data, chunk_seeds[s], &actual));
+
+        CHECK_EQ(expected.size(), actual.size());
+        int mismatches = 0;
+        for (size_t i = 0; i < expected.size() && i < actual.size(); i++) {
+            mismatches += expected[i].pid != actual[i].pid || expected[i].size != actual[i].size ||
+                          expected[i].pts != actual[i].pts || expected[i].dts != actual[i].dts ||
+                          expected[i].duration != actual[i].duration ||
+                          expected[i].checksum != actual[i].checksum || !actual[i].key_frame;
+        }
+        CHECK_EQ(0, mismatches);
+    }
+}
+
+/**
+ * raw_data_block이 여러 개인 프레임은 CRC가 있으면 블록마다 액세스 유닛 하나로 나뉘고
+ * 블록 길이만큼 PTS가 증가하는지 확인 (CRC가 없으면 프레임 전체가 하나)
+ */
+static void test_adts_multi_block_frames_split() {
+    TsFixture fixture;
+    ts_fixture_init(&fixture, 8);
+    TsFixtureStream audio = {FIXTURE_AUDIO_PID, FIXTURE_STREAM_TYPE_AAC};
+    ts_fixture_write_pat(&fixture, FIXTURE_PMT_PID);
+    ts_fixture_write_pmt(&fixture, FIXTURE_PMT_PID, &audio, 1);
+
+    const int three_blocks[] = {100, 57, 300};
+    const int two_blocks[] = {80, 90};
+    const int crc_two_blocks[] = {33, 44};
+    const int one_block[] = {70};
+    std::vector<uint8_t> payload;
+    fixture_adts_frame(&fixture.seed, three_blocks, 3, 3, true, &payload);
+    fixture_adts_frame(&fixture.seed, two_blocks, 2, 3, false, &payload);
+    fixture_adts_frame(&fixture.seed, crc_two_blocks, 2, 3, true, &payload);
+    fixture_adts_frame(&fixture.seed, one_block, 1, 3, true, &payload);
+    const int64_t pts = 9000;
+    ts_fixture_write_pes(&fixture, FIXTURE_AUDIO_PID, 0xC0, pts, pts, payload.data(),
+                         payload.size(), true, false);
+
+    TsDemuxer demuxer;
+    ts_demuxer_reset(&demuxer);
+    ts_demuxer_select_pids(&demuxer, nullptr, 0);
+    std::vector<CollectedUnit> units;
+    CHECK_EQ(TS_FEED_OK, demux(&demuxer, fixture.data, 0, &units));
+
+    // 블록은 1024샘플(1920틱): 3블록 + CRC 없는 2블록(통째로) + 2블록 + 1블록
+    const int sizes[] = {100, 57, 300, 80 + 90, 33, 44, 70};
+    const int64_t offsets[] = {0, 1920, 3840, 5760, 9600, 11520, 13440};
+    const int64_t durations[] = {1920, 1920, 1920, 3840, 1920, 1920, 1920};
+    CHECK_EQ(7, units.size());
+    for (size_t i = 0; i < 7 && i < units.size(); i++) {
+        CHECK_EQ(sizes[i], units[i].size);
+        CHECK_EQ(pts + offsets[i], units[i].pts);
+        CHECK_EQ(durations[i], units[i].duration);
+    }
+}
+
+int main() {
+    RUN_TEST(test_20000_access_units_not_truncated);
+    RUN_TEST(test_chunked_feed_matches_whole);
+    RUN_TEST(test_pid_selection);
+    RUN_TEST(test_adts_frames_match_reference);
+    RUN_TEST(test_adts_multi_block_frames_split);
+    return test_exit_code();
+}
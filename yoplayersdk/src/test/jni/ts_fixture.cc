@@ -0,0 +1,366 @@
+/*
+ * 합성 HLS TS 세그먼트 생성기 구현
+ */
+#include "ts_fixture.h"
+
+#include <string.h>
+
+static const int PACKET_SIZE = 188;
+static const int64_t PTS_MASK = ((int64_t)1 << 33) - 1;
+static const int AAC_FRAME_SAMPLES = 1024;
+static const int kSampleRates[13] = {
+    96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350,
+};
+
+// 1920x1080 High@4.0 SPS / PPS (x264 기본 설정)
+static const uint8_t kSps[] = {
+    0x67, 0x64, 0x00, 0x28, 0xAC, 0xD9, 0x40, 0x78, 0x02, 0x27, 0xE5, 0xC0, 0x44, 0x00,
+    0x00, 0x03, 0x00, 0x04, 0x00, 0x00, 0x03, 0x00, 0xF0, 0x3C, 0x60, 0xC6, 0x58,
+};
+static const uint8_t kPps[] = {0x68, 0xEB, 0xE3, 0xCB, 0x22, 0xC0};
+static const uint8_t kAud[] = {0x09, 0xF0};
+
+uint32_t fixture_random(uint32_t* state) {
+    // xorshift32
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static uint32_t crc32_mpeg(const uint8_t* data, size_t size) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= (uint32_t)data[i] << 24;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+void ts_fixture_init(TsFixture* fixture, uint32_t seed) {
+    fixture->data.clear();
+    memset(fixture->continuity, 0, sizeof(fixture->continuity));
+    fixture->seed = seed != 0 ? seed : 1;
+}
+
+/**
+ * TS 패킷 하나 기록 (페이로드가 모자라면 adaptation field stuffing으로 채움)
+ * @param size 184 이하, random_access면 182 이하
+ */
+static void write_packet(TsFixture* fixture, int pid, bool unit_start, bool random_access,
+                         const uint8_t* payload, size_t size) {
+    uint8_t packet[PACKET_SIZE];
+    packet[0] = 0x47;
+    packet[1] = (uint8_t)((unit_start ? 0x40 : 0x00) | ((pid >> 8) & 0x1F));
+    packet[2] = (uint8_t)(pid & 0xFF);
+    uint8_t continuity = fixture->continuity[pid];
+    fixture->continuity[pid] = (uint8_t)((continuity + 1) & 0x0F);
+
+    size_t offset = 4;
+    if (random_access || size < 184) {
+        packet[3] = (uint8_t)(0x30 | continuity);
+        size_t adaptation_length = 183 - size;
+        packet[4] = (uint8_t)adaptation_length;
+        if (adaptation_length > 0) {
+            packet[5] = random_access ? 0x40 : 0x00;
+            memset(packet + 6, 0xFF, adaptation_length - 1);
+        }
+        offset = 5 + adaptation_length;
+    } else {
+        packet[3] = (uint8_t)(0x10 | continuity);
+    }
+    memcpy(packet + offset, payload, size);
+    fixture->data.insert(fixture->data.end(), packet, packet + PACKET_SIZE);
+}
+
+/**
+ * PSI 섹션(table_id부터 CRC 앞까지)에 section_length와 CRC를 채워 패킷 하나로 기록
+ */
+static void write_section(TsFixture* fixture, int pid, std::vector<uint8_t> section) {
+    size_t section_length = section.size() - 3 + 4;
+    section[1] = (uint8_t)(0xB0 | ((section_length >> 8) & 0x0F));
+    section[2] = (uint8_t)(section_length & 0xFF);
+    uint32_t crc = crc32_mpeg(section.data(), section.size());
+    section.push_back((uint8_t)(crc >> 24));
+    section.push_back((uint8_t)(crc >> 16));
+    section.push_back((uint8_t)(crc >> 8));
+    section.push_back((uint8_t)crc);
+    section.insert(section.begin(), 0x00);  // pointer_field
+    write_packet(fixture, pid, true, false, section.data(), section.size());
+}
+
+void ts_fixture_write_pat(TsFixture* fixture, int pmt_pid) {
+    std::vector<uint8_t> section;
+    const uint8_t header[] = {0x00, 0x00, 0x00, 0x00, 0x01, 0xC1, 0x00, 0x00};
+    section.assign(header, header + sizeof(header));
+    section.push_back(0x00);
+    section.push_back(0x01);  // program_number 1
+    section.push_back((uint8_t)(0xE0 | (pmt_pid >> 8)));
+    section.push_back((uint8_t)(pmt_pid & 0xFF));
+    write_section(fixture, 0x0000, section);
+}
+
+void ts_fixture_write_pmt(TsFixture* fixture, int pmt_pid, const TsFixtureStream* streams,
+                          size_t count) {
+    int pcr_pid = count > 0 ? streams[0].pid : 0x1FFF;
+    const uint8_t header[] = {0x02, 0x00, 0x00, 0x00, 0x01, 0xC1, 0x00, 0x00};
+    std::vector<uint8_t> section(header, header + sizeof(header));
+    section.push_back((uint8_t)(0xE0 | (pcr_pid >> 8)));
+    section.push_back((uint8_t)(pcr_pid & 0xFF));
+    section.push_back(0xF0);
+    section.push_back(0x00);  // program_info_length 0
+    for (size_t i = 0; i < count; i++) {
+        section.push_back((uint8_t)streams[i].stream_type);
+        section.push_back((uint8_t)(0xE0 | (streams[i].pid >> 8)));
+        section.push_back((uint8_t)(streams[i].pid & 0xFF));
+        section.push_back(0xF0);
+        section.push_back(0x00);  // ES_info_length 0
+    }
+    write_section(fixture, pmt_pid, section);
+}
+
+static void put_timestamp(std::vector<uint8_t>* out, int prefix, int64_t timestamp) {
+    timestamp &= PTS_MASK;
+    out->push_back((uint8_t)((prefix << 4) | (((timestamp >> 30) & 0x07) << 1) | 0x01));
+    out->push_back((uint8_t)(timestamp >> 22));
+    out->push_back((uint8_t)((((timestamp >> 15) & 0x7F) << 1) | 0x01));
+    out->push_back((uint8_t)(timestamp >> 7));
+    out->push_back((uint8_t)(((timestamp & 0x7F) << 1) | 0x01));
+}
+
+void ts_fixture_write_pes(TsFixture* fixture, int pid, int stream_id, int64_t pts, int64_t dts,
+                          const uint8_t* payload, size_t size, bool bounded, bool random_access) {
+    bool has_dts = dts != pts;
+    std::vector<uint8_t> pes;
+    pes.reserve(size + 19);
+    pes.push_back(0x00);
+    pes.push_back(0x00);
+    pes.push_back(0x01);
+    pes.push_back((uint8_t)stream_id);
+    size_t header_length = has_dts ? 10 : 5;
+    size_t pes_length = bounded ? 3 + header_length + size : 0;
+    if (pes_length > 0xFFFF) {
+        pes_length = 0;
+    }
+    pes.push_back((uint8_t)(pes_length >> 8));
+    pes.push_back((uint8_t)(pes_length & 0xFF));
+    pes.push_back(0x80);
+    pes.push_back(has_dts ? 0xC0 : 0x80);
+    pes.push_back((uint8_t)header_length);
+    put_timestamp(&pes, has_dts ? 0x03 : 0x02, pts);
+    if (has_dts) {
+        put_timestamp(&pes, 0x01, dts);
+    }
+    pes.insert(pes.end(), payload, payload + size);
+
+    size_t pos = 0;
+    bool first = true;
+    while (pos < pes.size()) {
+        size_t capacity = first && random_access ? 182 : 184;
+        size_t chunk = pes.size() - pos < capacity ? pes.size() - pos : capacity;
+        write_packet(fixture, pid, first, first && random_access, pes.data() + pos, chunk);
+        pos += chunk;
+        first = false;
+    }
+}
+
+/**
+ * 임의 RBSP 바이트를 에뮬레이션 방지 바이트와 함께 추가 (0이 자주 나오는 엔트로피 코딩 데이터 흉내)
+ */
+static void append_slice_data(uint32_t* seed, size_t size, std::vector<uint8_t>* out) {
+    int zeros = 0;
+    size_t end = out->size() + size;
+    while (out->size() + 1 < end) {
+        uint32_t r = fixture_random(seed);
+        uint8_t byte = (r & 0x7) == 0 ? 0x00 : (uint8_t)(r >> 8);
+        if (zeros >= 2 && byte <= 0x03) {
+            out->push_back(0x03);
+            zeros = 0;
+            continue;
+        }
+        out->push_back(byte);
+        zeros = byte == 0 ? zeros + 1 : 0;
+    }
+    out->push_back(0x80);  // rbsp_trailing_bits
+}
+
+static void append_nal(const uint8_t* nal, size_t size, bool long_start_code,
+                       std::vector<uint8_t>* out) {
+    if (long_start_code) {
+        out->push_back(0x00);
+    }
+    out->push_back(0x00);
+    out->push_back(0x00);
+    out->push_back(0x01);
+    out->insert(out->end(), nal, nal + size);
+}
+
+void fixture_h264_access_unit(uint32_t* seed, int size, bool idr, std::vector<uint8_t>* out) {
+    out->clear();
+    append_nal(kAud, sizeof(kAud), true, out);
+    if (idr) {
+        append_nal(kSps, sizeof(kSps), true, out);
+        append_nal(kPps, sizeof(kPps), true, out);
+    }
+    // first_mb_in_slice = 0, slice_type = I(7) / P(5)
+    const uint8_t idr_slice[] = {0x65, 0x88, 0x84};
+    const uint8_t p_slice[] = {0x41, 0x9A, 0x02};
+    append_nal(idr ? idr_slice : p_slice, 3, false, out);
+    if ((int)out->size() < size) {
+        append_slice_data(seed, (size_t)size - out->size(), out);
+    }
+}
+
+void fixture_adts_frame(uint32_t* seed, const int* block_sizes, int blocks, int sample_rate_index,
+                        bool crc, std::vector<uint8_t>* out) {
+    const int channel_config = 2;
+    size_t header_size = crc ? 7 + 2 * (size_t)blocks : 7;
+    size_t frame_size = header_size;
+    for (int i = 0; i < blocks; i++) {
+        frame_size += (size_t)block_sizes[i] + (crc && blocks > 1 ? 2 : 0);
+    }
+
+    out->push_back(0xFF);
+    out->push_back(crc ? 0xF0 : 0xF1);
+    out->push_back((uint8_t)((1 << 6) | (sample_rate_index << 2) | (channel_config >> 2)));
+    out->push_back((uint8_t)(((channel_config & 0x03) << 6) | ((frame_size >> 11) & 0x03)));
+    out->push_back((uint8_t)((frame_size >> 3) & 0xFF));
+    out->push_back((uint8_t)(((frame_size & 0x07) << 5) | 0x1F));
+    out->push_back((uint8_t)(0xFC | (blocks - 1)));
+    if (crc) {
+        // raw_data_block_position[1..]: adts_frame 시작부터의 오프셋
+        size_t position = header_size;
+        for (int i = 1; i < blocks; i++) {
+            position += (size_t)block_sizes[i - 1] + 2;
+            out->push_back((uint8_t)(position >> 8));
+            out->push_back((uint8_t)(position & 0xFF));
+        }
+        out->push_back(0xC0);  // crc_check (검증하지 않음)
+        out->push_back(0xC1);
+    }
+    for (int i = 0; i < blocks; i++) {
+        for (int j = 0; j < block_sizes[i]; j++) {
+            // 블록 번호를 첫 바이트에 넣어 테스트가 분리 결과를 구분할 수 있게 함
+            out->push_back(j == 0 ? (uint8_t)(0x10 + i) : (uint8_t)fixture_random(seed));
+        }
+        if (crc && blocks > 1) {
+            out->push_back(0xB0);  // adts_raw_data_block_error_check
+            out->push_back((uint8_t)(0xB0 + i));
+        }
+    }
+}
+
+int64_t ts_fixture_write_adts_stream(TsFixture* fixture, int frame_count,
+                                     std::vector<std::vector<uint8_t> >* frames) {
+    const int64_t start_pts = 126000;
+    const int64_t frame_duration = AAC_FRAME_SAMPLES * 90000 / 48000;
+    TsFixtureStream audio = {FIXTURE_AUDIO_PID, FIXTURE_STREAM_TYPE_AAC};
+    ts_fixture_write_pat(fixture, FIXTURE_PMT_PID);
+    ts_fixture_write_pmt(fixture, FIXTURE_PMT_PID, &audio, 1);
+
+    std::vector<uint8_t> stream;
+    std::vector<size_t> frame_offsets;
+    frames->clear();
+    for (int i = 0; i < frame_count; i++) {
+        int block_size = 40 + (int)(fixture_random(&fixture->seed) % 760);
+        bool crc = fixture_random(&fixture->seed) % 4 == 0;
+        std::vector<uint8_t> frame;
+        fixture_adts_frame(&fixture->seed, &block_size, 1, 3, crc, &frame);
+        frame_offsets.push_back(stream.size());
+        stream.insert(stream.end(), frame.begin(), frame.end());
+        frames->push_back(frame);
+    }
+
+    size_t pos = 0;
+    size_t next_frame = 0;
+    while (pos < stream.size()) {
+        size_t size = 300 + fixture_random(&fixture->seed) % 2700;
+        size = size < stream.size() - pos ? size : stream.size() - pos;
+        // 이 PES에서 시작하는 첫 프레임 (없으면 다음 프레임)
+        while (next_frame < frame_offsets.size() && frame_offsets[next_frame] < pos) {
+            next_frame++;
+        }
+        int64_t pts = start_pts + (int64_t)next_frame * frame_duration;
+        ts_fixture_write_pes(fixture, FIXTURE_AUDIO_PID, 0xC0, pts, pts, stream.data() + pos, size,
+                             true, false);
+        pos += size;
+    }
+    return start_pts;
+}
+
+TsSegmentSpec fixture_hls_segment_spec() {
+    TsSegmentSpec spec;
+    spec.video_frames = 120;
+    spec.key_frame_bytes = 200 * 1024;
+    spec.frame_bytes = 30 * 1024;
+    spec.gop = 120;
+    spec.frame_duration = 1500;
+    spec.audio_tracks = 1;
+    spec.audio_frames_per_pes = 5;
+    spec.audio_frame_bytes = 370;
+    spec.sample_rate_index = 3;
+    spec.start_pts = 126000;
+    return spec;
+}
+
+int ts_fixture_write_segment(TsFixture* fixture, const TsSegmentSpec* spec) {
+    std::vector<TsFixtureStream> streams;
+    if (spec->video_frames > 0) {
+        TsFixtureStream video = {FIXTURE_VIDEO_PID, FIXTURE_STREAM_TYPE_H264};
+        streams.push_back(video);
+    }
+    for (int i = 0; i < spec->audio_tracks; i++) {
+        TsFixtureStream audio = {FIXTURE_AUDIO_PID + i, FIXTURE_STREAM_TYPE_AAC};
+        streams.push_back(audio);
+    }
+    ts_fixture_write_pat(fixture, FIXTURE_PMT_PID);
+    ts_fixture_write_pmt(fixture, FIXTURE_PMT_PID, streams.data(), streams.size());
+
+    int sample_rate = kSampleRates[spec->sample_rate_index];
+    int64_t segment_duration = spec->video_frames > 0
+                                   ? spec->video_frames * spec->frame_duration
+                                   : 2 * 90000;
+    int64_t audio_pes_count = ((segment_duration * sample_rate / 90000) / AAC_FRAME_SAMPLES +
+                               spec->audio_frames_per_pes - 1) / spec->audio_frames_per_pes;
+
+    std::vector<uint8_t> access_unit;
+    int video_index = 0;
+    int64_t audio_index = 0;
+    int access_units = 0;
+    while (video_index < spec->video_frames || audio_index < audio_pes_count) {
+        // 디코딩 시각이 이른 쪽부터 기록
+        int64_t video_dts = spec->start_pts + video_index * spec->frame_duration;
+        int64_t audio_frame = audio_index * spec->audio_frames_per_pes;
+        int64_t audio_pts = spec->start_pts + audio_frame * AAC_FRAME_SAMPLES * 90000 / sample_rate;
+        bool write_video = video_index < spec->video_frames &&
+                           (audio_index >= audio_pes_count || video_dts <= audio_pts);
+        if (write_video) {
+            bool idr = video_index % spec->gop == 0;
+            fixture_h264_access_unit(&fixture->seed,
+                                     idr ? spec->key_frame_bytes : spec->frame_bytes, idr,
+                                     &access_unit);
+            // 한 프레임 재정렬 지연 (PTS = DTS + 프레임 길이)
+            ts_fixture_write_pes(fixture, FIXTURE_VIDEO_PID, 0xE0, video_dts + spec->frame_duration,
+                                 video_dts, access_unit.data(), access_unit.size(), false, idr);
+            video_index++;
+            access_units++;
+            continue;
+        }
+        for (int track = 0; track < spec->audio_tracks; track++) {
+            access_unit.clear();
+            for (int i = 0; i < spec->audio_frames_per_pes; i++) {
+                fixture_adts_frame(&fixture->seed, &spec->audio_frame_bytes, 1,
+                                   spec->sample_rate_index, false, &access_unit);
+            }
+            ts_fixture_write_pes(fixture, FIXTURE_AUDIO_PID + track, 0xC0 + track, audio_pts,
+                                 audio_pts, access_unit.data(), access_unit.size(), true, false);
+            access_units += spec->audio_frames_per_pes;
+        }
+        audio_index++;
+    }
+    return access_units;
+}
@@ -0,0 +1,101 @@
+/*
+ * 테스트/벤치마크용 합성 HLS TS 세그먼트 생성기
+ *
+ * PAT/PMT(CRC 포함), 프레임마다 PES 하나인 H.264 비디오, PES마다 ADTS 프레임 여러 개를 묶은 AAC 오디오로
+ * 구성된 일반적인 HLS TS를 만든다. 같은 seed면 같은 바이트가 나온다.
+ * H.264 슬라이스는 임의 바이트에 에뮬레이션 방지 바이트를 넣어 실제 스트림처럼 시작 코드가 섞이지 않는다.
+ */
+#ifndef YOPLAYER_TEST_TS_FIXTURE_H
+#define YOPLAYER_TEST_TS_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+static const int FIXTURE_PMT_PID = 0x1000;
+static const int FIXTURE_VIDEO_PID = 0x100;
+static const int FIXTURE_AUDIO_PID = 0x101;   // 오디오 트랙 i는 FIXTURE_AUDIO_PID + i
+
+static const int FIXTURE_STREAM_TYPE_H264 = 0x1B;
+static const int FIXTURE_STREAM_TYPE_AAC = 0x0F;
+
+struct TsFixtureStream {
+    int pid;
+    int stream_type;
+};
+
+struct TsFixture {
+    std::vector<uint8_t> data;
+    uint8_t continuity[0x2000];
+    uint32_t seed;
+};
+
+// 세그먼트 구성
+struct TsSegmentSpec {
+    int video_frames;               // 0이면 비디오 없음
+    int key_frame_bytes;            // IDR 액세스 유닛 크기
+    int frame_bytes;                // 나머지 액세스 유닛 크기
+    int gop;                        // 키프레임 간격 (프레임)
+    int64_t frame_duration;         // 90kHz
+    int audio_tracks;
+    int audio_frames_per_pes;
+    int audio_frame_bytes;          // ADTS 헤더 제외
+    int sample_rate_index;          // ADTS sampling_frequency_index (3 = 48kHz)
+    int64_t start_pts;              // 90kHz (33비트를 넘으면 하위 33비트로 기록)
+};
+
+uint32_t fixture_random(uint32_t* state);
+
+void ts_fixture_init(TsFixture* fixture, uint32_t seed);
+
+void ts_fixture_write_pat(TsFixture* fixture, int pmt_pid);
+
+void ts_fixture_write_pmt(TsFixture* fixture, int pmt_pid, const TsFixtureStream* streams,
+                          size_t count);
+
+/**
+ * PES 하나를 TS 패킷으로 나누어 기록
+ * @param dts pts와 같으면 PTS만 기록
+ * @param bounded true면 PES_packet_length를 채움 (오디오), false면 0 (비디오)
+ * @param random_access 첫 패킷의 adaptation field에 random_access_indicator 표시
+ */
+void ts_fixture_write_pes(TsFixture* fixture, int pid, int stream_id, int64_t pts, int64_t dts,
+                          const uint8_t* payload, size_t size, bool bounded, bool random_access);
+
+/**
+ * Annex-B H.264 액세스 유닛 (IDR이면 SPS/PPS 포함, 1080p High 프로파일 SPS)
+ */
+void fixture_h264_access_unit(uint32_t* seed, int size, bool idr, std::vector<uint8_t>* out);
+
+/**
+ * ADTS AAC 프레임 추가 (AAC-LC 스테레오)
+ * @param block_sizes raw_data_block마다의 크기 (1~4개)
+ * @param crc true면 protection_absent = 0 (헤더 CRC, 블록 위치, 블록별 CRC 포함)
+ */
+void fixture_adts_frame(uint32_t* seed, const int* block_sizes, int blocks, int sample_rate_index,
+                        bool crc, std::vector<uint8_t>* out);
+
+/**
+ * PAT/PMT와 spec 구성의 비디오/오디오 PES를 시각 순서로 기록
+ * @return 기록한 액세스 유닛 수 (비디오 프레임 + 모든 트랙의 ADTS 프레임)
+ */
+int ts_fixture_write_segment(TsFixture* fixture, const TsSegmentSpec* spec);
+
+/**
+ * AAC 트랙(FIXTURE_AUDIO_PID, 48kHz) 하나만 있는 TS 기록
+ * 크기가 제각각인 ADTS 프레임(일부는 CRC 포함 단일 블록)을 이어 붙인 뒤 임의 크기의 PES로 나누므로
+ * PES 하나에 프레임이 여러 개 들어가거나 프레임이 PES 경계에 걸친다.
+ * PES PTS는 그 PES에서 시작하는 첫 프레임의 PTS다.
+ * @param frames 기록한 ADTS 프레임 (헤더 포함, 순서대로)
+ * @return 첫 프레임의 PTS (프레임 k의 PTS = 반환값 + k * 1920)
+ */
+int64_t ts_fixture_write_adts_stream(TsFixture* fixture, int frame_count,
+                                     std::vector<std::vector<uint8_t> >* frames);
+
+/**
+ * 2초 1080p60 / 48kHz AAC 세그먼트 구성 (약 4MB)
+ */
+TsSegmentSpec fixture_hls_segment_spec();
+
+#endif  // YOPLAYER_TEST_TS_FIXTURE_H
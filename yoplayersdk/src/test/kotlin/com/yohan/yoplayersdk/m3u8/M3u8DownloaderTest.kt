@@ -0,0 +1,255 @@
+package com.yohan.yoplayersdk.m3u8
+
+import okhttp3.mockwebserver.Dispatcher
+import okhttp3.mockwebserver.MockResponse
+import okhttp3.mockwebserver.MockWebServer
+import okhttp3.mockwebserver.RecordedRequest
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import java.nio.ByteBuffer
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
+
+/**
+ * 세그먼트를 동시에 미리 받는 다운로드 테스트
+ *
+ * 세그먼트마다 응답 본문 지연을 다르게 주어 뒤 세그먼트가 먼저 끝나는 상황을 만듭니다.
+ */
+class M3u8DownloaderTest {
+
+    private lateinit var server: MockWebServer
+    private lateinit var downloader: M3u8Downloader
+
+    // 세그먼트 인덱스별 응답 (dispatch에서 읽음)
+    @Volatile
+    private var segmentResponse: (Int) -> MockResponse = { MockResponse().setBody(segmentBody(it)) }
+    private val segmentRequests = CountDownLatch(CONCURRENT_SEGMENTS)
+
+    // 플레이어가 메모리 예산의 다운로드 바이트로 반영하는 수신 버퍼 크기 (보고된 순서대로)
+    private val downloadBytes = ArrayList<Long>()
+
+    @Before
+    fun setUp() {
+        server = MockWebServer()
+        server.dispatcher = object : Dispatcher() {
+            override fun dispatch(request: RecordedRequest): MockResponse {
+                val path = request.path ?: return MockResponse().setResponseCode(404)
+                if (path == PLAYLIST_PATH) {
+                    return MockResponse().setBody(mediaPlaylist())
+                }
+                val index = path.removePrefix("/segment").removeSuffix(".ts").toIntOrNull()
+                    ?: return MockResponse().setResponseCode(404)
+                segmentRequests.countDown()
+                return segmentResponse(index)
+            }
+        }
+        server.start()
+        downloader = M3u8Downloader()
+        downloader.onSegmentBufferResized = { bytes ->
+            synchronized(downloadBytes) { downloadBytes.add(bytes) }
+        }
+    }
+
+    @After
+    fun tearDown() {
+        downloader.release()
+        server.shutdown()
+    }
+
+    /**
+     * 뒤 세그먼트가 먼저 끝나도 재생 순서대로 전달되는지 확인
+     */
+    @Test
+    fun prefetchDeliversSegmentsInOrder() {
+        segmentResponse = { index ->
+            MockResponse()
+                .setBody(segmentBody(index))
+                .setBodyDelay((SEGMENT_COUNT - index) * 100L, TimeUnit.MILLISECONDS)
+        }
+        val listener = RecordingListener()
+
+        downloader.download(playlistUrl(), listener, maxConcurrentSegments = CONCURRENT_SEGMENTS)
+
+        assertTrue(listener.finished.await(TIMEOUT_SECONDS, TimeUnit.SECONDS))
+        assertTrue(listener.completed)
+        assertEquals((0 until SEGMENT_COUNT).toList(), listener.deliveredIndices())
+        listener.deliveredBodies().forEachIndexed { index, body ->
+            assertEquals(segmentBody(index), body)
+        }
+        assertSegmentBuffersTrimmed()
+    }
+
+    /**
+     * 먼저 실패한 뒤 세그먼트의 오류가 앞 세그먼트를 모두 넘긴 뒤, 그 세그먼트의 차례에 알려지는지 확인
+     */
+    @Test
+    fun prefetchReportsFailureAtFailedSegmentTurn() {
+        segmentResponse = { index ->
+            if (index == FAILED_SEGMENT) {
+                MockResponse().setResponseCode(500)
+            } else {
+                MockResponse()
+                    .setBody(segmentBody(index))
+                    .setBodyDelay((SEGMENT_COUNT - index) * 100L, TimeUnit.MILLISECONDS)
+            }
+        }
+        val listener = RecordingListener()
+
+        downloader.download(playlistUrl(), listener, maxConcurrentSegments = CONCURRENT_SEGMENTS)
+
+        assertTrue(listener.finished.await(TIMEOUT_SECONDS, TimeUnit.SECONDS))
+        val failedSegment = listener.failedSegment
+        assertNotNull(failedSegment)
+        assertTrue(failedSegment!!.url.endsWith("/segment$FAILED_SEGMENT.ts"))
+        assertEquals((0 until FAILED_SEGMENT).toList(), listener.deliveredAtFailure)
+        assertEquals((0 until FAILED_SEGMENT).toList(), listener.deliveredIndices())
+        assertTrue(listener.completed.not())
+        assertSegmentBuffersTrimmed()
+    }
+
+    /**
+     * 받는 중인 세그먼트가 있을 때 취소하면 본문을 기다리지 않고 끝나며,
+     * 동시에 받느라 늘어난 수신 버퍼를 하나만 남기고 해제하는지 확인
+     */
+    @Test
+    fun cancelReleasesSegmentBuffers() {
+        segmentResponse = { index ->
+            MockResponse()
+                .setBody(segmentBody(index))
+                .setBodyDelay(CANCEL_BODY_DELAY_MS, TimeUnit.MILLISECONDS)
+        }
+        val listener = RecordingListener()
+
+        downloader.download(playlistUrl(), listener, maxConcurrentSegments = CONCURRENT_SEGMENTS)
+
+        assertTrue(segmentRequests.await(TIMEOUT_SECONDS, TimeUnit.SECONDS))
+        val bufferBytes = synchronized(downloadBytes) { downloadBytes.first() }
+        assertEquals(CONCURRENT_SEGMENTS * bufferBytes, lastDownloadBytes())
+        val cancelTime = System.currentTimeMillis()
+        downloader.cancel()
+
+        assertTrue(listener.finished.await(TIMEOUT_SECONDS, TimeUnit.SECONDS))
+        assertTrue(listener.cancelled)
+        assertTrue(System.currentTimeMillis() - cancelTime < CANCEL_BODY_DELAY_MS)
+        assertTrue(listener.deliveredIndices().isEmpty())
+        assertSegmentBuffersTrimmed()
+    }
+
+    private fun lastDownloadBytes(): Long = synchronized(downloadBytes) { downloadBytes.last() }
+
+    /**
+     * 다운로드가 끝난 뒤 수신 버퍼가 처음 할당한 하나 크기로 줄었는지 확인
+     * (응답 본문이 처음 버퍼보다 작으므로 버퍼가 커지지 않음)
+     */
+    private fun assertSegmentBuffersTrimmed() {
+        val reported = synchronized(downloadBytes) { downloadBytes.toList() }
+        assertTrue(reported.isNotEmpty())
+        assertTrue(reported.max() > reported.first())
+        assertEquals(reported.first(), reported.last())
+    }
+
+    private fun playlistUrl(): String = server.url(PLAYLIST_PATH).toString()
+
+    private fun mediaPlaylist(): String = buildString {
+        appendLine("#EXTM3U")
+        appendLine("#EXT-X-VERSION:3")
+        appendLine("#EXT-X-TARGETDURATION:2")
+        appendLine("#EXT-X-MEDIA-SEQUENCE:0")
+        for (index in 0 until SEGMENT_COUNT) {
+            appendLine("#EXTINF:2.0,")
+            appendLine("segment$index.ts")
+        }
+        appendLine("#EXT-X-ENDLIST")
+    }
+
+    private fun segmentBody(index: Int): String = "segment-$index;".repeat(1024)
+
+    /**
+     * 리스너 호출을 기록 (다운로드 코루틴 스레드에서 호출됨)
+     */
+    private class RecordingListener : M3u8DownloadListener {
+        private val delivered = ArrayList<Pair<Int, String>>()
+
+        // 완료, 취소 또는 세그먼트와 무관한 마지막 오류에서 내려감
+        val finished = CountDownLatch(1)
+
+        @Volatile
+        var completed = false
+
+        @Volatile
+        var cancelled = false
+
+        @Volatile
+        var failedSegment: M3u8Segment? = null
+
+        @Volatile
+        var deliveredAtFailure: List<Int> = emptyList()
+
+        fun deliveredIndices(): List<Int> = synchronized(delivered) { delivered.map { it.first } }
+
+        fun deliveredBodies(): List<String> = synchronized(delivered) { delivered.map { it.second } }
+
+        override fun onDownloadStarted(playlist: M3u8Playlist.Media, totalSegments: Int) {
+        }
+
+        override fun onSegmentDownloaded(
+            segment: M3u8Segment,
+            data: ByteBuffer,
+            currentIndex: Int,
+            totalSegments: Int
+        ) {
+            val bytes = ByteArray(data.remaining())
+            data.duplicate().get(bytes)
+            synchronized(delivered) {
+                delivered.add(currentIndex to String(bytes, Charsets.US_ASCII))
+            }
+        }
+
+        override fun onSegmentDownloaded(
+            segment: M3u8Segment,
+            data: ByteArray,
+            currentIndex: Int,
+            totalSegments: Int
+        ) {
+        }
+
+        override fun onProgressUpdate(progress: Float, downloadedSegments: Int, totalSegments: Int) {
+        }
+
+        override fun onDownloadCompleted(
+            segments: List<DownloadedSegment>,
+            totalBytes: Long,
+            elapsedTimeMs: Long
+        ) {
+            completed = true
+            finished.countDown()
+        }
+
+        override fun onDownloadError(error: Throwable, segment: M3u8Segment?) {
+            if (segment != null) {
+                deliveredAtFailure = deliveredIndices()
+                failedSegment = segment
+            } else {
+                finished.countDown()
+            }
+        }
+
+        override fun onDownloadCancelled() {
+            cancelled = true
+            finished.countDown()
+        }
+    }
+
+    companion object {
+        private const val PLAYLIST_PATH = "/playlist.m3u8"
+        private const val SEGMENT_COUNT = 6
+        private const val CONCURRENT_SEGMENTS = 4
+        private const val FAILED_SEGMENT = 3
+        private const val CANCEL_BODY_DELAY_MS = 3_000L
+        private const val TIMEOUT_SECONDS = 10L
+    }
+}